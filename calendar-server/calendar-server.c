@@ -321,12 +321,46 @@ struct _App
 
   gchar *timezone_location;
 
-  GSList *notify_appointments; /* CalendarAppointment *, for EventsAdded */
-  GSList *notify_ids; /* gchar *, for EventsRemoved */
+  /* Changes are batched and emitted once per main loop iteration */
+  GHashTable *notify_appointments; /* id -> CalendarAppointment *, for EventsAdded */
+  GHashTable *notify_ids; /* gchar *, for EventsRemoved */
+  guint notify_id;
 
-  GSList *live_views;
+  /* Expanded instances of recurring events, keyed by the id of the master */
+  GHashTable *recurrences; /* gchar * -> RecurrenceCache * */
+
+  GSList *live_views; /* AppView * */
 };
 
+/* The instances of a recurring event expanded over [since, until) */
+typedef struct
+{
+  gchar      *revision;
+  time_t      since;
+  time_t      until;
+  GHashTable *instances; /* gchar * -> RecurrenceInstance * */
+} RecurrenceCache;
+
+typedef struct
+{
+  time_t start_time;
+  time_t end_time;
+} RecurrenceInstance;
+
+/* A live view on a calendar covering the range [since, until) */
+typedef struct
+{
+  ECalClientView *view;
+  gchar          *source_uid;
+  time_t          since;
+  time_t          until;
+  GHashTable     *ids; /* gchar * event ids the view currently reports */
+} AppView;
+
+/* Rebuild a source's views from scratch when a moving window fragmented
+ * it into more views than this */
+#define MAX_VIEWS_PER_SOURCE 3
+
 static void
 app_update_timezone (App *app)
 {
@@ -342,55 +376,60 @@ app_update_timezone (App *app)
       g_free (app->timezone_location);
       app->timezone_location = g_steal_pointer (&location);
       print_debug ("Using timezone %s", app->timezone_location);
+
+      /* Instances need to be expanded in the new timezone */
+      if (app->recurrences)
+        g_hash_table_remove_all (app->recurrences);
     }
 }
 
+static void
+recurrence_cache_free (gpointer ptr)
+{
+  RecurrenceCache *cache = ptr;
+
+  g_free (cache->revision);
+  g_clear_pointer (&cache->instances, g_hash_table_unref);
+  g_free (cache);
+}
+
 static void
 app_notify_events_added (App *app)
 {
   GVariantBuilder builder;
-  GSList *events, *link;
-
-  events = g_slist_reverse (app->notify_appointments);
-  app->notify_appointments = NULL;
+  GHashTableIter iter;
+  CalendarAppointment *appt;
 
-  print_debug ("Emitting EventsAddedOrUpdated with %d events", g_slist_length (events));
+  print_debug ("Emitting EventsAddedOrUpdated with %d events",
+               g_hash_table_size (app->notify_appointments));
 
-  if (!events)
+  if (!g_hash_table_size (app->notify_appointments))
     return;
 
   /* The a{sv} is used as an escape hatch in case we want to provide more
    * information in the future without breaking ABI
    */
   g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(ssxxa{sv})"));
-  for (link = events; link; link = g_slist_next (link))
+  g_hash_table_iter_init (&iter, app->notify_appointments);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &appt))
     {
-      CalendarAppointment *appt = link->data;
-      time_t start_time = appt->start_time;
-      time_t end_time   = appt->end_time;
       GVariantBuilder extras_builder;
 
-      if ((start_time >= app->since &&
-           start_time < app->until) ||
-          (start_time <= app->since &&
-          (end_time - 1) > app->since))
+      g_variant_builder_init (&extras_builder, G_VARIANT_TYPE ("a{sv}"));
+      if (appt->color)
         {
-          g_variant_builder_init (&extras_builder, G_VARIANT_TYPE ("a{sv}"));
-          if (appt->color)
-            {
-              g_variant_builder_add (&extras_builder,
-                                     "{sv}",
-                                     "color",
-                                     g_variant_new_string (appt->color));
-            }
-          g_variant_builder_add (&builder,
-                                 "(ssxxa{sv})",
-                                 appt->id,
-                                 appt->summary != NULL ? appt->summary : "",
-                                 (gint64) start_time,
-                                 (gint64) end_time,
-                                 &extras_builder);
+          g_variant_builder_add (&extras_builder,
+                                 "{sv}",
+                                 "color",
+                                 g_variant_new_string (appt->color));
         }
+      g_variant_builder_add (&builder,
+                             "(ssxxa{sv})",
+                             appt->id,
+                             appt->summary != NULL ? appt->summary : "",
+                             (gint64) appt->start_time,
+                             (gint64) appt->end_time,
+                             &extras_builder);
     }
 
   g_dbus_connection_emit_signal (app->connection,
@@ -403,30 +442,25 @@ app_notify_events_added (App *app)
 
   g_variant_builder_clear (&builder);
 
-  g_slist_free_full (events, calendar_appointment_free);
+  g_hash_table_remove_all (app->notify_appointments);
 }
 
 static void
 app_notify_events_removed (App *app)
 {
   GVariantBuilder builder;
-  GSList *ids, *link;
+  GHashTableIter iter;
+  const gchar *id;
 
-  ids = app->notify_ids;
-  app->notify_ids = NULL;
+  print_debug ("Emitting EventsRemoved with %d ids", g_hash_table_size (app->notify_ids));
 
-  print_debug ("Emitting EventsRemoved with %d ids", g_slist_length (ids));
-
-  if (!ids)
+  if (!g_hash_table_size (app->notify_ids))
     return;
 
   g_variant_builder_init (&builder, G_VARIANT_TYPE ("as"));
-  for (link = ids; link; link = g_slist_next (link))
-    {
-      const gchar *id = link->data;
-
-      g_variant_builder_add (&builder, "s", id);
-    }
+  g_hash_table_iter_init (&iter, app->notify_ids);
+  while (g_hash_table_iter_next (&iter, (gpointer *) &id, NULL))
+    g_variant_builder_add (&builder, "s", id);
 
   g_dbus_connection_emit_signal (app->connection,
                                  NULL, /* destination_bus_name */
@@ -437,9 +471,288 @@ app_notify_events_removed (App *app)
                                  NULL);
   g_variant_builder_clear (&builder);
 
-  g_slist_free_full (ids, g_free);
+  g_hash_table_remove_all (app->notify_ids);
+}
+
+static gboolean
+app_notify_events_cb (gpointer user_data)
+{
+  App *app = user_data;
+
+  app->notify_id = 0;
+
+  app_notify_events_removed (app);
+  app_notify_events_added (app);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+app_schedule_notify (App *app)
+{
+  if (app->notify_id)
+    return;
+
+  app->notify_id = g_idle_add (app_notify_events_cb, app);
+  g_source_set_name_by_id (app->notify_id, "[phosh-calendar-server] notify events");
+}
+
+static gboolean
+app_in_window (App *app,
+               time_t start_time,
+               time_t end_time)
+{
+  return (start_time >= app->since && start_time < app->until) ||
+         (start_time <= app->since && (end_time - 1) > app->since);
+}
+
+/* Takes ownership of appt */
+static void
+app_queue_appointment (App *app,
+                       CalendarAppointment *appt)
+{
+  if (!app_in_window (app, appt->start_time, appt->end_time))
+    {
+      calendar_appointment_free (appt);
+      return;
+    }
+
+  g_hash_table_remove (app->notify_ids, appt->id);
+  /* Replace the key too as it's owned by the appointment */
+  g_hash_table_replace (app->notify_appointments, appt->id, appt);
+  app_schedule_notify (app);
+}
+
+/* Takes ownership of id */
+static void
+app_queue_removal (App *app,
+                   gchar *id)
+{
+  g_hash_table_remove (app->notify_appointments, id);
+  g_hash_table_add (app->notify_ids, id);
+  app_schedule_notify (app);
+}
+
+static gchar *
+get_component_revision (ICalComponent *icomp)
+{
+  g_autofree gchar *str = i_cal_component_as_ical_string (icomp);
+
+  /* Any change (e.g. an added exception) can change the instances */
+  return g_compute_checksum_for_string (G_CHECKSUM_MD5, str, -1);
+}
+
+static void
+app_expand_range (App *app,
+                  ECalClient *cal_client,
+                  ICalComponent *icomp,
+                  time_t since,
+                  time_t until,
+                  GSList **pappointments)
+{
+  CollectAppointmentsData data;
+
+  if (since >= until)
+    return;
+
+  data.client = cal_client;
+  data.pappointments = pappointments;
+
+  e_cal_client_generate_instances_for_object_sync (cal_client, icomp, since, until, NULL,
+                                                   generate_instances_cb, &data);
+}
+
+/*
+ * Expand the instances of a recurring event. Instances are cached per
+ * master so an unchanged event is only expanded for the parts of the
+ * window it wasn't expanded for yet.
+ */
+static void
+app_process_recurrence (App *app,
+                        ECalClient *cal_client,
+                        ICalComponent *icomp)
+{
+  const gchar *source_uid = e_source_get_uid (e_client_get_source (E_CLIENT (cal_client)));
+  g_autofree gchar *key = create_event_id (source_uid, i_cal_component_get_uid (icomp), NULL);
+  g_autofree gchar *revision = get_component_revision (icomp);
+  g_autoptr (GHashTable) old_ids = NULL;
+  RecurrenceCache *cache;
+  GSList *appointments = NULL, *link;
+
+  cache = g_hash_table_lookup (app->recurrences, key);
+  if (cache && g_strcmp0 (cache->revision, revision) == 0)
+    {
+      if (app->since >= cache->until || app->until <= cache->since)
+        {
+          g_hash_table_remove_all (cache->instances);
+          app_expand_range (app, cal_client, icomp, app->since, app->until, &appointments);
+          cache->since = app->since;
+          cache->until = app->until;
+        }
+      else
+        {
+          app_expand_range (app, cal_client, icomp, app->since, cache->since, &appointments);
+          app_expand_range (app, cal_client, icomp, cache->until, app->until, &appointments);
+          cache->since = MIN (cache->since, app->since);
+          cache->until = MAX (cache->until, app->until);
+        }
+    }
+  else
+    {
+      if (cache)
+        {
+          print_debug ("Recurrence '%s' changed, reexpanding", i_cal_component_get_uid (icomp));
+          old_ids = g_steal_pointer (&cache->instances);
+          g_hash_table_remove (app->recurrences, key);
+        }
+
+      cache = g_new0 (RecurrenceCache, 1);
+      cache->revision = g_steal_pointer (&revision);
+      cache->since = app->since;
+      cache->until = app->until;
+      cache->instances = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+      g_hash_table_insert (app->recurrences, g_steal_pointer (&key), cache);
+
+      app_expand_range (app, cal_client, icomp, app->since, app->until, &appointments);
+    }
+
+  for (link = appointments; link; link = g_slist_next (link))
+    {
+      CalendarAppointment *appt = link->data;
+      RecurrenceInstance *instance = g_new0 (RecurrenceInstance, 1);
+
+      instance->start_time = appt->start_time;
+      instance->end_time = appt->end_time;
+      g_hash_table_insert (cache->instances, g_strdup (appt->id), instance);
+      if (old_ids)
+        g_hash_table_remove (old_ids, appt->id);
+
+      app_queue_appointment (app, appt);
+    }
+  g_slist_free (appointments);
+
+  /* Instances that vanished with the change (e.g. new exceptions) */
+  if (old_ids)
+    {
+      GHashTableIter iter;
+      gchar *id;
+
+      g_hash_table_iter_init (&iter, old_ids);
+      while (g_hash_table_iter_next (&iter, (gpointer *) &id, NULL))
+        app_queue_removal (app, g_strdup (id));
+    }
+}
+
+static void
+app_drop_recurrence (App *app,
+                     const gchar *key)
+{
+  RecurrenceCache *cache;
+  GHashTableIter iter;
+  gchar *id;
+
+  cache = g_hash_table_lookup (app->recurrences, key);
+  if (!cache)
+    return;
+
+  g_hash_table_iter_init (&iter, cache->instances);
+  while (g_hash_table_iter_next (&iter, (gpointer *) &id, NULL))
+    app_queue_removal (app, g_strdup (id));
+
+  g_hash_table_remove (app->recurrences, key);
+}
+
+static void
+app_drop_source_recurrences (App *app,
+                             const gchar *source_uid)
+{
+  g_autofree gchar *prefix = g_strconcat (source_uid, "\n", NULL);
+  GHashTableIter iter;
+  const gchar *key;
+
+  g_hash_table_iter_init (&iter, app->recurrences);
+  while (g_hash_table_iter_next (&iter, (gpointer *) &key, NULL))
+    {
+      if (g_str_has_prefix (key, prefix))
+        g_hash_table_iter_remove (&iter);
+    }
+}
+
+static AppView *
+app_lookup_view (App *app,
+                 ECalClientView *view)
+{
+  GSList *link;
+
+  for (link = app->live_views; link; link = g_slist_next (link))
+    {
+      AppView *app_view = link->data;
+
+      if (app_view->view == view)
+        return app_view;
+    }
+
+  return NULL;
+}
+
+/*
+ * Whether any view of the source still reports the event. The views of
+ * a source are adjacent so an event crossing a view boundary is reported
+ * by several of them and must only be removed once none does anymore.
+ */
+static gboolean
+app_source_reports_id (App *app,
+                       const gchar *source_uid,
+                       const gchar *id)
+{
+  GSList *link;
+
+  for (link = app->live_views; link; link = g_slist_next (link))
+    {
+      AppView *app_view = link->data;
 
-  return;
+      if (g_strcmp0 (source_uid, app_view->source_uid) == 0 &&
+          g_hash_table_contains (app_view->ids, id))
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+/*
+ * Shrink the cached expansions to the current window so the caches don't
+ * grow without bounds while the window moves. Instances outside of the
+ * window are forgotten, not removed, as clients drop them with the
+ * window change anyway.
+ */
+static void
+app_clip_recurrences (App *app)
+{
+  GHashTableIter iter;
+  RecurrenceCache *cache;
+
+  g_hash_table_iter_init (&iter, app->recurrences);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &cache))
+    {
+      GHashTableIter instance_iter;
+      RecurrenceInstance *instance;
+
+      if (app->since >= cache->until || app->until <= cache->since)
+        {
+          g_hash_table_iter_remove (&iter);
+          continue;
+        }
+
+      cache->since = MAX (cache->since, app->since);
+      cache->until = MIN (cache->until, app->until);
+
+      g_hash_table_iter_init (&instance_iter, cache->instances);
+      while (g_hash_table_iter_next (&instance_iter, NULL, (gpointer *) &instance))
+        {
+          if (!app_in_window (app, instance->start_time, instance->end_time))
+            g_hash_table_iter_remove (&instance_iter);
+        }
+    }
 }
 
 static void
@@ -448,11 +761,15 @@ app_process_added_modified_objects (App *app,
                                     GSList *objects) /* ICalComponent * */
 {
   ECalClient *cal_client;
+  AppView *app_view;
   GSList *link;
+  const gchar *source_uid;
   gboolean expand_recurrences;
 
   cal_client = e_cal_client_view_ref_client (view);
+  source_uid = e_source_get_uid (e_client_get_source (E_CLIENT (cal_client)));
   expand_recurrences = e_cal_client_get_source_type (cal_client) == E_CAL_CLIENT_SOURCE_TYPE_EVENTS;
+  app_view = app_lookup_view (app, view);
 
   for (link = objects; link; link = g_slist_next (link))
     {
@@ -462,17 +779,19 @@ app_process_added_modified_objects (App *app,
       if (!icomp || !i_cal_component_get_uid (icomp))
         continue;
 
+      if (app_view)
+        {
+          g_autofree gchar *rid = e_cal_util_component_get_recurid_as_string (icomp);
+
+          g_hash_table_add (app_view->ids,
+                            create_event_id (source_uid, i_cal_component_get_uid (icomp), rid));
+        }
+
       if (expand_recurrences &&
           !e_cal_util_component_is_instance (icomp) &&
           e_cal_util_component_has_recurrences (icomp))
         {
-          CollectAppointmentsData data;
-
-          data.client = cal_client;
-          data.pappointments = &app->notify_appointments;
-
-          e_cal_client_generate_instances_for_object_sync (cal_client, icomp, app->since, app->until, NULL,
-                                                           generate_instances_cb, &data);
+          app_process_recurrence (app, cal_client, icomp);
         }
       else
         {
@@ -480,16 +799,12 @@ app_process_added_modified_objects (App *app,
           if (!comp)
             continue;
 
-          app->notify_appointments = g_slist_prepend (app->notify_appointments,
-                                                      calendar_appointment_new (cal_client, comp));
+          app_queue_appointment (app, calendar_appointment_new (cal_client, comp));
           g_object_unref (comp);
         }
     }
 
   g_clear_object (&cal_client);
-
-  if (app->notify_appointments)
-    app_notify_events_added (app);
 }
 
 static void
@@ -529,31 +844,50 @@ on_objects_removed (ECalClientView *view,
 {
   App *app = user_data;
   ECalClient *client;
+  AppView *app_view;
   GSList *link;
   const gchar *source_uid;
 
   client = e_cal_client_view_ref_client (view);
   source_uid = e_source_get_uid (e_client_get_source (E_CLIENT (client)));
+  app_view = app_lookup_view (app, view);
 
   print_debug ("%s (%d) for calendar '%s'", G_STRFUNC, g_slist_length (uids), source_uid);
 
   for (link = uids; link; link = g_slist_next (link))
     {
       ECalComponentId *id = link->data;
+      g_autofree gchar *event_id = NULL;
 
       if (!id)
         continue;
 
-      app->notify_ids = g_slist_prepend (app->notify_ids,
-                                         create_event_id (source_uid,
-                                         e_cal_component_id_get_uid (id),
-                                         e_cal_component_id_get_rid (id)));
+      event_id = create_event_id (source_uid,
+                                  e_cal_component_id_get_uid (id),
+                                  e_cal_component_id_get_rid (id));
+      if (app_view)
+        g_hash_table_remove (app_view->ids, event_id);
+
+      /* Moved into an adjacent view of the same calendar */
+      if (app_source_reports_id (app, source_uid, event_id))
+        {
+          print_debug ("Event '%s' still in another view", event_id);
+          continue;
+        }
+
+      /* Removing a recurring event removes all of its instances */
+      if (!e_cal_component_id_get_rid (id))
+        {
+          g_autofree gchar *key = create_event_id (source_uid,
+                                                   e_cal_component_id_get_uid (id),
+                                                   NULL);
+          app_drop_recurrence (app, key);
+        }
+
+      app_queue_removal (app, g_steal_pointer (&event_id));
     }
 
   g_clear_object (&client);
-
-  if (app->notify_ids)
-    app_notify_events_removed (app);
 }
 
 static gboolean
@@ -562,18 +896,21 @@ app_has_calendars (App *app)
   return app->live_views != NULL;
 }
 
-static ECalClientView *
+static AppView *
 app_start_view (App *app,
-                ECalClient *cal_client)
+                ECalClient *cal_client,
+                time_t since,
+                time_t until)
 {
   g_autofree char *since_iso8601 = NULL;
   g_autofree char *until_iso8601 = NULL;
   g_autofree char *query = NULL;
   const gchar *tz_location;
   ECalClientView *view = NULL;
+  AppView *app_view;
   g_autoptr (GError) error = NULL;
 
-  if (app->since <= 0 || app->since >= app->until)
+  if (since <= 0 || since >= until)
     return NULL;
 
   if (!app->since || !app->until)
@@ -585,8 +922,8 @@ app_start_view (App *app,
   /* timezone could have changed */
   app_update_timezone (app);
 
-  since_iso8601 = isodate_from_time_t (app->since);
-  until_iso8601 = isodate_from_time_t (app->until);
+  since_iso8601 = isodate_from_time_t (since);
+  until_iso8601 = isodate_from_time_t (until);
   tz_location = i_cal_timezone_get_location (app->zone);
 
   print_debug ("Loading events since %s until %s for calendar '%s'",
@@ -606,36 +943,49 @@ app_start_view (App *app,
   if (!e_cal_client_get_view_sync (cal_client, query, &view, NULL /* cancellable */, &error))
     {
       g_warning ("Error setting up live-query '%s' on calendar: %s\n", query, error ? error->message : "Unknown error");
-      view = NULL;
-    }
-  else
-    {
-      g_signal_connect (view,
-                        "objects-added",
-                        G_CALLBACK (on_objects_added),
-                        app);
-      g_signal_connect (view,
-                        "objects-modified",
-                        G_CALLBACK (on_objects_modified),
-                        app);
-      g_signal_connect (view,
-                        "objects-removed",
-                        G_CALLBACK (on_objects_removed),
-                        app);
-      e_cal_client_view_start (view, NULL);
+      return NULL;
     }
-  return view;
+
+  g_signal_connect (view,
+                    "objects-added",
+                    G_CALLBACK (on_objects_added),
+                    app);
+  g_signal_connect (view,
+                    "objects-modified",
+                    G_CALLBACK (on_objects_modified),
+                    app);
+  g_signal_connect (view,
+                    "objects-removed",
+                    G_CALLBACK (on_objects_removed),
+                    app);
+  e_cal_client_view_start (view, NULL);
+
+  app_view = g_new0 (AppView, 1);
+  app_view->view = view;
+  app_view->source_uid = g_strdup (e_source_get_uid (e_client_get_source (E_CLIENT (cal_client))));
+  app_view->since = since;
+  app_view->until = until;
+  app_view->ids = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+  return app_view;
 }
 
 static void
 app_stop_view (App *app,
-               ECalClientView *view)
+               AppView *app_view)
 {
-      e_cal_client_view_stop (view, NULL);
+  ECalClientView *view = app_view->view;
+
+  e_cal_client_view_stop (view, NULL);
+
+  g_signal_handlers_disconnect_by_func (view, on_objects_added, app);
+  g_signal_handlers_disconnect_by_func (view, on_objects_modified, app);
+  g_signal_handlers_disconnect_by_func (view, on_objects_removed, app);
 
-      g_signal_handlers_disconnect_by_func (view, on_objects_added, app);
-      g_signal_handlers_disconnect_by_func (view, on_objects_modified, app);
-      g_signal_handlers_disconnect_by_func (view, on_objects_removed, app);
+  g_object_unref (view);
+  g_hash_table_unref (app_view->ids);
+  g_free (app_view->source_uid);
+  g_free (app_view);
 }
 
 static void
@@ -661,34 +1011,138 @@ app_notify_has_calendars (App *app)
 }
 
 static void
-app_update_views (App *app)
+app_stop_source_views (App *app,
+                       const gchar *source_uid)
+{
+  GSList *link = app->live_views;
+
+  while (link)
+    {
+      GSList *next = g_slist_next (link);
+      AppView *app_view = link->data;
+
+      if (g_strcmp0 (source_uid, app_view->source_uid) == 0)
+        {
+          app_stop_view (app, app_view);
+          app->live_views = g_slist_delete_link (app->live_views, link);
+        }
+
+      link = next;
+    }
+}
+
+static void
+app_add_view (App *app,
+              ECalClient *cal_client,
+              time_t since,
+              time_t until)
+{
+  AppView *app_view;
+
+  app_view = app_start_view (app, cal_client, since, until);
+  if (app_view)
+    app->live_views = g_slist_prepend (app->live_views, app_view);
+}
+
+/*
+ * Make sure the views of a calendar cover the current time window. The
+ * views of a source always cover a contiguous range so we only need to
+ * start views for the parts of the window that aren't covered yet.
+ */
+static void
+app_update_source_views (App *app,
+                         ECalClient *cal_client)
 {
+  const gchar *source_uid = e_source_get_uid (e_client_get_source (E_CLIENT (cal_client)));
+  time_t covered_since = 0, covered_until = 0;
+  guint n_views = 0;
+  GSList *link;
+
+  for (link = app->live_views; link; link = g_slist_next (link))
+    {
+      AppView *app_view = link->data;
+
+      if (g_strcmp0 (source_uid, app_view->source_uid) != 0)
+        continue;
+
+      if (n_views == 0 || app_view->since < covered_since)
+        covered_since = app_view->since;
+      if (n_views == 0 || app_view->until > covered_until)
+        covered_until = app_view->until;
+      n_views++;
+    }
+
+  if (n_views == 0)
+    {
+      app_add_view (app, cal_client, app->since, app->until);
+      return;
+    }
+
+  if (n_views + (app->since < covered_since) + (app->until > covered_until) > MAX_VIEWS_PER_SOURCE)
+    {
+      print_debug ("Rebuilding views for calendar '%s'", source_uid);
+      app_stop_source_views (app, source_uid);
+      app_add_view (app, cal_client, app->since, app->until);
+      return;
+    }
+
+  if (app->since < covered_since)
+    app_add_view (app, cal_client, app->since, covered_since);
+
+  if (app->until > covered_until)
+    app_add_view (app, cal_client, covered_until, app->until);
+}
+
+static void
+app_update_views (App *app,
+                  gboolean force_reload)
+{
+  g_autoptr (GHashTable) source_uids = NULL;
   GSList *link, *clients;
   gboolean had_views, has_views;
 
   had_views = app->live_views != NULL;
 
-  for (link = app->live_views; link; link = g_slist_next (link))
+  if (force_reload)
+    g_hash_table_remove_all (app->recurrences);
+
+  clients = calendar_sources_ref_clients (app->sources);
+  source_uids = g_hash_table_new (g_str_hash, g_str_equal);
+  for (link = clients; link; link = g_slist_next (link))
     {
-      app_stop_view (app, link->data);
+      ECalClient *cal_client = link->data;
+
+      if (cal_client)
+        g_hash_table_add (source_uids,
+                          (gpointer) e_source_get_uid (e_client_get_source (E_CLIENT (cal_client))));
     }
 
-  g_slist_free_full (app->live_views, g_object_unref);
-  app->live_views = NULL;
+  /* Drop views of vanished calendars and views that don't overlap the window anymore */
+  link = app->live_views;
+  while (link)
+    {
+      GSList *next = g_slist_next (link);
+      AppView *app_view = link->data;
 
-  clients = calendar_sources_ref_clients (app->sources);
+      if (force_reload ||
+          !g_hash_table_contains (source_uids, app_view->source_uid) ||
+          app_view->until <= app->since || app_view->since >= app->until)
+        {
+          app_stop_view (app, app_view);
+          app->live_views = g_slist_delete_link (app->live_views, link);
+        }
+
+      link = next;
+    }
 
   for (link = clients; link; link = g_slist_next (link))
     {
       ECalClient *cal_client = link->data;
-      ECalClientView *view;
 
       if (!cal_client)
         continue;
 
-      view = app_start_view (app, cal_client);
-      if (view)
-        app->live_views = g_slist_prepend (app->live_views, view);
+      app_update_source_views (app, cal_client);
     }
 
   has_views = app->live_views != NULL;
@@ -705,7 +1159,6 @@ on_client_appeared_cb (CalendarSources *sources,
                        gpointer user_data)
 {
   App *app = user_data;
-  ECalClientView *view;
   GSList *link;
   const gchar *source_uid;
 
@@ -715,32 +1168,17 @@ on_client_appeared_cb (CalendarSources *sources,
 
   for (link = app->live_views; link; link = g_slist_next (link))
     {
-      ECalClientView *v = link->data;
-      ECalClient *cal_client;
-      ESource *source;
-
-      cal_client = e_cal_client_view_ref_client (v);
-      source = e_client_get_source (E_CLIENT (cal_client));
-
-      if (g_strcmp0 (source_uid, e_source_get_uid (source)) == 0)
-        {
-          g_clear_object (&cal_client);
-          return;
-        }
+      AppView *app_view = link->data;
 
-      g_clear_object (&cal_client);
+      if (g_strcmp0 (source_uid, app_view->source_uid) == 0)
+        return;
     }
 
-  view = app_start_view (app, client);
-
-  if (view)
-    {
-      app->live_views = g_slist_prepend (app->live_views, view);
+  app_add_view (app, client, app->since, app->until);
 
-      /* It's the first view, notify that it has calendars now */
-      if (!g_slist_next (app->live_views))
-        app_notify_has_calendars (app);
-    }
+  /* It's the first view, notify that it has calendars now */
+  if (app->live_views && !g_slist_next (app->live_views))
+    app_notify_has_calendars (app);
 }
 
 static void
@@ -749,45 +1187,30 @@ on_client_disappeared_cb (CalendarSources *sources,
                           gpointer user_data)
 {
   App *app = user_data;
-  GSList *link;
+  guint n_views;
 
   print_debug ("Client disappeared '%s'", source_uid);
 
-  for (link = app->live_views; link; link = g_slist_next (link))
-    {
-      ECalClientView *view = link->data;
-      ECalClient *cal_client;
-      ESource *source;
-
-      cal_client = e_cal_client_view_ref_client (view);
-      source = e_client_get_source (E_CLIENT (cal_client));
-
-      if (g_strcmp0 (source_uid, e_source_get_uid (source)) == 0)
-        {
-          g_clear_object (&cal_client);
-          app_stop_view (app, view);
-          app->live_views = g_slist_remove (app->live_views, view);
-          g_object_unref (view);
-
-          print_debug ("Emitting ClientDisappeared for '%s'", source_uid);
+  app_drop_source_recurrences (app, source_uid);
 
-          g_dbus_connection_emit_signal (app->connection,
-                                         NULL, /* destination_bus_name */
-                                         PHOSH_DBUS_PATH_PREFIX "/CalendarServer",
-                                         PHOSH_APP_ID ".CalendarServer",
-                                         "ClientDisappeared",
-                                         g_variant_new ("(s)", source_uid),
-                                         NULL);
+  n_views = g_slist_length (app->live_views);
+  app_stop_source_views (app, source_uid);
+  if (n_views == g_slist_length (app->live_views))
+    return;
 
-          /* It was the last view, notify that it doesn't have calendars now */
-          if (!app->live_views)
-            app_notify_has_calendars (app);
+  print_debug ("Emitting ClientDisappeared for '%s'", source_uid);
 
-          break;
-        }
+  g_dbus_connection_emit_signal (app->connection,
+                                 NULL, /* destination_bus_name */
+                                 PHOSH_DBUS_PATH_PREFIX "/CalendarServer",
+                                 PHOSH_APP_ID ".CalendarServer",
+                                 "ClientDisappeared",
+                                 g_variant_new ("(s)", source_uid),
+                                 NULL);
 
-      g_clear_object (&cal_client);
-    }
+  /* It was the last view, notify that it doesn't have calendars now */
+  if (!app->live_views)
+    app_notify_has_calendars (app);
 }
 
 static App *
@@ -797,6 +1220,11 @@ app_new (GDBusConnection *connection)
 
   app = g_new0 (App, 1);
   app->connection = g_object_ref (connection);
+  app->notify_appointments = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                    NULL, calendar_appointment_free);
+  app->notify_ids = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  app->recurrences = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                            g_free, recurrence_cache_free);
   app->sources = calendar_sources_get ();
   app->client_appeared_signal_id = g_signal_connect (app->sources,
                                                      "client-appeared",
@@ -818,11 +1246,7 @@ app_free (App *app)
   GSList *ll;
 
   for (ll = app->live_views; ll != NULL; ll = g_slist_next (ll))
-    {
-      ECalClientView *view = E_CAL_CLIENT_VIEW (ll->data);
-
-      app_stop_view (app, view);
-    }
+    app_stop_view (app, ll->data);
 
   g_signal_handler_disconnect (app->sources,
                                app->client_appeared_signal_id);
@@ -831,9 +1255,11 @@ app_free (App *app)
 
   g_free (app->timezone_location);
 
-  g_slist_free_full (app->live_views, g_object_unref);
-  g_slist_free_full (app->notify_appointments, calendar_appointment_free);
-  g_slist_free_full (app->notify_ids, g_free);
+  g_slist_free (app->live_views);
+  g_clear_handle_id (&app->notify_id, g_source_remove);
+  g_hash_table_unref (app->notify_appointments);
+  g_hash_table_unref (app->notify_ids);
+  g_hash_table_unref (app->recurrences);
 
   g_object_unref (app->connection);
   g_object_unref (app->sources);
@@ -913,8 +1339,11 @@ handle_method_call (GDBusConnection       *connection,
 
       g_dbus_method_invocation_return_value (invocation, NULL);
 
+      if (window_changed)
+        app_clip_recurrences (app);
+
       if (window_changed || force_reload)
-        app_update_views (app);
+        app_update_views (app, force_reload);
     }
   else
     {
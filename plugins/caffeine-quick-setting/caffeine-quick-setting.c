@@ -7,6 +7,7 @@
  */
 
 #include "caffeine-quick-setting.h"
+#include "clock-ticker.h"
 #include "interval-row.h"
 #include "plugin-shell.h"
 #include "status-page.h"
@@ -19,7 +20,6 @@
 #define CAFFEINE_INTERVALS_KEY        "intervals"
 #define CAFFEINE_SELECTED_KEY         "selected-index"
 
-#define UPDATE_INTERVAL    1 /* seconds */
 #define CAFFEINE_ON_ICON   "cafe-hot-symbolic"
 #define CAFFEINE_OFF_ICON  "cafe-cold-symbolic"
 
@@ -49,7 +49,9 @@ struct _PhoshCaffeineQuickSetting {
   GSettings               *settings;
 
   uint                     remaining;
-  uint                     update_id;
+  gint64                   end_time;
+  uint                     expiry_id;
+  uint                     tick_id;
 };
 
 G_DEFINE_TYPE (PhoshCaffeineQuickSetting, phosh_caffeine_quick_setting, PHOSH_TYPE_QUICK_SETTING);
@@ -120,26 +122,36 @@ phosh_caffeine_quick_setting_clear_timer (PhoshCaffeineQuickSetting *self)
 {
   self->remaining = 0;
 
-  g_clear_handle_id (&self->update_id, g_source_remove);
+  g_clear_handle_id (&self->expiry_id, g_source_remove);
+  if (self->tick_id)
+    phosh_clock_ticker_unsubscribe (phosh_clock_ticker_get_default (), self->tick_id);
+  self->tick_id = 0;
 
   phosh_caffeine_quick_setting_inhibit (self, FALSE);
 }
 
 
-static gboolean
-on_update_expired (gpointer user_data)
+static void
+on_tick (gpointer user_data)
 {
   PhoshCaffeineQuickSetting *self = PHOSH_CAFFEINE_QUICK_SETTING (user_data);
+  g_autofree char *label = NULL;
+  gint64 left;
 
-  g_return_val_if_fail (self->remaining >= UPDATE_INTERVAL, FALSE);
-  self->remaining -= UPDATE_INTERVAL;
-  if (self->remaining > 0) {
-    g_autofree char *label = cui_call_format_duration ((double) self->remaining);
-    phosh_status_icon_set_info (self->info, label);
+  left = self->end_time - g_get_monotonic_time ();
+  self->remaining = MAX (0, (left + G_USEC_PER_SEC - 1) / G_USEC_PER_SEC);
 
-    return G_SOURCE_CONTINUE;
-  }
+  label = cui_call_format_duration ((double) self->remaining);
+  phosh_status_icon_set_info (self->info, label);
+}
+
+
+static gboolean
+on_expired (gpointer user_data)
+{
+  PhoshCaffeineQuickSetting *self = PHOSH_CAFFEINE_QUICK_SETTING (user_data);
 
+  self->expiry_id = 0;
   phosh_caffeine_quick_setting_clear_timer (self);
 
   return G_SOURCE_REMOVE;
@@ -163,14 +175,22 @@ on_clicked (PhoshCaffeineQuickSetting *self)
   }
 
   /* Clear timer if on */
-  if (self->update_id) {
+  if (self->expiry_id) {
     phosh_caffeine_quick_setting_clear_timer (self);
 
     return;
   }
 
   self->remaining = value;
-  self->update_id = g_timeout_add_seconds (UPDATE_INTERVAL, on_update_expired, self);
+  self->end_time = g_get_monotonic_time () + value * G_USEC_PER_SEC;
+  self->expiry_id = g_timeout_add_seconds (value, on_expired, self);
+  g_source_set_name_by_id (self->expiry_id, "[phosh] caffeine expired");
+  /* The countdown is only shown while visible */
+  self->tick_id = phosh_clock_ticker_subscribe (phosh_clock_ticker_get_default (),
+                                                PHOSH_CLOCK_TICKER_GRANULARITY_SECOND,
+                                                GTK_WIDGET (self->info),
+                                                on_tick,
+                                                self);
   phosh_caffeine_quick_setting_inhibit (self, TRUE);
 }
 
@@ -243,7 +263,7 @@ transform_to_label (GBinding     *binding,
 
   if (!inhibited) {
     g_value_set_string (to_value, C_("caffeine-disabled", "Off"));
-  } else if (self->update_id) {
+  } else if (self->expiry_id) {
     g_autofree char *label = cui_call_format_duration ((uint) self->remaining);
     g_value_set_string (to_value, label);
   } else {
@@ -262,6 +282,9 @@ phosh_caffeine_quick_setting_finalize (GObject *gobject)
   if (self->cookie)
     phosh_caffeine_quick_setting_inhibit (self, FALSE);
 
+  g_clear_handle_id (&self->expiry_id, g_source_remove);
+  if (self->tick_id)
+    phosh_clock_ticker_unsubscribe (phosh_clock_ticker_get_default (), self->tick_id);
   g_clear_object (&self->settings);
 
   G_OBJECT_CLASS (phosh_caffeine_quick_setting_parent_class)->finalize (gobject);
@@ -9,6 +9,7 @@
 
 #include "pomodoro-quick-setting.h"
 #include "pomodoro-enums.h"
+#include "clock-ticker.h"
 #include "plugin-shell.h"
 #include "notify-manager.h"
 
@@ -16,7 +17,6 @@
 
 #include <glib/gi18n.h>
 
-#define UPDATE_INTERVAL 1 /* seconds */
 #define ACTIVE_ICON    "pomodoro-active-symbolic"
 #define BREAK_ICON     "pomodoro-break-symbolic"
 
@@ -41,7 +41,9 @@ struct _PhoshPomodoroQuickSetting {
   PhoshStatusIcon         *info;
   PhoshPomodoroState       state;
   int                      remaining;
-  guint                    update_id;
+  gint64                   end_time;
+  guint                    expiry_id;
+  guint                    tick_id;
   GSettings               *settings;
 };
 
@@ -53,7 +55,10 @@ static void
 phosh_pomodoro_quick_setting_clear_timers (PhoshPomodoroQuickSetting *self)
 {
   self->remaining = 0;
-  g_clear_handle_id (&self->update_id, g_source_remove);
+  g_clear_handle_id (&self->expiry_id, g_source_remove);
+  if (self->tick_id)
+    phosh_clock_ticker_unsubscribe (phosh_clock_ticker_get_default (), self->tick_id);
+  self->tick_id = 0;
 }
 
 
@@ -124,16 +129,24 @@ update_label (PhoshPomodoroQuickSetting *self)
 static void phosh_pomodoro_quick_setting_set_state (PhoshPomodoroQuickSetting *self,
                                                     PhoshPomodoroState         state);
 
+static void
+on_tick (gpointer user_data)
+{
+  PhoshPomodoroQuickSetting *self = PHOSH_POMODORO_QUICK_SETTING (user_data);
+  gint64 left;
+
+  left = self->end_time - g_get_monotonic_time ();
+  self->remaining = MAX (0, (left + G_USEC_PER_SEC - 1) / G_USEC_PER_SEC);
+  update_label (self);
+}
+
+
 static gboolean
-on_update_expired (gpointer user_data)
+on_expired (gpointer user_data)
 {
   PhoshPomodoroQuickSetting *self = PHOSH_POMODORO_QUICK_SETTING (user_data);
 
-  self->remaining -= UPDATE_INTERVAL;
-  if (self->remaining > 0) {
-    update_label (self);
-    return G_SOURCE_CONTINUE;
-  }
+  self->expiry_id = 0;
 
   switch (self->state) {
   case PHOSH_POMODORO_STATE_ACTIVE:
@@ -177,7 +190,15 @@ phosh_pomodoro_quick_setting_set_state (PhoshPomodoroQuickSetting *self, PhoshPo
 
   if (timeout) {
     self->remaining = timeout;
-    self->update_id = g_timeout_add_seconds (UPDATE_INTERVAL, on_update_expired, self);
+    self->end_time = g_get_monotonic_time () + timeout * G_USEC_PER_SEC;
+    self->expiry_id = g_timeout_add_seconds (timeout, on_expired, self);
+    g_source_set_name_by_id (self->expiry_id, "[phosh] pomodoro expired");
+    /* The countdown is only shown while visible */
+    self->tick_id = phosh_clock_ticker_subscribe (phosh_clock_ticker_get_default (),
+                                                  PHOSH_CLOCK_TICKER_GRANULARITY_SECOND,
+                                                  GTK_WIDGET (self->info),
+                                                  on_tick,
+                                                  self);
   }
 
   update_label (self);
@@ -287,12 +287,22 @@ update_calendar (PhoshUpcomingEvents *self, gboolean force_reload)
 static void
 on_client_disappeared (PhoshUpcomingEvents *self, const char *client_id)
 {
+  g_autofree char *prefix = g_strconcat (client_id, "\n", NULL);
+  g_autoptr (GPtrArray) ids = g_ptr_array_new_with_free_func (g_free);
+  GHashTableIter iter;
+  const char *id;
+
   g_debug ("Client %s gone", client_id);
 
-  /* Update the whole calendar */
-  g_list_store_remove_all (self->events);
-  g_hash_table_remove_all (self->event_ids);
-  update_calendar (self, TRUE);
+  /* Event ids are prefixed by the calendar's source uid, drop only its events */
+  g_hash_table_iter_init (&iter, self->event_ids);
+  while (g_hash_table_iter_next (&iter, (gpointer *)&id, NULL)) {
+    if (g_str_has_prefix (id, prefix))
+      g_ptr_array_add (ids, g_strdup (id));
+  }
+  g_ptr_array_add (ids, NULL);
+
+  on_events_removed (self, (GStrv) ids->pdata);
 }
 
 
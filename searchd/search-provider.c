@@ -14,6 +14,10 @@
  */
 
 #include <gdk-pixbuf/gdk-pixbuf.h>
+#include <glib/gstdio.h>
+
+#include <errno.h>
+#include <stdlib.h>
 
 #include "search-provider.h"
 #include "search-result-meta.h"
@@ -27,13 +31,52 @@
  * The #PhoshSearchProvider class is handle searches initiated by the
  * user. It interfaces with the D-Bus to communicate with the search service,
  * allowing for the retrieval and activation of search results.
+ *
+ * Result metadata is kept in a per provider LRU cache keyed by result
+ * id so results shown for previous queries don't need to be fetched
+ * again. Icons sent as raw pixels are interned and written once to
+ * the runtime dir so the shell only gets a file reference.
+ *
+ * Searches have a deadline after which they're cancelled. Providers
+ * that keep missing their deadline are demoted and skipped for a
+ * while so they don't hold up queries.
+ *
+ * The D-Bus proxy is only created once
+ * [method@SearchProvider.ensure_proxy] is invoked so providers that
+ * are never queried don't cost anything. The `ready` signal is
+ * emitted once the proxy is available.
  */
 
+#define META_CACHE_SIZE 200
+
+/* Searches taking longer than this get cancelled */
+#define SEARCH_DEADLINE_MS 1000
+#define LATENCY_HISTORY    20
+/* Skip providers that missed DEMOTE_MISSES of their last DEMOTE_WINDOW deadlines */
+#define DEMOTE_MISSES      3
+#define DEMOTE_WINDOW      5
+#define DEMOTE_TIMEOUT     (30 * G_USEC_PER_SEC)
+#define ICON_STORE_DIR "phosh-searchd-icons"
+#define ICON_STORE_ENTRY_KEY "phosh-icon-store-entry"
+
+/* An interned icon, dropped with its file once no cached result meta uses it */
+typedef struct {
+  char  *key;
+  GIcon *icon;
+  char  *path;
+  guint  users;
+} IconStoreEntry;
+
+/* Interned icons from `icon-data`, shared by all providers. key: content key, value: IconStoreEntry */
+static GHashTable *icon_store;
+static char       *icon_store_dir;
+
 
 typedef struct _PhoshSearchProviderPrivate PhoshSearchProviderPrivate;
 struct _PhoshSearchProviderPrivate {
   GAppInfo                 *info;
   PhoshDBusSearchProvider2 *proxy;
+  gboolean                  proxy_pending;
   GCancellable             *cancellable;
   GCancellable             *parent_cancellable;
   gulong                    parent_cancellable_handler;
@@ -42,6 +85,23 @@ struct _PhoshSearchProviderPrivate {
   char                     *bus_path;
   gboolean                  autostart;
   gboolean                  default_disabled;
+
+  /* key: result id, value: GList link in meta_lru */
+  GHashTable               *meta_cache;
+  /* element-type: PhoshSearchResultMeta, most recently used first */
+  GQueue                    meta_lru;
+  guint                     meta_hits;
+  guint                     meta_misses;
+
+  /* Rolling search latency history */
+  struct {
+    gint64   latency;
+    gboolean missed;
+  }                         latencies[LATENCY_HISTORY];
+  guint                     latency_pos;
+  guint                     n_latencies;
+  guint                     n_missed;
+  gint64                    demoted_until;
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (PhoshSearchProvider, phosh_search_provider, G_TYPE_OBJECT)
@@ -73,6 +133,7 @@ got_proxy (GObject *source_object, GAsyncResult *res, gpointer user_data)
   g_autoptr (GError) error = NULL;
 
   priv->proxy = phosh_dbus_search_provider2_proxy_new_for_bus_finish (res, &error);
+  priv->proxy_pending = FALSE;
 
   if (!priv->proxy) {
     g_warning ("[%s]: Unable to create proxy: %s", priv->bus_path, error->message);
@@ -85,24 +146,6 @@ got_proxy (GObject *source_object, GAsyncResult *res, gpointer user_data)
 }
 
 
-static void
-phosh_search_provider_constructed (GObject *object)
-{
-  PhoshSearchProvider *self = PHOSH_SEARCH_PROVIDER (object);
-  PhoshSearchProviderPrivate *priv = phosh_search_provider_get_instance_private (self);
-
-  G_OBJECT_CLASS (phosh_search_provider_parent_class)->constructed (object);
-
-  phosh_dbus_search_provider2_proxy_new_for_bus (G_BUS_TYPE_SESSION,
-                                                 priv->proxy_flags,
-                                                 priv->bus_name,
-                                                 priv->bus_path,
-                                                 priv->cancellable,
-                                                 got_proxy,
-                                                 g_object_ref (self));
-}
-
-
 static void
 phosh_search_provider_finalize (GObject *object)
 {
@@ -122,23 +165,35 @@ phosh_search_provider_finalize (GObject *object)
   g_clear_pointer (&priv->bus_name, g_free);
   g_clear_pointer (&priv->bus_path, g_free);
 
+  phosh_search_provider_clear_cache (self);
+  g_clear_pointer (&priv->meta_cache, g_hash_table_destroy);
+
   G_OBJECT_CLASS (phosh_search_provider_parent_class)->finalize (object);
 }
 
 
 static void
-parent_canceled (GCancellable *cancellable, PhoshSearchProvider *self)
+cancel_pending (PhoshSearchProvider *self)
 {
   PhoshSearchProviderPrivate *priv = phosh_search_provider_get_instance_private (self);
 
-  g_debug ("Provider %s cancelling", priv->bus_name);
-
   g_cancellable_cancel (priv->cancellable);
   g_clear_object (&priv->cancellable);
   priv->cancellable = g_cancellable_new ();
 }
 
 
+static void
+parent_canceled (GCancellable *cancellable, PhoshSearchProvider *self)
+{
+  PhoshSearchProviderPrivate *priv = phosh_search_provider_get_instance_private (self);
+
+  g_debug ("Provider %s cancelling", priv->bus_name);
+
+  cancel_pending (self);
+}
+
+
 static void
 set_parent_cancellable (PhoshSearchProvider *self, GCancellable *parent_cancellable)
 {
@@ -246,7 +301,6 @@ phosh_search_provider_class_init (PhoshSearchProviderClass *klass)
 {
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
-  object_class->constructed = phosh_search_provider_constructed;
   object_class->finalize = phosh_search_provider_finalize;
   object_class->set_property = phosh_search_provider_set_property;
   object_class->get_property = phosh_search_provider_get_property;
@@ -299,6 +353,9 @@ phosh_search_provider_init (PhoshSearchProvider *self)
   priv->cancellable = g_cancellable_new ();
   priv->proxy_flags = G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES;
   priv->autostart = TRUE;
+
+  priv->meta_cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  g_queue_init (&priv->meta_lru);
 }
 
 
@@ -421,55 +478,287 @@ phosh_search_provider_launch_search (PhoshSearchProvider *self,
 }
 
 
+static void
+icon_store_entry_free (IconStoreEntry *entry)
+{
+  if (entry->path)
+    g_unlink (entry->path);
+
+  g_object_set_data (G_OBJECT (entry->icon), ICON_STORE_ENTRY_KEY, NULL);
+  g_object_unref (entry->icon);
+  g_free (entry->path);
+  g_free (entry->key);
+  g_free (entry);
+}
+
+/* Track the cached result metas using an interned icon */
+static void
+icon_store_acquire (GIcon *icon)
+{
+  IconStoreEntry *entry;
+
+  if (icon == NULL)
+    return;
+
+  entry = g_object_get_data (G_OBJECT (icon), ICON_STORE_ENTRY_KEY);
+  if (entry)
+    entry->users++;
+}
+
+
+static void
+icon_store_release (GIcon *icon)
+{
+  IconStoreEntry *entry;
+
+  if (icon == NULL)
+    return;
+
+  entry = g_object_get_data (G_OBJECT (icon), ICON_STORE_ENTRY_KEY);
+  if (entry == NULL)
+    return;
+
+  g_return_if_fail (entry->users > 0);
+  entry->users--;
+  if (entry->users)
+    return;
+
+  g_debug ("Dropping interned icon %s", entry->key);
+  /* Frees the entry and removes the file */
+  g_hash_table_remove (icon_store, entry->key);
+}
+
+
+static void
+meta_cache_drop (PhoshSearchResultMeta *meta)
+{
+  icon_store_release (phosh_search_result_meta_get_icon (meta));
+  phosh_search_result_meta_unref (meta);
+}
+
+
+static PhoshSearchResultMeta *
+meta_cache_lookup (PhoshSearchProvider *self, const char *id)
+{
+  PhoshSearchProviderPrivate *priv = phosh_search_provider_get_instance_private (self);
+  GList *link;
+
+  link = g_hash_table_lookup (priv->meta_cache, id);
+  if (link == NULL)
+    return NULL;
+
+  g_queue_unlink (&priv->meta_lru, link);
+  g_queue_push_head_link (&priv->meta_lru, link);
+
+  return link->data;
+}
+
+
+static void
+meta_cache_insert (PhoshSearchProvider *self, PhoshSearchResultMeta *meta)
+{
+  PhoshSearchProviderPrivate *priv = phosh_search_provider_get_instance_private (self);
+  const char *id = phosh_search_result_meta_get_id (meta);
+  GList *link;
+
+  /* Interned icons are only kept as long as a cached result uses them */
+  icon_store_acquire (phosh_search_result_meta_get_icon (meta));
+
+  link = g_hash_table_lookup (priv->meta_cache, id);
+  if (link) {
+    meta_cache_drop (link->data);
+    link->data = phosh_search_result_meta_ref (meta);
+    g_queue_unlink (&priv->meta_lru, link);
+    g_queue_push_head_link (&priv->meta_lru, link);
+    return;
+  }
+
+  g_queue_push_head (&priv->meta_lru, phosh_search_result_meta_ref (meta));
+  g_hash_table_insert (priv->meta_cache, g_strdup (id), priv->meta_lru.head);
+
+  while (priv->meta_lru.length > META_CACHE_SIZE) {
+    PhoshSearchResultMeta *oldest = g_queue_pop_tail (&priv->meta_lru);
+
+    g_hash_table_remove (priv->meta_cache, phosh_search_result_meta_get_id (oldest));
+    meta_cache_drop (oldest);
+  }
+}
+
+
+static const char *
+get_icon_store_dir (void)
+{
+  g_autofree char *dir = NULL;
+
+  if (icon_store_dir)
+    return icon_store_dir;
+
+  dir = g_build_filename (g_get_user_runtime_dir (), ICON_STORE_DIR, NULL);
+  if (g_mkdir_with_parents (dir, 0700) != 0) {
+    g_warning ("Failed to create icon dir %s: %s", dir, g_strerror (errno));
+    return NULL;
+  }
+
+  icon_store_dir = g_steal_pointer (&dir);
+  return icon_store_dir;
+}
+
+/*
+ * Icons sent as raw pixels are identical for many results (e.g. the
+ * same file type). Intern them by content and write them out once so
+ * serialising only needs to send a file reference instead of encoding
+ * the pixels again for each result.
+ */
+static GIcon *
+intern_icon_data (PhoshSearchProvider *self, GVariant *icon_data)
+{
+  PhoshSearchProviderPrivate *priv = phosh_search_provider_get_instance_private (self);
+  g_autoptr (GVariant) pixels = NULL;
+  g_autoptr (GBytes) bytes = NULL;
+  g_autoptr (GdkPixbuf) pixbuf = NULL;
+  g_autoptr (GError) err = NULL;
+  g_autofree char *checksum = NULL;
+  g_autofree char *key = NULL;
+  g_autofree char *filename = NULL;
+  g_autofree char *path = NULL;
+  IconStoreEntry *entry;
+  const char *dir;
+  GIcon *icon;
+  int width, height, row_stride, sample_size, channels;
+  gboolean has_alpha;
+
+  g_variant_get (icon_data, "(iiibii@ay)",
+                 &width, &height, &row_stride, &has_alpha,
+                 &sample_size, &channels, &pixels);
+
+  if (width <= 0 || height <= 0 || sample_size != 8 || channels != (has_alpha ? 4 : 3) ||
+      row_stride < width * channels ||
+      g_variant_get_size (pixels) < (gsize) row_stride * (height - 1) + width * channels) {
+    g_warning ("[%s]: bad icon data", priv->bus_path);
+    return NULL;
+  }
+
+  bytes = g_variant_get_data_as_bytes (pixels);
+  checksum = g_compute_checksum_for_bytes (G_CHECKSUM_SHA1, bytes);
+  key = g_strdup_printf ("%dx%d-%d-%d-%s", width, height, row_stride, has_alpha, checksum);
+
+  if (icon_store == NULL) {
+    icon_store = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+                                        (GDestroyNotify) icon_store_entry_free);
+  }
+
+  entry = g_hash_table_lookup (icon_store, key);
+  if (entry)
+    return g_object_ref (entry->icon);
+
+  pixbuf = gdk_pixbuf_new_from_bytes (bytes, GDK_COLORSPACE_RGB, has_alpha, sample_size,
+                                      width, height, row_stride);
+
+  dir = get_icon_store_dir ();
+  if (dir) {
+    filename = g_strdup_printf ("%s.png", key);
+    path = g_build_filename (dir, filename, NULL);
+  }
+
+  entry = g_new0 (IconStoreEntry, 1);
+  if (path && gdk_pixbuf_save (pixbuf, path, "png", &err, NULL)) {
+    g_autoptr (GFile) file = g_file_new_for_path (path);
+
+    icon = g_file_icon_new (file);
+    entry->path = g_steal_pointer (&path);
+  } else {
+    if (err)
+      g_warning ("Failed to store icon %s: %s", path, err->message);
+    icon = G_ICON (g_object_ref (pixbuf));
+  }
+
+  /* Dropped once the result metas using it are evicted from their cache */
+  entry->key = g_steal_pointer (&key);
+  entry->icon = g_object_ref (icon);
+  g_object_set_data (G_OBJECT (icon), ICON_STORE_ENTRY_KEY, entry);
+  g_hash_table_insert (icon_store, entry->key, entry);
+
+  return icon;
+}
+
+
 static GIcon *
 get_result_icon (PhoshSearchProvider *self, GVariantDict *result_meta)
 {
   PhoshSearchProviderPrivate *priv = phosh_search_provider_get_instance_private (self);
   g_autoptr (GError) error = NULL;
   g_autoptr (GVariant) variant = NULL;
-  g_autofree char *icon_data = NULL;
+  g_autofree char *icon_str = NULL;
   GIcon *icon = NULL;
-  int width = 0;
-  int height = 0;
-  int row_stride = 0;
-  int has_alpha = 0;
-  int sample_size = 0;
-  int channels = 0;
 
   if (g_variant_dict_lookup (result_meta, "icon", "v", &variant)) {
     icon = g_icon_deserialize (variant);
-  } else if (g_variant_dict_lookup (result_meta, "gicon", "s", &icon_data)) {
-    icon = g_icon_new_for_string (icon_data, &error);
+  } else if (g_variant_dict_lookup (result_meta, "gicon", "s", &icon_str)) {
+    icon = g_icon_new_for_string (icon_str, &error);
 
     if (error) {
       g_warning ("[%s]: bad icon: %s", priv->bus_path, error->message);
     }
-  } else if (g_variant_dict_lookup (result_meta, "icon-data", "iiibiiay",
-                                    &width, &height, &row_stride, &has_alpha,
-                                    &sample_size, &channels, &icon_data)) {
-    icon = G_ICON (gdk_pixbuf_new_from_data ((guchar *) icon_data,
-                                             GDK_COLORSPACE_RGB,
-                                             has_alpha,
-                                             sample_size,
-                                             width,
-                                             height,
-                                             row_stride,
-                                             (GdkPixbufDestroyNotify) g_free,
-                                             NULL));
+  } else {
+    variant = g_variant_dict_lookup_value (result_meta, "icon-data",
+                                           G_VARIANT_TYPE ("(iiibiiay)"));
+    if (variant)
+      icon = intern_icon_data (self, variant);
   }
 
   return icon;
 }
 
 
+typedef struct {
+  GStrv       ids;
+  /* key: result id, value: PhoshSearchResultMeta */
+  GHashTable *fetched;
+} GetResultMetaData;
+
+
+static void
+get_result_meta_data_free (GetResultMetaData *data)
+{
+  g_strfreev (data->ids);
+  g_hash_table_destroy (data->fetched);
+  g_free (data);
+}
+
+/* Assemble the results in the requested order */
+static void
+return_result_metas (PhoshSearchProvider *self, GTask *task)
+{
+  GetResultMetaData *data = g_task_get_task_data (task);
+  g_autoptr (GPtrArray) results = NULL;
+
+  results = g_ptr_array_new_full (g_strv_length (data->ids),
+                                  (GDestroyNotify) phosh_search_result_meta_unref);
+
+  for (int i = 0; data->ids[i]; i++) {
+    PhoshSearchResultMeta *meta;
+
+    meta = g_hash_table_lookup (data->fetched, data->ids[i]);
+    if (meta == NULL)
+      meta = meta_cache_lookup (self, data->ids[i]);
+    if (meta == NULL)
+      continue;
+
+    g_ptr_array_add (results, phosh_search_result_meta_ref (meta));
+  }
+
+  g_task_return_pointer (task, g_ptr_array_ref (results), (GDestroyNotify) g_ptr_array_unref);
+}
+
+
 static void
 got_result_meta (GObject *source, GAsyncResult *res, gpointer user_data)
 {
   g_autoptr (GError) error = NULL;
   g_autoptr (GVariant) metas = NULL;
-  g_autoptr (GPtrArray) results = NULL;
   g_autoptr (GTask) task = user_data;
   g_autofree char *bus_path = NULL;
+  GetResultMetaData *data = g_task_get_task_data (task);
   GVariant *val = NULL;
   GVariantIter iter;
   gboolean success;
@@ -486,8 +775,6 @@ got_result_meta (GObject *source, GAsyncResult *res, gpointer user_data)
   if (!success)
     g_warning ("[%s]: Failed get result meta: %s", bus_path, error->message);
 
-  results = g_ptr_array_new_full (100, (GDestroyNotify) phosh_search_result_meta_unref);
-
 /*
  * Some providers decide to provide NULL instead of an empty array
  * thus we do what JS does and map NULL to an empty array
@@ -526,10 +813,11 @@ got_result_meta (GObject *source, GAsyncResult *res, gpointer user_data)
 
     meta = phosh_search_result_meta_new (id, name, desc, icon, clipboard);
 
-    g_ptr_array_add (results, meta);
+    meta_cache_insert (self, meta);
+    g_hash_table_insert (data->fetched, g_strdup (id), meta);
   }
 
-  g_task_return_pointer (task, g_ptr_array_ref (results), (GDestroyNotify) g_ptr_array_unref);
+  return_result_metas (self, task);
 }
 
 
@@ -540,14 +828,44 @@ phosh_search_provider_get_result_meta (PhoshSearchProvider *self,
                                        gpointer             callback_data)
 {
   PhoshSearchProviderPrivate *priv = phosh_search_provider_get_instance_private (self);
+  g_autoptr (GStrvBuilder) missing = g_strv_builder_new ();
+  g_auto (GStrv) missing_ids = NULL;
+  GetResultMetaData *data;
   GTask *task;
 
   task = g_task_new (self, priv->cancellable, callback, callback_data);
 
   g_task_set_source_tag (task, phosh_search_provider_get_result_meta);
 
+  data = g_new0 (GetResultMetaData, 1);
+  data->ids = g_strdupv (results);
+  data->fetched = g_hash_table_new_full (g_str_hash,
+                                         g_str_equal,
+                                         g_free,
+                                         (GDestroyNotify) phosh_search_result_meta_unref);
+  g_task_set_task_data (task, data, (GDestroyNotify) get_result_meta_data_free);
+
+  /* Only fetch what we don't know yet */
+  for (int i = 0; results[i]; i++) {
+    if (g_hash_table_contains (priv->meta_cache, results[i])) {
+      priv->meta_hits++;
+      continue;
+    }
+
+    priv->meta_misses++;
+    g_strv_builder_add (missing, results[i]);
+  }
+  missing_ids = g_strv_builder_end (missing);
+
+  if (missing_ids[0] == NULL) {
+    g_debug ("[%s]: All %u result metas cached", priv->bus_path, g_strv_length (results));
+    return_result_metas (self, task);
+    g_object_unref (task);
+    return;
+  }
+
   phosh_dbus_search_provider2_call_get_result_metas (PHOSH_DBUS_SEARCH_PROVIDER2 (priv->proxy),
-                                                     (const char * const*) results,
+                                                     (const char * const*) missing_ids,
                                                      priv->cancellable,
                                                      got_result_meta,
                                                      task);
@@ -565,14 +883,235 @@ phosh_search_provider_get_result_meta_finish (PhoshSearchProvider  *self,
   return g_task_propagate_pointer (G_TASK (res), error);
 }
 
+/**
+ * phosh_search_provider_ensure_proxy:
+ * @self: The search provider
+ *
+ * Create the D-Bus proxy for the provider unless it exists or is
+ * already being created. `ready` is emitted once the proxy is
+ * available.
+ */
+void
+phosh_search_provider_ensure_proxy (PhoshSearchProvider *self)
+{
+  PhoshSearchProviderPrivate *priv;
+
+  g_return_if_fail (PHOSH_IS_SEARCH_PROVIDER (self));
+  priv = phosh_search_provider_get_instance_private (self);
+
+  if (priv->proxy || priv->proxy_pending)
+    return;
+
+  g_debug ("[%s]: Creating proxy", priv->bus_path);
+
+  priv->proxy_pending = TRUE;
+  /* Not using priv->cancellable as each new query cancels that */
+  phosh_dbus_search_provider2_proxy_new_for_bus (G_BUS_TYPE_SESSION,
+                                                 priv->proxy_flags,
+                                                 priv->bus_name,
+                                                 priv->bus_path,
+                                                 NULL,
+                                                 got_proxy,
+                                                 g_object_ref (self));
+}
+
+/**
+ * phosh_search_provider_clear_cache:
+ * @self: The search provider
+ *
+ * Drop all cached result metadata, e.g. when the provider got reloaded.
+ */
+void
+phosh_search_provider_clear_cache (PhoshSearchProvider *self)
+{
+  PhoshSearchProviderPrivate *priv;
+
+  g_return_if_fail (PHOSH_IS_SEARCH_PROVIDER (self));
+
+  priv = phosh_search_provider_get_instance_private (self);
+
+  g_hash_table_remove_all (priv->meta_cache);
+  g_queue_clear_full (&priv->meta_lru, (GDestroyNotify) meta_cache_drop);
+}
+
+/**
+ * phosh_search_provider_get_cache_stats:
+ * @self: The search provider
+ * @hits:(out)(optional): Number of result metas served from the cache
+ * @misses:(out)(optional): Number of result metas fetched from the provider
+ *
+ * Get statistics about the result meta cache.
+ */
+void
+phosh_search_provider_get_cache_stats (PhoshSearchProvider *self, guint *hits, guint *misses)
+{
+  PhoshSearchProviderPrivate *priv;
+
+  g_return_if_fail (PHOSH_IS_SEARCH_PROVIDER (self));
+
+  priv = phosh_search_provider_get_instance_private (self);
+
+  if (hits)
+    *hits = priv->meta_hits;
+  if (misses)
+    *misses = priv->meta_misses;
+}
+
+/**
+ * phosh_search_provider_clear_icon_store:
+ *
+ * Remove the interned icons and their files. Call this when shutting
+ * down.
+ */
+void
+phosh_search_provider_clear_icon_store (void)
+{
+  /* Removes the files */
+  g_clear_pointer (&icon_store, g_hash_table_destroy);
+
+  if (icon_store_dir)
+    g_rmdir (icon_store_dir);
+  g_clear_pointer (&icon_store_dir, g_free);
+}
+
+/**
+ * phosh_search_provider_get_n_interned_icons:
+ *
+ * Get the number of interned icons. Icons are dropped together with
+ * the last cached result meta using them.
+ *
+ * Returns: The number of interned icons
+ */
+guint
+phosh_search_provider_get_n_interned_icons (void)
+{
+  return icon_store ? g_hash_table_size (icon_store) : 0;
+}
+
+
+static void
+record_latency (PhoshSearchProvider *self, gint64 latency, gboolean missed)
+{
+  PhoshSearchProviderPrivate *priv = phosh_search_provider_get_instance_private (self);
+  guint recent_misses = 0;
+
+  priv->latencies[priv->latency_pos].latency = latency;
+  priv->latencies[priv->latency_pos].missed = missed;
+  priv->latency_pos = (priv->latency_pos + 1) % LATENCY_HISTORY;
+  priv->n_latencies = MIN (priv->n_latencies + 1, LATENCY_HISTORY);
+
+  if (!missed) {
+    priv->demoted_until = 0;
+    return;
+  }
+
+  priv->n_missed++;
+
+  for (guint i = 1; i <= MIN (priv->n_latencies, DEMOTE_WINDOW); i++) {
+    guint pos = (priv->latency_pos + LATENCY_HISTORY - i) % LATENCY_HISTORY;
+
+    if (priv->latencies[pos].missed)
+      recent_misses++;
+  }
+
+  if (recent_misses >= DEMOTE_MISSES) {
+    g_warning ("[%s]: Missed %u of the last %u deadlines, skipping for %ds",
+               priv->bus_path, recent_misses, DEMOTE_WINDOW,
+               (int) (DEMOTE_TIMEOUT / G_USEC_PER_SEC));
+    priv->demoted_until = g_get_monotonic_time () + DEMOTE_TIMEOUT;
+  }
+}
+
+
+typedef struct {
+  gint64        start;
+  guint         deadline_id;
+  gboolean      missed;
+  /* Cancelled by a missed deadline or along with the provider's pending calls */
+  GCancellable *cancellable;
+  GCancellable *pending;
+  gulong        pending_handler;
+} SearchData;
+
+
+static void
+search_data_free (SearchData *data)
+{
+  g_clear_handle_id (&data->deadline_id, g_source_remove);
+  g_cancellable_disconnect (data->pending, data->pending_handler);
+  g_clear_object (&data->pending);
+  g_clear_object (&data->cancellable);
+  g_free (data);
+}
+
+
+static void
+on_pending_cancelled (GCancellable *pending, GCancellable *cancellable)
+{
+  g_cancellable_cancel (cancellable);
+}
+
+
+static gboolean
+on_search_deadline (gpointer user_data)
+{
+  GTask *task = G_TASK (user_data);
+  PhoshSearchProvider *self = PHOSH_SEARCH_PROVIDER (g_task_get_source_object (task));
+  PhoshSearchProviderPrivate *priv = phosh_search_provider_get_instance_private (self);
+  SearchData *data = g_task_get_task_data (task);
+
+  g_debug ("[%s]: Search missed deadline, cancelling", priv->bus_path);
+
+  data->deadline_id = 0;
+  data->missed = TRUE;
+  /* Only cancel this search, other calls (e.g. result metas) are unaffected */
+  g_cancellable_cancel (data->cancellable);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static GTask *
+search_task_new (PhoshSearchProvider *self,
+                 gpointer             source_tag,
+                 GAsyncReadyCallback  callback,
+                 gpointer             callback_data)
+{
+  PhoshSearchProviderPrivate *priv = phosh_search_provider_get_instance_private (self);
+  SearchData *data;
+  GTask *task;
+
+  data = g_new0 (SearchData, 1);
+  data->start = g_get_monotonic_time ();
+  data->cancellable = g_cancellable_new ();
+  data->pending = g_object_ref (priv->cancellable);
+  data->pending_handler = g_cancellable_connect (data->pending,
+                                                 G_CALLBACK (on_pending_cancelled),
+                                                 g_object_ref (data->cancellable),
+                                                 g_object_unref);
+
+  task = g_task_new (self, data->cancellable, callback, callback_data);
+  g_task_set_source_tag (task, source_tag);
+  /* The pending D-Bus call keeps the task alive until the deadline is removed */
+  data->deadline_id = g_timeout_add (SEARCH_DEADLINE_MS, on_search_deadline, task);
+  g_source_set_name_by_id (data->deadline_id, "[phosh-searchd] search deadline");
+  g_task_set_task_data (task, data, (GDestroyNotify) search_data_free);
+
+  return task;
+}
+
 
 static void
 got_results (GObject *source, GAsyncResult *res, gpointer user_data)
 {
   g_autoptr (GError) error = NULL;
   g_autoptr (GTask) task = user_data;
+  PhoshSearchProvider *self = PHOSH_SEARCH_PROVIDER (g_task_get_source_object (task));
+  SearchData *data = g_task_get_task_data (task);
   GStrv results = NULL;
 
+  g_clear_handle_id (&data->deadline_id, g_source_remove);
+
   if (g_task_get_source_tag (task) == phosh_search_provider_get_initial) {
     phosh_dbus_search_provider2_call_get_initial_result_set_finish (PHOSH_DBUS_SEARCH_PROVIDER2 (source),
                                                                     &results,
@@ -585,6 +1124,10 @@ got_results (GObject *source, GAsyncResult *res, gpointer user_data)
                                                                       &error);
   }
 
+  /* Searches cancelled by a new query tell nothing about the provider */
+  if (data->missed || !g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    record_latency (self, g_get_monotonic_time () - data->start, data->missed);
+
   if (error)
     g_task_return_error (task, g_steal_pointer (&error));
   else
@@ -601,12 +1144,11 @@ phosh_search_provider_get_initial (PhoshSearchProvider *self,
   PhoshSearchProviderPrivate *priv = phosh_search_provider_get_instance_private (self);
   GTask *task;
 
-  task = g_task_new (self, priv->cancellable, callback, callback_data);
-  g_task_set_source_tag (task, phosh_search_provider_get_initial);
+  task = search_task_new (self, phosh_search_provider_get_initial, callback, callback_data);
 
   phosh_dbus_search_provider2_call_get_initial_result_set (PHOSH_DBUS_SEARCH_PROVIDER2 (priv->proxy),
                                                            terms,
-                                                           priv->cancellable,
+                                                           g_task_get_cancellable (task),
                                                            got_results,
                                                            task);
 }
@@ -634,13 +1176,12 @@ phosh_search_provider_get_subsearch (PhoshSearchProvider *self,
   PhoshSearchProviderPrivate *priv = phosh_search_provider_get_instance_private (self);
   GTask *task;
 
-  task = g_task_new (self, priv->cancellable, callback, callback_data);
-  g_task_set_source_tag (task, phosh_search_provider_get_subsearch);
+  task = search_task_new (self, phosh_search_provider_get_subsearch, callback, callback_data);
 
   phosh_dbus_search_provider2_call_get_subsearch_result_set (PHOSH_DBUS_SEARCH_PROVIDER2 (priv->proxy),
                                                              results,
                                                              terms,
-                                                             priv->cancellable,
+                                                             g_task_get_cancellable (task),
                                                              got_results,
                                                              task);
 }
@@ -682,3 +1223,78 @@ phosh_search_provider_get_bus_path (PhoshSearchProvider  *self)
 
   return priv->bus_path;
 }
+
+
+static int
+compare_latency (gconstpointer a, gconstpointer b)
+{
+  gint64 la = *(const gint64 *) a;
+  gint64 lb = *(const gint64 *) b;
+
+  return (la > lb) - (la < lb);
+}
+
+/**
+ * phosh_search_provider_get_latency_stats:
+ * @self: The search provider
+ *
+ * Get the latency statistics of recent searches. Keys are `p50` and
+ * `p95` (latency in milliseconds), `samples` (the number of recent
+ * searches considered), `missed` (the number of searches that missed
+ * their deadline so far) and `demoted` (whether the provider is
+ * currently skipped).
+ *
+ * Returns: (transfer floating): The statistics as `a{sv}`
+ */
+GVariant *
+phosh_search_provider_get_latency_stats (PhoshSearchProvider *self)
+{
+  PhoshSearchProviderPrivate *priv;
+  gint64 sorted[LATENCY_HISTORY];
+  GVariantBuilder builder;
+  guint p50 = 0, p95 = 0;
+
+  g_return_val_if_fail (PHOSH_IS_SEARCH_PROVIDER (self), NULL);
+
+  priv = phosh_search_provider_get_instance_private (self);
+
+  if (priv->n_latencies) {
+    for (guint i = 0; i < priv->n_latencies; i++)
+      sorted[i] = priv->latencies[i].latency;
+    qsort (sorted, priv->n_latencies, sizeof (gint64), compare_latency);
+
+    p50 = sorted[(priv->n_latencies - 1) * 50 / 100] / 1000;
+    p95 = sorted[(priv->n_latencies - 1) * 95 / 100] / 1000;
+  }
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+  g_variant_builder_add (&builder, "{sv}", "p50", g_variant_new_uint32 (p50));
+  g_variant_builder_add (&builder, "{sv}", "p95", g_variant_new_uint32 (p95));
+  g_variant_builder_add (&builder, "{sv}", "samples", g_variant_new_uint32 (priv->n_latencies));
+  g_variant_builder_add (&builder, "{sv}", "missed", g_variant_new_uint32 (priv->n_missed));
+  g_variant_builder_add (&builder, "{sv}", "demoted",
+                         g_variant_new_boolean (phosh_search_provider_get_demoted (self)));
+
+  return g_variant_builder_end (&builder);
+}
+
+/**
+ * phosh_search_provider_get_demoted:
+ * @self: The search provider
+ *
+ * Whether the provider missed too many deadlines recently and should
+ * be skipped.
+ *
+ * Returns: %TRUE if the provider should currently be skipped
+ */
+gboolean
+phosh_search_provider_get_demoted (PhoshSearchProvider *self)
+{
+  PhoshSearchProviderPrivate *priv;
+
+  g_return_val_if_fail (PHOSH_IS_SEARCH_PROVIDER (self), FALSE);
+
+  priv = phosh_search_provider_get_instance_private (self);
+
+  return g_get_monotonic_time () < priv->demoted_until;
+}
@@ -59,6 +59,15 @@ GStrv                phosh_search_provider_get_subsearch_finish   (PhoshSearchPr
                                                                    GAsyncResult         *res,
                                                                    GError              **error);
 gboolean             phosh_search_provider_get_ready              (PhoshSearchProvider  *self);
+void                 phosh_search_provider_ensure_proxy           (PhoshSearchProvider *self);
 const char          *phosh_search_provider_get_bus_path           (PhoshSearchProvider *self);
+void                 phosh_search_provider_clear_cache            (PhoshSearchProvider *self);
+void                 phosh_search_provider_get_cache_stats        (PhoshSearchProvider *self,
+                                                                   guint               *hits,
+                                                                   guint               *misses);
+void                 phosh_search_provider_clear_icon_store       (void);
+guint                phosh_search_provider_get_n_interned_icons   (void);
+GVariant            *phosh_search_provider_get_latency_stats      (PhoshSearchProvider *self);
+gboolean             phosh_search_provider_get_demoted            (PhoshSearchProvider *self);
 
 G_END_DECLS
@@ -20,6 +20,9 @@
 #include "search-provider.h"
 
 #include <glib-unix.h>
+#include <glib/gstdio.h>
+
+#include <errno.h>
 
 #include <search-source.h>
 #include <search-result-meta.h>
@@ -29,14 +32,33 @@
 
 #define LIMIT_RESULTS 5
 
+/* Debounce bounds while providers are still busy with the last query */
+#define DEBOUNCE_MIN_MS 50
+#define DEBOUNCE_MAX_MS 400
+
 /**
  * PhoshSearchApplication:
  *
  * The #PhoshSearchApplication class that serves as a service to facilitate search
  * operations within the Phosh desktop environment. It interacts with various search
  * providers to perform queries and return results.
+ *
+ * Parsed provider descriptions are cached by file modification time
+ * so reloads only parse what changed. Providers only get a D-Bus
+ * proxy (and hence get activated) once a query needs them.
  */
 
+typedef struct {
+  gint64               mtime;
+  char                *desktop_id;
+  char                *bus_name;
+  char                *bus_path;
+  gboolean             autostart;
+  gboolean             default_disabled;
+  /* Only set while the provider is enabled */
+  PhoshSearchProvider *provider;
+} PhoshSearchProviderDesc;
+
 
 typedef struct _PhoshSearchApplicationPrivate PhoshSearchApplicationPrivate;
 struct _PhoshSearchApplicationPrivate {
@@ -48,6 +70,8 @@ struct _PhoshSearchApplicationPrivate {
   GList        *sources;
   /* element-type: Phosh.SearchProvider */
   GHashTable   *providers;
+  /* key: char * (ini file path), value: PhoshSearchProviderDesc */
+  GHashTable   *provider_descs;
 
   /* key: char * (object path), value: GVariant * (results) */
   GHashTable   *last_results;
@@ -59,7 +83,14 @@ struct _PhoshSearchApplicationPrivate {
   GCancellable *cancellable;
 
   gulong        search_timeout;
+  guint         debounce;
   int           outstanding_searches;
+  /* Incremented on each search to drop results of older ones */
+  guint         generation;
+  /* Outstanding searches of the current generation */
+  int           generation_outstanding;
+  /* The last generation QueryFinished was emitted for */
+  guint         finished_generation;
 
   GRegex       *splitter;
 };
@@ -86,6 +117,8 @@ phosh_search_application_finalize (GObject *object)
 
   g_list_free_full (priv->sources, (GDestroyNotify) phosh_search_source_unref);
   g_clear_pointer (&priv->providers, g_hash_table_destroy);
+  g_clear_pointer (&priv->provider_descs, g_hash_table_destroy);
+  phosh_search_provider_clear_icon_store ();
 
   g_clear_pointer (&priv->splitter, g_regex_unref);
 
@@ -309,28 +342,85 @@ get_last_results (PhoshDBusSearch *interface, GDBusMethodInvocation *invocation,
 }
 
 
+static gboolean
+get_provider_stats (PhoshDBusSearch *interface, GDBusMethodInvocation *invocation, gpointer user_data)
+{
+  PhoshSearchApplication *self = PHOSH_SEARCH_APPLICATION (user_data);
+  PhoshSearchApplicationPrivate *priv = phosh_search_application_get_instance_private (self);
+  GVariantBuilder builder;
+  GHashTableIter iter;
+  gpointer key, value;
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sa{sv}}"));
+
+  g_hash_table_iter_init (&iter, priv->providers);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    g_variant_builder_add (&builder, "{s@a{sv}}",
+                           (const char *) key,
+                           phosh_search_provider_get_latency_stats (PHOSH_SEARCH_PROVIDER (value)));
+  }
+
+  phosh_dbus_search_complete_get_provider_stats (interface,
+                                                 invocation,
+                                                 g_variant_builder_end (&builder));
+
+  return TRUE;
+}
+
+
+/* Emit QueryFinished once per query generation */
+static void
+emit_query_finished (PhoshSearchApplication *self)
+{
+  PhoshSearchApplicationPrivate *priv = phosh_search_application_get_instance_private (self);
+
+  if (priv->finished_generation == priv->generation)
+    return;
+
+  priv->finished_generation = priv->generation;
+  phosh_dbus_search_emit_query_finished (priv->object);
+}
+
+
+struct GotMetasData {
+  guint generation;
+  PhoshSearchApplication *self;
+};
+
+
 static void
 got_metas (GObject *source, GAsyncResult *res, gpointer user_data)
 {
-  PhoshSearchApplication *self = PHOSH_SEARCH_APPLICATION (user_data);
+  g_autofree struct GotMetasData *data = user_data;
+  g_autoptr (PhoshSearchApplication) self = data->self;
   PhoshSearchApplicationPrivate *priv = phosh_search_application_get_instance_private (self);
   g_autoptr (GError) error = NULL;
   g_autoptr (GVariant) result = NULL;
+  g_autoptr (GPtrArray) metas = NULL;
   GVariantBuilder builder;
-  GPtrArray *metas;
   char *bus_path;
 
   metas = phosh_search_provider_get_result_meta_finish (PHOSH_SEARCH_PROVIDER (source),
                                                         res,
                                                         &error);
 
-  g_object_get (source, "bus-path", &bus_path, NULL);
-
   if (error) {
     g_critical ("Failed to load results %s", error->message);
     return;
   }
 
+  /*
+   * Results of each provider are sent as soon as they arrive so fast
+   * (local) providers show up first. Results of a slow provider for
+   * an older query must not replace the ones of the current query.
+   */
+  if (data->generation != priv->generation) {
+    g_debug ("Dropping results of outdated search");
+    return;
+  }
+
+  g_object_get (source, "bus-path", &bus_path, NULL);
+
   g_variant_builder_init (&builder, G_VARIANT_TYPE ("aa{sv}"));
 
   for (int i = 0; i < metas->len; i++) {
@@ -348,6 +438,7 @@ got_metas (GObject *source, GAsyncResult *res, gpointer user_data)
 
 struct GotResultsData {
   gboolean initial;
+  guint generation;
   PhoshSearchApplication *self;
 };
 
@@ -362,6 +453,7 @@ got_results (GObject *source, GAsyncResult *res, gpointer user_data)
   g_autoptr (GPtrArray) sub_res = NULL;
   g_autofree char *bus_path = NULL;
   GStrv sub_res_strv = NULL;
+  struct GotMetasData *metas_data;
 
   priv = phosh_search_application_get_instance_private (data->self);
 
@@ -389,18 +481,27 @@ got_results (GObject *source, GAsyncResult *res, gpointer user_data)
 
     sub_res_strv[sub_res->len] = NULL;
 
+    metas_data = g_new0 (struct GotMetasData, 1);
+    metas_data->self = g_object_ref (data->self);
+    metas_data->generation = data->generation;
     phosh_search_provider_get_result_meta (PHOSH_SEARCH_PROVIDER (source),
                                            sub_res_strv,
                                            got_metas,
-                                           data->self);
+                                           metas_data);
+    g_free (sub_res_strv);
   }
 
   priv->outstanding_searches--;
-
-  /* If all searches are done, emit the signal */
-  if (priv->outstanding_searches == 0) {
-    g_debug ("Query finished: All outstanding searches completed.\n");
-    phosh_dbus_search_emit_query_finished (priv->object);
+  if (priv->outstanding_searches == 0)
+    priv->debounce = 0;
+
+  /* If all searches of the current query are done, emit the signal */
+  if (data->generation == priv->generation) {
+    priv->generation_outstanding--;
+    if (priv->generation_outstanding == 0) {
+      g_debug ("Query finished: All outstanding searches completed.");
+      emit_query_finished (data->self);
+    }
   }
 
   g_object_unref (data->self);
@@ -434,51 +535,70 @@ extract_result_ids (GVariant *results_variant)
 }
 
 
-static void
-search (PhoshSearchApplication *self)
+static gboolean
+search_provider (PhoshSearchApplication *self, PhoshSearchProvider *provider)
 {
   PhoshSearchApplicationPrivate *priv = phosh_search_application_get_instance_private (self);
-  GHashTableIter iter;
-  gpointer key, value;
-
-  g_hash_table_iter_init (&iter, priv->providers);
-  while (g_hash_table_iter_next (&iter, &key, &value)) {
-    PhoshSearchProvider *provider = PHOSH_SEARCH_PROVIDER (value);
-    char *bus_path;
-    struct GotResultsData *data;
+  const char *bus_path = phosh_search_provider_get_bus_path (provider);
+  struct GotResultsData *data;
 
-    g_object_get (provider, "bus-path", &bus_path, NULL);
+  if (!phosh_search_provider_get_ready (provider)) {
+    /* Searched once the proxy is up */
+    g_debug ("[%s]: not ready", bus_path);
+    phosh_search_provider_ensure_proxy (provider);
+    return FALSE;
+  }
 
-    if (!phosh_search_provider_get_ready (provider)) {
-      g_warning ("[%s]: not ready", bus_path);
-      continue;
-    }
+  /* Don't let a slow provider hold up the query */
+  if (phosh_search_provider_get_demoted (provider)) {
+    g_debug ("[%s]: demoted, skipping", bus_path);
+    return FALSE;
+  }
 
-    data = g_new (struct GotResultsData, 1);
-    data->self = g_object_ref (self);
+  data = g_new (struct GotResultsData, 1);
+  data->self = g_object_ref (self);
+  data->generation = priv->generation;
 
-    /* Increment counter for each provider that will be queried */
-    priv->outstanding_searches++;
+  /* Increment counter for each provider that will be queried */
+  priv->outstanding_searches++;
+  priv->generation_outstanding++;
 
-    if (priv->doing_subsearch && g_hash_table_contains (priv->last_results, bus_path)) {
-      GVariant *prev = g_hash_table_lookup (priv->last_results, bus_path);
-      g_auto (GStrv) prev_results = extract_result_ids (prev);
+  if (priv->doing_subsearch && g_hash_table_contains (priv->last_results, bus_path)) {
+    GVariant *prev = g_hash_table_lookup (priv->last_results, bus_path);
+    g_auto (GStrv) prev_results = extract_result_ids (prev);
 
-      data->initial = FALSE;
-      phosh_search_provider_get_subsearch (provider,
-                                           (const char * const *) prev_results,
-                                           (const char * const *) priv->query_parts,
-                                           got_results,
-                                           data);
-    } else {
-      data->initial = TRUE;
-      phosh_search_provider_get_initial (provider,
-                                         (const char * const*) priv->query_parts,
+    data->initial = FALSE;
+    phosh_search_provider_get_subsearch (provider,
+                                         (const char * const *) prev_results,
+                                         (const char * const *) priv->query_parts,
                                          got_results,
                                          data);
-    }
+  } else {
+    data->initial = TRUE;
+    phosh_search_provider_get_initial (provider,
+                                       (const char * const*) priv->query_parts,
+                                       got_results,
+                                       data);
   }
 
+  return TRUE;
+}
+
+
+static void
+search (PhoshSearchApplication *self)
+{
+  PhoshSearchApplicationPrivate *priv = phosh_search_application_get_instance_private (self);
+  GHashTableIter iter;
+  gpointer value;
+
+  priv->generation++;
+  priv->generation_outstanding = 0;
+
+  g_hash_table_iter_init (&iter, priv->providers);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    search_provider (self, PHOSH_SEARCH_PROVIDER (value));
+
   g_hash_table_remove_all (priv->last_results);
 
   if (priv->search_timeout != 0) {
@@ -499,8 +619,8 @@ search_timeout (gpointer user_data)
   search (self);
 
   /* Edge case: if no providers are ready/active, emit immediately */
-  if (priv->outstanding_searches == 0)
-    phosh_dbus_search_emit_query_finished (priv->object);
+  if (priv->generation_outstanding == 0)
+    emit_query_finished (self);
 
   return G_SOURCE_REMOVE;
 }
@@ -525,7 +645,9 @@ query (PhoshDBusSearch       *interface,
   if (priv->query_parts && g_strv_equal ((const char *const *) priv->query_parts,
                                          (const char *const *) parts)) {
     phosh_dbus_search_complete_query (interface, invocation, FALSE);
-    phosh_dbus_search_emit_query_finished (interface);
+    /* A pending or running search of this query emits it when done */
+    if (priv->search_timeout == 0 && priv->generation_outstanding == 0)
+      emit_query_finished (self);
 
     return TRUE;
   }
@@ -540,9 +662,16 @@ query (PhoshDBusSearch       *interface,
     g_clear_pointer (&priv->query_parts, g_strfreev);
 
     priv->doing_subsearch = FALSE;
+    /* Drop pending searches and late results of the last query */
+    if (priv->search_timeout != 0) {
+      g_source_remove (priv->search_timeout);
+      priv->search_timeout = 0;
+    }
+    priv->generation++;
+    priv->generation_outstanding = 0;
 
     phosh_dbus_search_complete_query (interface, invocation, FALSE);
-    phosh_dbus_search_emit_query_finished (interface);
+    emit_query_finished (self);
 
     return TRUE;
   }
@@ -556,8 +685,22 @@ query (PhoshDBusSearch       *interface,
   priv->query_parts = g_strdupv (parts);
   priv->query = g_strdup (query);
 
-  if (priv->search_timeout == 0)
-    priv->search_timeout = g_timeout_add (150, search_timeout, self);
+  /*
+   * Search right away when providers are idle. If they're still busy
+   * with the last query widen the debounce so we don't pile up requests.
+   * A pending search picks up the latest query when it fires.
+   */
+  if (priv->search_timeout == 0) {
+    if (priv->outstanding_searches <= 0) {
+      priv->debounce = 0;
+      priv->search_timeout = g_idle_add (search_timeout, self);
+    } else {
+      priv->debounce = CLAMP (priv->debounce * 2, DEBOUNCE_MIN_MS, DEBOUNCE_MAX_MS);
+      g_debug ("Providers busy, debouncing for %ums", priv->debounce);
+      priv->search_timeout = g_timeout_add (priv->debounce, search_timeout, self);
+    }
+    g_source_set_name_by_id (priv->search_timeout, "[phosh-searchd] search");
+  }
 
   phosh_dbus_search_complete_query (interface, invocation, TRUE);
 
@@ -620,6 +763,174 @@ sort_sources (gconstpointer a, gconstpointer b, gpointer user_data)
 }
 
 
+static void
+provider_desc_free (PhoshSearchProviderDesc *desc)
+{
+  g_free (desc->desktop_id);
+  g_free (desc->bus_name);
+  g_free (desc->bus_path);
+  g_clear_object (&desc->provider);
+  g_free (desc);
+}
+
+
+static PhoshSearchProviderDesc *
+provider_desc_parse (const char *provider, gint64 mtime)
+{
+  g_autoptr (GError) error = NULL;
+  g_autoptr (GKeyFile) data = NULL;
+  g_autofree char *bus_path = NULL;
+  g_autofree char *bus_name = NULL;
+  g_autofree char *desktop_id = NULL;
+  PhoshSearchProviderDesc *desc;
+  int version = 0;
+  gboolean autostart = TRUE;
+  gboolean autostart_tmp = FALSE;
+  gboolean default_disabled = FALSE;
+  gboolean default_disabled_tmp = FALSE;
+
+  data = g_key_file_new ();
+
+  g_key_file_load_from_file (data, provider, G_KEY_FILE_NONE, &error);
+
+  if (error) {
+    g_warning ("Can't read %s: %s", provider, error->message);
+    return NULL;
+  }
+
+  if (!g_key_file_has_group (data, GROUP_NAME)) {
+    g_warning ("%s doesn't define a search provider", provider);
+    return NULL;
+  }
+
+
+  version = g_key_file_get_integer (data, GROUP_NAME, "Version", &error);
+
+  if (error) {
+    g_warning ("Failed to fetch provider version %s: %s", provider, error->message);
+    return NULL;
+  }
+
+  if (version < 2) {
+    g_warning ("Provider %s implements version %i but we only support version 2 and up", provider, version);
+    return NULL;
+  }
+
+
+  desktop_id = g_key_file_get_string (data, GROUP_NAME, "DesktopId", &error);
+  if (error) {
+    g_warning ("Failed to fetch provider desktop id %s: %s", provider, error->message);
+    return NULL;
+  }
+  if (!desktop_id) {
+    g_warning ("Provider %s doesn't specify a desktop id", provider);
+    return NULL;
+  }
+
+
+  bus_name = g_key_file_get_string (data, GROUP_NAME, "BusName", &error);
+  if (error) {
+    g_warning ("Failed to fetch provider bus name %s: %s", provider, error->message);
+    return NULL;
+  }
+  if (!bus_name) {
+    g_warning ("Provider %s doesn't specify a bus name", provider);
+    return NULL;
+  }
+
+
+  bus_path = g_key_file_get_string (data, GROUP_NAME, "ObjectPath", &error);
+  if (error) {
+    g_warning ("Failed to fetch provider bus path %s: %s", provider, error->message);
+    return NULL;
+  }
+  if (!bus_path) {
+    g_warning ("Provider %s doesn't specify a bus path", provider);
+    return NULL;
+  }
+
+  autostart_tmp = g_key_file_get_boolean (data, GROUP_NAME, "AutoStart", &error);
+
+  if (G_LIKELY (error))
+    g_clear_error (&error);
+  else
+    autostart = autostart_tmp;
+
+  default_disabled_tmp = g_key_file_get_boolean (data, GROUP_NAME, "DefaultDisabled", &error);
+  if (G_LIKELY (error))
+    g_clear_error (&error);
+  else
+    default_disabled = default_disabled_tmp;
+
+  desc = g_new0 (PhoshSearchProviderDesc, 1);
+  desc->mtime = mtime;
+  desc->desktop_id = g_steal_pointer (&desktop_id);
+  desc->bus_name = g_steal_pointer (&bus_name);
+  desc->bus_path = g_steal_pointer (&bus_path);
+  desc->autostart = autostart;
+  desc->default_disabled = default_disabled;
+
+  return desc;
+}
+
+
+static void
+on_provider_ready (PhoshSearchProvider *provider, PhoshSearchApplication *self)
+{
+  PhoshSearchApplicationPrivate *priv = phosh_search_application_get_instance_private (self);
+
+  /* A pending search will pick up the provider anyway */
+  if (!priv->query_parts || priv->search_timeout)
+    return;
+
+  /*
+   * Feed the current query to providers that became ready late. Their
+   * results are tagged with the current generation. If the query already
+   * finished they're only sent as source results.
+   */
+  search_provider (self, provider);
+}
+
+
+/* Looks up the cached descriptor, parsing the file if it's new or changed */
+static PhoshSearchProviderDesc *
+lookup_provider_desc (PhoshSearchApplication *self, const char *provider)
+{
+  PhoshSearchApplicationPrivate *priv = phosh_search_application_get_instance_private (self);
+  PhoshSearchProviderDesc *desc;
+  GStatBuf buf;
+  gint64 mtime;
+
+  if (g_stat (provider, &buf) != 0) {
+    g_warning ("Can't stat %s: %s", provider, g_strerror (errno));
+    return NULL;
+  }
+  mtime = buf.st_mtime;
+
+  desc = g_hash_table_lookup (priv->provider_descs, provider);
+  if (desc && desc->mtime == mtime)
+    return desc;
+
+  g_debug ("Parsing %s", provider);
+  desc = provider_desc_parse (provider, mtime);
+  if (desc)
+    g_hash_table_insert (priv->provider_descs, g_strdup (provider), desc);
+  else
+    g_hash_table_remove (priv->provider_descs, provider);
+
+  return desc;
+}
+
+
+static gboolean
+provider_desc_unseen (gpointer key, gpointer value, gpointer user_data)
+{
+  GHashTable *seen = user_data;
+
+  return !g_hash_table_contains (seen, key);
+}
+
+
 static void
 reload_providers (PhoshSearchApplication *self)
 {
@@ -629,19 +940,28 @@ reload_providers (PhoshSearchApplication *self)
   g_autolist (PhoshSearchSource) sources = NULL;
   /* This skip the normal sorting */
   g_autoptr (PhoshSearchSource) settings = NULL;
+  g_autoptr (GHashTable) seen = NULL;
+  g_autoptr (GHashTable) providers = NULL;
   g_auto (GStrv) enabled = NULL;
   g_auto (GStrv) disabled = NULL;
   g_auto (GStrv) sort_order = NULL;
   GList *list;
   int i = 0;
 
-  if (g_settings_get_boolean (priv->settings, "disable-external"))
-    g_list_free_full (priv->sources, (GDestroyNotify) phosh_search_source_unref);
+  providers = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+
+  if (g_settings_get_boolean (priv->settings, "disable-external")) {
+    g_debug ("External search providers disabled");
+    g_hash_table_remove_all (priv->provider_descs);
+    goto out;
+  }
 
   enabled = g_settings_get_strv (priv->settings, "enabled");
   disabled = g_settings_get_strv (priv->settings, "disabled");
   sort_order = g_settings_get_strv (priv->settings, "sort-order");
 
+  seen = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
   while ((data_dir = data_dirs[i])) {
     g_autofree char *dir = NULL;
     g_autoptr (GError) error = NULL;
@@ -663,137 +983,71 @@ reload_providers (PhoshSearchApplication *self)
 
     while ((name = g_dir_read_name (contents))) {
       g_autofree char *provider = NULL;
-      g_autofree char *bus_path = NULL;
-      g_autofree char *bus_name = NULL;
-      g_autofree char *desktop_id = NULL;
-      g_autoptr (GKeyFile) data = NULL;
-      g_autoptr (PhoshSearchProvider) provider_object = NULL;
       g_autoptr (PhoshSearchSource) source = NULL;
       g_autoptr (GAppInfo) info = NULL;
-      int version = 0;
-      gboolean autostart = TRUE;
-      gboolean autostart_tmp = FALSE;
-      gboolean default_disabled = FALSE;
-      gboolean default_disabled_tmp = FALSE;
+      PhoshSearchProviderDesc *desc;
 
       provider = g_build_filename (dir, name, NULL);
-      data = g_key_file_new ();
-
-      g_key_file_load_from_file (data, provider, G_KEY_FILE_NONE, &error);
-
-      if (error) {
-        g_warning ("Can't read %s: %s", provider, error->message);
-        g_clear_error (&error);
+      desc = lookup_provider_desc (self, provider);
+      if (!desc)
         continue;
-      }
-
-      if (!g_key_file_has_group (data, GROUP_NAME)) {
-        g_warning ("%s doesn't define a search provider", provider);
-        continue;
-      }
-
 
-      version = g_key_file_get_integer (data, GROUP_NAME, "Version", &error);
+      g_hash_table_add (seen, g_strdup (provider));
 
-      if (error) {
-        g_warning ("Failed to fetch provider version %s: %s", provider, error->message);
-        g_clear_error (&error);
+      if (g_hash_table_contains (providers, desc->bus_path)) {
+        g_debug ("We already have a provider for %s, ignoring %s", desc->bus_path, provider);
         continue;
       }
 
-      if (version < 2) {
-        g_warning ("Provider %s implements version %i but we only support version 2 and up", provider, version);
-        continue;
-      }
-
-
-      desktop_id = g_key_file_get_string (data, GROUP_NAME, "DesktopId", &error);
-      if (error) {
-        g_warning ("Failed to fetch provider desktop id %s: %s", provider, error->message);
-        g_clear_error (&error);
-        continue;
-      }
-      if (!desktop_id) {
-        g_warning ("Provider %s doesn't specify a desktop id", provider);
-        continue;
-      }
-
-
-      bus_name = g_key_file_get_string (data, GROUP_NAME, "BusName", &error);
-      if (error) {
-        g_warning ("Failed to fetch provider bus name %s: %s", provider, error->message);
-        g_clear_error (&error);
-        continue;
-      }
-      if (!bus_name) {
-        g_warning ("Provider %s doesn't specify a bus name", provider);
-        continue;
-      }
-
-
-      bus_path = g_key_file_get_string (data, GROUP_NAME, "ObjectPath", &error);
-      if (error) {
-        g_warning ("Failed to fetch provider bus path %s: %s", provider, error->message);
-        g_clear_error (&error);
-        continue;
-      }
-      if (!bus_path) {
-        g_warning ("Provider %s doesn't specify a bus path", provider);
-        continue;
-      }
-
-      if (g_hash_table_contains (priv->providers, bus_path)) {
-        g_debug ("We already have a provider for %s, ignoring %s", bus_path, provider);
-        continue;
-      }
-
-      autostart_tmp = g_key_file_get_boolean (data, GROUP_NAME, "AutoStart", &error);
-
-      if (G_LIKELY (error))
-        g_clear_error (&error);
-      else
-        autostart = autostart_tmp;
-
-      default_disabled_tmp = g_key_file_get_boolean (data, GROUP_NAME, "DefaultDisabled", &error);
-      if (G_LIKELY (error))
-        g_clear_error (&error);
-      else
-        default_disabled = default_disabled_tmp;
-
-      if (!default_disabled) {
-        if (g_strv_contains ((const char * const*) disabled, desktop_id)) {
+      if (!desc->default_disabled) {
+        if (g_strv_contains ((const char * const*) disabled, desc->desktop_id)) {
           g_debug ("Provider %s has been disabled", provider);
+          g_clear_object (&desc->provider);
           continue;
         }
       } else {
-        if (!g_strv_contains ((const char * const*) enabled, desktop_id)) {
+        if (!g_strv_contains ((const char * const*) enabled, desc->desktop_id)) {
           g_debug ("Provider %s hasn't been enabled", provider);
+          g_clear_object (&desc->provider);
           continue;
         }
       }
 
-      provider_object = phosh_search_provider_new (desktop_id,
-                                                   priv->cancellable,
-                                                   bus_path,
-                                                   bus_name,
-                                                   autostart,
-                                                   default_disabled);
+      if (desc->provider) {
+        /* Result metadata might be stale after a provider update */
+        phosh_search_provider_clear_cache (desc->provider);
+      } else {
+        /* The D-Bus proxy is only created once a query needs it */
+        desc->provider = phosh_search_provider_new (desc->desktop_id,
+                                                    priv->cancellable,
+                                                    desc->bus_path,
+                                                    desc->bus_name,
+                                                    desc->autostart,
+                                                    desc->default_disabled);
+        g_signal_connect_object (desc->provider, "ready",
+                                 G_CALLBACK (on_provider_ready), self,
+                                 G_CONNECT_DEFAULT);
+      }
 
-      if (G_UNLIKELY (g_str_equal (desktop_id, "org.gnome.Settings.desktop"))) {
-        info = G_APP_INFO (g_desktop_app_info_new (desktop_id));
-        settings = phosh_search_source_new (bus_path, info);
+      info = G_APP_INFO (g_desktop_app_info_new (desc->desktop_id));
+      if (G_UNLIKELY (g_str_equal (desc->desktop_id, "org.gnome.Settings.desktop"))) {
+        g_clear_pointer (&settings, phosh_search_source_unref);
+        settings = phosh_search_source_new (desc->bus_path, info);
       } else {
-        info = G_APP_INFO (g_desktop_app_info_new (desktop_id));
-        source = phosh_search_source_new (bus_path, info);
+        source = phosh_search_source_new (desc->bus_path, info);
         sources = g_list_prepend (sources, phosh_search_source_ref (source));
       }
 
-      g_hash_table_insert (priv->providers, g_strdup (bus_path), g_object_ref (provider_object));
+      g_hash_table_insert (providers, g_strdup (desc->bus_path), g_object_ref (desc->provider));
     }
   }
 
+  /* Drop descriptors of removed files */
+  g_hash_table_foreach_remove (priv->provider_descs, provider_desc_unseen, seen);
+
   sources = g_list_sort_with_data (sources, sort_sources, sort_order);
 
+ out:
   if (settings)
     sources = g_list_prepend (sources, phosh_search_source_ref (settings));
 
@@ -807,6 +1061,9 @@ reload_providers (PhoshSearchApplication *self)
     list = g_list_next (list);
   }
 
+  g_hash_table_unref (priv->providers);
+  priv->providers = g_steal_pointer (&providers);
+
   g_list_free_full (priv->sources, (GDestroyNotify) phosh_search_source_unref);
   priv->sources = g_list_copy_deep (sources, (GCopyFunc) phosh_search_source_ref, NULL);
 }
@@ -841,6 +1098,10 @@ phosh_search_application_init (PhoshSearchApplication *self)
                                            g_str_equal,
                                            g_free,
                                            (GDestroyNotify) g_object_unref);
+  priv->provider_descs = g_hash_table_new_full (g_str_hash,
+                                                g_str_equal,
+                                                g_free,
+                                                (GDestroyNotify) provider_desc_free);
 
   priv->cancellable = g_cancellable_new ();
 
@@ -863,6 +1124,7 @@ phosh_search_application_init (PhoshSearchApplication *self)
                     "object-signal::handle-get-sources", get_sources, self,
                     "object-signal::handle-query", query, self,
                     "object-signal::handle-get-last-results", get_last_results, self,
+                    "object-signal::handle-get-provider-stats", get_provider_stats, self,
                     NULL);
 
   reload_providers (self);
@@ -16,6 +16,7 @@
 #include "thumbnail.h"
 #include "util.h"
 #include "app-grid-button.h"
+#include "watchdog.h"
 
 /**
  * PhoshActivity:
@@ -255,8 +256,8 @@ removed_cb (PhoshActivity *self)
   if (priv->remove_timeout_id)
     g_source_remove (priv->remove_timeout_id);
 
-  priv->remove_timeout_id = g_timeout_add_seconds_once (1, on_remove_timeout, self);
-  g_source_set_name_by_id (priv->remove_timeout_id, "[phosh] remove_timeout_id");
+  priv->remove_timeout_id = phosh_watchdog_timeout_add_seconds_once (1, on_remove_timeout, self,
+                                                                     "[phosh] remove_timeout_id");
 
   g_signal_emit (self, signals[CLOSED], 0);
 }
@@ -13,9 +13,11 @@
 #include "animation.h"
 #include "fader.h"
 #include "ambient.h"
+#include "light-filter.h"
 #include "shell-priv.h"
 #include "sensor-proxy-manager.h"
 #include "util.h"
+#include "watchdog.h"
 
 #define INTERFACE_SCHEMA        "org.gnome.desktop.interface"
 #define HIGH_CONTRAST_THEME     "HighContrast"
@@ -29,7 +31,7 @@
 #define POWER_SCHEMA "org.gnome.settings-daemon.plugins.power"
 #define KEY_AMBIENT_ENABLED "ambient-enabled"
 
-#define NUM_VALUES              3
+#define HC_WINDOW_MS            3000
 
 /**
  * PhoshAmbient:
@@ -66,8 +68,7 @@ typedef struct _PhoshAmbient {
   double                   light_level;
   gboolean                 blanked;
 
-  guint                    sample_id;
-  GArray                  *values;
+  PhoshLightFilter        *hc_filter;
 
   PhoshFader              *fader;
   guint                    fader_id;
@@ -152,82 +153,31 @@ switch_theme (PhoshAmbient *self, gboolean use_hc)
                               NULL);
   gtk_widget_set_visible (GTK_WIDGET (self->fader), TRUE);
 
-  self->fader_id = g_timeout_add (100 * PHOSH_ANIMATION_SLOWDOWN,
-                                  G_SOURCE_FUNC (on_fade_in_done),
-                                  self);
-  g_source_set_name_by_id (self->fader_id, "[phosh] ambient fader");
+  self->fader_id = phosh_watchdog_timeout_add (100 * PHOSH_ANIMATION_SLOWDOWN,
+                                               G_SOURCE_FUNC (on_fade_in_done), self,
+                                               "[phosh] ambient fader");
 
   self->use_hc = use_hc;
 }
 
 
-static gboolean
-on_ambient_sample_for_hc (gpointer data)
-{
-  PhoshAmbient *self = PHOSH_AMBIENT (data);
-  double level, threshold;
-  double avg = 0.0;
-  gboolean use_hc;
-
-  level = phosh_dbus_sensor_proxy_get_light_level (PHOSH_DBUS_SENSOR_PROXY (self->sensor_proxy_manager));
-  g_array_append_val (self->values, level);
-
-  if (self->values->len < NUM_VALUES)
-    return G_SOURCE_CONTINUE;
-
-  for (int i = 0; i < self->values->len; i++)
-    avg += g_array_index (self->values, double, i);
-
-  avg /= self->values->len;
-  threshold = g_settings_get_uint (self->phosh_settings, KEY_AUTOMATIC_HC_THRESHOLD);
-  use_hc = avg > threshold;
-
-  g_debug ("Avg: %f Switching theme to hc: %d", avg, use_hc);
-  switch_theme (self, use_hc);
-
-  g_array_set_size (self->values, 0);
-  self->sample_id = 0;
-  return G_SOURCE_REMOVE;
-}
-
-
 static void
 stop_high_contrast_sampling (PhoshAmbient *self)
 {
-  g_clear_handle_id (&self->sample_id, g_source_remove);
-  g_array_set_size (self->values, 0);
+  phosh_light_filter_reset (self->hc_filter, self->use_hc);
 }
 
 
 static void
-check_high_contrast (PhoshAmbient *self, double level)
+on_hc_filter_high_contrast_changed (PhoshAmbient *self)
 {
-  double hyst, threshold;
-  gboolean wants_hc;
+  gboolean use_hc = phosh_light_filter_get_high_contrast (self->hc_filter);
 
   if (!self->auto_hc)
     return;
 
-  /* Currently sampling, ignoring changes */
-  if (self->sample_id)
-    return;
-
-  threshold = g_settings_get_uint (self->phosh_settings, KEY_AUTOMATIC_HC_THRESHOLD);
-  /* Use a bit of hysteresis to not switch too often around the threshold */
-  hyst = self->use_hc ? 0.9 : 1.1;
-  threshold *= hyst;
-
-  wants_hc = level > threshold;
-  /* New value wouldn't change anything, nothing to do */
-  if (wants_hc == self->use_hc)
-    return;
-
-  /* new value would change hc mode, sample to see if it should stick */
-  g_return_if_fail (self->sample_id == 0);
-  g_return_if_fail (self->values->len == 0);
-  g_array_append_val (self->values, level);
-  self->sample_id = g_timeout_add_seconds (1, on_ambient_sample_for_hc, self);
-  g_source_set_name_by_id (self->sample_id, "[phosh] ambient_sample_for_hc");
+  g_debug ("Switching theme to hc: %d", use_hc);
+  switch_theme (self, use_hc);
 }
 
 
@@ -258,7 +208,8 @@ on_ambient_light_level_changed (PhoshAmbient            *self,
     g_object_notify_by_pspec (G_OBJECT (self), props[PROP_LIGHT_LEVEL]);
   }
 
-  check_high_contrast (self, level);
+  if (self->auto_hc)
+    phosh_light_filter_add_sample (self->hc_filter, level);
 }
 
 
@@ -369,7 +320,10 @@ maybe_claim (PhoshAmbient *self)
     return;
   }
 
-  self->auto_hc = auto_hc;
+  if (self->auto_hc != auto_hc) {
+    self->auto_hc = auto_hc;
+    stop_high_contrast_sampling (self);
+  }
   update_auto_brightness_enabled (self);
 
   if (claim) {
@@ -382,8 +336,10 @@ maybe_claim (PhoshAmbient *self)
   } else {
     phosh_ambient_claim_light (self, FALSE);
     /* Switch back to normal theme */
-    if (!self->auto_hc)
+    if (!self->auto_hc) {
       switch_theme (self, FALSE);
+      stop_high_contrast_sampling (self);
+    }
   }
 }
 
@@ -422,16 +378,14 @@ on_has_ambient_light_changed (PhoshAmbient         *self,
 
 
 static void
-on_shell_state_changed (PhoshAmbient *self, GParamSpec *pspec, PhoshShell *shell)
+on_shell_blanked_changed (PhoshAmbient *self, GParamSpec *pspec, PhoshShell *shell)
 {
   gboolean blanked;
-  PhoshShellStateFlags state;
 
   g_return_if_fail (PHOSH_IS_AMBIENT (self));
   g_return_if_fail (PHOSH_IS_SHELL (shell));
 
-  state = phosh_shell_get_state (shell);
-  blanked = !!(state & PHOSH_STATE_BLANKED);
+  blanked = phosh_shell_get_blanked (shell);
 
   if (self->blanked == blanked)
     return;
@@ -466,14 +420,20 @@ phosh_ambient_constructed (GObject *object)
                     "swapped-signal::changed::" KEY_AUTOMATIC_HC,
                     G_CALLBACK (on_settings_changed),
                     self,
-                    "swapped-signal::changed::" KEY_AUTOMATIC_HC_THRESHOLD,
-                    G_CALLBACK (on_settings_changed),
-                    self,
                     NULL);
 
+  g_settings_bind (self->phosh_settings, KEY_AUTOMATIC_HC_THRESHOLD,
+                   self->hc_filter, "threshold",
+                   G_SETTINGS_BIND_GET);
+  g_signal_connect_object (self->hc_filter,
+                           "notify::high-contrast",
+                           G_CALLBACK (on_hc_filter_high_contrast_changed),
+                           self,
+                           G_CONNECT_SWAPPED);
+
   g_signal_connect_object (phosh_shell_get_default (),
-                           "notify::shell-state",
-                           G_CALLBACK (on_shell_state_changed),
+                           "notify::blanked",
+                           G_CALLBACK (on_shell_blanked_changed),
                            self,
                            G_CONNECT_SWAPPED);
 
@@ -494,8 +454,7 @@ phosh_ambient_dispose (GObject *object)
   g_cancellable_cancel (self->cancel);
   g_clear_object (&self->cancel);
 
-  g_clear_handle_id (&self->sample_id, g_source_remove);
-  g_clear_pointer (&self->values, g_array_unref);
+  g_clear_object (&self->hc_filter);
 
   if (self->sensor_proxy_manager) {
     g_signal_handlers_disconnect_by_data (self->sensor_proxy_manager, self);
@@ -566,8 +525,6 @@ phosh_ambient_init (PhoshAmbient *self)
   self->blanked = -1;
   self->cancel = g_cancellable_new ();
 
-  self->values = g_array_new (FALSE, FALSE, sizeof(double));
-
   self->interface_settings = g_settings_new (INTERFACE_SCHEMA);
   self->phosh_settings = g_settings_new (PHOSH_SCHEMA);
   self->power_settings = g_settings_new (POWER_SCHEMA);
@@ -576,6 +533,9 @@ phosh_ambient_init (PhoshAmbient *self)
   theme_name = g_settings_get_string (self->interface_settings, KEY_GTK_THEME);
   if (g_strcmp0 (theme_name, HIGH_CONTRAST_THEME) == 0)
     self->use_hc = TRUE;
+
+  self->hc_filter = phosh_light_filter_new (HC_WINDOW_MS);
+  phosh_light_filter_reset (self->hc_filter, self->use_hc);
 }
 
 
@@ -380,6 +380,29 @@ view_details_activated (GSimpleAction *action,
 }
 
 
+static void
+update_uninstall_action (PhoshAppGridButton *self)
+{
+  PhoshAppGridButtonPrivate *priv = phosh_app_grid_button_get_instance_private (self);
+  PhoshMetainfoCache *metainfo_cache = phosh_metainfo_cache_get_default ();
+  g_autofree char *appstream_id = NULL;
+  const char *app_id = NULL;
+  gboolean ready = FALSE;
+  GAction *act;
+
+  g_object_get (metainfo_cache, "ready", &ready, NULL);
+  if (priv->info)
+    app_id = g_app_info_get_id (priv->info);
+
+  /* Only apps known to AppStream can be uninstalled */
+  if (ready && app_id && phosh_util_have_gnome_software (FALSE))
+    appstream_id = phosh_metainfo_get_data_id (metainfo_cache, app_id);
+
+  act = g_action_map_lookup_action (priv->action_map, "uninstall");
+  g_simple_action_set_enabled (G_SIMPLE_ACTION (act), !!appstream_id);
+}
+
+
 static void
 uninstall_activated (GSimpleAction *action,
                      GVariant      *parameter,
@@ -392,7 +415,10 @@ uninstall_activated (GSimpleAction *action,
   g_return_if_fail (app_id);
 
   appstream_id = phosh_metainfo_get_data_id (phosh_metainfo_cache_get_default (), app_id);
-  g_return_if_fail (appstream_id);
+  if (!appstream_id) {
+    g_warning ("No AppStream data id for %s, can't uninstall", app_id);
+    return;
+  }
 
   spawn_gnome_software ("--uninstall", appstream_id);
 }
@@ -535,14 +561,14 @@ phosh_app_grid_button_init (PhoshAppGridButton *self)
   act = g_action_map_lookup_action (priv->action_map, "folder-remove");
   g_simple_action_set_enabled (G_SIMPLE_ACTION (act), FALSE);
 
-  /* Uninstall is hidden initially until we're sure the AppStream cache has loaded. */
-  act = g_action_map_lookup_action (priv->action_map, "uninstall");
-  g_simple_action_set_enabled (G_SIMPLE_ACTION (act), FALSE);
-
-  if (have_gnome_software) {
-    act = g_action_map_lookup_action (priv->action_map, "uninstall");
-    g_object_bind_property (metainfo_cache, "ready", act, "enabled", G_BINDING_SYNC_CREATE);
-  }
+  /* Uninstall is hidden until we're sure the app has an AppStream data id */
+  g_signal_connect_object (metainfo_cache, "notify::ready",
+                           G_CALLBACK (update_uninstall_action), self,
+                           G_CONNECT_SWAPPED);
+  g_signal_connect_object (metainfo_cache, "changed",
+                           G_CALLBACK (update_uninstall_action), self,
+                           G_CONNECT_SWAPPED);
+  update_uninstall_action (self);
 
   g_type_ensure (PHOSH_TYPE_CLAMP);
   g_type_ensure (PHOSH_TYPE_FADING_LABEL);
@@ -697,6 +723,8 @@ phosh_app_grid_button_set_app_info (PhoshAppGridButton *self,
     gtk_widget_set_sensitive (GTK_WIDGET (self), FALSE);
   }
 
+  update_uninstall_action (self);
+
   g_object_notify_by_pspec (G_OBJECT (self), props[PROP_APP_INFO]);
 }
 
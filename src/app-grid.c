@@ -16,6 +16,7 @@
 #include "favorite-list-model.h"
 #include "shell-priv.h"
 #include "util.h"
+#include "watchdog.h"
 
 #include "gtk-list-models/gtksortlistmodel.h"
 #include "gtk-list-models/gtkfilterlistmodel.h"
@@ -587,8 +588,8 @@ on_search_changed (GtkSearchEntry *entry,
 
     /* GtkSearchEntry already adds 150ms of delay, but it's too little
      * so add a bit more until searching is faster and/or non-blocking */
-    priv->debounce = g_timeout_add_once (SEARCH_DEBOUNCE, do_search, self);
-    g_source_set_name_by_id (priv->debounce, "[phosh] debounce app grid search (search-changed)");
+    priv->debounce = phosh_watchdog_timeout_add_once (SEARCH_DEBOUNCE, do_search, self,
+                                                      "[phosh] debounce app grid search (search-changed)");
   } else {
     /* don't add the delay when the entry got cleared */
     do_search (self);
@@ -610,8 +611,9 @@ on_search_preedit_changed (GtkSearchEntry *entry,
 
   g_clear_handle_id (&priv->debounce, g_source_remove);
 
-  priv->debounce = g_timeout_add_once (SEARCH_DEBOUNCE + DEFAULT_GTK_DEBOUNCE, do_search, self);
-  g_source_set_name_by_id (priv->debounce, "[phosh] debounce app grid search (preedit-changed)");
+  priv->debounce = phosh_watchdog_timeout_add_once (SEARCH_DEBOUNCE + DEFAULT_GTK_DEBOUNCE,
+                                                    do_search, self,
+                                                    "[phosh] debounce app grid search (preedit-changed)");
 }
 
 
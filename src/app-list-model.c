@@ -14,11 +14,14 @@
 
 #include "app-list-model.h"
 #include "folder-info.h"
+#include "watchdog.h"
 
 #include <gmobile.h>
 
 #include <gio/gio.h>
 
+#include <string.h>
+
 typedef struct _PhoshAppListModelPrivate PhoshAppListModelPrivate;
 struct _PhoshAppListModelPrivate {
   GAppInfoMonitor *monitor;
@@ -38,6 +41,8 @@ struct _PhoshAppListModelPrivate {
 
   GHashTable *startup_wm_class;
   GHashTable *exec_to_id;
+  /* app-id → GDesktopAppInfo, NULL if there's no matching app */
+  GHashTable *app_id_cache;
 };
 
 static void list_iface_init (GListModelInterface *iface);
@@ -57,6 +62,7 @@ phosh_app_list_model_finalize (GObject *object)
 
   g_clear_pointer (&priv->startup_wm_class, g_hash_table_destroy);
   g_clear_pointer (&priv->exec_to_id, g_hash_table_destroy);
+  g_clear_pointer (&priv->app_id_cache, g_hash_table_destroy);
   g_clear_object (&priv->monitor);
   g_clear_object (&priv->settings);
 
@@ -187,6 +193,7 @@ items_changed (gpointer data)
                            g_sequence_get_end_iter (priv->items));
   g_hash_table_remove_all (priv->startup_wm_class);
   g_hash_table_remove_all (priv->exec_to_id);
+  g_hash_table_remove_all (priv->app_id_cache);
 
   folder_paths = g_settings_get_strv (priv->settings, "folder-children");
 
@@ -243,11 +250,14 @@ on_monitor_changed_cb (GAppInfoMonitor *monitor,
   PhoshAppListModel *self = PHOSH_APP_LIST_MODEL (data);
   PhoshAppListModelPrivate *priv = phosh_app_list_model_get_instance_private (self);
 
+  /* GIO's view on installed apps changed already */
+  g_hash_table_remove_all (priv->app_id_cache);
+
   if (priv->debounce != 0) {
     g_source_remove (priv->debounce);
   }
-  priv->debounce = g_timeout_add (500, items_changed, data);
-  g_source_set_name_by_id (priv->debounce, "[phosh] debounce app changes");
+  priv->debounce = phosh_watchdog_timeout_add (500, items_changed, data,
+                                               "[phosh] debounce app changes");
 }
 
 
@@ -262,6 +272,15 @@ on_folder_children_changed (PhoshAppListModel *self)
 }
 
 
+static void
+unref_app_info (gpointer data)
+{
+  /* Negative cache entries are NULL */
+  if (data)
+    g_object_unref (data);
+}
+
+
 static void
 phosh_app_list_model_init (PhoshAppListModel *self)
 {
@@ -276,6 +295,10 @@ phosh_app_list_model_init (PhoshAppListModel *self)
                                             g_str_equal,
                                             g_free,
                                             g_object_unref);
+  priv->app_id_cache = g_hash_table_new_full (g_str_hash,
+                                              g_str_equal,
+                                              g_free,
+                                              unref_app_info);
 
   priv->last.is_valid = FALSE;
 
@@ -354,6 +377,8 @@ phosh_app_list_model_add_exec (PhoshAppListModel *self,
     return;
 
   g_hash_table_insert (priv->exec_to_id, g_steal_pointer (&cmd), g_object_ref (info));
+  /* Might resolve app-ids that didn't resolve before */
+  g_hash_table_remove_all (priv->app_id_cache);
 }
 
 
@@ -364,3 +389,92 @@ phosh_app_list_model_lookup_by_exec (PhoshAppListModel *self, const char *exec)
 
   return g_hash_table_lookup (priv->exec_to_id, exec);
 }
+
+
+static GDesktopAppInfo *
+resolve_app_id (PhoshAppListModel *self, const char *app_id)
+{
+  g_autofree char *desktop_id = NULL;
+  g_autofree char *lowercase = NULL;
+  GDesktopAppInfo *app_info = NULL;
+  char *last_component;
+
+  desktop_id = g_strdup_printf ("%s.desktop", app_id);
+  g_return_val_if_fail (desktop_id, NULL);
+  app_info = g_desktop_app_info_new (desktop_id);
+
+  if (app_info)
+    return app_info;
+
+  app_info = phosh_app_list_model_lookup_by_startup_wm_class (self, app_id);
+  if (app_info)
+    return g_object_ref (app_info);
+
+  app_info = phosh_app_list_model_lookup_by_exec (self, app_id);
+  if (app_info)
+    return g_object_ref (app_info);
+
+  /* try to handle the case where app-id is rev-DNS, but desktop file is not */
+  last_component = strrchr (app_id, '.');
+  if (last_component) {
+    /* Skip past '.' */
+    last_component++;
+    g_free (desktop_id);
+    desktop_id = g_strdup_printf ("%s.desktop", last_component);
+    g_return_val_if_fail (desktop_id, NULL);
+    app_info = g_desktop_app_info_new (desktop_id);
+    if (app_info)
+      return app_info;
+  }
+
+  /* X11 WM_CLASS is often capitalized, so try in lowercase as well */
+  lowercase = g_utf8_strdown (last_component ?: app_id, -1);
+  g_clear_pointer (&desktop_id, g_free);
+
+  app_info = phosh_app_list_model_lookup_by_startup_wm_class (self, lowercase);
+  if (app_info)
+    return g_object_ref (app_info);
+
+  app_info = phosh_app_list_model_lookup_by_exec (self, lowercase);
+  if (app_info)
+    return g_object_ref (app_info);
+
+  g_message ("Could not find application for app-id '%s'", app_id);
+  return NULL;
+}
+
+/**
+ * phosh_app_list_model_lookup_by_app_id:
+ * @self: The app list model
+ * @app_id: the app_id
+ *
+ * Looks up an app info object for specified application ID.
+ * Tries a bunch of transformations in order to maximize compatibility
+ * with X11 and non-GTK applications that may not report the exact same
+ * string as their app-id and in their desktop file.
+ *
+ * Results (including failed lookups) are cached until the list of
+ * installed applications changes.
+ *
+ * Returns: (transfer full)(nullable): GDesktopAppInfo for requested app_id
+ */
+GDesktopAppInfo *
+phosh_app_list_model_lookup_by_app_id (PhoshAppListModel *self, const char *app_id)
+{
+  PhoshAppListModelPrivate *priv;
+  GDesktopAppInfo *app_info;
+
+  g_return_val_if_fail (PHOSH_IS_APP_LIST_MODEL (self), NULL);
+  g_return_val_if_fail (app_id, NULL);
+  priv = phosh_app_list_model_get_instance_private (self);
+
+  if (g_hash_table_lookup_extended (priv->app_id_cache, app_id, NULL, (gpointer *)&app_info))
+    return app_info ? g_object_ref (app_info) : NULL;
+
+  app_info = resolve_app_id (self, app_id);
+  g_hash_table_insert (priv->app_id_cache,
+                       g_strdup (app_id),
+                       app_info ? g_object_ref (app_info) : NULL);
+
+  return app_info;
+}
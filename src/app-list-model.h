@@ -23,6 +23,8 @@ PhoshAppListModel *phosh_app_list_model_get_default (void);
 GDesktopAppInfo *  phosh_app_list_model_lookup_by_startup_wm_class (PhoshAppListModel *self,
                                                                     const char        *class);
 GDesktopAppInfo *  phosh_app_list_model_lookup_by_exec (PhoshAppListModel *self, const char *exec);
+GDesktopAppInfo *  phosh_app_list_model_lookup_by_app_id (PhoshAppListModel *self,
+                                                          const char        *app_id);
 void               phosh_app_list_model_add_exec (PhoshAppListModel *self,
                                                   const char        *exec,
                                                   GAppInfo          *info);
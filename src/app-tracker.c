@@ -17,6 +17,7 @@
 #include "toplevel-manager.h"
 #include "phosh-marshalers.h"
 #include "util.h"
+#include "watchdog.h"
 
 #define GNOME_DESKTOP_USE_UNSTABLE_API
 #include <libgnome-desktop/gnome-systemd.h>
@@ -146,8 +147,8 @@ phosh_app_state_new (GDesktopAppInfo    *info,
   state->state = flags;
   state->info = g_object_ref (info);
   state->tracker = tracker;
-  state->timeout_id = g_timeout_add_seconds (STARTUP_TIMEOUT, on_startup_timeout, state);
-  g_source_set_name_by_id (state->timeout_id, "[phosh] state timeout");
+  state->timeout_id = phosh_watchdog_timeout_add_seconds (STARTUP_TIMEOUT, on_startup_timeout,
+                                                          state, "[phosh] state timeout");
 
   g_debug ("Pid %" G_GINT64_FORMAT ", '%s', startup-id: %s got state %d",
            state->pid,
@@ -659,8 +660,7 @@ phosh_app_tracker_init (PhoshAppTracker *self)
                                       g_str_equal,
                                       g_free,
                                       (GDestroyNotify) phosh_app_state_free);
-  self->idle_id = g_idle_add ((GSourceFunc)on_idle, self);
-  g_source_set_name_by_id (self->idle_id, "[PhoshAppTracker] idle");
+  self->idle_id = phosh_watchdog_idle_add ((GSourceFunc)on_idle, self, "[PhoshAppTracker] idle");
 
   version = phosh_wayland_get_phosh_private_version (wl);
   if (!phosh_private || version < PHOSH_PRIVATE_GET_STARTUP_TRACKER_SINCE_VERSION) {
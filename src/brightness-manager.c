@@ -15,6 +15,7 @@
 #include "brightness-manager.h"
 #include "shell-priv.h"
 #include "util.h"
+#include "watchdog.h"
 
 #define KEYBINDINGS_SCHEMA_ID "org.gnome.shell.keybindings"
 #define KEYBINDING_KEY_BRIGHTNESS_UP "screen-brightness-up"
@@ -168,7 +169,12 @@ transition_to_brightness (PhoshBrightnessManager *self, double target)
   g_debug ("Starting auto brightness transition from %.2f to %.2f, duration: %.2fms",
            self->transition.start, self->transition.target, self->transition.duration);
 
-  self->transition.id = g_timeout_add (self->transition.interval, on_transition_step, self);
+  self->transition.id = phosh_watchdog_timeout_add_full (G_PRIORITY_DEFAULT,
+                                                         self->transition.interval,
+                                                         on_transition_step,
+                                                         self,
+                                                         NULL,
+                                                         "[phosh] auto brightness transition");
 }
 
 
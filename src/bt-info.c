@@ -67,14 +67,14 @@ phosh_bt_info_get_property (GObject    *object,
 
 
 static void
-update_icon (PhoshBtInfo *self, GParamSpec *pspec, PhoshBtManager *bt)
+update_icon (PhoshBtInfo *self)
 {
   const char *icon_name;
 
   g_return_if_fail (PHOSH_IS_BT_INFO (self));
-  g_return_if_fail (PHOSH_IS_BT_MANAGER (bt));
+  g_return_if_fail (PHOSH_IS_BT_MANAGER (self->bt));
 
-  icon_name = phosh_bt_manager_get_icon_name (bt);
+  icon_name = phosh_bt_manager_get_icon_name (self->bt);
   g_debug ("Updating bt icon to %s", icon_name);
   if (icon_name)
     phosh_status_icon_set_icon_name (PHOSH_STATUS_ICON (self), icon_name);
@@ -140,7 +140,7 @@ on_bt_enabled (PhoshBtInfo *self, GParamSpec *pspec, PhoshBtManager *bt)
   self->enabled = enabled;
   g_object_notify_by_pspec (G_OBJECT (self), props[PROP_ENABLED]);
 
-  update_info (self);
+  phosh_status_icon_queue_update (PHOSH_STATUS_ICON (self));
 }
 
 
@@ -166,12 +166,22 @@ phosh_bt_info_idle_init (PhoshStatusIcon *icon)
 {
   PhoshBtInfo *self = PHOSH_BT_INFO (icon);
 
-  update_icon (self, NULL, self->bt);
+  update_icon (self);
   update_info (self);
   on_bt_enabled (self, NULL, self->bt);
 }
 
 
+static void
+phosh_bt_info_update (PhoshStatusIcon *icon)
+{
+  PhoshBtInfo *self = PHOSH_BT_INFO (icon);
+
+  update_icon (self);
+  update_info (self);
+}
+
+
 static void
 phosh_bt_info_constructed (GObject *object)
 {
@@ -189,10 +199,11 @@ phosh_bt_info_constructed (GObject *object)
   }
 
   g_object_connect (self->bt,
-                    "swapped-signal::notify::icon-name", update_icon, self,
+                    "swapped-signal::notify::icon-name", phosh_status_icon_queue_update, self,
                     "swapped-signal::notify::enabled", on_bt_enabled, self,
                     "swapped-signal::notify::present", on_bt_present, self,
-                    "swapped-signal::notify::n-connected", update_info, self,
+                    "swapped-signal::notify::n-connected", phosh_status_icon_queue_update, self,
+                    "swapped-signal::notify::info", phosh_status_icon_queue_update, self,
                     NULL);
 }
 
@@ -223,6 +234,7 @@ phosh_bt_info_class_init (PhoshBtInfoClass *klass)
   object_class->get_property = phosh_bt_info_get_property;
 
   status_icon_class->idle_init = phosh_bt_info_idle_init;
+  status_icon_class->update = phosh_bt_info_update;
 
   gtk_widget_class_set_css_name (widget_class, "phosh-bt-info");
 
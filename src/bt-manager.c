@@ -56,12 +56,24 @@ struct _PhoshBtManager {
   char               *info;
 
   BluetoothClient    *bt_client;
+  GListStore         *devices;
   GtkFilterListModel *connectable_devices;
+  /* Object path to PhoshBtDeviceState */
+  GHashTable         *device_states;
+  /* Connected and connectable devices, most recently connected last */
+  GQueue              connected;
 
   PhoshDBusRfkill    *proxy;
 };
 G_DEFINE_TYPE (PhoshBtManager, phosh_bt_manager, PHOSH_TYPE_MANAGER);
 
+typedef struct {
+  PhoshBtManager  *manager;
+  BluetoothDevice *device;
+  gboolean         connectable;
+  gboolean         connected;
+} PhoshBtDeviceState;
+
 
 static void
 on_adapter_setup_mode_changed (PhoshBtManager *self)
@@ -232,7 +244,12 @@ phosh_bt_manager_dispose (GObject *object)
   PhoshBtManager *self = PHOSH_BT_MANAGER (object);
 
   g_clear_object (&self->proxy);
+  if (self->bt_client)
+    g_signal_handlers_disconnect_by_data (self->bt_client, self);
+  g_queue_clear (&self->connected);
+  g_clear_pointer (&self->device_states, g_hash_table_destroy);
   g_clear_object (&self->connectable_devices);
+  g_clear_object (&self->devices);
   g_clear_object (&self->bt_client);
 
   g_clear_pointer (&self->info, g_free);
@@ -327,36 +344,24 @@ filter_devices (gpointer item, gpointer data)
 
 
 static void
-refilter_cb (PhoshBtManager *self)
+device_state_free (PhoshBtDeviceState *state)
 {
-  g_assert (PHOSH_IS_BT_MANAGER (self));
-
-  gtk_filter_list_model_refilter (self->connectable_devices);
+  g_signal_handlers_disconnect_by_data (state->device, state->manager);
+  g_object_unref (state->device);
+  g_free (state);
 }
 
 
 static void
-recount_cb (PhoshBtManager *self)
+update_counts (PhoshBtManager *self)
 {
+  PhoshBtDeviceState *last;
   g_autofree char *last_info = NULL;
-  guint n_devices, n_connected = 0;
-
-  g_assert (PHOSH_IS_BT_MANAGER (self));
-
-  n_devices = g_list_model_get_n_items (G_LIST_MODEL (self->connectable_devices));
-  for (int i = 0; i < n_devices; i++) {
-    g_autoptr (BluetoothDevice) device = NULL;
-    g_autofree char *info = NULL;
-    gboolean connected;
+  guint n_devices, n_connected;
 
-    device = g_list_model_get_item (G_LIST_MODEL (self->connectable_devices), i);
-    g_object_get (device, "connected", &connected, "alias", &info, NULL);
-
-    if (connected) {
-      n_connected++;
-      last_info = g_steal_pointer (&info);
-    }
-  }
+  last = g_queue_peek_tail (&self->connected);
+  if (last)
+    g_object_get (last->device, "alias", &last_info, NULL);
 
   if (g_strcmp0 (self->info, last_info)) {
     g_debug ("New info: %s", last_info);
@@ -365,12 +370,14 @@ recount_cb (PhoshBtManager *self)
     g_object_notify_by_pspec (G_OBJECT (self), props[PROP_INFO]);
   }
 
+  n_connected = g_queue_get_length (&self->connected);
   if (self->n_connected != n_connected) {
     g_debug ("%d Bluetooth devices connected", n_connected);
     self->n_connected = n_connected;
     g_object_notify_by_pspec (G_OBJECT (self), props[PROP_N_CONNECTED]);
   }
 
+  n_devices = g_list_model_get_n_items (G_LIST_MODEL (self->connectable_devices));
   if (self->n_devices != n_devices) {
     g_debug ("%d Bluetooth devices", n_devices);
     self->n_devices = n_devices;
@@ -378,38 +385,146 @@ recount_cb (PhoshBtManager *self)
   }
 }
 
+/* Only connectable devices are accounted as connected */
+static void
+set_device_state (PhoshBtManager     *self,
+                  PhoshBtDeviceState *state,
+                  gboolean            connectable,
+                  gboolean            connected)
+{
+  gboolean was_counted = state->connectable && state->connected;
+  gboolean counted = connectable && connected;
+
+  state->connectable = connectable;
+  state->connected = connected;
+
+  if (was_counted == counted)
+    return;
+
+  if (counted)
+    g_queue_push_tail (&self->connected, state);
+  else
+    g_queue_remove (&self->connected, state);
+}
+
+
+static void
+on_device_connectable_changed (PhoshBtManager *self, GParamSpec *pspec, BluetoothDevice *device)
+{
+  PhoshBtDeviceState *state;
+  gboolean connectable;
+  guint pos;
+
+  g_assert (PHOSH_IS_BT_MANAGER (self));
+
+  state = g_hash_table_lookup (self->device_states, bluetooth_device_get_object_path (device));
+  g_return_if_fail (state);
+
+  g_object_get (device, "connectable", &connectable, NULL);
+  if (state->connectable == connectable)
+    return;
+
+  /* Only re-evaluate the affected item */
+  if (g_list_store_find (self->devices, device, &pos))
+    gtk_filter_list_model_refilter_item (self->connectable_devices, pos);
+
+  set_device_state (self, state, connectable, state->connected);
+  update_counts (self);
+}
+
+
+static void
+on_device_connected_changed (PhoshBtManager *self, GParamSpec *pspec, BluetoothDevice *device)
+{
+  PhoshBtDeviceState *state;
+  gboolean connected;
+
+  g_assert (PHOSH_IS_BT_MANAGER (self));
+
+  state = g_hash_table_lookup (self->device_states, bluetooth_device_get_object_path (device));
+  g_return_if_fail (state);
+
+  g_object_get (device, "connected", &connected, NULL);
+  if (state->connected == connected)
+    return;
+
+  set_device_state (self, state, state->connectable, connected);
+  update_counts (self);
+}
+
+
+static void
+on_device_alias_changed (PhoshBtManager *self, GParamSpec *pspec, BluetoothDevice *device)
+{
+  PhoshBtDeviceState *last;
+
+  g_assert (PHOSH_IS_BT_MANAGER (self));
+
+  last = g_queue_peek_tail (&self->connected);
+  if (last && last->device == device)
+    update_counts (self);
+}
+
 
 static void
 on_device_added (PhoshBtManager *self, BluetoothDevice *device)
 {
+  PhoshBtDeviceState *state;
+  gboolean connectable, connected;
+
   g_assert (PHOSH_IS_BT_MANAGER (self));
   g_assert (BLUETOOTH_IS_DEVICE (device));
 
-  g_signal_connect_swapped (device, "notify::connectable", G_CALLBACK (refilter_cb), self);
-  g_signal_connect_swapped (device, "notify::connected", G_CALLBACK (recount_cb), self);
-
-  refilter_cb (self);
-  recount_cb (self);
+  state = g_new0 (PhoshBtDeviceState, 1);
+  state->manager = self;
+  state->device = g_object_ref (device);
+  g_hash_table_replace (self->device_states,
+                        g_strdup (bluetooth_device_get_object_path (device)),
+                        state);
+
+  g_object_get (device, "connectable", &connectable, "connected", &connected, NULL);
+  set_device_state (self, state, connectable, connected);
+
+  g_signal_connect_object (device, "notify::connectable",
+                           G_CALLBACK (on_device_connectable_changed), self,
+                           G_CONNECT_SWAPPED);
+  g_signal_connect_object (device, "notify::connected",
+                           G_CALLBACK (on_device_connected_changed), self,
+                           G_CONNECT_SWAPPED);
+  g_signal_connect_object (device, "notify::alias",
+                           G_CALLBACK (on_device_alias_changed), self,
+                           G_CONNECT_SWAPPED);
+
+  update_counts (self);
 }
 
 
 static void
-on_device_removed (PhoshBtManager *self, BluetoothDevice *device)
+on_device_removed (PhoshBtManager *self, const char *object_path)
 {
-  refilter_cb (self);
-  recount_cb (self);
+  PhoshBtDeviceState *state;
+
+  g_assert (PHOSH_IS_BT_MANAGER (self));
+
+  state = g_hash_table_lookup (self->device_states, object_path);
+  if (state == NULL)
+    return;
+
+  set_device_state (self, state, FALSE, FALSE);
+  g_hash_table_remove (self->device_states, object_path);
+
+  update_counts (self);
 }
 
 
 static void
 setup_devices (PhoshBtManager *self)
 {
-  g_autoptr (GListStore) devices = NULL;
   guint n_items;
 
   /* Keep a list of connectable devices */
-  devices = bluetooth_client_get_devices (self->bt_client);
-  self->connectable_devices = gtk_filter_list_model_new (G_LIST_MODEL (devices),
+  self->devices = bluetooth_client_get_devices (self->bt_client);
+  self->connectable_devices = gtk_filter_list_model_new (G_LIST_MODEL (self->devices),
                                                          filter_devices,
                                                          self,
                                                          NULL);
@@ -419,15 +534,15 @@ setup_devices (PhoshBtManager *self)
                     NULL);
 
   /* cold plug existing devices */
-  n_items = g_list_model_get_n_items (G_LIST_MODEL (devices));
+  n_items = g_list_model_get_n_items (G_LIST_MODEL (self->devices));
   for (int i = 0; i < n_items; i++) {
     g_autoptr (BluetoothDevice) device = NULL;
 
-    device = g_list_model_get_item (G_LIST_MODEL (devices), i);
+    device = g_list_model_get_item (G_LIST_MODEL (self->devices), i);
     on_device_added (self, device);
   }
 
-  recount_cb (self);
+  update_counts (self);
 }
 
 
@@ -436,6 +551,12 @@ phosh_bt_manager_init (PhoshBtManager *self)
 {
   self->icon_name = "bluetooth-disabled-symbolic";
 
+  self->device_states = g_hash_table_new_full (g_str_hash,
+                                               g_str_equal,
+                                               g_free,
+                                               (GDestroyNotify) device_state_free);
+  g_queue_init (&self->connected);
+
   self->bt_client = bluetooth_client_new ();
   g_object_connect (self->bt_client,
                     "swapped-signal::notify::default-adapter-state",
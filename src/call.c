@@ -9,6 +9,7 @@
 #define G_LOG_DOMAIN "phosh-call"
 
 #include "call.h"
+#include "clock-ticker.h"
 #include "util.h"
 
 #include <gmobile.h>
@@ -54,7 +55,7 @@ typedef struct _PhoshCall {
 
   GTimer             *timer;
   gdouble             active_time;
-  guint               timer_id;
+  guint               tick_id;
 } PhoshCall;
 
 
@@ -160,15 +161,22 @@ on_prop_changed (PhoshCall *self, GParamSpec *pspec)
 }
 
 
-static gboolean
+static void
 on_active_time_ticked (gpointer data)
 {
   PhoshCall *self = PHOSH_CALL (data);
 
   self->active_time = g_timer_elapsed (self->timer, NULL);
   g_object_notify_by_pspec (G_OBJECT (self), props[PROP_ACTIVE_TIME]);
+}
 
-  return G_SOURCE_CONTINUE;
+
+static void
+phosh_call_stop_ticking (PhoshCall *self)
+{
+  if (self->tick_id)
+    phosh_clock_ticker_unsubscribe (phosh_clock_ticker_get_default (), self->tick_id);
+  self->tick_id = 0;
 }
 
 
@@ -184,10 +192,13 @@ on_state_changed (PhoshCall *self)
   if (cui_call_get_state (CUI_CALL (self)) == CUI_CALL_STATE_ACTIVE &&
       !self->timer) {
     self->timer = g_timer_new ();
-    self->timer_id = g_timeout_add (500, on_active_time_ticked, self);
-    g_source_set_name_by_id (self->timer_id, "[phosh] call timeout");
+    self->tick_id = phosh_clock_ticker_subscribe (phosh_clock_ticker_get_default (),
+                                                  PHOSH_CLOCK_TICKER_GRANULARITY_SECOND,
+                                                  NULL,
+                                                  on_active_time_ticked,
+                                                  self);
   } else if (cui_call_get_state (CUI_CALL (self)) == CUI_CALL_STATE_DISCONNECTED) {
-    g_clear_handle_id (&self->timer_id, g_source_remove);
+    phosh_call_stop_ticking (self);
     g_clear_pointer (&self->timer, g_timer_destroy);
   }
 
@@ -304,7 +315,7 @@ phosh_call_dispose (GObject *object)
   g_signal_handlers_disconnect_by_data (self->proxy, self);
   g_clear_object (&self->proxy);
   g_clear_object (&self->avatar_icon);
-  g_clear_handle_id (&self->timer_id, g_source_remove);
+  phosh_call_stop_ticking (self);
   g_clear_pointer (&self->timer, g_timer_destroy);
 
   G_OBJECT_CLASS (phosh_call_parent_class)->dispose (object);
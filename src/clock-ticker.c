@@ -0,0 +1,366 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#define G_LOG_DOMAIN "phosh-clock-ticker"
+
+#include "phosh-config.h"
+
+#include "clock-ticker.h"
+#include "watchdog.h"
+
+/**
+ * PhoshClockTicker:
+ *
+ * Shell wide clock ticks aligned to wall clock boundaries
+ *
+ * Consumers that need to update periodically (e.g. relative timestamps
+ * or call durations) subscribe with a granularity instead of arming
+ * their own timers. All ticks are aligned to full seconds or minutes of
+ * the wall clock and share a single timer so many subscribers only wake
+ * up the main loop once per period.
+ *
+ * Subscriptions bound to a widget are paused while the widget isn't
+ * mapped. All subscriptions are paused while the ticker is paused
+ * (e.g. when the screen is blanked). When a subscription resumes it
+ * gets an immediate tick so it can catch up.
+ */
+
+typedef struct {
+  guint                        id;
+  PhoshClockTicker            *ticker;
+  PhoshClockTickerGranularity  granularity;
+  PhoshClockTickerFunc         func;
+  gpointer                     user_data;
+
+  GtkWidget                   *widget;
+  gulong                       map_id;
+  gulong                       unmap_id;
+  gulong                       destroy_id;
+} PhoshClockTickerSub;
+
+
+struct _PhoshClockTicker {
+  GObject     parent;
+
+  /* key: subscription id, value: PhoshClockTickerSub */
+  GHashTable *subs;
+  guint       last_id;
+
+  gboolean    paused;
+  guint       timer_id;
+  GTimeSpan   period;
+  gint64      last_minute;
+  guint       n_wakeups;
+};
+G_DEFINE_TYPE (PhoshClockTicker, phosh_clock_ticker, G_TYPE_OBJECT)
+
+
+static void update_timer (PhoshClockTicker *self);
+
+
+static gboolean
+sub_is_active (PhoshClockTicker *self, PhoshClockTickerSub *sub)
+{
+  if (self->paused)
+    return FALSE;
+
+  return sub->widget == NULL || gtk_widget_get_mapped (sub->widget);
+}
+
+
+static void
+dispatch (PhoshClockTicker *self, gboolean second, gboolean minute)
+{
+  g_autoptr (GArray) ids = g_array_new (FALSE, FALSE, sizeof (guint));
+  GHashTableIter iter;
+  PhoshClockTickerSub *sub;
+
+  /* Subscribers might (un)subscribe from their callback */
+  g_hash_table_iter_init (&iter, self->subs);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *)&sub)) {
+    if (!sub_is_active (self, sub))
+      continue;
+
+    if ((sub->granularity == PHOSH_CLOCK_TICKER_GRANULARITY_SECOND && second) ||
+        (sub->granularity == PHOSH_CLOCK_TICKER_GRANULARITY_MINUTE && minute)) {
+      g_array_append_val (ids, sub->id);
+    }
+  }
+
+  for (guint i = 0; i < ids->len; i++) {
+    guint id = g_array_index (ids, guint, i);
+
+    sub = g_hash_table_lookup (self->subs, GUINT_TO_POINTER (id));
+    if (sub)
+      sub->func (sub->user_data);
+  }
+}
+
+
+static gboolean
+on_timer_expired (gpointer data)
+{
+  PhoshClockTicker *self = PHOSH_CLOCK_TICKER (data);
+  gint64 minute = g_get_real_time () / (60 * G_USEC_PER_SEC);
+  gboolean minute_changed = minute != self->last_minute;
+
+  self->timer_id = 0;
+  self->n_wakeups++;
+  self->last_minute = minute;
+
+  dispatch (self, TRUE, minute_changed);
+  update_timer (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static void
+update_timer (PhoshClockTicker *self)
+{
+  GHashTableIter iter;
+  PhoshClockTickerSub *sub;
+  GTimeSpan period = 0;
+  gint64 now, next;
+
+  g_hash_table_iter_init (&iter, self->subs);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *)&sub)) {
+    if (!sub_is_active (self, sub))
+      continue;
+
+    if (sub->granularity == PHOSH_CLOCK_TICKER_GRANULARITY_SECOND) {
+      period = G_USEC_PER_SEC;
+      break;
+    }
+    period = 60 * G_USEC_PER_SEC;
+  }
+
+  if (period == self->period && self->timer_id)
+    return;
+
+  g_clear_handle_id (&self->timer_id, g_source_remove);
+  self->period = period;
+
+  if (period == 0)
+    return;
+
+  /* Wake up right after the next boundary */
+  now = g_get_real_time ();
+  next = (now / period + 1) * period;
+  self->timer_id = phosh_watchdog_timeout_add ((next - now) / 1000 + 1, on_timer_expired, self,
+                                               "[phosh] clock ticker");
+}
+
+
+static void
+on_widget_mapped (PhoshClockTickerSub *sub)
+{
+  if (sub->ticker->paused)
+    return;
+
+  /* Catch up on ticks missed while unmapped */
+  sub->func (sub->user_data);
+  update_timer (sub->ticker);
+}
+
+
+static void
+on_widget_unmapped (PhoshClockTickerSub *sub)
+{
+  update_timer (sub->ticker);
+}
+
+
+static void
+on_widget_destroyed (PhoshClockTickerSub *sub)
+{
+  g_debug ("Widget %p destroyed, dropping subscription %u", sub->widget, sub->id);
+
+  phosh_clock_ticker_unsubscribe (sub->ticker, sub->id);
+}
+
+
+static void
+phosh_clock_ticker_sub_free (PhoshClockTickerSub *sub)
+{
+  if (sub->widget) {
+    g_clear_signal_handler (&sub->map_id, sub->widget);
+    g_clear_signal_handler (&sub->unmap_id, sub->widget);
+    g_clear_signal_handler (&sub->destroy_id, sub->widget);
+  }
+  g_free (sub);
+}
+
+
+static void
+phosh_clock_ticker_finalize (GObject *object)
+{
+  PhoshClockTicker *self = PHOSH_CLOCK_TICKER (object);
+
+  g_clear_handle_id (&self->timer_id, g_source_remove);
+  g_clear_pointer (&self->subs, g_hash_table_destroy);
+
+  G_OBJECT_CLASS (phosh_clock_ticker_parent_class)->finalize (object);
+}
+
+
+static void
+phosh_clock_ticker_class_init (PhoshClockTickerClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = phosh_clock_ticker_finalize;
+}
+
+
+static void
+phosh_clock_ticker_init (PhoshClockTicker *self)
+{
+  self->subs = g_hash_table_new_full (g_direct_hash,
+                                      g_direct_equal,
+                                      NULL,
+                                      (GDestroyNotify) phosh_clock_ticker_sub_free);
+  self->last_minute = g_get_real_time () / (60 * G_USEC_PER_SEC);
+}
+
+/**
+ * phosh_clock_ticker_get_default:
+ *
+ * Gets the clock ticker singleton.
+ *
+ * Returns:(transfer none): The clock ticker singleton.
+ */
+PhoshClockTicker *
+phosh_clock_ticker_get_default (void)
+{
+  static PhoshClockTicker *instance;
+
+  if (instance == NULL) {
+    g_debug ("Creating clock ticker");
+    instance = g_object_new (PHOSH_TYPE_CLOCK_TICKER, NULL);
+    g_object_add_weak_pointer (G_OBJECT (instance), (gpointer *)&instance);
+  }
+  return instance;
+}
+
+/**
+ * phosh_clock_ticker_subscribe:
+ * @self: The clock ticker
+ * @granularity: How often to tick
+ * @widget:(nullable): The widget displaying the data
+ * @func: The function to invoke on each tick
+ * @user_data: The data passed to @func
+ *
+ * Subscribe to clock ticks. If @widget is given ticks are only delivered
+ * while it is mapped and the subscription is dropped when it is destroyed.
+ *
+ * Returns: The subscription id to pass to `phosh_clock_ticker_unsubscribe()`
+ */
+guint
+phosh_clock_ticker_subscribe (PhoshClockTicker            *self,
+                              PhoshClockTickerGranularity  granularity,
+                              GtkWidget                   *widget,
+                              PhoshClockTickerFunc         func,
+                              gpointer                     user_data)
+{
+  PhoshClockTickerSub *sub;
+
+  g_return_val_if_fail (PHOSH_IS_CLOCK_TICKER (self), 0);
+  g_return_val_if_fail (widget == NULL || GTK_IS_WIDGET (widget), 0);
+  g_return_val_if_fail (func, 0);
+
+  sub = g_new0 (PhoshClockTickerSub, 1);
+  sub->id = ++self->last_id;
+  sub->ticker = self;
+  sub->granularity = granularity;
+  sub->func = func;
+  sub->user_data = user_data;
+
+  if (widget) {
+    sub->widget = widget;
+    /* Run after the default handlers so the mapped state is updated */
+    sub->map_id = g_signal_connect_data (widget, "map", G_CALLBACK (on_widget_mapped), sub,
+                                         NULL, G_CONNECT_SWAPPED | G_CONNECT_AFTER);
+    sub->unmap_id = g_signal_connect_data (widget, "unmap", G_CALLBACK (on_widget_unmapped), sub,
+                                           NULL, G_CONNECT_SWAPPED | G_CONNECT_AFTER);
+    sub->destroy_id = g_signal_connect_swapped (widget, "destroy",
+                                                G_CALLBACK (on_widget_destroyed), sub);
+  }
+
+  g_hash_table_insert (self->subs, GUINT_TO_POINTER (sub->id), sub);
+  update_timer (self);
+
+  return sub->id;
+}
+
+/**
+ * phosh_clock_ticker_unsubscribe:
+ * @self: The clock ticker
+ * @id: The subscription id
+ *
+ * Stop receiving clock ticks.
+ */
+void
+phosh_clock_ticker_unsubscribe (PhoshClockTicker *self, guint id)
+{
+  g_return_if_fail (PHOSH_IS_CLOCK_TICKER (self));
+  g_return_if_fail (id > 0);
+
+  g_hash_table_remove (self->subs, GUINT_TO_POINTER (id));
+  update_timer (self);
+}
+
+/**
+ * phosh_clock_ticker_set_paused:
+ * @self: The clock ticker
+ * @paused: Whether to pause all subscriptions
+ *
+ * Pause all subscriptions e.g. while the screen is blanked. When
+ * unpausing all active subscriptions get an immediate tick.
+ */
+void
+phosh_clock_ticker_set_paused (PhoshClockTicker *self, gboolean paused)
+{
+  g_return_if_fail (PHOSH_IS_CLOCK_TICKER (self));
+
+  if (self->paused == paused)
+    return;
+
+  g_debug ("Clock ticker %s", paused ? "paused" : "resumed");
+  self->paused = paused;
+
+  if (!paused) {
+    self->last_minute = g_get_real_time () / (60 * G_USEC_PER_SEC);
+    dispatch (self, TRUE, TRUE);
+  }
+
+  update_timer (self);
+}
+
+
+gboolean
+phosh_clock_ticker_get_paused (PhoshClockTicker *self)
+{
+  g_return_val_if_fail (PHOSH_IS_CLOCK_TICKER (self), FALSE);
+
+  return self->paused;
+}
+
+/**
+ * phosh_clock_ticker_get_n_wakeups:
+ * @self: The clock ticker
+ *
+ * Get the number of times the ticker woke up the main loop.
+ *
+ * Returns: The number of wakeups
+ */
+guint
+phosh_clock_ticker_get_n_wakeups (PhoshClockTicker *self)
+{
+  g_return_val_if_fail (PHOSH_IS_CLOCK_TICKER (self), 0);
+
+  return self->n_wakeups;
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+/**
+ * PhoshClockTickerGranularity:
+ * @PHOSH_CLOCK_TICKER_GRANULARITY_SECOND: Tick on every full second
+ * @PHOSH_CLOCK_TICKER_GRANULARITY_MINUTE: Tick on every full minute
+ *
+ * How often a subscriber wants to be notified.
+ */
+typedef enum {
+  PHOSH_CLOCK_TICKER_GRANULARITY_SECOND,
+  PHOSH_CLOCK_TICKER_GRANULARITY_MINUTE,
+} PhoshClockTickerGranularity;
+
+#define PHOSH_TYPE_CLOCK_TICKER (phosh_clock_ticker_get_type ())
+
+G_DECLARE_FINAL_TYPE (PhoshClockTicker, phosh_clock_ticker, PHOSH, CLOCK_TICKER, GObject)
+
+typedef void (*PhoshClockTickerFunc) (gpointer user_data);
+
+PhoshClockTicker *phosh_clock_ticker_get_default   (void);
+guint             phosh_clock_ticker_subscribe     (PhoshClockTicker            *self,
+                                                    PhoshClockTickerGranularity  granularity,
+                                                    GtkWidget                   *widget,
+                                                    PhoshClockTickerFunc         func,
+                                                    gpointer                     user_data);
+void              phosh_clock_ticker_unsubscribe   (PhoshClockTicker            *self,
+                                                    guint                        id);
+void              phosh_clock_ticker_set_paused    (PhoshClockTicker            *self,
+                                                    gboolean                     paused);
+gboolean          phosh_clock_ticker_get_paused    (PhoshClockTicker            *self);
+guint             phosh_clock_ticker_get_n_wakeups (PhoshClockTicker            *self);
+
+G_END_DECLS
@@ -11,8 +11,12 @@
 #include "phosh-config.h"
 
 #include "debug-control.h"
+#include "notifications/notify-manager.h"
 #include "phosh-enums.h"
 #include "shell-priv.h"
+#include "status-icon-priv.h"
+#include "timeline.h"
+#include "watchdog.h"
 
 #include <gio/gio.h>
 
@@ -46,9 +50,98 @@ G_DEFINE_TYPE_WITH_CODE (PhoshDebugControl, phosh_debug_control,
                          G_IMPLEMENT_INTERFACE (PHOSH_DBUS_TYPE_DEBUG_CONTROL,
                                                 phosh_dbus_debug_control_iface_init))
 
+static gboolean
+handle_get_timeline (PhoshDBusDebugControl *object, GDBusMethodInvocation *invocation)
+{
+  phosh_dbus_debug_control_complete_get_timeline (object, invocation, phosh_timeline_get_spans ());
+
+  return TRUE;
+}
+
+
+static gboolean
+handle_get_timeline_chrome_trace (PhoshDBusDebugControl *object,
+                                  GDBusMethodInvocation *invocation)
+{
+  g_autofree char *trace = phosh_timeline_to_chrome_trace ();
+
+  phosh_dbus_debug_control_complete_get_timeline_chrome_trace (object, invocation, trace);
+
+  return TRUE;
+}
+
+
+static gboolean
+handle_get_startup_critical_path (PhoshDBusDebugControl *object,
+                                  GDBusMethodInvocation *invocation)
+{
+  PhoshStartupScheduler *scheduler;
+  GVariant *path;
+
+  scheduler = phosh_shell_get_startup_scheduler (phosh_shell_get_default ());
+  if (scheduler)
+    path = phosh_startup_scheduler_get_critical_path (scheduler);
+  else
+    path = g_variant_new_array (G_VARIANT_TYPE ("(sxx)"), NULL, 0);
+
+  phosh_dbus_debug_control_complete_get_startup_critical_path (object, invocation, path);
+
+  return TRUE;
+}
+
+
+static gboolean
+handle_get_watchdog_stats (PhoshDBusDebugControl *object, GDBusMethodInvocation *invocation)
+{
+  phosh_dbus_debug_control_complete_get_watchdog_stats (object, invocation,
+                                                        phosh_watchdog_get_stats ());
+
+  return TRUE;
+}
+
+
+static gboolean
+handle_reset_watchdog_stats (PhoshDBusDebugControl *object, GDBusMethodInvocation *invocation)
+{
+  phosh_watchdog_reset ();
+  phosh_dbus_debug_control_complete_reset_watchdog_stats (object, invocation);
+
+  return TRUE;
+}
+
+
+static gboolean
+handle_get_notification_stats (PhoshDBusDebugControl *object, GDBusMethodInvocation *invocation)
+{
+  PhoshNotifyManager *manager = phosh_notify_manager_get_default ();
+
+  phosh_dbus_debug_control_complete_get_notification_stats (object, invocation,
+                                                            phosh_notify_manager_get_stats (manager));
+
+  return TRUE;
+}
+
+
+static gboolean
+handle_get_status_icon_stats (PhoshDBusDebugControl *object, GDBusMethodInvocation *invocation)
+{
+  phosh_dbus_debug_control_complete_get_status_icon_stats (object, invocation,
+                                                           phosh_status_icon_get_update_stats ());
+
+  return TRUE;
+}
+
+
 static void
 phosh_dbus_debug_control_iface_init (PhoshDBusDebugControlIface *iface)
 {
+  iface->handle_get_notification_stats = handle_get_notification_stats;
+  iface->handle_get_startup_critical_path = handle_get_startup_critical_path;
+  iface->handle_get_status_icon_stats = handle_get_status_icon_stats;
+  iface->handle_get_timeline = handle_get_timeline;
+  iface->handle_get_timeline_chrome_trace = handle_get_timeline_chrome_trace;
+  iface->handle_get_watchdog_stats = handle_get_watchdog_stats;
+  iface->handle_reset_watchdog_stats = handle_reset_watchdog_stats;
 }
 
 
@@ -71,6 +164,18 @@ on_bus_acquired (GDBusConnection *connection, const char *name, gpointer user_da
 }
 
 
+static void
+on_watchdog_threshold_changed (PhoshDebugControl *self)
+{
+  guint threshold = phosh_dbus_debug_control_get_watchdog_threshold (PHOSH_DBUS_DEBUG_CONTROL (self));
+
+  if (threshold)
+    phosh_watchdog_start (threshold);
+  else
+    phosh_watchdog_stop ();
+}
+
+
 static void
 phosh_debug_control_set_property (GObject      *object,
                                   guint         property_id,
@@ -150,6 +255,13 @@ phosh_debug_control_init (PhoshDebugControl *self)
                           self,
                           "log-domains",
                           G_BINDING_SYNC_CREATE | G_BINDING_BIDIRECTIONAL);
+
+  phosh_dbus_debug_control_set_watchdog_threshold (PHOSH_DBUS_DEBUG_CONTROL (self),
+                                                   phosh_watchdog_get_threshold ());
+  g_signal_connect (self,
+                    "notify::watchdog-threshold",
+                    G_CALLBACK (on_watchdog_threshold_changed),
+                    NULL);
 }
 
 
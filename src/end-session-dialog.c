@@ -16,6 +16,7 @@
 #include "phosh-config.h"
 #include "end-session-dialog.h"
 #include "util.h"
+#include "watchdog.h"
 
 #include <gmobile.h>
 
@@ -147,8 +148,8 @@ static void
 maybe_start_timer (PhoshEndSessionDialog *self)
 {
   if (self->timeout_id == 0 && self->timeout) {
-    self->timeout_id = g_timeout_add_seconds (1, end_session_dialog_timeout, self);
-    g_source_set_name_by_id (self->timeout_id, "[phosh] end_session_dialog_timeout");
+    self->timeout_id = phosh_watchdog_timeout_add_seconds (1, end_session_dialog_timeout, self,
+                                                           "[phosh] end_session_dialog_timeout");
   }
 }
 
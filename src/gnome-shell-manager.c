@@ -43,6 +43,10 @@ typedef struct _PhoshGnomeShellManager {
   PhoshDBusGnomeShellSkeleton parent;
 
   GHashTable                 *info_by_action;
+  /* key: normalized accelerator, value: AcceleratorBinding */
+  GHashTable                 *bindings;
+  /* key: action name, value: AcceleratorBinding */
+  GHashTable                 *binding_by_action;
   guint                       last_action_id;
   int                         dbus_name_id;
   PhoshShellActionMode        action_mode;
@@ -51,6 +55,9 @@ typedef struct _PhoshGnomeShellManager {
   gboolean                    do_repeat;
   guint                       repeat_delay_ms;
   guint                       repeat_interval_ms;
+  GSource                    *repeat_source;
+  /* The binding currently held down and repeating */
+  struct _AcceleratorBinding *repeat_binding;
 
   gboolean                    overview_active;
 } PhoshGnomeShellManager;
@@ -64,38 +71,128 @@ G_DEFINE_TYPE_WITH_CODE (PhoshGnomeShellManager,
 
 static void accelerator_activated_action (GSimpleAction *action, GVariant *param, gpointer data);
 
+/* A grab of an accelerator by a DBus client */
 typedef struct _AcceleratorInfo {
   guint                            action_id;
   char                            *accelerator;
   char                            *sender;
   guint                            mode_flags;
   guint                            grab_flags;
-  guint                            repeat_id;
+  struct _AcceleratorBinding      *binding;
 } AcceleratorInfo;
 
+/* An installed keybinding, shared by all grabs of the same accelerator */
+typedef struct _AcceleratorBinding {
+  char                            *key;
+  char                            *action_name;
+  /* element-type: AcceleratorInfo */
+  GPtrArray                       *infos;
+  gboolean                         installed;
+} AcceleratorBinding;
+
+
 static void
-remove_action_entries (char *accelerator)
+remove_action_entries (GStrv action_names)
 {
-  GStrv action_names = (char*[]){ accelerator, NULL };
-
   phosh_shell_remove_global_keyboard_action_entries (phosh_shell_get_default (),
                                                      action_names);
 }
 
 
 static void
-free_accelerator_info_from_hash_table (gpointer data)
+accelerator_info_free (gpointer data)
 {
   AcceleratorInfo *info = (AcceleratorInfo *) data;
   g_return_if_fail (info != NULL);
 
-  remove_action_entries (info->accelerator);
-  g_clear_handle_id (&info->repeat_id, g_source_remove);
   g_free (info->accelerator);
   g_free (info->sender);
   g_free (info);
 }
 
+
+static void
+accelerator_binding_free (AcceleratorBinding *binding)
+{
+  g_free (binding->key);
+  g_free (binding->action_name);
+  g_ptr_array_free (binding->infos, TRUE);
+  g_free (binding);
+}
+
+
+static void
+free_accelerator_binding_from_hash_table (gpointer data)
+{
+  AcceleratorBinding *binding = data;
+
+  if (binding->installed)
+    remove_action_entries ((char *[]){ binding->action_name, NULL });
+
+  accelerator_binding_free (binding);
+}
+
+
+static char *
+get_binding_key (const char *accelerator)
+{
+  guint keyval;
+  GdkModifierType mods;
+
+  /* Different spellings of the same keysym and modifiers share a binding */
+  gtk_accelerator_parse (accelerator, &keyval, &mods);
+  if (keyval == 0 && mods == 0)
+    return g_strdup (accelerator);
+
+  return gtk_accelerator_name (keyval, mods);
+}
+
+
+static void
+stop_repeat (PhoshGnomeShellManager *self)
+{
+  self->repeat_binding = NULL;
+  g_source_set_ready_time (self->repeat_source, -1);
+}
+
+
+/*
+ * Detach a grab from its binding. If it was the last grab of the
+ * binding the binding's action name is added to stale_actions so
+ * callers can remove all of them at once.
+ */
+static void
+ungrab_info (PhoshGnomeShellManager *self, AcceleratorInfo *info, GPtrArray *stale_actions)
+{
+  AcceleratorBinding *binding = info->binding;
+
+  g_ptr_array_remove_fast (binding->infos, info);
+  g_hash_table_remove (self->info_by_action, GUINT_TO_POINTER (info->action_id));
+
+  if (binding->infos->len)
+    return;
+
+  if (self->repeat_binding == binding)
+    stop_repeat (self);
+
+  g_hash_table_remove (self->binding_by_action, binding->action_name);
+  g_hash_table_steal (self->bindings, binding->key);
+  if (binding->installed)
+    g_ptr_array_add (stale_actions, g_steal_pointer (&binding->action_name));
+  accelerator_binding_free (binding);
+}
+
+
+static void
+remove_stale_actions (GPtrArray *stale_actions)
+{
+  if (stale_actions->len == 0)
+    return;
+
+  g_ptr_array_add (stale_actions, NULL);
+  remove_action_entries ((GStrv) stale_actions->pdata);
+}
+
 /* DBus handlers */
 static gboolean
 handle_show_monitor_labels (PhoshDBusGnomeShell   *skeleton,
@@ -163,30 +260,30 @@ handle_show_osd (PhoshDBusGnomeShell   *skeleton,
 }
 
 
-static guint
+static AcceleratorInfo *
 grab_single_accelerator (PhoshGnomeShellManager *self,
                          const char             *accelerator,
                          guint                   mode_flags,
                          guint                   grab_flags,
                          const char             *sender,
+                         GArray                 *new_entries,
                          GError                **error)
 {
   AcceleratorInfo *info;
-  const GActionEntry action_entries[] = {
-    { .name = accelerator, .activate = accelerator_activated_action, "b" },
-  };
+  AcceleratorBinding *binding;
+  g_autofree char *key = NULL;
 
   g_assert (PHOSH_IS_GNOME_SHELL_MANAGER (self));
 
   if (self->last_action_id == G_MAXUINT) {
     g_set_error (error, G_IO_ERROR, G_IO_ERROR_ADDRESS_IN_USE, "All action ids taken");
-    return 0;
+    return NULL;
   }
 
   /* this should never happen */
   if (g_hash_table_contains (self->info_by_action, GUINT_TO_POINTER (self->last_action_id + 1))) {
     g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED, "action id %d already taken", self->last_action_id + 1);
-    return 0;
+    return NULL;
   }
 
   info = g_new0 (AcceleratorInfo, 1);
@@ -199,22 +296,51 @@ grab_single_accelerator (PhoshGnomeShellManager *self,
   g_debug ("Using action id %d for accelerator %s", info->action_id, info->accelerator);
   g_hash_table_insert (self->info_by_action, GUINT_TO_POINTER (info->action_id), info);
 
-  if (g_strcmp0 (accelerator, "XF86PowerOff")) {
-    phosh_shell_add_global_keyboard_action_entries (phosh_shell_get_default (),
-                                                    action_entries,
-                                                    G_N_ELEMENTS (action_entries),
-                                                    info);
-  } else {
-    /*
-     * FIXME: Don't allow binding of power keys so we can blank the screen
-     * See https://gitlab.gnome.org/GNOME/gnome-settings-daemon/-/issues/703
-     * We don't return an error as we want g-s-d to handle all the other keys
-     */
-    g_debug ("Skipping power key grab");
+  key = get_binding_key (accelerator);
+  binding = g_hash_table_lookup (self->bindings, key);
+  if (binding == NULL) {
+    binding = g_new0 (AcceleratorBinding, 1);
+    binding->key = g_steal_pointer (&key);
+    binding->action_name = g_strdup (accelerator);
+    binding->infos = g_ptr_array_new ();
+    g_hash_table_insert (self->bindings, binding->key, binding);
+    g_hash_table_insert (self->binding_by_action, binding->action_name, binding);
+
+    if (g_strcmp0 (accelerator, "XF86PowerOff")) {
+      GActionEntry entry = { .name = binding->action_name,
+                             .activate = accelerator_activated_action,
+                             .parameter_type = "b" };
+
+      /* Installed by the caller together with the other new bindings */
+      g_array_append_val (new_entries, entry);
+      binding->installed = TRUE;
+    } else {
+      /*
+       * FIXME: Don't allow binding of power keys so we can blank the screen
+       * See https://gitlab.gnome.org/GNOME/gnome-settings-daemon/-/issues/703
+       * We don't return an error as we want g-s-d to handle all the other keys
+       */
+      g_debug ("Skipping power key grab");
+    }
   }
+  g_ptr_array_add (binding->infos, info);
+  info->binding = binding;
 
   g_assert (info->action_id > 0);
-  return info->action_id;
+  return info;
+}
+
+
+static void
+install_action_entries (PhoshGnomeShellManager *self, GArray *new_entries)
+{
+  if (new_entries->len == 0)
+    return;
+
+  phosh_shell_add_global_keyboard_action_entries (phosh_shell_get_default (),
+                                                  (GActionEntry *) new_entries->data,
+                                                  new_entries->len,
+                                                  self);
 }
 
 
@@ -226,22 +352,24 @@ handle_grab_accelerator (PhoshDBusGnomeShell   *skeleton,
                          guint                  arg_grabFlags)
 {
   PhoshGnomeShellManager *self = PHOSH_GNOME_SHELL_MANAGER (skeleton);
+  g_autoptr (GArray) new_entries = g_array_new (FALSE, FALSE, sizeof (GActionEntry));
   g_autoptr (GError) error = NULL;
+  AcceleratorInfo *info;
   const char *sender;
-  guint action_id;
 
   g_return_val_if_fail (PHOSH_IS_GNOME_SHELL_MANAGER (self), FALSE);
   g_debug ("DBus grab accelerator %s", arg_accelerator);
 
   sender = g_dbus_method_invocation_get_sender (invocation);
 
-  action_id = grab_single_accelerator (self,
-                                       arg_accelerator,
-                                       arg_modeFlags,
-                                       arg_grabFlags,
-                                       sender,
-                                       &error);
-  if (action_id == 0) {
+  info = grab_single_accelerator (self,
+                                  arg_accelerator,
+                                  arg_modeFlags,
+                                  arg_grabFlags,
+                                  sender,
+                                  new_entries,
+                                  &error);
+  if (info == NULL) {
     g_warning ("Error trying to grab accelerator %s: %s", arg_accelerator, error->message);
     g_dbus_method_invocation_return_error (invocation,
                                            error->domain,
@@ -250,9 +378,10 @@ handle_grab_accelerator (PhoshDBusGnomeShell   *skeleton,
                                            error->message);
     return TRUE;
   }
+  install_action_entries (self, new_entries);
 
   phosh_dbus_gnome_shell_complete_grab_accelerator (
-    skeleton, invocation, action_id);
+    skeleton, invocation, info->action_id);
 
   return TRUE;
 }
@@ -264,6 +393,8 @@ handle_grab_accelerators (PhoshDBusGnomeShell   *skeleton,
                           GVariant              *arg_accelerators)
 {
   PhoshGnomeShellManager *self = PHOSH_GNOME_SHELL_MANAGER (skeleton);
+  g_autoptr (GArray) new_entries = g_array_new (FALSE, FALSE, sizeof (GActionEntry));
+  g_autoptr (GPtrArray) infos = NULL;
   g_autoptr (GVariantBuilder) builder = NULL;
   g_autoptr (GVariantIter) arg_iter = NULL;
   char *accelerator_name;
@@ -271,13 +402,24 @@ handle_grab_accelerators (PhoshDBusGnomeShell   *skeleton,
   guint accelerator_grab_flags;
   g_autoptr (GError) error = NULL;
   const char *sender;
-  gboolean conflict = FALSE;
+  gsize n;
 
   g_return_val_if_fail (PHOSH_IS_GNOME_SHELL_MANAGER (self), FALSE);
-  g_debug ("DBus grab accelerators");
+
+  n = g_variant_n_children (arg_accelerators);
+  g_debug ("DBus grab %" G_GSIZE_FORMAT " accelerators", n);
+
+  if (n > G_MAXUINT - self->last_action_id) {
+    g_dbus_method_invocation_return_error (invocation,
+                                           G_IO_ERROR,
+                                           G_IO_ERROR_ADDRESS_IN_USE,
+                                           "All action ids taken");
+    return TRUE;
+  }
 
   sender = g_dbus_method_invocation_get_sender (invocation);
 
+  infos = g_ptr_array_sized_new (n);
   builder = g_variant_builder_new (G_VARIANT_TYPE ("au"));
   g_variant_get (arg_accelerators, "a(suu)", &arg_iter);
 
@@ -285,42 +427,40 @@ handle_grab_accelerators (PhoshDBusGnomeShell   *skeleton,
                               &accelerator_name,
                               &accelerator_mode_flags,
                               &accelerator_grab_flags)) {
-    guint action_id;
-
-    action_id = grab_single_accelerator (self,
-                                         accelerator_name,
-                                         accelerator_mode_flags,
-                                         accelerator_grab_flags,
-                                         sender,
-                                         &error);
-    if (action_id == 0) {
+    AcceleratorInfo *info;
+
+    info = grab_single_accelerator (self,
+                                    accelerator_name,
+                                    accelerator_mode_flags,
+                                    accelerator_grab_flags,
+                                    sender,
+                                    new_entries,
+                                    &error);
+    if (info == NULL) {
+      g_autoptr (GPtrArray) stale_actions = g_ptr_array_new_with_free_func (g_free);
+
       g_warning ("Error trying to grab accelerator %s: %s", accelerator_name, error->message);
       g_dbus_method_invocation_return_error (invocation,
                                              error->domain,
                                              error->code,
                                              "%s",
                                              error->message);
-      conflict = TRUE;
-      break;
+
+      /* Clean up the grabs of this batch, none of them got installed yet */
+      for (guint i = 0; i < infos->len; i++)
+        ungrab_info (self, g_ptr_array_index (infos, i), stale_actions);
+      return TRUE;
     }
 
-    g_variant_builder_add (builder, "u", action_id);
+    g_ptr_array_add (infos, info);
+    g_variant_builder_add (builder, "u", info->action_id);
   }
 
-  if (conflict) { /* clean up existing bindings */
-    g_autoptr (GVariant) unroll_ids = g_variant_builder_end (builder);
-    gsize n = g_variant_n_children (unroll_ids);
-
-    for (gsize i = 0; i < n; ++i) {
-      guint action_id;
+  /* Install all new keybindings at once */
+  install_action_entries (self, new_entries);
 
-      g_variant_get_child (unroll_ids, i, "u", &action_id);
-      g_hash_table_remove (self->info_by_action, GUINT_TO_POINTER (action_id));
-    }
-  } else { /* success */
-    phosh_dbus_gnome_shell_complete_grab_accelerators (
-      skeleton, invocation, g_variant_builder_end (builder));
-  }
+  phosh_dbus_gnome_shell_complete_grab_accelerators (
+    skeleton, invocation, g_variant_builder_end (builder));
 
   return TRUE;
 }
@@ -332,6 +472,7 @@ handle_ungrab_accelerator (PhoshDBusGnomeShell   *skeleton,
                            guint                  arg_action)
 {
   PhoshGnomeShellManager *self = PHOSH_GNOME_SHELL_MANAGER (skeleton);
+  g_autoptr (GPtrArray) stale_actions = g_ptr_array_new_with_free_func (g_free);
   AcceleratorInfo *info;
   gboolean success = FALSE;
   const char *sender;
@@ -344,13 +485,14 @@ handle_ungrab_accelerator (PhoshDBusGnomeShell   *skeleton,
 
   if (info != NULL) {
     if (g_strcmp0 (info->sender, sender) == 0) {
-      g_hash_table_remove (self->info_by_action, GUINT_TO_POINTER (info->action_id));
+      ungrab_info (self, info, stale_actions);
       success = TRUE;
     } else {
       g_debug ("Ungrab not allowed: Sender %s not allowed to ungrab (grabbed by %s)",
                sender, info->sender);
     }
   }
+  remove_stale_actions (stale_actions);
 
   phosh_dbus_gnome_shell_complete_ungrab_accelerator (
     skeleton, invocation, success);
@@ -366,6 +508,7 @@ handle_ungrab_accelerators (PhoshDBusGnomeShell   *skeleton,
 {
   gsize n;
   PhoshGnomeShellManager *self = PHOSH_GNOME_SHELL_MANAGER (skeleton);
+  g_autoptr (GPtrArray) stale_actions = g_ptr_array_new_with_free_func (g_free);
   AcceleratorInfo *info;
   gboolean success = TRUE;
   const char *sender;
@@ -391,8 +534,11 @@ handle_ungrab_accelerators (PhoshDBusGnomeShell   *skeleton,
       success = FALSE;
       continue;
     }
-    g_hash_table_remove (self->info_by_action, GUINT_TO_POINTER (info->action_id));
+    ungrab_info (self, info, stale_actions);
   }
+  /* Remove all unused keybindings at once */
+  remove_stale_actions (stale_actions);
+
   phosh_dbus_gnome_shell_complete_ungrab_accelerators (
     skeleton, invocation, success);
 
@@ -515,36 +661,49 @@ do_activate_accelerator (AcceleratorInfo *info)
 }
 
 
+static void
+activate_binding (AcceleratorBinding *binding, gboolean is_repeat)
+{
+  for (guint i = 0; i < binding->infos->len; i++) {
+    AcceleratorInfo *info = g_ptr_array_index (binding->infos, i);
+
+    if (is_repeat && (info->grab_flags & PHOSH_SHELL_KEY_BINDING_IGNORE_AUTOREPEAT))
+      continue;
+
+    do_activate_accelerator (info);
+  }
+}
+
+
 static gboolean
 on_accelerator_repeat (gpointer data)
 {
-  AcceleratorInfo *info = data;
+  PhoshGnomeShellManager *self = PHOSH_GNOME_SHELL_MANAGER (data);
 
-  g_assert (info);
-  g_assert (info->action_id);
+  if (self->repeat_binding == NULL) {
+    g_source_set_ready_time (self->repeat_source, -1);
+    return G_SOURCE_CONTINUE;
+  }
 
-  do_activate_accelerator (info);
+  activate_binding (self->repeat_binding, TRUE);
 
+  g_source_set_ready_time (self->repeat_source,
+                           g_get_monotonic_time () + self->repeat_interval_ms * 1000);
   return G_SOURCE_CONTINUE;
 }
 
 
 static gboolean
-on_accelerator_repeat_delay (gpointer data)
+binding_wants_repeat (AcceleratorBinding *binding)
 {
-  PhoshGnomeShellManager *self = phosh_gnome_shell_manager_get_default ();
-  AcceleratorInfo *info = data;
-  g_autofree char *source_name = g_strdup_printf ("[phosh] key repeat for id %u", info->action_id);
+  for (guint i = 0; i < binding->infos->len; i++) {
+    AcceleratorInfo *info = g_ptr_array_index (binding->infos, i);
 
-  g_assert (info);
-  g_assert (info->action_id);
-
-  do_activate_accelerator (info);
-
-  info->repeat_id = g_timeout_add (self->repeat_interval_ms, on_accelerator_repeat, info);
-  g_source_set_name_by_id (info->repeat_id, source_name);
+    if ((info->grab_flags & PHOSH_SHELL_KEY_BINDING_IGNORE_AUTOREPEAT) == 0)
+      return TRUE;
+  }
 
-  return G_SOURCE_REMOVE;
+  return FALSE;
 }
 
 
@@ -553,27 +712,31 @@ accelerator_activated_action (GSimpleAction *action,
                               GVariant      *param,
                               gpointer       data)
 {
-  AcceleratorInfo *info = (AcceleratorInfo *) data;
-  PhoshGnomeShellManager *self = phosh_gnome_shell_manager_get_default ();
+  PhoshGnomeShellManager *self = PHOSH_GNOME_SHELL_MANAGER (data);
+  const char *name = g_action_get_name (G_ACTION (action));
   gboolean press = g_variant_get_boolean (param);
-  uint32_t action_id;
+  AcceleratorBinding *binding;
+
+  binding = g_hash_table_lookup (self->binding_by_action, name);
+  g_return_if_fail (binding);
 
-  action_id = info->action_id;
   if (!press) {
-    g_debug ("accelerator released for id %u", action_id);
-    g_clear_handle_id (&info->repeat_id, g_source_remove);
+    g_debug ("accelerator %s released", name);
+    if (self->repeat_binding == binding)
+      stop_repeat (self);
     return;
   }
-  g_debug ("accelerator action activated for id %u", action_id);
-
-  if ((info->grab_flags & PHOSH_SHELL_KEY_BINDING_IGNORE_AUTOREPEAT) == 0 && self->do_repeat) {
-    g_autofree char *source_name = g_strdup_printf ("[phosh] key-repeat-delay for %u", action_id);
-    g_debug ("setting up accelerator autorepeat for id %u", action_id);
-    info->repeat_id = g_timeout_add (self->repeat_delay_ms, on_accelerator_repeat_delay, info);
-    g_source_set_name_by_id (info->repeat_id, source_name);
+  g_debug ("accelerator %s activated", name);
+
+  /* Like keyboard repeat only the most recently pressed key repeats */
+  if (self->do_repeat && binding_wants_repeat (binding)) {
+    g_debug ("setting up accelerator autorepeat for %s", name);
+    self->repeat_binding = binding;
+    g_source_set_ready_time (self->repeat_source,
+                             g_get_monotonic_time () + self->repeat_delay_ms * 1000);
   }
 
-  do_activate_accelerator (info);
+  activate_binding (binding, FALSE);
 }
 
 
@@ -701,6 +864,14 @@ phosh_gnome_shell_manager_dispose (GObject *object)
   if (g_dbus_interface_skeleton_get_object_path (G_DBUS_INTERFACE_SKELETON (self)))
     g_dbus_interface_skeleton_unexport (G_DBUS_INTERFACE_SKELETON (self));
 
+  if (self->repeat_source) {
+    g_source_destroy (self->repeat_source);
+    g_clear_pointer (&self->repeat_source, g_source_unref);
+  }
+  self->repeat_binding = NULL;
+
+  g_clear_pointer (&self->binding_by_action, g_hash_table_unref);
+  g_clear_pointer (&self->bindings, g_hash_table_unref);
   g_clear_pointer (&self->info_by_action, g_hash_table_unref);
   g_clear_object (&self->keyboard_settings);
 
@@ -761,6 +932,18 @@ phosh_gnome_shell_manager_class_init (PhoshGnomeShellManagerClass *klass)
 }
 
 
+static gboolean
+repeat_source_dispatch (GSource *source, GSourceFunc callback, gpointer user_data)
+{
+  return callback (user_data);
+}
+
+
+static GSourceFuncs repeat_source_funcs = {
+  .dispatch = repeat_source_dispatch,
+};
+
+
 static void
 phosh_gnome_shell_manager_init (PhoshGnomeShellManager *self)
 {
@@ -769,9 +952,21 @@ phosh_gnome_shell_manager_init (PhoshGnomeShellManager *self)
   self->info_by_action = g_hash_table_new_full (g_direct_hash,
                                                 g_direct_equal,
                                                 NULL,
-                                                free_accelerator_info_from_hash_table);
+                                                accelerator_info_free);
+  self->bindings = g_hash_table_new_full (g_str_hash,
+                                          g_str_equal,
+                                          NULL,
+                                          free_accelerator_binding_from_hash_table);
+  self->binding_by_action = g_hash_table_new (g_str_hash, g_str_equal);
   self->last_action_id = 0;
 
+  /* A single source drives key repeat, armed via its ready time */
+  self->repeat_source = g_source_new (&repeat_source_funcs, sizeof (GSource));
+  g_source_set_callback (self->repeat_source, on_accelerator_repeat, self, NULL);
+  g_source_set_name (self->repeat_source, "[phosh] accelerator key repeat");
+  g_source_set_ready_time (self->repeat_source, -1);
+  g_source_attach (self->repeat_source, NULL);
+
   self->keyboard_settings = g_settings_new ("org.gnome.desktop.peripherals.keyboard");
 
   g_object_connect (self->keyboard_settings,
@@ -709,3 +709,42 @@ gtk_filter_list_model_refilter (GtkFilterListModel *self)
     }
 }
 
+/**
+ * gtk_filter_list_model_refilter_item:
+ * @self: a #GtkFilterListModel
+ * @position: the position of the item in the underlying model
+ *
+ * Causes @self to refilter the item at @position of the underlying
+ * model only.
+ *
+ * Calling this function is cheaper than gtk_filter_list_model_refilter()
+ * when data used by the filter function changed for a single item.
+ **/
+void
+gtk_filter_list_model_refilter_item (GtkFilterListModel *self,
+                                     guint               position)
+{
+  FilterNode *node;
+  guint filtered;
+  gboolean visible;
+
+  g_return_if_fail (GTK_IS_FILTER_LIST_MODEL (self));
+
+  if (self->items == NULL || self->model == NULL)
+    return;
+
+  node = gtk_filter_list_model_get_nth (self->items, position, &filtered);
+  g_return_if_fail (node != NULL);
+
+  visible = gtk_filter_list_model_run_filter (self, position);
+  if (visible == node->visible)
+    return;
+
+  node->visible = visible;
+  gtk_rb_tree_node_mark_dirty (node);
+
+  if (visible)
+    g_list_model_items_changed (G_LIST_MODEL (self), filtered, 0, 1);
+  else
+    g_list_model_items_changed (G_LIST_MODEL (self), filtered, 1, 0);
+}
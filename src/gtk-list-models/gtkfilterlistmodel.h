@@ -68,6 +68,9 @@ gboolean                gtk_filter_list_model_has_filter        (GtkFilterListMo
 
 GDK_AVAILABLE_IN_ALL
 void                    gtk_filter_list_model_refilter          (GtkFilterListModel     *self);
+GDK_AVAILABLE_IN_ALL
+void                    gtk_filter_list_model_refilter_item     (GtkFilterListModel     *self,
+                                                                 guint                   position);
 
 G_END_DECLS
 
@@ -19,6 +19,7 @@
 #include "style-manager.h"
 #include "feedback-manager.h"
 #include "util.h"
+#include "watchdog.h"
 
 #include <handy.h>
 
@@ -323,8 +324,8 @@ on_has_activities_changed (PhoshHome *self)
   /* TODO: we need to debounce the handle resize a little until all
      the queued resizing is done, would be nicer to have that tied to
      a signal */
-  self->debounce_handle = g_timeout_add_once (200, delayed_handle_resize, self);
-  g_source_set_name_by_id (self->debounce_handle, "[phosh] delayed_handle_resize");
+  self->debounce_handle = phosh_watchdog_timeout_add_once (200, delayed_handle_resize, self,
+                                                           "[phosh] delayed_handle_resize");
 }
 
 
@@ -0,0 +1,16 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "idle-manager.h"
+
+G_BEGIN_DECLS
+
+guint phosh_idle_manager_get_n_timers (PhoshIdleManager *self);
+guint phosh_idle_manager_get_n_clients (PhoshIdleManager *self);
+
+G_END_DECLS
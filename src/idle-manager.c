@@ -10,7 +10,7 @@
 
 #define G_LOG_DOMAIN "phosh-idle-manager"
 
-#include "idle-manager.h"
+#include "idle-manager-priv.h"
 #include "shell-priv.h"
 
 #include <gdk/gdkwayland.h>
@@ -26,21 +26,41 @@
  * about core.
  *
  * Each DBus watch either notifies on idle *or* on activity.
+ *
+ * Watches with the same interval share a single Wayland idle
+ * notification and watches of the same client share a single bus
+ * name watcher. The idle time is derived from the shared
+ * notifications so its granularity is limited to the registered
+ * intervals.
  */
 
+/* A Wayland idle notification shared by all watches with the same interval */
+typedef struct {
+  struct ext_idle_notification_v1 *idle_noti;
+  guint32                          interval;
+  /* element-type: DBusWatch */
+  GPtrArray                       *watches;
+  /* When the idled event was received (monotonic, in µs), 0 if not idle */
+  gint64                           idled_at;
+} IdleTimer;
+
+/* A DBus client that registered watches */
+typedef struct {
+  guint                            name_watcher_id;
+  guint                            n_watches;
+} IdleClient;
+
 /* A DBus watch corresponding to either an idle or active timer */
 typedef struct {
   /* DBus */
   PhoshIdleDBusIdleMonitor        *dbus_monitor;
   char                            *dbus_name;
   guint                            watch_id;
-  guint                            name_watcher_id;
   /* Whether this watch reports on active or on idle */
   gboolean                         active;
 
   /* Wayland */
-  struct ext_idle_notification_v1 *idle_noti;
-  guint32                          interval;
+  IdleTimer                       *timer;
 } DBusWatch;
 
 
@@ -50,6 +70,10 @@ typedef struct _PhoshIdleManager
   GObject parent;
 
   GHashTable *watches;
+  /* key: interval, value: IdleTimer */
+  GHashTable *timers;
+  /* key: bus name, value: IdleClient */
+  GHashTable *clients;
   GDBusObjectManagerServer *manager;
   int dbus_name_id;
 } PhoshIdleManager;
@@ -67,12 +91,45 @@ get_next_dbus_watch_serial (void)
 }
 
 
+static void
+idle_timer_free (IdleTimer *timer)
+{
+  g_clear_pointer (&timer->idle_noti, ext_idle_notification_v1_destroy);
+  g_ptr_array_free (timer->watches, TRUE);
+  g_free (timer);
+}
+
+
+static void
+idle_client_free (IdleClient *client)
+{
+  g_bus_unwatch_name (client->name_watcher_id);
+  g_free (client);
+}
+
+
 /* cleanup a single watch */
 static void
 watch_dispose (DBusWatch *watch)
 {
-  ext_idle_notification_v1_destroy (watch->idle_noti);
-  g_bus_unwatch_name (watch->name_watcher_id);
+  PhoshIdleManager *self = phosh_idle_manager_get_default ();
+  IdleClient *client;
+
+  /* Drop the shared timer once unused */
+  g_ptr_array_remove_fast (watch->timer->watches, watch);
+  if (watch->timer->watches->len == 0) {
+    g_debug ("Dropping idle timer for %u msec", watch->timer->interval);
+    g_hash_table_remove (self->timers, GUINT_TO_POINTER (watch->timer->interval));
+  }
+
+  /* Stop watching the client when it has no more watches */
+  client = g_hash_table_lookup (self->clients, watch->dbus_name);
+  if (client) {
+    client->n_watches--;
+    if (client->n_watches == 0)
+      g_hash_table_remove (self->clients, watch->dbus_name);
+  }
+
   g_object_unref (watch->dbus_monitor);
   g_free (watch->dbus_name);
   g_free (watch);
@@ -91,15 +148,10 @@ watch_remove (DBusWatch *watch)
 
 
 static void
-idle_notification_idled_cb (void *data, struct ext_idle_notification_v1 *timer)
+watch_fire (DBusWatch *watch)
 {
-  DBusWatch *watch = data;
   GDBusInterfaceSkeleton *skeleton = G_DBUS_INTERFACE_SKELETON (watch->dbus_monitor);
 
-  if (watch->active)
-    return;
-
-  g_debug ("Idle Timer %d fired on %s", watch->watch_id, watch->dbus_name);
   g_dbus_connection_emit_signal (g_dbus_interface_skeleton_get_connection (skeleton),
                                  watch->dbus_name,
                                  g_dbus_interface_skeleton_get_object_path (skeleton),
@@ -111,23 +163,46 @@ idle_notification_idled_cb (void *data, struct ext_idle_notification_v1 *timer)
 
 
 static void
-idle_notification_resumed_cb (void* data, struct ext_idle_notification_v1 *timer)
+idle_notification_idled_cb (void *data, struct ext_idle_notification_v1 *noti)
 {
-  DBusWatch *watch = data;
-  GDBusInterfaceSkeleton *skeleton = G_DBUS_INTERFACE_SKELETON (watch->dbus_monitor);
+  IdleTimer *timer = data;
 
-  if (!watch->active)
-    return;
+  timer->idled_at = g_get_monotonic_time ();
 
-  g_debug ("Active Timer %d fired", watch->watch_id);
-  g_dbus_connection_emit_signal (g_dbus_interface_skeleton_get_connection (skeleton),
-                                 watch->dbus_name,
-                                 g_dbus_interface_skeleton_get_object_path (skeleton),
-                                 "org.gnome.Mutter.IdleMonitor",
-                                 "WatchFired",
-                                 g_variant_new ("(u)", watch->watch_id),
-                                 NULL);
-  watch_remove (watch);
+  for (guint i = 0; i < timer->watches->len; i++) {
+    DBusWatch *watch = g_ptr_array_index (timer->watches, i);
+
+    if (watch->active)
+      continue;
+
+    g_debug ("Idle Timer %d fired on %s", watch->watch_id, watch->dbus_name);
+    watch_fire (watch);
+  }
+}
+
+
+static void
+idle_notification_resumed_cb (void* data, struct ext_idle_notification_v1 *noti)
+{
+  IdleTimer *timer = data;
+  g_autoptr (GPtrArray) fired = g_ptr_array_new ();
+
+  timer->idled_at = 0;
+
+  for (guint i = 0; i < timer->watches->len; i++) {
+    DBusWatch *watch = g_ptr_array_index (timer->watches, i);
+
+    if (!watch->active)
+      continue;
+
+    g_debug ("Active Timer %d fired", watch->watch_id);
+    watch_fire (watch);
+    g_ptr_array_add (fired, watch);
+  }
+
+  /* Active watches only fire once. This might drop the timer too */
+  for (guint i = 0; i < fired->len; i++)
+    watch_remove (g_ptr_array_index (fired, i));
 }
 
 
@@ -137,12 +212,59 @@ static const struct ext_idle_notification_v1_listener idle_notification_listener
 };
 
 
+static void
+idle_timer_create_notification (IdleTimer *timer)
+{
+  PhoshWayland *wl = phosh_wayland_get_default ();
+  struct ext_idle_notifier_v1 *idle_manager = phosh_wayland_get_ext_idle_notifier_v1 (wl);
+
+  g_clear_pointer (&timer->idle_noti, ext_idle_notification_v1_destroy);
+  timer->idled_at = 0;
+  timer->idle_noti = ext_idle_notifier_v1_get_idle_notification (idle_manager,
+                                                                 timer->interval,
+                                                                 phosh_wayland_get_wl_seat (wl));
+  g_assert (timer->idle_noti);
+  ext_idle_notification_v1_add_listener (timer->idle_noti, &idle_notification_listener, timer);
+}
+
+
+static IdleTimer *
+idle_timer_get (PhoshIdleManager *self, guint32 interval)
+{
+  IdleTimer *timer;
+
+  timer = g_hash_table_lookup (self->timers, GUINT_TO_POINTER (interval));
+  if (timer)
+    return timer;
+
+  g_debug ("Creating idle timer for %u msec", interval);
+  timer = g_new0 (IdleTimer, 1);
+  timer->interval = interval;
+  timer->watches = g_ptr_array_new ();
+  idle_timer_create_notification (timer);
+  g_hash_table_insert (self->timers, GUINT_TO_POINTER (interval), timer);
+
+  return timer;
+}
+
+
 static void
 name_vanished_callback (GDBusConnection *connection,
                         const char      *name,
                         gpointer         user_data)
 {
-  watch_remove ((DBusWatch*)user_data);
+  PhoshIdleManager *self = PHOSH_IDLE_MANAGER (user_data);
+  GHashTableIter iter;
+  DBusWatch *watch;
+
+  g_debug ("%s vanished, removing its watches", name);
+
+  /* Removing the last watch drops the client and with it the name watcher */
+  g_hash_table_iter_init (&iter, self->watches);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &watch)) {
+    if (g_str_equal (watch->dbus_name, name))
+      g_hash_table_iter_remove (&iter);
+  }
 }
 
 
@@ -152,35 +274,37 @@ watch_new (PhoshIdleDBusIdleMonitor *skeleton,
            guint32                   interval,
            gboolean                  active)
 {
+  PhoshIdleManager *self = phosh_idle_manager_get_default ();
   DBusWatch *watch;
+  IdleClient *client;
   guint32 watch_id;
-  PhoshWayland *wl = phosh_wayland_get_default ();
-  struct ext_idle_notification_v1 *idle_noti;
-  struct ext_idle_notifier_v1 *idle_manager = phosh_wayland_get_ext_idle_notifier_v1 (wl);
+  const char *sender = g_dbus_method_invocation_get_sender (invocation);
 
   watch_id = get_next_dbus_watch_serial ();
   g_return_val_if_fail (watch_id != 0, NULL); /* protect against wrap around */
-  idle_noti = ext_idle_notifier_v1_get_idle_notification (idle_manager,
-                                                          interval,
-                                                          phosh_wayland_get_wl_seat (wl));
-  g_assert (idle_noti);
 
   watch = g_new0 (DBusWatch, 1);
-  watch->interval = interval;
   watch->active = active;
   watch->watch_id = watch_id;
-  watch->idle_noti = idle_noti;
   watch->dbus_monitor = g_object_ref (skeleton);
-  watch->dbus_name = g_strdup (g_dbus_method_invocation_get_sender (invocation));
-  watch->name_watcher_id = g_bus_watch_name_on_connection (
-    g_dbus_method_invocation_get_connection (invocation),
-    watch->dbus_name,
-    G_BUS_NAME_WATCHER_FLAGS_NONE,
-    NULL, /* appeared */
-    name_vanished_callback,
-    watch, NULL);
-
-  ext_idle_notification_v1_add_listener (watch->idle_noti, &idle_notification_listener, watch);
+  watch->dbus_name = g_strdup (sender);
+
+  watch->timer = idle_timer_get (self, interval);
+  g_ptr_array_add (watch->timer->watches, watch);
+
+  client = g_hash_table_lookup (self->clients, sender);
+  if (!client) {
+    client = g_new0 (IdleClient, 1);
+    client->name_watcher_id = g_bus_watch_name_on_connection (
+      g_dbus_method_invocation_get_connection (invocation),
+      sender,
+      G_BUS_NAME_WATCHER_FLAGS_NONE,
+      NULL, /* appeared */
+      name_vanished_callback,
+      self, NULL);
+    g_hash_table_insert (self->clients, g_strdup (sender), client);
+  }
+  client->n_watches++;
 
   return watch;
 }
@@ -272,10 +396,28 @@ static gboolean
 handle_get_idle_time (PhoshIdleDBusIdleMonitor *skeleton,
                       GDBusMethodInvocation    *invocation)
 {
-  g_debug ("Unimplemented DBus call %s", __func__);
-  g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR,
-                                         G_DBUS_ERROR_NOT_SUPPORTED,
-                                         "Not supported");
+  PhoshIdleManager *self = phosh_idle_manager_get_default ();
+  gint64 now = g_get_monotonic_time ();
+  guint64 idle_time = 0;
+  GHashTableIter iter;
+  IdleTimer *timer;
+
+  /*
+   * A timer that went idle tells us the user is idle since at least
+   * its interval. If no timer is idle the user is considered active.
+   */
+  g_hash_table_iter_init (&iter, self->timers);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &timer)) {
+    guint64 idle;
+
+    if (!timer->idled_at)
+      continue;
+
+    idle = (now - timer->idled_at) / 1000 + timer->interval;
+    idle_time = MAX (idle_time, idle);
+  }
+
+  phosh_idle_dbus_idle_monitor_complete_get_idletime (skeleton, invocation, idle_time);
   return TRUE;
 }
 
@@ -366,6 +508,8 @@ phosh_idle_manager_dispose (GObject *object)
   g_clear_handle_id (&self->dbus_name_id, g_bus_unown_name);
 
   g_clear_pointer (&self->watches, g_hash_table_destroy);
+  g_clear_pointer (&self->timers, g_hash_table_destroy);
+  g_clear_pointer (&self->clients, g_hash_table_destroy);
   g_clear_object (&self->manager);
   G_OBJECT_CLASS (phosh_idle_manager_parent_class)->dispose (object);
 }
@@ -374,28 +518,52 @@ void
 phosh_idle_manager_reset_timers (PhoshIdleManager *self)
 {
   GHashTableIter iter;
-  DBusWatch *watch;
-  PhoshWayland *wl = phosh_wayland_get_default ();
-  struct ext_idle_notifier_v1 *idle_manager = phosh_wayland_get_ext_idle_notifier_v1 (wl);
+  IdleTimer *timer;
 
   g_return_if_fail (PHOSH_IS_IDLE_MANAGER (self));
 
   g_debug ("Resetting idle timers");
 
-  g_hash_table_iter_init (&iter, self->watches);
-  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &watch)) {
-    if (watch->active)
+  g_hash_table_iter_init (&iter, self->timers);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &timer)) {
+    gboolean has_idle_watch = FALSE;
+
+    for (guint i = 0; i < timer->watches->len; i++) {
+      DBusWatch *watch = g_ptr_array_index (timer->watches, i);
+
+      if (!watch->active) {
+        has_idle_watch = TRUE;
+        break;
+      }
+    }
+
+    if (!has_idle_watch)
       continue;
 
     /* Recreate the idle timers to reset their interval */
-    ext_idle_notification_v1_destroy (watch->idle_noti);
-    watch->idle_noti = ext_idle_notifier_v1_get_idle_notification (idle_manager,
-                                                                   watch->interval,
-                                                                   phosh_wayland_get_wl_seat (wl));
-    ext_idle_notification_v1_add_listener (watch->idle_noti, &idle_notification_listener, watch);
+    idle_timer_create_notification (timer);
   }
 }
 
+/* The number of shared Wayland idle notifications */
+guint
+phosh_idle_manager_get_n_timers (PhoshIdleManager *self)
+{
+  g_return_val_if_fail (PHOSH_IS_IDLE_MANAGER (self), 0);
+
+  return g_hash_table_size (self->timers);
+}
+
+/* The number of DBus clients with watches */
+guint
+phosh_idle_manager_get_n_clients (PhoshIdleManager *self)
+{
+  g_return_val_if_fail (PHOSH_IS_IDLE_MANAGER (self), 0);
+
+  return g_hash_table_size (self->clients);
+}
+
+
 static void
 phosh_idle_manager_constructed (GObject *object)
 {
@@ -416,6 +584,14 @@ phosh_idle_manager_constructed (GObject *object)
                                          g_int_equal,
                                          NULL,
                                          (GDestroyNotify) watch_dispose);
+  self->timers = g_hash_table_new_full (g_direct_hash,
+                                        g_direct_equal,
+                                        NULL,
+                                        (GDestroyNotify) idle_timer_free);
+  self->clients = g_hash_table_new_full (g_str_hash,
+                                         g_str_equal,
+                                         g_free,
+                                         (GDestroyNotify) idle_client_free);
 }
 
 
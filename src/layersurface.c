@@ -11,6 +11,8 @@
 #include "phosh-config.h"
 #include "layersurface-priv.h"
 #include "phosh-wayland.h"
+#include "timeline.h"
+#include "watchdog.h"
 #include "phoc-layer-shell-effects-unstable-v1-client-protocol.h"
 
 #include <gdk/gdkwayland.h>
@@ -75,6 +77,9 @@ typedef struct {
   /* stacked_layer_surface_v1 */
   PhoshLayerSurface            *stack_target;
   gboolean                      stack_above;
+  /* timeline */
+  gint64                        map_time;
+  gulong                        after_paint_id;
 } PhoshLayerSurfacePrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (PhoshLayerSurface, phosh_layer_surface, GTK_TYPE_WINDOW)
@@ -330,6 +335,16 @@ phosh_layer_surface_get_property (GObject    *object,
 }
 
 
+static void
+on_first_frame_after_paint (PhoshLayerSurface *self, GdkFrameClock *frame_clock)
+{
+  PhoshLayerSurfacePrivate *priv = phosh_layer_surface_get_instance_private (self);
+
+  phosh_timeline_end (priv->map_time, "first-frame", priv->namespace ?: G_OBJECT_TYPE_NAME (self));
+  g_clear_signal_handler (&priv->after_paint_id, frame_clock);
+}
+
+
 static void
 phosh_layer_surface_realize (GtkWidget *widget)
 {
@@ -355,6 +370,7 @@ phosh_layer_surface_map (GtkWidget *widget)
   PhoshWayland *wl = phosh_wayland_get_default ();
   struct zphoc_layer_shell_effects_v1 *layer_shell_effects;
 
+  priv->map_time = phosh_timeline_begin ();
   GTK_WIDGET_CLASS (phosh_layer_surface_parent_class)->map (widget);
 
   if (!priv->wl_surface) {
@@ -404,6 +420,16 @@ phosh_layer_surface_map (GtkWidget *widget)
   /* Catch up with stackings set before map */
   if (priv->stacked_surface)
     phosh_layer_surface_set_stacked (self, priv->stack_target, priv->stack_above);
+
+  if (phosh_timeline_is_recording ()) {
+    priv->after_paint_id = g_signal_connect_swapped (gtk_widget_get_frame_clock (widget),
+                                                     "after-paint",
+                                                     G_CALLBACK (on_first_frame_after_paint),
+                                                     self);
+  }
+
+  phosh_watchdog_track_frame_clock (gtk_widget_get_frame_clock (widget),
+                                    priv->namespace ?: G_OBJECT_TYPE_NAME (self));
 }
 
 
@@ -413,6 +439,7 @@ phosh_layer_surface_unmap (GtkWidget *widget)
   PhoshLayerSurface *self = PHOSH_LAYER_SURFACE (widget);
   PhoshLayerSurfacePrivate *priv = phosh_layer_surface_get_instance_private (self);
 
+  g_clear_signal_handler (&priv->after_paint_id, gtk_widget_get_frame_clock (widget));
   g_clear_pointer (&priv->alpha_surface, zphoc_alpha_layer_surface_v1_destroy);
   g_clear_pointer (&priv->stacked_surface, zphoc_stacked_layer_surface_v1_destroy);
   g_clear_pointer (&priv->layer_surface, zwlr_layer_surface_v1_destroy);
@@ -0,0 +1,379 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#define G_LOG_DOMAIN "phosh-light-filter"
+
+#include "phosh-config.h"
+
+#include "light-filter.h"
+#include "watchdog.h"
+
+/* Share of the window the light level must be on the other side of the threshold */
+#define REQUIRED_RATIO 0.8
+/* Hysteresis around the threshold */
+#define HYST_ENTER     1.1
+#define HYST_LEAVE     0.9
+
+/**
+ * PhoshLightFilter:
+ *
+ * Decide on high contrast based on ambient light levels
+ *
+ * The filter keeps a rolling window of light level samples. Each
+ * sample is weighted by how long it was the current level. High
+ * contrast is toggled once the level stayed beyond the threshold (with
+ * some hysteresis) for most of the window. Short spikes and flapping
+ * around the threshold hence don't cause repeated theme switches.
+ *
+ * As sensors only report changes a single timer is armed while a
+ * switch is pending so a level that stays constant is still taken into
+ * account.
+ */
+
+enum {
+  PROP_0,
+  PROP_WINDOW,
+  PROP_THRESHOLD,
+  PROP_HIGH_CONTRAST,
+  PROP_LAST_PROP
+};
+static GParamSpec *props[PROP_LAST_PROP];
+
+
+typedef struct {
+  gint64 time;
+  double level;
+} LightSample;
+
+
+struct _PhoshLightFilter {
+  GObject     parent;
+
+  GTimeSpan   window;
+  guint       threshold;
+  gboolean    high_contrast;
+
+  GArray     *samples; /* (element-type: LightSample) */
+  guint       decide_id;
+};
+G_DEFINE_TYPE (PhoshLightFilter, phosh_light_filter, G_TYPE_OBJECT)
+
+
+static void evaluate (PhoshLightFilter *self, gint64 now);
+
+
+static gboolean
+wants_switch (PhoshLightFilter *self, double level)
+{
+  double threshold = self->threshold;
+
+  if (self->high_contrast)
+    return level < threshold * HYST_LEAVE;
+
+  return level > threshold * HYST_ENTER;
+}
+
+
+static void
+prune_samples (PhoshLightFilter *self, gint64 now)
+{
+  gint64 start = now - self->window;
+  guint n = 0;
+
+  /* Keep the last sample before the window start as it's still the current level then */
+  while (n + 1 < self->samples->len &&
+         g_array_index (self->samples, LightSample, n + 1).time <= start)
+    n++;
+
+  if (n)
+    g_array_remove_range (self->samples, 0, n);
+}
+
+/* The time weighted share of the window the level wanted a switch */
+static double
+get_switch_ratio (PhoshLightFilter *self, gint64 now)
+{
+  gint64 start = now - self->window;
+  GTimeSpan wanted = 0;
+
+  for (guint i = 0; i < self->samples->len; i++) {
+    LightSample *sample = &g_array_index (self->samples, LightSample, i);
+    gint64 from, until;
+
+    from = MAX (sample->time, start);
+    if (i + 1 < self->samples->len)
+      until = g_array_index (self->samples, LightSample, i + 1).time;
+    else
+      until = now;
+
+    if (until <= from || !wants_switch (self, sample->level))
+      continue;
+
+    wanted += until - from;
+  }
+
+  return (double) wanted / self->window;
+}
+
+
+static gboolean
+on_decide_timeout (gpointer data)
+{
+  PhoshLightFilter *self = PHOSH_LIGHT_FILTER (data);
+
+  self->decide_id = 0;
+  evaluate (self, g_get_monotonic_time ());
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static void
+evaluate (PhoshLightFilter *self, gint64 now)
+{
+  LightSample *last;
+  gint64 run_start, deadline;
+  double ratio;
+
+  prune_samples (self, now);
+  if (self->samples->len == 0)
+    return;
+
+  ratio = get_switch_ratio (self, now);
+  if (ratio >= REQUIRED_RATIO) {
+    g_clear_handle_id (&self->decide_id, g_source_remove);
+    self->high_contrast = !self->high_contrast;
+    g_debug ("Ratio %.2f, switching high contrast: %d", ratio, self->high_contrast);
+    g_object_notify_by_pspec (G_OBJECT (self), props[PROP_HIGH_CONTRAST]);
+    return;
+  }
+
+  last = &g_array_index (self->samples, LightSample, self->samples->len - 1);
+  if (!wants_switch (self, last->level)) {
+    g_clear_handle_id (&self->decide_id, g_source_remove);
+    return;
+  }
+
+  /* A switch is pending, check again when the current run would fill the window */
+  if (self->decide_id)
+    return;
+
+  run_start = last->time;
+  for (int i = self->samples->len - 2; i >= 0; i--) {
+    LightSample *sample = &g_array_index (self->samples, LightSample, i);
+
+    if (!wants_switch (self, sample->level))
+      break;
+    run_start = sample->time;
+  }
+
+  deadline = MAX (run_start, now - self->window) + REQUIRED_RATIO * self->window;
+  self->decide_id = phosh_watchdog_timeout_add (MAX (deadline - now, 0) / 1000 + 1,
+                                                on_decide_timeout, self,
+                                                "[phosh] light filter decide");
+}
+
+
+static void
+phosh_light_filter_set_property (GObject      *object,
+                                 guint         property_id,
+                                 const GValue *value,
+                                 GParamSpec   *pspec)
+{
+  PhoshLightFilter *self = PHOSH_LIGHT_FILTER (object);
+
+  switch (property_id) {
+  case PROP_WINDOW:
+    self->window = g_value_get_uint (value) * (G_USEC_PER_SEC / 1000);
+    break;
+  case PROP_THRESHOLD:
+    phosh_light_filter_set_threshold (self, g_value_get_uint (value));
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+    break;
+  }
+}
+
+
+static void
+phosh_light_filter_get_property (GObject    *object,
+                                 guint       property_id,
+                                 GValue     *value,
+                                 GParamSpec *pspec)
+{
+  PhoshLightFilter *self = PHOSH_LIGHT_FILTER (object);
+
+  switch (property_id) {
+  case PROP_WINDOW:
+    g_value_set_uint (value, self->window / (G_USEC_PER_SEC / 1000));
+    break;
+  case PROP_THRESHOLD:
+    g_value_set_uint (value, self->threshold);
+    break;
+  case PROP_HIGH_CONTRAST:
+    g_value_set_boolean (value, self->high_contrast);
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+    break;
+  }
+}
+
+
+static void
+phosh_light_filter_finalize (GObject *object)
+{
+  PhoshLightFilter *self = PHOSH_LIGHT_FILTER (object);
+
+  g_clear_handle_id (&self->decide_id, g_source_remove);
+  g_clear_pointer (&self->samples, g_array_unref);
+
+  G_OBJECT_CLASS (phosh_light_filter_parent_class)->finalize (object);
+}
+
+
+static void
+phosh_light_filter_class_init (PhoshLightFilterClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->get_property = phosh_light_filter_get_property;
+  object_class->set_property = phosh_light_filter_set_property;
+  object_class->finalize = phosh_light_filter_finalize;
+
+  /**
+   * PhoshLightFilter:window:
+   *
+   * The length of the sample window in milliseconds.
+   */
+  props[PROP_WINDOW] =
+    g_param_spec_uint ("window", "", "",
+                       1, G_MAXUINT, 3000,
+                       G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+  /**
+   * PhoshLightFilter:threshold:
+   *
+   * The light level (in lux) above which high contrast should be used.
+   */
+  props[PROP_THRESHOLD] =
+    g_param_spec_uint ("threshold", "", "",
+                       0, G_MAXUINT, 500,
+                       G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+  /**
+   * PhoshLightFilter:high-contrast:
+   *
+   * Whether high contrast should currently be used.
+   */
+  props[PROP_HIGH_CONTRAST] =
+    g_param_spec_boolean ("high-contrast", "", "",
+                          FALSE,
+                          G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
+  g_object_class_install_properties (object_class, PROP_LAST_PROP, props);
+}
+
+
+static void
+phosh_light_filter_init (PhoshLightFilter *self)
+{
+  self->threshold = 500;
+  self->samples = g_array_new (FALSE, FALSE, sizeof (LightSample));
+}
+
+/**
+ * phosh_light_filter_new:
+ * @window: The length of the sample window in milliseconds
+ *
+ * Create a new light filter.
+ *
+ * Returns: The new light filter
+ */
+PhoshLightFilter *
+phosh_light_filter_new (guint window)
+{
+  return g_object_new (PHOSH_TYPE_LIGHT_FILTER, "window", window, NULL);
+}
+
+/**
+ * phosh_light_filter_add_sample:
+ * @self: The light filter
+ * @level: The light level in lux
+ *
+ * Add a new light level reading. The level is assumed to be current
+ * until the next sample is added.
+ */
+void
+phosh_light_filter_add_sample (PhoshLightFilter *self, double level)
+{
+  LightSample sample;
+
+  g_return_if_fail (PHOSH_IS_LIGHT_FILTER (self));
+
+  sample.time = g_get_monotonic_time ();
+  sample.level = level;
+  g_array_append_val (self->samples, sample);
+
+  evaluate (self, sample.time);
+}
+
+
+void
+phosh_light_filter_set_threshold (PhoshLightFilter *self, guint threshold)
+{
+  g_return_if_fail (PHOSH_IS_LIGHT_FILTER (self));
+
+  if (self->threshold == threshold)
+    return;
+
+  self->threshold = threshold;
+  g_object_notify_by_pspec (G_OBJECT (self), props[PROP_THRESHOLD]);
+
+  g_clear_handle_id (&self->decide_id, g_source_remove);
+  evaluate (self, g_get_monotonic_time ());
+}
+
+
+guint
+phosh_light_filter_get_threshold (PhoshLightFilter *self)
+{
+  g_return_val_if_fail (PHOSH_IS_LIGHT_FILTER (self), 0);
+
+  return self->threshold;
+}
+
+
+gboolean
+phosh_light_filter_get_high_contrast (PhoshLightFilter *self)
+{
+  g_return_val_if_fail (PHOSH_IS_LIGHT_FILTER (self), FALSE);
+
+  return self->high_contrast;
+}
+
+/**
+ * phosh_light_filter_reset:
+ * @self: The light filter
+ * @high_contrast: The current high contrast state
+ *
+ * Drop all samples and start over assuming the given high contrast
+ * state e.g. when the sensor got released or the theme got changed
+ * by other means.
+ */
+void
+phosh_light_filter_reset (PhoshLightFilter *self, gboolean high_contrast)
+{
+  g_return_if_fail (PHOSH_IS_LIGHT_FILTER (self));
+
+  g_clear_handle_id (&self->decide_id, g_source_remove);
+  g_array_set_size (self->samples, 0);
+
+  if (self->high_contrast == high_contrast)
+    return;
+
+  self->high_contrast = high_contrast;
+  g_object_notify_by_pspec (G_OBJECT (self), props[PROP_HIGH_CONTRAST]);
+}
@@ -0,0 +1,27 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define PHOSH_TYPE_LIGHT_FILTER (phosh_light_filter_get_type ())
+
+G_DECLARE_FINAL_TYPE (PhoshLightFilter, phosh_light_filter, PHOSH, LIGHT_FILTER, GObject)
+
+PhoshLightFilter *phosh_light_filter_new               (guint             window);
+void              phosh_light_filter_add_sample        (PhoshLightFilter *self,
+                                                        double            level);
+void              phosh_light_filter_set_threshold     (PhoshLightFilter *self,
+                                                        guint             threshold);
+guint             phosh_light_filter_get_threshold     (PhoshLightFilter *self);
+gboolean          phosh_light_filter_get_high_contrast (PhoshLightFilter *self);
+void              phosh_light_filter_reset             (PhoshLightFilter *self,
+                                                        gboolean          high_contrast);
+
+G_END_DECLS
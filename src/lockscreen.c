@@ -23,6 +23,7 @@
 #include "util.h"
 #include "widget-box.h"
 #include "wall-clock-priv.h"
+#include "watchdog.h"
 
 #include "gmobile.h"
 
@@ -349,8 +350,8 @@ shake_entry (GtkWidget     *widget,
       guint id;
 
       gtk_entry_set_alignment (GTK_ENTRY (priv->entry_pin), 0.5);
-      id = g_timeout_add (400, (GSourceFunc) finish_shake_entry, self);
-      g_source_set_name_by_id (id, "[PhoshLockscreen] shake PIN entry");
+      id = phosh_watchdog_timeout_add (400, (GSourceFunc) finish_shake_entry, self,
+                                       "[PhoshLockscreen] shake PIN entry");
       return FALSE;
     }
   }
@@ -591,10 +592,9 @@ carousel_page_changed_cb (PhoshLockscreen *self,
 
     if (!priv->idle_timer) {
       priv->last_input = g_get_monotonic_time ();
-      priv->idle_timer = g_timeout_add_seconds (LOCKSCREEN_IDLE_SECONDS,
-                                                (GSourceFunc) keypad_check_idle,
-                                                self);
-      g_source_set_name_by_id (priv->idle_timer, "[PhoshLockscreen] keypad check");
+      priv->idle_timer = phosh_watchdog_timeout_add_seconds (LOCKSCREEN_IDLE_SECONDS,
+                                                             (GSourceFunc) keypad_check_idle, self,
+                                                             "[PhoshLockscreen] keypad check");
     }
     if (!priv->require_unlock) {
       g_signal_emit (self, signals[LOCKSCREEN_UNLOCK], 0);
@@ -18,6 +18,7 @@
 #include "fake-clock.h"
 #include "background-cache.h"
 #include "metainfo-cache.h"
+#include "watchdog.h"
 
 #include <handy.h>
 #include <libfeedback.h>
@@ -43,8 +44,7 @@ on_shutdown_signal (gpointer unused)
   guint id;
 
   phosh_shell_fade_out (phosh_shell_get_default (), 0);
-  id = g_timeout_add_seconds (2, (GSourceFunc)quit, NULL);
-  g_source_set_name_by_id (id, "[PhoshMain] quit");
+  id = phosh_watchdog_timeout_add_seconds (2, (GSourceFunc)quit, NULL, "[PhoshMain] quit");
 
   return FALSE;
 }
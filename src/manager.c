@@ -11,6 +11,8 @@
 #include "phosh-config.h"
 
 #include "manager.h"
+#include "timeline.h"
+#include "watchdog.h"
 
 /**
  * PhoshManager:
@@ -36,7 +38,7 @@ on_idle (gpointer user_data)
   PhoshManagerPrivate *priv = phosh_manager_get_instance_private (self);
 
   if (klass->idle_init)
-    (*klass->idle_init) (self);
+    PHOSH_TIMELINE_SPAN ("idle-init", G_OBJECT_TYPE_NAME (self), (*klass->idle_init) (self));
 
   priv->idle_id = 0;
 }
@@ -64,8 +66,7 @@ phosh_manager_constructed (GObject *object)
   G_OBJECT_CLASS (phosh_manager_parent_class)->constructed (object);
 
   if (klass->idle_init) {
-    priv->idle_id = g_idle_add_once (on_idle, self);
-    g_source_set_name_by_id (priv->idle_id, "[PhoshManager] idle");
+    priv->idle_id = phosh_watchdog_idle_add_once (on_idle, self, "[PhoshManager] idle");
   }
 }
 
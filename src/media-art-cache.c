@@ -0,0 +1,517 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#define G_LOG_DOMAIN "phosh-media-art-cache"
+
+#include "phosh-config.h"
+
+#include "media-art-cache.h"
+
+#include <libsoup/soup.h>
+
+#include <math.h>
+
+#define MAX_ENTRIES 8
+
+/**
+ * PhoshMediaArtCache:
+ *
+ * A small cache for media (album) art
+ *
+ * Art is decoded directly at the size it is displayed at and stored as
+ * a centered, rounded surface that is ready to paint. Entries are keyed
+ * by art URL and target size so media player widgets showing the same
+ * art share the decoded result. Concurrent loads of the same art are
+ * deduplicated and only the most recently used entries are kept.
+ */
+
+typedef struct {
+  PhoshMediaArtCache *cache;
+  char               *key;
+  char               *url;
+  int                 size;
+  int                 scale;
+  /* element-type: GTask */
+  GPtrArray          *tasks;
+} ArtLoad;
+
+
+struct _PhoshMediaArtCache {
+  GObject       parent;
+
+  /* key: art key, value: cairo_surface_t */
+  GHashTable   *surfaces;
+  /* Keys of the surfaces, most recently used first */
+  GQueue        lru;
+  /* key: art key, value: ArtLoad */
+  GHashTable   *loads;
+  GCancellable *cancel;
+};
+G_DEFINE_TYPE (PhoshMediaArtCache, phosh_media_art_cache, G_TYPE_OBJECT)
+
+
+static void
+art_load_free (ArtLoad *load)
+{
+  g_ptr_array_free (load->tasks, TRUE);
+  g_free (load->key);
+  g_free (load->url);
+  g_object_unref (load->cache);
+  g_free (load);
+}
+
+
+static char *
+get_key (const char *url, int size, int scale)
+{
+  g_autofree char *checksum = NULL;
+
+  /* Data URIs can be huge so don't use them as keys directly */
+  if (g_strcmp0 (g_uri_peek_scheme (url), "data") == 0) {
+    checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA256, url, -1);
+    url = checksum;
+  }
+
+  return g_strdup_printf ("%d@%d:%s", size, scale, url);
+}
+
+
+static cairo_surface_t *
+render_art (GdkPixbuf *pixbuf, int size, int scale)
+{
+  g_autoptr (GdkPixbuf) scaled = NULL;
+  cairo_surface_t *surface;
+  cairo_t *cr;
+  int width, height, px;
+  double radius;
+  const double degrees = M_PI / 180.0;
+
+  px = size * scale;
+  width = gdk_pixbuf_get_width (pixbuf);
+  height = gdk_pixbuf_get_height (pixbuf);
+
+  /* Loaders usually decode at the right size already */
+  if (MAX (width, height) != px) {
+    double factor = (double) px / MAX (width, height);
+
+    width = MAX (1, round (width * factor));
+    height = MAX (1, round (height * factor));
+    scaled = gdk_pixbuf_scale_simple (pixbuf, width, height, GDK_INTERP_BILINEAR);
+    pixbuf = scaled;
+  }
+
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, px, px);
+  cr = cairo_create (surface);
+
+  /* Center non square art and round the corners */
+  radius = px / 8.0;
+  cairo_new_path (cr);
+  cairo_arc (cr, px - radius, radius, radius, -90 * degrees, 0 * degrees);
+  cairo_arc (cr, px - radius, px - radius, radius, 0 * degrees, 90 * degrees);
+  cairo_arc (cr, radius, px - radius, radius, 90 * degrees, 180 * degrees);
+  cairo_arc (cr, radius, radius, radius, 180 * degrees, 270 * degrees);
+  cairo_close_path (cr);
+  cairo_clip (cr);
+
+  gdk_cairo_set_source_pixbuf (cr, pixbuf, (px - width) / 2.0, (px - height) / 2.0);
+  cairo_paint (cr);
+  cairo_destroy (cr);
+
+  cairo_surface_set_device_scale (surface, scale, scale);
+
+  return surface;
+}
+
+
+static void
+cache_insert (PhoshMediaArtCache *self, const char *key, cairo_surface_t *surface)
+{
+  char *cache_key = g_strdup (key);
+
+  g_hash_table_insert (self->surfaces, cache_key, cairo_surface_reference (surface));
+  g_queue_push_head (&self->lru, cache_key);
+
+  while (g_queue_get_length (&self->lru) > MAX_ENTRIES) {
+    char *old = g_queue_pop_tail (&self->lru);
+
+    g_debug ("Evicting %s", old);
+    g_hash_table_remove (self->surfaces, old);
+  }
+}
+
+
+static void
+art_load_complete (ArtLoad *load, GdkPixbuf *pixbuf, GError *err)
+{
+  PhoshMediaArtCache *self = load->cache;
+  cairo_surface_t *surface = NULL;
+
+  if (pixbuf) {
+    surface = render_art (pixbuf, load->size, load->scale);
+    cache_insert (self, load->key, surface);
+  }
+
+  for (guint i = 0; i < load->tasks->len; i++) {
+    GTask *task = g_ptr_array_index (load->tasks, i);
+
+    if (surface) {
+      g_task_return_pointer (task, cairo_surface_reference (surface),
+                             (GDestroyNotify) cairo_surface_destroy);
+    } else {
+      g_task_return_error (task, g_error_copy (err));
+    }
+  }
+
+  g_clear_pointer (&surface, cairo_surface_destroy);
+  /* Frees the load */
+  g_hash_table_remove (self->loads, load->key);
+}
+
+
+static void
+on_pixbuf_ready (GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+  ArtLoad *load = user_data;
+  g_autoptr (GdkPixbuf) pixbuf = NULL;
+  g_autoptr (GError) err = NULL;
+
+  pixbuf = gdk_pixbuf_new_from_stream_finish (res, &err);
+  art_load_complete (load, pixbuf, err);
+}
+
+
+static void
+load_from_stream (ArtLoad *load, GInputStream *stream)
+{
+  int px = load->size * load->scale;
+
+  /* Decode at the target size right away */
+  gdk_pixbuf_new_from_stream_at_scale_async (stream,
+                                             px,
+                                             px,
+                                             TRUE,
+                                             load->cache->cancel,
+                                             on_pixbuf_ready,
+                                             load);
+}
+
+
+static void
+on_file_read_ready (GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+  ArtLoad *load = user_data;
+  g_autoptr (GFileInputStream) stream = NULL;
+  g_autoptr (GError) err = NULL;
+
+  stream = g_file_read_finish (G_FILE (source_object), res, &err);
+  if (!stream) {
+    art_load_complete (load, NULL, err);
+    return;
+  }
+
+  load_from_stream (load, G_INPUT_STREAM (stream));
+}
+
+
+static void
+on_icon_load_ready (GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+  ArtLoad *load = user_data;
+  g_autoptr (GInputStream) stream = NULL;
+  g_autoptr (GError) err = NULL;
+  g_autofree char *type = NULL;
+
+  stream = g_loadable_icon_load_finish (G_LOADABLE_ICON (source_object), res, &type, &err);
+  if (!stream) {
+    art_load_complete (load, NULL, err);
+    return;
+  }
+
+  g_debug ("Loading art of type: %s", type);
+  load_from_stream (load, stream);
+}
+
+
+static void
+on_size_prepared (GdkPixbufLoader *loader, int width, int height, gpointer user_data)
+{
+  int px = GPOINTER_TO_INT (user_data);
+
+  if (width >= height)
+    gdk_pixbuf_loader_set_size (loader, px, MAX (1, height * px / width));
+  else
+    gdk_pixbuf_loader_set_size (loader, MAX (1, width * px / height), px);
+}
+
+
+static void
+decode_data_uri_thread (GTask        *task,
+                        gpointer      source_object,
+                        gpointer      task_data,
+                        GCancellable *cancel)
+{
+  ArtLoad *load = task_data;
+  g_autoptr (GdkPixbufLoader) loader = NULL;
+  g_autoptr (GBytes) bytes = NULL;
+  GError *err = NULL;
+  GdkPixbuf *pixbuf;
+
+  bytes = soup_uri_decode_data_uri (load->url, NULL);
+  if (!bytes) {
+    g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_FAILED, "Failed to decode data URI");
+    return;
+  }
+
+  loader = gdk_pixbuf_loader_new ();
+  g_signal_connect (loader, "size-prepared", G_CALLBACK (on_size_prepared),
+                    GINT_TO_POINTER (load->size * load->scale));
+
+  if (!gdk_pixbuf_loader_write_bytes (loader, bytes, &err) ||
+      !gdk_pixbuf_loader_close (loader, &err)) {
+    g_task_return_error (task, err);
+    return;
+  }
+
+  pixbuf = gdk_pixbuf_loader_get_pixbuf (loader);
+  if (!pixbuf) {
+    g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_FAILED, "Failed to decode image");
+    return;
+  }
+
+  g_task_return_pointer (task, g_object_ref (pixbuf), g_object_unref);
+}
+
+
+static void
+on_data_uri_decoded (GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+  ArtLoad *load = user_data;
+  g_autoptr (GdkPixbuf) pixbuf = NULL;
+  g_autoptr (GError) err = NULL;
+
+  pixbuf = g_task_propagate_pointer (G_TASK (res), &err);
+  art_load_complete (load, pixbuf, err);
+}
+
+
+static void
+art_load_start (ArtLoad *load)
+{
+  PhoshMediaArtCache *self = load->cache;
+  const char *scheme = g_uri_peek_scheme (load->url);
+
+  g_debug ("Loading art for %s", load->key);
+
+  if (g_strcmp0 (scheme, "file") == 0) {
+    g_autoptr (GFile) file = g_file_new_for_uri (load->url);
+
+    g_file_read_async (file, G_PRIORITY_DEFAULT, self->cancel, on_file_read_ready, load);
+  } else if (g_strcmp0 (scheme, "http") == 0 || g_strcmp0 (scheme, "https") == 0) {
+    g_autoptr (GFile) file = g_file_new_for_uri (load->url);
+    g_autoptr (GIcon) icon = g_file_icon_new (file);
+
+    g_loadable_icon_load_async (G_LOADABLE_ICON (icon),
+                                load->size * load->scale,
+                                self->cancel,
+                                on_icon_load_ready,
+                                load);
+  } else if (g_strcmp0 (scheme, "data") == 0) {
+    g_autoptr (GTask) task = g_task_new (self, self->cancel, on_data_uri_decoded, load);
+
+    g_task_set_source_tag (task, art_load_start);
+    g_task_set_task_data (task, load, NULL);
+    g_task_run_in_thread (task, decode_data_uri_thread);
+  } else {
+    g_autoptr (GError) err = g_error_new (G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                                          "Unsupported art URL scheme '%s'", scheme);
+    art_load_complete (load, NULL, err);
+  }
+}
+
+
+static void
+phosh_media_art_cache_dispose (GObject *object)
+{
+  PhoshMediaArtCache *self = PHOSH_MEDIA_ART_CACHE (object);
+
+  g_cancellable_cancel (self->cancel);
+  g_clear_object (&self->cancel);
+
+  G_OBJECT_CLASS (phosh_media_art_cache_parent_class)->dispose (object);
+}
+
+
+static void
+phosh_media_art_cache_finalize (GObject *object)
+{
+  PhoshMediaArtCache *self = PHOSH_MEDIA_ART_CACHE (object);
+
+  g_queue_clear (&self->lru);
+  g_clear_pointer (&self->surfaces, g_hash_table_destroy);
+  g_clear_pointer (&self->loads, g_hash_table_destroy);
+
+  G_OBJECT_CLASS (phosh_media_art_cache_parent_class)->finalize (object);
+}
+
+
+static void
+phosh_media_art_cache_class_init (PhoshMediaArtCacheClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->dispose = phosh_media_art_cache_dispose;
+  object_class->finalize = phosh_media_art_cache_finalize;
+}
+
+
+static void
+phosh_media_art_cache_init (PhoshMediaArtCache *self)
+{
+  self->surfaces = g_hash_table_new_full (g_str_hash,
+                                          g_str_equal,
+                                          g_free,
+                                          (GDestroyNotify) cairo_surface_destroy);
+  self->loads = g_hash_table_new_full (g_str_hash,
+                                       g_str_equal,
+                                       NULL,
+                                       (GDestroyNotify) art_load_free);
+  g_queue_init (&self->lru);
+  self->cancel = g_cancellable_new ();
+}
+
+/**
+ * phosh_media_art_cache_get_default:
+ *
+ * Gets the media art cache singleton.
+ *
+ * Returns:(transfer none): The media art cache singleton.
+ */
+PhoshMediaArtCache *
+phosh_media_art_cache_get_default (void)
+{
+  static PhoshMediaArtCache *instance;
+
+  if (instance == NULL) {
+    g_debug ("Creating media art cache");
+    instance = g_object_new (PHOSH_TYPE_MEDIA_ART_CACHE, NULL);
+    g_object_add_weak_pointer (G_OBJECT (instance), (gpointer *)&instance);
+  }
+  return instance;
+}
+
+/**
+ * phosh_media_art_cache_lookup:
+ * @self: The media art cache
+ * @url: The art URL
+ * @size: The size in logical pixels
+ * @scale: The scale factor
+ *
+ * Looks up already loaded art.
+ *
+ * Returns:(transfer full)(nullable): The art or %NULL if not loaded yet
+ */
+cairo_surface_t *
+phosh_media_art_cache_lookup (PhoshMediaArtCache *self, const char *url, int size, int scale)
+{
+  g_autofree char *key = NULL;
+  cairo_surface_t *surface;
+  char *cache_key;
+
+  g_return_val_if_fail (PHOSH_IS_MEDIA_ART_CACHE (self), NULL);
+  g_return_val_if_fail (url, NULL);
+
+  key = get_key (url, size, scale);
+  if (!g_hash_table_lookup_extended (self->surfaces, key, (gpointer *)&cache_key,
+                                     (gpointer *)&surface)) {
+    return NULL;
+  }
+
+  /* Mark as most recently used */
+  g_queue_remove (&self->lru, cache_key);
+  g_queue_push_head (&self->lru, cache_key);
+
+  return cairo_surface_reference (surface);
+}
+
+/**
+ * phosh_media_art_cache_load_async:
+ * @self: The media art cache
+ * @url: The art URL
+ * @size: The size in logical pixels
+ * @scale: The scale factor
+ * @cancellable: (nullable): A cancellable
+ * @callback: The callback to invoke when the art is loaded
+ * @user_data: The data passed to @callback
+ *
+ * Loads the art at @url at the given size. If the art is already cached
+ * it is returned right away.
+ */
+void
+phosh_media_art_cache_load_async (PhoshMediaArtCache  *self,
+                                  const char          *url,
+                                  int                  size,
+                                  int                  scale,
+                                  GCancellable        *cancellable,
+                                  GAsyncReadyCallback  callback,
+                                  gpointer             user_data)
+{
+  g_autoptr (GTask) task = NULL;
+  g_autofree char *key = NULL;
+  cairo_surface_t *surface;
+  ArtLoad *load;
+
+  g_return_if_fail (PHOSH_IS_MEDIA_ART_CACHE (self));
+  g_return_if_fail (url);
+  g_return_if_fail (size > 0 && scale > 0);
+
+  task = g_task_new (self, cancellable, callback, user_data);
+  g_task_set_source_tag (task, phosh_media_art_cache_load_async);
+
+  surface = phosh_media_art_cache_lookup (self, url, size, scale);
+  if (surface) {
+    g_task_return_pointer (task, surface, (GDestroyNotify) cairo_surface_destroy);
+    return;
+  }
+
+  key = get_key (url, size, scale);
+  load = g_hash_table_lookup (self->loads, key);
+  if (load) {
+    g_debug ("Art for %s already loading", key);
+    g_ptr_array_add (load->tasks, g_steal_pointer (&task));
+    return;
+  }
+
+  load = g_new0 (ArtLoad, 1);
+  load->cache = g_object_ref (self);
+  load->key = g_steal_pointer (&key);
+  load->url = g_strdup (url);
+  load->size = size;
+  load->scale = scale;
+  load->tasks = g_ptr_array_new_with_free_func (g_object_unref);
+  g_ptr_array_add (load->tasks, g_steal_pointer (&task));
+  g_hash_table_insert (self->loads, load->key, load);
+
+  art_load_start (load);
+}
+
+/**
+ * phosh_media_art_cache_load_finish:
+ * @self: The media art cache
+ * @res: The async result
+ * @error: The location for a #GError
+ *
+ * Finishes loading art.
+ *
+ * Returns:(transfer full): The art ready to paint or %NULL on error
+ */
+cairo_surface_t *
+phosh_media_art_cache_load_finish (PhoshMediaArtCache *self, GAsyncResult *res, GError **error)
+{
+  g_return_val_if_fail (PHOSH_IS_MEDIA_ART_CACHE (self), NULL);
+  g_return_val_if_fail (g_task_is_valid (res, self), NULL);
+
+  return g_task_propagate_pointer (G_TASK (res), error);
+}
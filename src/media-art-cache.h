@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+#define PHOSH_TYPE_MEDIA_ART_CACHE (phosh_media_art_cache_get_type ())
+
+G_DECLARE_FINAL_TYPE (PhoshMediaArtCache, phosh_media_art_cache, PHOSH, MEDIA_ART_CACHE, GObject)
+
+PhoshMediaArtCache *phosh_media_art_cache_get_default (void);
+cairo_surface_t    *phosh_media_art_cache_lookup       (PhoshMediaArtCache   *self,
+                                                        const char           *url,
+                                                        int                   size,
+                                                        int                   scale);
+void                phosh_media_art_cache_load_async   (PhoshMediaArtCache   *self,
+                                                        const char           *url,
+                                                        int                   size,
+                                                        int                   scale,
+                                                        GCancellable         *cancellable,
+                                                        GAsyncReadyCallback   callback,
+                                                        gpointer              user_data);
+cairo_surface_t    *phosh_media_art_cache_load_finish  (PhoshMediaArtCache   *self,
+                                                        GAsyncResult         *res,
+                                                        GError              **error);
+
+G_END_DECLS
@@ -11,11 +11,13 @@
 
 #include "phosh-config.h"
 
+#include "media-art-cache.h"
 #include "mpris-dbus.h"
 #include "mpris-manager.h"
 #include "media-player.h"
 #include "shell-priv.h"
 #include "util.h"
+#include "watchdog.h"
 
 #include <gmobile.h>
 #include <cui-call.h>
@@ -29,9 +31,6 @@
 #define SEEK_BACK (-10 * SEEK_SECOND)
 #define SEEK_FORWARD (30 * SEEK_SECOND)
 
-G_DEFINE_AUTOPTR_CLEANUP_FUNC (cairo_t, cairo_destroy)
-G_DEFINE_AUTOPTR_CLEANUP_FUNC (cairo_surface_t, cairo_surface_destroy)
-
 /**
  * PhoshMediaPlayer:
  *
@@ -259,16 +258,35 @@ start_pos_poller (PhoshMediaPlayer *self)
     g_debug ("box_pos_len not visible, not starting position poller");
     return;
   }
+  if (phosh_shell_get_blanked (phosh_shell_get_default ())) {
+    g_debug ("Display blanked, not starting position poller");
+    return;
+  }
   if (priv->pos_poller_id != 0) {
     g_debug ("Position poller already running");
     return;
   }
   g_debug ("Starting position poller");
   poll_position (self);
-  priv->pos_poller_id = g_timeout_add_seconds (POLLER_INTERVAL,
-                                               (GSourceFunc) poll_position,
-                                               self);
-  g_source_set_name_by_id (priv->pos_poller_id, "[PhoshMediaPlayer] pos_poller");
+  priv->pos_poller_id = phosh_watchdog_timeout_add_seconds (POLLER_INTERVAL,
+                                                            (GSourceFunc) poll_position, self,
+                                                            "[PhoshMediaPlayer] pos_poller");
+}
+
+
+static void
+on_shell_blanked_changed (PhoshMediaPlayer *self, GParamSpec *pspec, PhoshShell *shell)
+{
+  PhoshMediaPlayerPrivate *priv = phosh_media_player_get_instance_private (self);
+
+  if (phosh_shell_get_blanked (shell)) {
+    stop_pos_poller (self);
+    return;
+  }
+
+  /* Resync the position right away, the poller polls on start */
+  if (priv->status == PHOSH_MEDIA_PLAYER_STATUS_PLAYING)
+    start_pos_poller (self);
 }
 
 
@@ -447,174 +465,66 @@ btn_details_clicked_cb (PhoshMediaPlayer *self, GtkButton *button)
 }
 
 
-static GdkPixbuf *
-center_pixbuf (GdkPixbuf *pixbuf)
-{
-  int width, height, size;
-  g_autoptr (GdkPixbuf) centered = NULL;
-  g_autoptr (cairo_t) cr = NULL;
-  g_autoptr (cairo_surface_t) surface = NULL;
-
-  g_return_val_if_fail (GDK_IS_PIXBUF (pixbuf), NULL);
-
-  width = gdk_pixbuf_get_width (pixbuf);
-  height = gdk_pixbuf_get_height (pixbuf);
-
-  if (width == height)
-    return g_object_ref (pixbuf);
-
-  size = MAX (width, height);
-  /* gdk_pixbuf_copy_area would work as well but that goes via gdk_pixbuf_scale, …*/
-  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, size, size);
-  cr = cairo_create (surface);
-  if (width > height)
-    gdk_cairo_set_source_pixbuf (cr, pixbuf, 0, (width - height) / 2.0);
-  else
-    gdk_cairo_set_source_pixbuf (cr, pixbuf, (height - width) / 2.0, 0);
-  cairo_paint (cr);
-
-  return gdk_pixbuf_get_from_surface (surface, 0, 0, size, size);
-}
-
-
-static GdkPixbuf *
-round_corners (GdkPixbuf *pixbuf)
-{
-  g_autoptr (GdkPixbuf) rounded = NULL;
-  g_autoptr (cairo_t) cr = NULL;
-  g_autoptr (cairo_surface_t) surface = NULL;
-  int width, height, size;
-  double radius;
-  const double degrees = M_PI / 180.0;
-
-  g_return_val_if_fail (GDK_IS_PIXBUF (pixbuf), NULL);
-
-  width = gdk_pixbuf_get_width (pixbuf);
-  height = gdk_pixbuf_get_height (pixbuf);
-
-  /* We only round square images */
-  g_return_val_if_fail (width == height, NULL);
-
-  size = width;
-  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, size, size);
-  cr = cairo_create (surface);
-
-  radius = size / 8.0;
-  cairo_new_path (cr);
-  cairo_arc (cr, size - radius, radius, radius, -90 * degrees, 0 * degrees);
-  cairo_arc (cr, size - radius, size - radius, radius, 0 * degrees, 90 * degrees);
-  cairo_arc (cr, radius, size - radius, radius, 90 * degrees, 180 * degrees);
-  cairo_arc (cr, radius, radius, radius, 180 * degrees, 270 * degrees);
-  cairo_close_path (cr);
-  cairo_clip (cr);
-
-  gdk_cairo_set_source_pixbuf (cr, pixbuf, 0, 0);
-  cairo_paint (cr);
-
-  return gdk_pixbuf_get_from_surface (surface, 0, 0, size, size);
-}
-
-
-static void
-phosh_media_player_set_image (PhoshMediaPlayer *self, GdkPixbuf *pixbuf)
-{
-  PhoshMediaPlayerPrivate *priv = phosh_media_player_get_instance_private (self);
-  g_autoptr (GdkPixbuf) centered = NULL;
-  g_autoptr (GdkPixbuf) rounded = NULL;
-
-  centered = center_pixbuf (pixbuf);
-  rounded = round_corners (centered);
-  g_object_set (priv->img_art, "gicon", rounded, NULL);
-}
-
-
 static void
-on_fetch_icon_ready (GObject *source_object, GAsyncResult *res, gpointer user_data)
+on_art_loaded (GObject *source_object, GAsyncResult *res, gpointer user_data)
 {
   PhoshMediaPlayer *self;
   PhoshMediaPlayerPrivate *priv;
-  g_autoptr (GInputStream) stream = NULL;
+  cairo_surface_t *surface;
   g_autoptr (GError) err = NULL;
-  g_autofree char *type = NULL;
-  g_autoptr (GdkPixbuf) pixbuf = NULL;
 
-  stream = g_loadable_icon_load_finish (G_LOADABLE_ICON (source_object), res, &type, &err);
-  if (!stream) {
-    g_warning ("Failed to fetch icon: %s", err->message);
+  surface = phosh_media_art_cache_load_finish (PHOSH_MEDIA_ART_CACHE (source_object), res, &err);
+  if (!surface) {
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED))
+      g_debug ("Can't load album art: %s", err->message);
+    else
+      phosh_async_error_warn (err, "Failed to load album art");
     return;
   }
 
-  g_debug ("Loading icon of type: %s", type);
   self = PHOSH_MEDIA_PLAYER (user_data);
   priv = phosh_media_player_get_instance_private (self);
-  pixbuf = gdk_pixbuf_new_from_stream (stream, priv->fetch_icon_cancel, &err);
-
-  phosh_media_player_set_image (self, pixbuf);
+  gtk_image_set_from_surface (GTK_IMAGE (priv->img_art), surface);
+  cairo_surface_destroy (surface);
 }
 
 
-static void
-fetch_icon_async (PhoshMediaPlayer *self, const char *url)
-
+/* Load the art for the current URL at the current scale */
+static gboolean
+load_art (PhoshMediaPlayer *self)
 {
   PhoshMediaPlayerPrivate *priv = phosh_media_player_get_instance_private (self);
-  g_autoptr (GFile) file = g_file_new_for_uri (url);
-  GIcon *icon;
-
-  g_debug ("Fetching icon for %s", url);
-
-  if (!priv->fetch_icon_cancel)
-    priv->fetch_icon_cancel = g_cancellable_new ();
-
-  icon = g_file_icon_new (file);
-  g_loadable_icon_load_async (G_LOADABLE_ICON (icon),
-                              ART_PIXEL_SIZE,
-                              priv->fetch_icon_cancel,
-                              on_fetch_icon_ready,
-                              self);
-}
-
-
-static void
-on_load_icon_from_file_ready (GObject *source_object, GAsyncResult *res, gpointer user_data)
-{
-  PhoshMediaPlayer *self;
-  g_autoptr (GdkPixbuf) pixbuf = NULL;
-  g_autoptr (GError) err = NULL;
-
-  pixbuf = gdk_pixbuf_new_from_stream_finish (res, &err);
-  if (!pixbuf) {
-    phosh_async_error_warn (err, "Failed to load image");
-    return;
-  }
+  PhoshMediaArtCache *cache = phosh_media_art_cache_get_default ();
+  cairo_surface_t *surface;
+  int scale;
 
-  self = PHOSH_MEDIA_PLAYER (user_data);
-  phosh_media_player_set_image (self, pixbuf);
-}
-
-
-static void
-phosh_media_player_load_icon_from_file_async (PhoshMediaPlayer *self, GFile *file)
-{
-  PhoshMediaPlayerPrivate *priv = phosh_media_player_get_instance_private (self);
-  g_autoptr (GFileInputStream) stream = NULL;
-  g_autoptr (GError) err = NULL;
+  /* Cancel any pending icon loads */
+  g_cancellable_cancel (priv->fetch_icon_cancel);
+  g_clear_object (&priv->fetch_icon_cancel);
 
-  stream = g_file_read (file, NULL, &err);
-  if (stream == NULL) {
-    g_autofree char *path = g_file_get_path (file);
+  if (priv->url == NULL)
+    return FALSE;
 
-    g_warning ("Failed to open '%s': %s", path, err->message);
-    return;
+  /* Art might already be loaded e.g. by the lockscreen's player */
+  scale = gtk_widget_get_scale_factor (priv->img_art);
+  surface = phosh_media_art_cache_lookup (cache, priv->url, ART_PIXEL_SIZE, scale);
+  if (surface) {
+    g_debug ("Using cached art for '%s'", priv->url);
+    gtk_image_set_from_surface (GTK_IMAGE (priv->img_art), surface);
+    cairo_surface_destroy (surface);
+    return TRUE;
   }
 
-  if (!priv->fetch_icon_cancel)
-    priv->fetch_icon_cancel = g_cancellable_new ();
-
-  gdk_pixbuf_new_from_stream_async (G_INPUT_STREAM (stream),
+  g_debug ("Loading '%s' at scale %d", priv->url, scale);
+  priv->fetch_icon_cancel = g_cancellable_new ();
+  phosh_media_art_cache_load_async (cache,
+                                    priv->url,
+                                    ART_PIXEL_SIZE,
+                                    scale,
                                     priv->fetch_icon_cancel,
-                                    on_load_icon_from_file_ready,
+                                    on_art_loaded,
                                     self);
+  return FALSE;
 }
 
 
@@ -622,39 +532,26 @@ static gboolean
 phosh_media_player_load_icon (PhoshMediaPlayer *self, const char *url)
 {
   PhoshMediaPlayerPrivate *priv = phosh_media_player_get_instance_private (self);
-  gboolean has_art = FALSE;
 
   if (!g_set_str (&priv->url, url)) {
     g_debug ("Media URL did not change, skippig load");
     return TRUE;
   }
 
-  g_debug ("Loading '%s'", url);
-  /* Cancel any pending icon loads */
-  g_cancellable_cancel (priv->fetch_icon_cancel);
-  g_clear_object (&priv->fetch_icon_cancel);
+  return load_art (self);
+}
 
-  if (url && g_strcmp0 (g_uri_peek_scheme (url), "file") == 0) {
-    g_autoptr (GFile) file = g_file_new_for_uri (url);
-
-    phosh_media_player_load_icon_from_file_async (self, file);
-  } else if (url && (g_strcmp0 (g_uri_peek_scheme (url), "http") == 0 ||
-                     g_strcmp0 (g_uri_peek_scheme (url), "https") == 0)) {
-    fetch_icon_async (self, url);
-  } else if (url && g_strcmp0 (g_uri_peek_scheme (url), "data") == 0) {
-    g_autoptr (GdkPixbuf) pixbuf = NULL;
-    g_autoptr (GError) error = NULL;
-
-    pixbuf = phosh_util_data_uri_to_pixbuf (url, &error);
-    if (pixbuf) {
-      phosh_media_player_set_image (self, pixbuf);
-      has_art = TRUE;
-    } else {
-      g_warning_once ("Failed to load album art from base64 string: %s", error->message);
-    }
-  }
 
-  return has_art;
+static void
+on_scale_factor_changed (PhoshMediaPlayer *self, GParamSpec *pspec, gpointer unused)
+{
+  PhoshMediaPlayerPrivate *priv = phosh_media_player_get_instance_private (self);
+
+  if (priv->url == NULL)
+    return;
+
+  /* Art is rendered for a specific scale, keep the current one until the new one is loaded */
+  load_art (self);
 }
 
 
@@ -934,6 +831,13 @@ phosh_media_player_init (PhoshMediaPlayer *self)
   priv->track_position = -1;
   priv->pos_poller_id = 0;
 
+  g_signal_connect_object (phosh_shell_get_default (),
+                           "notify::blanked",
+                           G_CALLBACK (on_shell_blanked_changed),
+                           self,
+                           G_CONNECT_SWAPPED);
+  g_signal_connect (self, "notify::scale-factor", G_CALLBACK (on_scale_factor_changed), NULL);
+
   if (manager) {
     priv->manager = g_object_ref (manager);
 
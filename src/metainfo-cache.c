@@ -11,14 +11,31 @@
 #include "config.h"
 #include "metainfo-cache.h"
 #include "util.h"
+#include "watchdog.h"
 
 #include <appstream/appstream.h>
 
 #include <gio/gio.h>
+#include <glib/gstdio.h>
+
+#include <errno.h>
+#include <string.h>
+
+#define INDEX_VERSION 3
+#define INDEX_GROUP "index"
+#define KEY_VERSION "version"
+#define LAUNCHABLES_GROUP "launchables"
+#define SOURCE_GROUP_PREFIX "file:"
+#define KEY_MTIME "mtime"
+#define KEY_DESKTOP_IDS "desktop-ids"
+#define KEY_DATA_IDS "data-ids"
+#define RESCAN_DELAY_MS 500
 
 enum {
   PROP_0,
   PROP_READY,
+  PROP_INDEX_PATH,
+  PROP_METAINFO_DIRS,
   LAST_PROP
 };
 static GParamSpec *props[LAST_PROP];
@@ -33,51 +50,684 @@ static guint signals[N_SIGNALS] = { 0 };
  * PhoshMetainfoCache:
  *
  * Cache for application meta information
+ *
+ * Looking up the AppStream data id of an app only needs the mapping
+ * from launchable desktop ids to data ids. Rather than loading the
+ * whole AppStream pool (which includes the OS catalog) we keep a small
+ * index of that mapping. The index is built in a worker thread from
+ * the files `AsPool` would load and persisted in the user's cache
+ * directory together with the launchables and modification times of
+ * each file. On changes to the source directories only the files that
+ * changed since are parsed again.
  */
 typedef struct _PhoshMetainfoCache {
   GObject       parent;
 
-  AsPool       *as_pool;
+  char         *index_path;
+  GStrv         metainfo_dirs;
+
   GCancellable *cancel;
   gboolean      ready;
+
+  /* key: desktop id, value: data id */
+  GHashTable   *index;
+  /* key: directory path, value: GFileMonitor */
+  GHashTable   *monitors;
+  guint         rescan_id;
+  gboolean      scanning;
+  gboolean      rescan_pending;
 } PhoshMetainfoCache;
 
 
 G_DEFINE_TYPE (PhoshMetainfoCache, phosh_metainfo_cache, G_TYPE_OBJECT)
 
 
+typedef struct {
+  char       *index_path;
+  GStrv       metainfo_dirs;
+
+  GHashTable *index;
+  /* The directories the index depends on */
+  GPtrArray  *dirs;
+  gboolean    changed;
+} ScanData;
+
+
+static void
+scan_data_free (ScanData *data)
+{
+  g_free (data->index_path);
+  g_strfreev (data->metainfo_dirs);
+  g_clear_pointer (&data->index, g_hash_table_unref);
+  g_clear_pointer (&data->dirs, g_ptr_array_unref);
+  g_free (data);
+}
+
+
+typedef enum {
+  SOURCE_KIND_METAINFO,
+  SOURCE_KIND_DESKTOP,
+  SOURCE_KIND_CATALOG,
+  SOURCE_KIND_FLATPAK,
+} SourceKind;
+
+
+typedef struct {
+  char       *path;
+  guint       depth;
+  SourceKind  kind;
+} SourceDir;
+
+
+static void
+source_dir_free (SourceDir *source)
+{
+  g_free (source->path);
+  g_free (source);
+}
+
+
+typedef struct {
+  char      *path;
+  SourceDir *source;
+} SourceFile;
+
+
+static void
+source_file_free (SourceFile *file)
+{
+  g_free (file->path);
+  g_free (file);
+}
+
+
+static void
+add_source_dir (GPtrArray *sources, SourceKind kind, guint depth, const char *first_element, ...)
+{
+  SourceDir *source = g_new0 (SourceDir, 1);
+  va_list args;
+
+  va_start (args, first_element);
+  source->path = g_build_filename_valist (first_element, &args);
+  va_end (args);
+
+  source->depth = depth;
+  source->kind = kind;
+  g_ptr_array_add (sources, source);
+}
+
+/*
+ * The locations AsPool loads data from (see AsPool's std data
+ * locations). Flatpak keeps its AppStream data in per remote and arch
+ * subdirectories hence we look deeper there. Like in AsPool
+ * catalog data takes precedence over metainfo files which take
+ * precedence over plain desktop files.
+ */
+static GPtrArray *
+get_source_dirs (ScanData *data)
+{
+  const char * const *data_dirs = g_get_system_data_dirs ();
+  const char *var_dirs[] = { "/var/cache", "/var/lib", NULL };
+  GPtrArray *sources = g_ptr_array_new_with_free_func ((GDestroyNotify) source_dir_free);
+  g_autoptr (GPtrArray) all_data_dirs = g_ptr_array_new ();
+
+  if (data->metainfo_dirs) {
+    for (int i = 0; data->metainfo_dirs[i]; i++)
+      add_source_dir (sources, SOURCE_KIND_METAINFO, 0, data->metainfo_dirs[i], NULL);
+    return sources;
+  }
+
+  g_ptr_array_add (all_data_dirs, (gpointer) g_get_user_data_dir ());
+  for (int i = 0; data_dirs[i]; i++)
+    g_ptr_array_add (all_data_dirs, (gpointer) data_dirs[i]);
+
+  for (guint i = 0; i < all_data_dirs->len; i++) {
+    const char *dir = g_ptr_array_index (all_data_dirs, i);
+
+    add_source_dir (sources, SOURCE_KIND_CATALOG, 0, dir, "swcatalog", "xml", NULL);
+    add_source_dir (sources, SOURCE_KIND_CATALOG, 0, dir, "swcatalog", "yaml", NULL);
+    add_source_dir (sources, SOURCE_KIND_CATALOG, 0, dir, "app-info", "xmls", NULL);
+    add_source_dir (sources, SOURCE_KIND_CATALOG, 0, dir, "app-info", "yaml", NULL);
+  }
+
+  for (int i = 0; var_dirs[i]; i++) {
+    add_source_dir (sources, SOURCE_KIND_CATALOG, 0, var_dirs[i], "swcatalog", "xml", NULL);
+    add_source_dir (sources, SOURCE_KIND_CATALOG, 0, var_dirs[i], "swcatalog", "yaml", NULL);
+    add_source_dir (sources, SOURCE_KIND_CATALOG, 0, var_dirs[i], "app-info", "xmls", NULL);
+    add_source_dir (sources, SOURCE_KIND_CATALOG, 0, var_dirs[i], "app-info", "yaml", NULL);
+  }
+
+  /* <remote>/<arch>/active/appstream.xml.gz */
+  add_source_dir (sources, SOURCE_KIND_FLATPAK, 3, "/var/lib/flatpak/appstream", NULL);
+  add_source_dir (sources, SOURCE_KIND_FLATPAK, 3, g_get_user_data_dir (), "flatpak", "appstream",
+                  NULL);
+
+  for (guint i = 0; i < all_data_dirs->len; i++) {
+    const char *dir = g_ptr_array_index (all_data_dirs, i);
+
+    add_source_dir (sources, SOURCE_KIND_METAINFO, 0, dir, "metainfo", NULL);
+    /* Legacy location */
+    add_source_dir (sources, SOURCE_KIND_METAINFO, 0, dir, "appdata", NULL);
+  }
+
+  for (guint i = 0; i < all_data_dirs->len; i++) {
+    const char *dir = g_ptr_array_index (all_data_dirs, i);
+
+    add_source_dir (sources, SOURCE_KIND_DESKTOP, 1, dir, "applications", NULL);
+  }
+
+  return sources;
+}
+
+
 static void
-on_as_pool_changed (PhoshMetainfoCache *self)
+add_stamp (GHashTable *stamps, char *path, gint64 mtime)
 {
-  g_debug ("Metainfo pool changed");
-  g_signal_emit (self, signals[CHANGED], 0);
+  g_hash_table_insert (stamps, path, g_memdup2 (&mtime, sizeof (mtime)));
 }
 
 
 static void
-on_as_pool_load_ready (GObject      *source_object,
-                       GAsyncResult *res,
-                       gpointer      user_data)
+stamp_dir (SourceDir  *source,
+           const char *dirname,
+           guint       depth,
+           GHashTable *stamps,
+           GPtrArray  *files,
+           GPtrArray  *dirs)
 {
-  gboolean success;
-  PhoshMetainfoCache *self;
+  g_autoptr (GDir) dir = NULL;
+  const char *name;
+  GStatBuf st;
+
+  if (g_stat (dirname, &st) != 0 || !S_ISDIR (st.st_mode))
+    return;
+
+  /* Already covered by another source */
+  if (g_hash_table_contains (stamps, dirname))
+    return;
+
+  add_stamp (stamps, g_strdup (dirname), st.st_mtime);
+  g_ptr_array_add (dirs, g_strdup (dirname));
+
+  dir = g_dir_open (dirname, 0, NULL);
+  if (!dir)
+    return;
+
+  while ((name = g_dir_read_name (dir))) {
+    g_autofree char *path = g_build_filename (dirname, name, NULL);
+    SourceFile *file;
+
+    if (g_stat (path, &st) != 0)
+      continue;
+
+    if (S_ISDIR (st.st_mode)) {
+      /* Flatpak keeps older revisions next to the active one */
+      if (source->kind == SOURCE_KIND_FLATPAK && depth == 1 && !g_str_equal (name, "active"))
+        continue;
+      if (depth > 0)
+        stamp_dir (source, path, depth - 1, stamps, files, dirs);
+      continue;
+    }
+
+    file = g_new0 (SourceFile, 1);
+    file->path = g_strdup (path);
+    file->source = source;
+    g_ptr_array_add (files, file);
+    add_stamp (stamps, g_steal_pointer (&path), st.st_mtime);
+  }
+}
+
+/* Whether the index was built from the sources with the given stamps */
+static gboolean
+index_is_current (GKeyFile *keyfile, GHashTable *stamps)
+{
+  g_auto (GStrv) groups = NULL;
+  guint n_sources = 0;
+
+  if (g_key_file_get_integer (keyfile, INDEX_GROUP, KEY_VERSION, NULL) != INDEX_VERSION)
+    return FALSE;
+
+  groups = g_key_file_get_groups (keyfile, NULL);
+  for (int i = 0; groups[i]; i++) {
+    const char *path;
+    gint64 *mtime;
+
+    if (!g_str_has_prefix (groups[i], SOURCE_GROUP_PREFIX))
+      continue;
+
+    path = groups[i] + strlen (SOURCE_GROUP_PREFIX);
+    mtime = g_hash_table_lookup (stamps, path);
+    if (!mtime)
+      return FALSE;
+
+    if (g_key_file_get_int64 (keyfile, groups[i], KEY_MTIME, NULL) != *mtime)
+      return FALSE;
+
+    n_sources++;
+  }
+
+  return n_sources == g_hash_table_size (stamps);
+}
+
+
+static void
+load_index (GKeyFile *keyfile, GHashTable *index)
+{
+  g_auto (GStrv) keys = g_key_file_get_keys (keyfile, LAUNCHABLES_GROUP, NULL, NULL);
+
+  for (int i = 0; keys && keys[i]; i++) {
+    char *data_id = g_key_file_get_string (keyfile, LAUNCHABLES_GROUP, keys[i], NULL);
+
+    if (data_id)
+      g_hash_table_insert (index, g_strdup (keys[i]), data_id);
+  }
+}
+
+
+static gboolean
+is_parsable (SourceFile *file)
+{
+  const char *suffixes[] = { ".xml", ".xml.gz", ".yml", ".yml.gz", ".yaml", ".yaml.gz", NULL };
+
+  switch (file->source->kind) {
+  case SOURCE_KIND_DESKTOP:
+    return g_str_has_suffix (file->path, ".desktop");
+  case SOURCE_KIND_FLATPAK:
+    /* Flatpak also keeps an uncompressed copy */
+    return g_str_has_suffix (file->path, "/appstream.xml.gz");
+  case SOURCE_KIND_METAINFO:
+  case SOURCE_KIND_CATALOG:
+  default:
+    break;
+  }
+
+  for (int i = 0; suffixes[i]; i++) {
+    if (g_str_has_suffix (file->path, suffixes[i]))
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+/*
+ * Build the data id like AsPool does: scope and bundle kind are
+ * determined by where the data came from, origin and branch by the
+ * data itself.
+ */
+static char *
+build_data_id (AsComponent *cpt, SourceFile *file)
+{
+  AsComponentScope scope = AS_COMPONENT_SCOPE_SYSTEM;
+  AsBundleKind bundle = AS_BUNDLE_KIND_PACKAGE;
+  const char *origin = as_component_get_origin (cpt);
+  const char *branch = as_component_get_branch (cpt);
+  g_auto (GStrv) parts = NULL;
+
+  if (g_str_has_prefix (file->path, g_get_user_data_dir ()))
+    scope = AS_COMPONENT_SCOPE_USER;
+
+  if (file->source->kind == SOURCE_KIND_FLATPAK) {
+    const char *relpath = file->path + strlen (file->source->path);
+
+    bundle = AS_BUNDLE_KIND_FLATPAK;
+    /* The origin of Flatpak data is the remote's name */
+    parts = g_strsplit (relpath, G_DIR_SEPARATOR_S, -1);
+    if (g_strv_length (parts) > 1 && *parts[1])
+      origin = parts[1];
+  }
+
+  return g_strdup_printf ("%s/%s/%s/%s/%s",
+                          as_component_scope_to_string (scope),
+                          as_bundle_kind_to_string (bundle),
+                          origin && *origin ? origin : "*",
+                          as_component_get_id (cpt),
+                          branch && *branch ? branch : "*");
+}
+
+/*
+ * Parse a single source file and record the launchables it provides
+ * in its group of the index.
+ */
+static void
+parse_source_file (SourceFile *file, GKeyFile *keyfile, const char *group)
+{
+  g_autoptr (AsMetadata) metadata = NULL;
+  g_autoptr (GFile) gfile = NULL;
+  g_autoptr (GPtrArray) desktop_ids = NULL;
+  g_autoptr (GPtrArray) data_ids = NULL;
   g_autoptr (GError) err = NULL;
+  AsComponentBox *cpts;
+
+  if (!is_parsable (file))
+    return;
+
+  metadata = as_metadata_new ();
+  gfile = g_file_new_for_path (file->path);
+  if (file->source->kind == SOURCE_KIND_CATALOG || file->source->kind == SOURCE_KIND_FLATPAK)
+    as_metadata_set_format_style (metadata, AS_FORMAT_STYLE_CATALOG);
+  else
+    as_metadata_set_format_style (metadata, AS_FORMAT_STYLE_METAINFO);
 
-  success = as_pool_load_finish (AS_POOL (source_object), res, &err);
-  if (!success) {
-    phosh_async_error_warn (err, "Failed to load metainfo pool");
+  /* Broken files are remembered too so we don't reparse them on every scan */
+  if (!as_metadata_parse_file (metadata, gfile, AS_FORMAT_KIND_UNKNOWN, &err)) {
+    g_debug ("Failed to parse %s: %s", file->path, err->message);
     return;
   }
 
-  g_return_if_fail (PHOSH_IS_METAINFO_CACHE (user_data));
-  self = PHOSH_METAINFO_CACHE (user_data);
+  desktop_ids = g_ptr_array_new_with_free_func (g_free);
+  data_ids = g_ptr_array_new_with_free_func (g_free);
+
+  cpts = as_metadata_get_components (metadata);
+  for (guint i = 0; i < as_component_box_len (cpts); i++) {
+    AsComponent *cpt = as_component_box_index (cpts, i);
+    AsLaunchable *launchable;
+    GPtrArray *entries;
+
+    launchable = as_component_get_launchable (cpt, AS_LAUNCHABLE_KIND_DESKTOP_ID);
+    if (!launchable)
+      continue;
 
-  g_signal_connect_object (self->as_pool, "changed", G_CALLBACK (on_as_pool_changed), self,
-                           G_CONNECT_SWAPPED);
+    entries = as_launchable_get_entries (launchable);
+    for (guint j = 0; entries && j < entries->len; j++) {
+      g_ptr_array_add (desktop_ids, g_strdup (g_ptr_array_index (entries, j)));
+      g_ptr_array_add (data_ids, build_data_id (cpt, file));
+    }
+  }
+
+  if (desktop_ids->len == 0)
+    return;
 
-  self->ready = TRUE;
-  g_debug ("Metainfo cache loaded");
-  g_object_notify_by_pspec (G_OBJECT (self), props[PROP_READY]);
+  g_key_file_set_string_list (keyfile, group, KEY_DESKTOP_IDS,
+                              (const char * const *) desktop_ids->pdata, desktop_ids->len);
+  g_key_file_set_string_list (keyfile, group, KEY_DATA_IDS,
+                              (const char * const *) data_ids->pdata, data_ids->len);
+}
+
+/*
+ * Update the index using the launchables recorded for unchanged files
+ * in the old index and only parsing files that changed.
+ */
+static gboolean
+build_index (ScanData     *data,
+             GPtrArray    *files,
+             GHashTable   *stamps,
+             GKeyFile     *old,
+             GKeyFile     *keyfile,
+             GCancellable *cancel,
+             GError      **error)
+{
+  guint n_parsed = 0;
+
+  for (guint i = 0; i < files->len; i++) {
+    SourceFile *file = g_ptr_array_index (files, i);
+    g_autofree char *group = g_strconcat (SOURCE_GROUP_PREFIX, file->path, NULL);
+    g_auto (GStrv) desktop_ids = NULL;
+    g_auto (GStrv) data_ids = NULL;
+    gint64 mtime = *(gint64 *) g_hash_table_lookup (stamps, file->path);
+    gsize n_desktop_ids = 0, n_data_ids = 0;
+
+    if (g_cancellable_set_error_if_cancelled (cancel, error))
+      return FALSE;
+
+    g_key_file_set_int64 (keyfile, group, KEY_MTIME, mtime);
+
+    if (g_key_file_has_group (old, group) &&
+        g_key_file_get_int64 (old, group, KEY_MTIME, NULL) == mtime) {
+      desktop_ids = g_key_file_get_string_list (old, group, KEY_DESKTOP_IDS, &n_desktop_ids, NULL);
+      data_ids = g_key_file_get_string_list (old, group, KEY_DATA_IDS, &n_data_ids, NULL);
+      if (desktop_ids && data_ids && n_desktop_ids == n_data_ids) {
+        g_key_file_set_string_list (keyfile, group, KEY_DESKTOP_IDS,
+                                    (const char * const *) desktop_ids, n_desktop_ids);
+        g_key_file_set_string_list (keyfile, group, KEY_DATA_IDS,
+                                    (const char * const *) data_ids, n_data_ids);
+      }
+    } else {
+      parse_source_file (file, keyfile, group);
+      n_parsed++;
+      desktop_ids = g_key_file_get_string_list (keyfile, group, KEY_DESKTOP_IDS, &n_desktop_ids,
+                                                NULL);
+      data_ids = g_key_file_get_string_list (keyfile, group, KEY_DATA_IDS, &n_data_ids, NULL);
+    }
+
+    for (gsize j = 0; desktop_ids && data_ids && j < MIN (n_desktop_ids, n_data_ids); j++) {
+      /* Like as_pool_get_components_by_launchable () we use the first match */
+      if (g_hash_table_contains (data->index, desktop_ids[j]))
+        continue;
+
+      g_hash_table_insert (data->index, g_strdup (desktop_ids[j]), g_strdup (data_ids[j]));
+    }
+  }
+
+  g_debug ("Updated %u of %u metainfo sources", n_parsed, files->len);
+  return TRUE;
+}
+
+
+static void
+save_index (ScanData *data, GKeyFile *keyfile, GHashTable *stamps)
+{
+  g_autofree char *dirname = g_path_get_dirname (data->index_path);
+  g_autoptr (GError) err = NULL;
+  GHashTableIter iter;
+  gpointer key, value;
+
+  g_key_file_set_integer (keyfile, INDEX_GROUP, KEY_VERSION, INDEX_VERSION);
+
+  g_hash_table_iter_init (&iter, data->index);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    g_key_file_set_string (keyfile, LAUNCHABLES_GROUP, key, value);
+
+  /* Directories, files already got their group */
+  g_hash_table_iter_init (&iter, stamps);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    g_autofree char *group = g_strconcat (SOURCE_GROUP_PREFIX, key, NULL);
+
+    g_key_file_set_int64 (keyfile, group, KEY_MTIME, *(gint64 *) value);
+  }
+
+  if (g_mkdir_with_parents (dirname, 0755) != 0 ||
+      !g_key_file_save_to_file (keyfile, data->index_path, &err)) {
+    g_warning ("Failed to save metainfo index to %s: %s", data->index_path,
+               err ? err->message : g_strerror (errno));
+  }
+}
+
+/*
+ * Use the persisted index if the sources didn't change since it was
+ * written, otherwise update and persist it.
+ * Runs in a worker thread.
+ */
+static void
+scan_metainfo_thread (GTask        *task,
+                      gpointer      source_object,
+                      gpointer      task_data,
+                      GCancellable *cancel)
+{
+  ScanData *data = task_data;
+  g_autoptr (GPtrArray) sources = get_source_dirs (data);
+  g_autoptr (GPtrArray) files = g_ptr_array_new_with_free_func ((GDestroyNotify) source_file_free);
+  g_autoptr (GHashTable) stamps = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+  g_autoptr (GKeyFile) old = g_key_file_new ();
+  g_autoptr (GKeyFile) keyfile = g_key_file_new ();
+  g_autoptr (GError) err = NULL;
+
+  for (guint i = 0; i < sources->len; i++) {
+    SourceDir *source = g_ptr_array_index (sources, i);
+
+    stamp_dir (source, source->path, source->depth, stamps, files, data->dirs);
+  }
+
+  if (g_key_file_load_from_file (old, data->index_path, G_KEY_FILE_NONE, &err)) {
+    if (index_is_current (old, stamps)) {
+      load_index (old, data->index);
+      g_debug ("Metainfo index is current, %u entries", g_hash_table_size (data->index));
+      g_task_return_boolean (task, TRUE);
+      return;
+    }
+
+    /* Entries of older index versions can't be reused */
+    if (g_key_file_get_integer (old, INDEX_GROUP, KEY_VERSION, NULL) != INDEX_VERSION)
+      g_clear_pointer (&old, g_key_file_unref);
+  } else if (!g_error_matches (err, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
+    g_warning ("Failed to load metainfo index from %s: %s", data->index_path, err->message);
+  }
+  g_clear_error (&err);
+
+  if (!old)
+    old = g_key_file_new ();
+
+  if (!build_index (data, files, stamps, old, keyfile, cancel, &err)) {
+    g_task_return_error (task, g_steal_pointer (&err));
+    return;
+  }
+
+  if (g_task_return_error_if_cancelled (task))
+    return;
+
+  save_index (data, keyfile, stamps);
+  data->changed = TRUE;
+
+  g_debug ("Updated metainfo index, %u entries", g_hash_table_size (data->index));
+  g_task_return_boolean (task, TRUE);
+}
+
+
+static void scan_metainfo (PhoshMetainfoCache *self);
+static void on_metainfo_dir_changed (PhoshMetainfoCache *self,
+                                     GFile              *file,
+                                     GFile              *other_file,
+                                     GFileMonitorEvent   event_type,
+                                     GFileMonitor       *monitor);
+
+
+static void
+monitor_dirs (PhoshMetainfoCache *self, GPtrArray *dirs)
+{
+  for (guint i = 0; i < dirs->len; i++) {
+    const char *path = g_ptr_array_index (dirs, i);
+    g_autoptr (GFile) dir = NULL;
+    g_autoptr (GError) err = NULL;
+    GFileMonitor *monitor;
+
+    if (g_hash_table_contains (self->monitors, path))
+      continue;
+
+    dir = g_file_new_for_path (path);
+    monitor = g_file_monitor_directory (dir, G_FILE_MONITOR_WATCH_MOVES, self->cancel, &err);
+    if (!monitor) {
+      g_debug ("Failed to monitor %s: %s", path, err->message);
+      continue;
+    }
+
+    g_signal_connect_object (monitor, "changed", G_CALLBACK (on_metainfo_dir_changed), self,
+                             G_CONNECT_SWAPPED);
+    g_hash_table_insert (self->monitors, g_strdup (path), monitor);
+  }
+}
+
+
+static void
+on_scan_metainfo_ready (GObject      *source_object,
+                        GAsyncResult *res,
+                        gpointer      user_data)
+{
+  PhoshMetainfoCache *self = PHOSH_METAINFO_CACHE (source_object);
+  ScanData *data = g_task_get_task_data (G_TASK (res));
+  g_autoptr (GError) err = NULL;
+
+  if (!g_task_propagate_boolean (G_TASK (res), &err)) {
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+      return;
+
+    /* Keep the current (possibly empty) index but still watch for changes
+     * so a later fix up of the sources triggers a rebuild */
+    g_warning ("Failed to build metainfo index: %s", err->message);
+  } else {
+    g_clear_pointer (&self->index, g_hash_table_unref);
+    self->index = g_steal_pointer (&data->index);
+  }
+
+  self->scanning = FALSE;
+  monitor_dirs (self, data->dirs);
+
+  if (self->rescan_pending) {
+    self->rescan_pending = FALSE;
+    scan_metainfo (self);
+  }
+
+  if (!self->ready) {
+    self->ready = TRUE;
+    g_debug ("Metainfo cache loaded");
+    g_object_notify_by_pspec (G_OBJECT (self), props[PROP_READY]);
+  } else if (data->changed) {
+    g_signal_emit (self, signals[CHANGED], 0);
+  }
+}
+
+
+static void
+scan_metainfo (PhoshMetainfoCache *self)
+{
+  g_autoptr (GTask) task = NULL;
+  ScanData *data;
+
+  if (self->scanning) {
+    self->rescan_pending = TRUE;
+    return;
+  }
+
+  data = g_new0 (ScanData, 1);
+  data->index_path = g_strdup (self->index_path);
+  data->metainfo_dirs = g_strdupv (self->metainfo_dirs);
+  data->index = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+  data->dirs = g_ptr_array_new_with_free_func (g_free);
+  self->scanning = TRUE;
+
+  task = g_task_new (self, self->cancel, on_scan_metainfo_ready, NULL);
+  g_task_set_source_tag (task, scan_metainfo);
+  g_task_set_task_data (task, data, (GDestroyNotify) scan_data_free);
+  g_task_set_priority (task, G_PRIORITY_LOW);
+  g_task_run_in_thread (task, scan_metainfo_thread);
+}
+
+
+static gboolean
+on_rescan_timeout (gpointer user_data)
+{
+  PhoshMetainfoCache *self = PHOSH_METAINFO_CACHE (user_data);
+
+  self->rescan_id = 0;
+  scan_metainfo (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static void
+on_metainfo_dir_changed (PhoshMetainfoCache *self,
+                         GFile              *file,
+                         GFile              *other_file,
+                         GFileMonitorEvent   event_type,
+                         GFileMonitor       *monitor)
+{
+  switch (event_type) {
+  case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
+  case G_FILE_MONITOR_EVENT_DELETED:
+  case G_FILE_MONITOR_EVENT_CREATED:
+  case G_FILE_MONITOR_EVENT_MOVED_IN:
+  case G_FILE_MONITOR_EVENT_MOVED_OUT:
+  case G_FILE_MONITOR_EVENT_RENAMED:
+    break;
+  default:
+    return;
+  }
+
+  /* Package installs touch many files at once so batch them */
+  if (self->rescan_id)
+    return;
+
+  self->rescan_id = phosh_watchdog_timeout_add (RESCAN_DELAY_MS, on_rescan_timeout, self,
+                                                "[phosh] metainfo rescan");
 }
 
 
@@ -88,16 +738,32 @@ phosh_metainfo_cache_constructed (GObject *object)
 
   G_OBJECT_CLASS (phosh_metainfo_cache_parent_class)->constructed (object);
 
-  self->as_pool = as_pool_new ();
-  /* We only bother about metainfo in a non-system cache */
-  as_pool_set_flags (self->as_pool,
-                     AS_POOL_FLAG_LOAD_OS_CATALOG | AS_POOL_FLAG_LOAD_OS_DESKTOP_FILES |
-                     AS_POOL_FLAG_LOAD_OS_METAINFO | AS_POOL_FLAG_LOAD_FLATPAK |
-                     AS_POOL_FLAG_MONITOR);
+  if (!self->index_path)
+    self->index_path = g_build_filename (g_get_user_cache_dir (), "phosh", "metainfo-index", NULL);
 
-  as_pool_load_async (self->as_pool, self->cancel,
-                      on_as_pool_load_ready,
-                      self);
+  scan_metainfo (self);
+}
+
+
+static void
+phosh_metainfo_cache_set_property (GObject      *object,
+                                   guint         property_id,
+                                   const GValue *value,
+                                   GParamSpec   *pspec)
+{
+  PhoshMetainfoCache *self = PHOSH_METAINFO_CACHE (object);
+
+  switch (property_id) {
+  case PROP_INDEX_PATH:
+    self->index_path = g_value_dup_string (value);
+    break;
+  case PROP_METAINFO_DIRS:
+    self->metainfo_dirs = g_value_dup_boxed (value);
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+    break;
+  }
 }
 
 
@@ -113,6 +779,12 @@ phosh_metainfo_cache_get_property (GObject    *object,
   case PROP_READY:
     g_value_set_boolean (value, self->ready);
     break;
+  case PROP_INDEX_PATH:
+    g_value_set_string (value, self->index_path);
+    break;
+  case PROP_METAINFO_DIRS:
+    g_value_set_boxed (value, self->metainfo_dirs);
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
     break;
@@ -127,29 +799,66 @@ phosh_metainfo_cache_dispose (GObject *object)
 
   g_cancellable_cancel (self->cancel);
   g_clear_object (&self->cancel);
-  g_clear_object (&self->as_pool);
+  g_clear_handle_id (&self->rescan_id, g_source_remove);
+  g_clear_pointer (&self->monitors, g_hash_table_unref);
+  g_clear_pointer (&self->index, g_hash_table_unref);
 
   G_OBJECT_CLASS (phosh_metainfo_cache_parent_class)->dispose (object);
 }
 
 
+static void
+phosh_metainfo_cache_finalize (GObject *object)
+{
+  PhoshMetainfoCache *self = PHOSH_METAINFO_CACHE (object);
+
+  g_free (self->index_path);
+  g_strfreev (self->metainfo_dirs);
+
+  G_OBJECT_CLASS (phosh_metainfo_cache_parent_class)->finalize (object);
+}
+
+
 static void
 phosh_metainfo_cache_class_init (PhoshMetainfoCacheClass *klass)
 {
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
   object_class->constructed = phosh_metainfo_cache_constructed;
+  object_class->set_property = phosh_metainfo_cache_set_property;
   object_class->get_property = phosh_metainfo_cache_get_property;
   object_class->dispose = phosh_metainfo_cache_dispose;
+  object_class->finalize = phosh_metainfo_cache_finalize;
 
   /**
    * PhoshMetainfoCache:ready:
    *
-   * Whether the cache is ready to use
+   * Whether the cache is ready to use. This happens once the
+   * launchable index is up to date.
    */
   props[PROP_READY] =
     g_param_spec_boolean ("ready", "", "", FALSE,
                           G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+  /**
+   * PhoshMetainfoCache:index-path:
+   *
+   * Where to persist the launchable index. Defaults to a file in the
+   * user's cache directory.
+   */
+  props[PROP_INDEX_PATH] =
+    g_param_spec_string ("index-path", "", "",
+                         NULL,
+                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+  /**
+   * PhoshMetainfoCache:metainfo-dirs:
+   *
+   * If set only metainfo files in these directories are indexed instead
+   * of AppStream's standard data locations.
+   */
+  props[PROP_METAINFO_DIRS] =
+    g_param_spec_boxed ("metainfo-dirs", "", "",
+                        G_TYPE_STRV,
+                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
 
   g_object_class_install_properties (object_class, LAST_PROP, props);
 
@@ -163,6 +872,27 @@ static void
 phosh_metainfo_cache_init (PhoshMetainfoCache *self)
 {
   self->cancel = g_cancellable_new ();
+  self->monitors = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+  self->index = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+}
+
+/**
+ * phosh_metainfo_cache_new:
+ * @index_path:(nullable): Where to persist the index
+ * @metainfo_dirs:(nullable): Directories with metainfo files to index
+ *
+ * Create a new metainfo cache. Unless you need to use non-standard
+ * locations use `phosh_metainfo_cache_get_default()`.
+ *
+ * Returns:(transfer full): The new metainfo cache
+ */
+PhoshMetainfoCache *
+phosh_metainfo_cache_new (const char *index_path, const char * const *metainfo_dirs)
+{
+  return g_object_new (PHOSH_TYPE_METAINFO_CACHE,
+                       "index-path", index_path,
+                       "metainfo-dirs", metainfo_dirs,
+                       NULL);
 }
 
 
@@ -182,18 +912,15 @@ phosh_metainfo_cache_get_default (void)
  * phosh_metainfo_get_data_id:
  * @app_id: desktop app id
  *
+ * Looks up the data id in the launchable index.
+ *
  * Returns (transfer full): the 5-part AppStream identifier or NULL
  */
 char *
 phosh_metainfo_get_data_id (PhoshMetainfoCache *self, const char *app_id)
 {
-  g_autoptr (AsComponentBox) result = NULL;
-
-  result = as_pool_get_components_by_launchable (self->as_pool, AS_LAUNCHABLE_KIND_DESKTOP_ID,
-                                                 app_id);
-
-  if (!result || as_component_box_is_empty (result))
-    return NULL;
+  g_return_val_if_fail (PHOSH_IS_METAINFO_CACHE (self), NULL);
+  g_return_val_if_fail (app_id, NULL);
 
-  return g_strdup (as_component_get_data_id (as_component_box_index_safe (result, 0)));
+  return g_strdup (g_hash_table_lookup (self->index, app_id));
 }
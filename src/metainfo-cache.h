@@ -15,6 +15,8 @@ G_BEGIN_DECLS
 G_DECLARE_FINAL_TYPE (PhoshMetainfoCache, phosh_metainfo_cache,
                       PHOSH, METAINFO_CACHE, GObject)
 
+PhoshMetainfoCache *phosh_metainfo_cache_new         (const char         *index_path,
+                                                      const char * const *metainfo_dirs);
 PhoshMetainfoCache *phosh_metainfo_cache_get_default (void);
 char               *phosh_metainfo_get_data_id (PhoshMetainfoCache *self, const char *cid);
 
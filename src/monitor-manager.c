@@ -20,6 +20,7 @@
 #include "shell-priv.h"
 
 #include "util.h"
+#include "watchdog.h"
 
 #include "dbus/gsd-color-dbus.h"
 
@@ -28,6 +29,9 @@
 #define GSD_COLOR_BUS_NAME "org.gnome.SettingsDaemon.Color"
 #define GSD_COLOR_OBJECT_PATH "/org/gnome/SettingsDaemon/Color"
 
+/* How long to wait for the head state after a configuration got applied */
+#define AWAITING_DONE_TIMEOUT_MS 1000
+
 /**
  * PhoshMonitorManager:
  *
@@ -50,6 +54,7 @@ enum {
   PROP_SENSOR_PROXY_MANAGER,
   PROP_N_MONITORS,
   PROP_NIGHT_LIGHT_TEMP,
+  PROP_CONFIG_PENDING,
   PROP_LAST_PROP
 };
 static GParamSpec *props[PROP_LAST_PROP];
@@ -82,6 +87,12 @@ typedef struct _PhoshMonitorManager
 
   PhoshHead *pending_primary;
   uint32_t zwlr_output_serial;
+  /* Configurations waiting for succeeded/failed/cancelled */
+  guint    n_configs_in_flight;
+  /* A configuration succeeded but the new head state isn't there yet */
+  gboolean awaiting_done;
+  guint    awaiting_done_id;
+  gboolean config_pending;
 
   GCancellable            *cancel;
 } PhoshMonitorManager;
@@ -1101,6 +1112,20 @@ zwlr_output_manager_v1_handle_head (void                          *data,
 }
 
 
+static void
+update_config_pending (PhoshMonitorManager *self)
+{
+  gboolean pending = self->n_configs_in_flight > 0 || self->awaiting_done;
+
+  if (pending == self->config_pending)
+    return;
+
+  self->config_pending = pending;
+  g_debug ("Output configuration %s", pending ? "pending" : "settled");
+  g_object_notify_by_pspec (G_OBJECT (self), props[PROP_CONFIG_PENDING]);
+}
+
+
 static void
 zwlr_output_manager_v1_handle_done (void                          *data,
                                     struct zwlr_output_manager_v1 *manager,
@@ -1114,6 +1139,11 @@ zwlr_output_manager_v1_handle_done (void                          *data,
   self->serial++;
 
   phosh_dbus_display_config_emit_monitors_changed (PHOSH_DBUS_DISPLAY_CONFIG (self));
+
+  /* Head state now reflects the applied configuration */
+  self->awaiting_done = FALSE;
+  g_clear_handle_id (&self->awaiting_done_id, g_source_remove);
+  update_config_pending (self);
 }
 
 
@@ -1123,12 +1153,48 @@ static const struct zwlr_output_manager_v1_listener zwlr_output_manager_v1_liste
 };
 
 
+static gboolean
+on_awaiting_done_timeout (gpointer data)
+{
+  PhoshMonitorManager *self = PHOSH_MONITOR_MANAGER (data);
+
+  /* E.g. the configuration didn't change anything so there's no new head state */
+  g_debug ("No head state after applying configuration, not waiting any longer");
+  self->awaiting_done_id = 0;
+  self->awaiting_done = FALSE;
+  update_config_pending (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static void
+config_finished (PhoshMonitorManager *self, gboolean succeeded)
+{
+  g_return_if_fail (self->n_configs_in_flight > 0);
+
+  self->n_configs_in_flight--;
+  if (succeeded) {
+    self->awaiting_done = TRUE;
+    g_clear_handle_id (&self->awaiting_done_id, g_source_remove);
+    self->awaiting_done_id = phosh_watchdog_timeout_add (AWAITING_DONE_TIMEOUT_MS,
+                                                         on_awaiting_done_timeout, self,
+                                                         "[phosh] monitor manager awaiting done");
+  }
+
+  update_config_pending (self);
+}
+
+
 static void
 zwlr_output_configuration_v1_handle_succeeded (void                                *data,
                                                struct zwlr_output_configuration_v1 *config)
 {
+  PhoshMonitorManager *self = PHOSH_MONITOR_MANAGER (data);
+
   g_debug ("New output configuration %p applied", config);
   zwlr_output_configuration_v1_destroy (config);
+  config_finished (self, TRUE);
 }
 
 
@@ -1136,9 +1202,12 @@ static void
 zwlr_output_configuration_v1_handle_failed (void                                *data,
                                             struct zwlr_output_configuration_v1 *config)
 {
+  PhoshMonitorManager *self = PHOSH_MONITOR_MANAGER (data);
+
   /* TODO: bubble up error */
   g_warning ("Failed to apply New output %p configuration", config);
   zwlr_output_configuration_v1_destroy (config);
+  config_finished (self, FALSE);
 }
 
 
@@ -1146,8 +1215,11 @@ static void
 zwlr_output_configuration_v1_handle_cancelled (void                                *data,
                                                struct zwlr_output_configuration_v1 *config)
 {
+  PhoshMonitorManager *self = PHOSH_MONITOR_MANAGER (data);
+
   zwlr_output_configuration_v1_destroy (config);
   g_warning ("Failed to apply New output configuration %p due to changes", config);
+  config_finished (self, FALSE);
 }
 
 
@@ -1164,6 +1236,7 @@ phosh_monitor_manager_dispose (GObject *object)
   PhoshMonitorManager *self = PHOSH_MONITOR_MANAGER (object);
 
   g_clear_handle_id (&self->dbus_name_id, g_bus_unown_name);
+  g_clear_handle_id (&self->awaiting_done_id, g_source_remove);
 
   if (g_dbus_interface_skeleton_get_object_path (G_DBUS_INTERFACE_SKELETON (self)))
     g_dbus_interface_skeleton_unexport (G_DBUS_INTERFACE_SKELETON (self));
@@ -1231,6 +1304,9 @@ phosh_monitor_manager_get_property (GObject    *object,
   case PROP_NIGHT_LIGHT_TEMP:
     g_value_set_uint (value, self->night_light_temp);
     break;
+  case PROP_CONFIG_PENDING:
+    g_value_set_boolean (value, self->config_pending);
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
     break;
@@ -1353,8 +1429,7 @@ phosh_monitor_manager_constructed (GObject *object)
   phosh_dbus_display_config_set_apply_monitors_config_allowed (
     PHOSH_DBUS_DISPLAY_CONFIG (self), TRUE);
 
-  id = g_idle_add ((GSourceFunc) on_idle, self);
-  g_source_set_name_by_id (id, "[PhoshMonitorManager] idle");
+  id = phosh_watchdog_idle_add ((GSourceFunc) on_idle, self, "[PhoshMonitorManager] idle");
 }
 
 
@@ -1391,6 +1466,17 @@ phosh_monitor_manager_class_init (PhoshMonitorManagerClass *klass)
     g_param_spec_uint ("night-light-temp", "", "",
                        0, G_MAXUINT, 0,
                        G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+  /**
+   * PhoshMonitorManager:config-pending:
+   *
+   * Whether an output configuration was sent to the compositor but
+   * the resulting head state isn't known yet. Users that want to
+   * apply further changes should wait for this to become %FALSE.
+   */
+  props[PROP_CONFIG_PENDING] =
+    g_param_spec_boolean ("config-pending", "", "",
+                          FALSE,
+                          G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
 
   g_object_class_install_properties (object_class, PROP_LAST_PROP, props);
 
@@ -1591,6 +1677,24 @@ phosh_monitor_manager_apply_monitor_config (PhoshMonitorManager *self)
   }
 
   zwlr_output_configuration_v1_apply (config);
+  self->n_configs_in_flight++;
+  update_config_pending (self);
+}
+
+/**
+ * phosh_monitor_manager_get_config_pending:
+ * @self: a #PhoshMonitorManager
+ *
+ * Whether an output configuration is still being applied.
+ *
+ * Returns: %TRUE if a configuration is in flight
+ */
+gboolean
+phosh_monitor_manager_get_config_pending (PhoshMonitorManager *self)
+{
+  g_return_val_if_fail (PHOSH_IS_MONITOR_MANAGER (self), FALSE);
+
+  return self->config_pending;
 }
 
 void
@@ -48,6 +48,7 @@ void                  phosh_monitor_manager_set_monitor_scale         (PhoshMoni
                                                                        PhoshMonitor        *monitor,
                                                                        double               scale);
 void                  phosh_monitor_manager_apply_monitor_config      (PhoshMonitorManager *self);
+gboolean              phosh_monitor_manager_get_config_pending        (PhoshMonitorManager *self);
 void                  phosh_monitor_manager_set_sensor_proxy_manager  (PhoshMonitorManager     *self,
                                                                        PhoshSensorProxyManager *manager);
 gboolean              phosh_monitor_manager_enable_fallback           (PhoshMonitorManager *self);
@@ -17,6 +17,8 @@
 #include "util.h"
 #include "timestamp-label.h"
 
+#include <glib/gi18n.h>
+
 #include <gmobile.h>
 #include <math.h>
 
@@ -42,6 +44,7 @@ struct _PhoshNotificationFrame {
 
   GListModel *model;
   gulong      model_watch;
+  gulong      collapsed_watch;
 
   GBinding *bind_name;
   GBinding *bind_icon;
@@ -54,6 +57,7 @@ struct _PhoshNotificationFrame {
   GtkWidget *img_icon;
   GtkWidget *list_notifs;
   GtkWidget *updated;
+  GtkWidget *lbl_collapsed;
 
   gboolean   show_body;
   gboolean   animate_show;
@@ -141,6 +145,7 @@ phosh_notification_frame_finalize (GObject *object)
   /* Don't clear bindings, they're already unref'd before here */
 
   g_clear_signal_handler (&self->model_watch, self->model);
+  g_clear_signal_handler (&self->collapsed_watch, self->model);
 
   g_clear_object (&self->model);
   g_clear_pointer (&self->action_filter_keys, g_strfreev);
@@ -426,6 +431,7 @@ phosh_notification_frame_class_init (PhoshNotificationFrameClass *klass)
   gtk_widget_class_bind_template_child (widget_class, PhoshNotificationFrame, img_icon);
   gtk_widget_class_bind_template_child (widget_class, PhoshNotificationFrame, list_notifs);
   gtk_widget_class_bind_template_child (widget_class, PhoshNotificationFrame, updated);
+  gtk_widget_class_bind_template_child (widget_class, PhoshNotificationFrame, lbl_collapsed);
   gtk_widget_class_bind_template_child (widget_class, PhoshNotificationFrame, header_click_gesture);
   gtk_widget_class_bind_template_child (widget_class, PhoshNotificationFrame, list_click_gesture);
 
@@ -534,6 +540,24 @@ items_changed (GListModel             *list,
 }
 
 
+static void
+on_n_collapsed_changed (PhoshNotificationFrame *self)
+{
+  g_autofree char *label = NULL;
+  guint n_collapsed;
+
+  n_collapsed = phosh_notification_source_get_n_collapsed (PHOSH_NOTIFICATION_SOURCE (self->model));
+  gtk_widget_set_visible (self->lbl_collapsed, n_collapsed > 0);
+  if (n_collapsed == 0)
+    return;
+
+  label = g_strdup_printf (ngettext ("%u older notification", "%u older notifications",
+                                     n_collapsed),
+                           n_collapsed);
+  gtk_label_set_label (GTK_LABEL (self->lbl_collapsed), label);
+}
+
+
 void
 phosh_notification_frame_bind_model (PhoshNotificationFrame *self,
                                      GListModel             *model)
@@ -554,6 +578,12 @@ phosh_notification_frame_bind_model (PhoshNotificationFrame *self,
   self->model_watch = g_signal_connect (model, "items-changed",
                                         G_CALLBACK (items_changed), self);
   items_changed (model, 0, 0, 0, self);
+
+  if (PHOSH_IS_NOTIFICATION_SOURCE (model)) {
+    self->collapsed_watch = g_signal_connect_swapped (model, "notify::n-collapsed",
+                                                      G_CALLBACK (on_n_collapsed_changed), self);
+    on_n_collapsed_changed (self);
+  }
 }
 
 
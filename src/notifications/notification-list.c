@@ -11,6 +11,7 @@
 #include "phosh-config.h"
 #include "notification-source.h"
 #include "notification-list.h"
+#include "watchdog.h"
 
 /**
  * PhoshNotificationList:
@@ -19,8 +20,20 @@
  *
  * #PhoshNotificationList maps between #PhoshNotificationSource objects and their
  * notifications creating and removing sources on the fly.
+ *
+ * With [property@NotificationList:batch-updates] enabled moving sources
+ * to the top and adding new sources is deferred until right before
+ * the next frame so a burst of notifications only moves each affected
+ * source once.
  */
 
+enum {
+  PROP_0,
+  PROP_BATCH_UPDATES,
+  LAST_PROP
+};
+static GParamSpec *props[LAST_PROP];
+
 
 struct _PhoshNotificationList {
   GObject     parent;
@@ -40,6 +53,15 @@ struct _PhoshNotificationList {
 
   /* Map of id -> notification */
   GHashTable *notifications;
+
+  gboolean    batch_updates;
+  /* Sources to move to the top, most recent last */
+  GPtrArray  *raised;
+  /* Map of source name -> new source not yet in source_list */
+  GHashTable *pending_sources;
+  guint       flush_id;
+  guint       n_pending;
+  guint       n_coalesced;
 };
 typedef struct _PhoshNotificationList PhoshNotificationList;
 
@@ -50,11 +72,53 @@ G_DEFINE_TYPE_WITH_CODE (PhoshNotificationList, phosh_notification_list, G_TYPE_
                          G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL, list_iface_init))
 
 
+static void
+phosh_notification_list_set_property (GObject      *object,
+                                      guint         property_id,
+                                      const GValue *value,
+                                      GParamSpec   *pspec)
+{
+  PhoshNotificationList *self = PHOSH_NOTIFICATION_LIST (object);
+
+  switch (property_id) {
+  case PROP_BATCH_UPDATES:
+    phosh_notification_list_set_batch_updates (self, g_value_get_boolean (value));
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+    break;
+  }
+}
+
+
+static void
+phosh_notification_list_get_property (GObject    *object,
+                                      guint       property_id,
+                                      GValue     *value,
+                                      GParamSpec *pspec)
+{
+  PhoshNotificationList *self = PHOSH_NOTIFICATION_LIST (object);
+
+  switch (property_id) {
+  case PROP_BATCH_UPDATES:
+    g_value_set_boolean (value, self->batch_updates);
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+    break;
+  }
+}
+
+
 static void
 phosh_notification_list_finalize (GObject *object)
 {
   PhoshNotificationList *self = PHOSH_NOTIFICATION_LIST (object);
 
+  g_clear_handle_id (&self->flush_id, g_source_remove);
+  g_clear_pointer (&self->raised, g_ptr_array_unref);
+  g_clear_pointer (&self->pending_sources, g_hash_table_unref);
+
   g_clear_pointer (&self->source_list, g_sequence_free);
   g_clear_pointer (&self->source_map, g_hash_table_unref);
 
@@ -70,6 +134,21 @@ phosh_notification_list_class_init (PhoshNotificationListClass *klass)
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
   object_class->finalize = phosh_notification_list_finalize;
+  object_class->set_property = phosh_notification_list_set_property;
+  object_class->get_property = phosh_notification_list_get_property;
+
+  /**
+   * PhoshNotificationList:batch-updates:
+   *
+   * Whether to batch reordering and adding of sources until right
+   * before the next frame.
+   */
+  props[PROP_BATCH_UPDATES] =
+    g_param_spec_boolean ("batch-updates", "", "",
+                          FALSE,
+                          G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
+  g_object_class_install_properties (object_class, LAST_PROP, props);
 }
 
 
@@ -141,6 +220,10 @@ phosh_notification_list_init (PhoshNotificationList *self)
                                                g_direct_equal,
                                                NULL,
                                                NULL);
+
+  self->raised = g_ptr_array_new_with_free_func (g_object_unref);
+  /* Keys belong to the sources, the map owns the sources */
+  self->pending_sources = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, g_object_unref);
 }
 
 
@@ -179,6 +262,12 @@ empty (PhoshNotificationSource *source,
 
   source_id = phosh_notification_source_get_name (source);
 
+  g_ptr_array_remove (self->raised, source);
+
+  /* Not visible yet, nothing to notify about */
+  if (g_hash_table_remove (self->pending_sources, source_id))
+    return;
+
   iter = g_hash_table_lookup (self->source_map, source_id);
 
   i = g_sequence_iter_get_position (iter);
@@ -222,6 +311,114 @@ closed (PhoshNotification       *notification,
 }
 
 
+static gboolean
+is_unchanged (PhoshNotificationList *self)
+{
+  for (guint i = 0; i < self->raised->len; i++) {
+    PhoshNotificationSource *source = g_ptr_array_index (self->raised, i);
+    GSequenceIter *iter;
+
+    iter = g_hash_table_lookup (self->source_map, phosh_notification_source_get_name (source));
+    if (iter == NULL)
+      return FALSE;
+
+    /* Already in the order we'd move them to? */
+    if (g_sequence_iter_get_position (iter) != (int)(self->raised->len - 1 - i))
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+
+static void
+flush_updates (PhoshNotificationList *self)
+{
+  g_clear_handle_id (&self->flush_id, g_source_remove);
+
+  if (self->raised->len == 0) {
+    self->n_pending = 0;
+    return;
+  }
+
+  /* All updates since the last flush are folded into a single flush */
+  self->n_coalesced += self->n_pending - 1;
+  self->n_pending = 0;
+
+  if (is_unchanged (self)) {
+    g_ptr_array_set_size (self->raised, 0);
+    return;
+  }
+
+  /* Most recently raised source ends up at the top. Only rows that
+   * actually move are touched so the other rows keep their state. */
+  for (guint i = 0; i < self->raised->len; i++) {
+    PhoshNotificationSource *source = g_ptr_array_index (self->raised, i);
+    const char *source_id = phosh_notification_source_get_name (source);
+    GSequenceIter *iter;
+    int old_pos;
+
+    iter = g_hash_table_lookup (self->source_map, source_id);
+    if (iter) {
+      old_pos = g_sequence_iter_get_position (iter);
+      /* Already on top */
+      if (old_pos == 0)
+        continue;
+
+      g_sequence_move (iter, g_sequence_get_begin_iter (self->source_list));
+    } else {
+      old_pos = -1;
+      /* Transfer the pending source's reference to the source list */
+      g_hash_table_steal (self->pending_sources, source_id);
+      iter = g_sequence_prepend (self->source_list, source);
+      g_hash_table_insert (self->source_map, g_strdup (source_id), iter);
+    }
+
+    self->last.is_valid = FALSE;
+    self->last.iter = NULL;
+    self->last.position = 0;
+
+    /* We "removed" an item */
+    if (old_pos > 0)
+      g_list_model_items_changed (G_LIST_MODEL (self), old_pos, 1, 0);
+    /* And "added" it to the start */
+    g_list_model_items_changed (G_LIST_MODEL (self), 0, 0, 1);
+  }
+  g_ptr_array_set_size (self->raised, 0);
+}
+
+
+static gboolean
+on_flush_idle (gpointer data)
+{
+  PhoshNotificationList *self = PHOSH_NOTIFICATION_LIST (data);
+
+  self->flush_id = 0;
+  flush_updates (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static void
+raise_source (PhoshNotificationList *self, PhoshNotificationSource *source)
+{
+  g_object_ref (source);
+  g_ptr_array_remove (self->raised, source);
+  g_ptr_array_add (self->raised, source);
+  self->n_pending++;
+
+  if (self->flush_id)
+    return;
+
+  /* Run before the next redraw */
+  self->flush_id = phosh_watchdog_idle_add_full (G_PRIORITY_HIGH_IDLE,
+                                                 on_flush_idle,
+                                                 self,
+                                                 NULL,
+                                                 "[phosh] notification list flush");
+}
+
 /**
  * phosh_notification_list_add:
  * @self: the #PhoshNotificationList
@@ -253,7 +450,21 @@ phosh_notification_list_add (PhoshNotificationList *self,
   /* Lookup an existing entry for source id */
   source_iter = g_hash_table_lookup (self->source_map, source_id);
 
-  if (source_iter == NULL) {
+  if (self->batch_updates) {
+    if (source_iter) {
+      source = g_sequence_get (source_iter);
+    } else {
+      source = g_hash_table_lookup (self->pending_sources, source_id);
+      if (source == NULL) {
+        source = phosh_notification_source_new (source_id);
+        g_signal_connect (source, "empty", G_CALLBACK (empty), self);
+        g_hash_table_insert (self->pending_sources,
+                             (gpointer) phosh_notification_source_get_name (source),
+                             source);
+      }
+    }
+    raise_source (self, source);
+  } else if (source_iter == NULL) {
     /* Source doesn't currently exist, generate it */
     source = phosh_notification_source_new (source_id);
     g_signal_connect (source, "empty", G_CALLBACK (empty), self);
@@ -320,3 +531,62 @@ phosh_notification_list_get_by_id (PhoshNotificationList *self,
 
   return notification;
 }
+
+
+/**
+ * phosh_notification_list_get_source:
+ * @self: the #PhoshNotificationList
+ * @source_id: The source's id
+ *
+ * Find a #PhoshNotificationSource in @self by it's id. This includes
+ * sources not yet visible due to batched updates.
+ *
+ * Returns:(nullable)(transfer none): the #PhoshNotificationSource or %NULL
+ */
+PhoshNotificationSource *
+phosh_notification_list_get_source (PhoshNotificationList *self, const char *source_id)
+{
+  GSequenceIter *iter;
+
+  g_return_val_if_fail (PHOSH_IS_NOTIFICATION_LIST (self), NULL);
+  g_return_val_if_fail (source_id, NULL);
+
+  iter = g_hash_table_lookup (self->source_map, source_id);
+  if (iter)
+    return g_sequence_get (iter);
+
+  return g_hash_table_lookup (self->pending_sources, source_id);
+}
+
+
+void
+phosh_notification_list_set_batch_updates (PhoshNotificationList *self, gboolean batch_updates)
+{
+  g_return_if_fail (PHOSH_IS_NOTIFICATION_LIST (self));
+
+  if (self->batch_updates == batch_updates)
+    return;
+
+  self->batch_updates = batch_updates;
+  if (!batch_updates)
+    flush_updates (self);
+
+  g_object_notify_by_pspec (G_OBJECT (self), props[PROP_BATCH_UPDATES]);
+}
+
+/**
+ * phosh_notification_list_get_n_coalesced:
+ * @self: the #PhoshNotificationList
+ *
+ * Get the number of source updates that were merged into other
+ * updates due to batching.
+ *
+ * Returns: The number of coalesced updates
+ */
+guint
+phosh_notification_list_get_n_coalesced (PhoshNotificationList *self)
+{
+  g_return_val_if_fail (PHOSH_IS_NOTIFICATION_LIST (self), 0);
+
+  return self->n_coalesced;
+}
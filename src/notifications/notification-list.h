@@ -11,6 +11,7 @@
 #include <glib-object.h>
 
 #include "notification.h"
+#include "notification-source.h"
 
 G_BEGIN_DECLS
 
@@ -27,5 +28,10 @@ void                   phosh_notification_list_add       (PhoshNotificationList
                                                           PhoshNotification     *notification);
 PhoshNotification     *phosh_notification_list_get_by_id (PhoshNotificationList *self,
                                                           guint                  id);
+PhoshNotificationSource *phosh_notification_list_get_source (PhoshNotificationList *self,
+                                                             const char            *source_id);
+void                   phosh_notification_list_set_batch_updates (PhoshNotificationList *self,
+                                                                  gboolean               batch_updates);
+guint                  phosh_notification_list_get_n_coalesced (PhoshNotificationList *self);
 
 G_END_DECLS
@@ -27,6 +27,7 @@ typedef struct _PhoshNotificationSource {
   GListStore *list;
 
   char       *name;
+  guint       n_collapsed;
 } PhoshNotificationSource;
 
 
@@ -39,6 +40,7 @@ G_DEFINE_TYPE_WITH_CODE (PhoshNotificationSource, phosh_notification_source, G_T
 enum {
   PROP_0,
   PROP_NAME,
+  PROP_N_COLLAPSED,
   LAST_PROP
 };
 static GParamSpec *props[LAST_PROP];
@@ -94,6 +96,9 @@ phosh_notification_source_get_property (GObject    *object,
     case PROP_NAME:
       g_value_set_string (value, self->name);
       break;
+    case PROP_N_COLLAPSED:
+      g_value_set_uint (value, self->n_collapsed);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -117,6 +122,16 @@ phosh_notification_source_class_init (PhoshNotificationSourceClass *klass)
       "Source name (ID)",
       NULL,
       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_CONSTRUCT_ONLY);
+  /**
+   * PhoshNotificationSource:n-collapsed:
+   *
+   * The number of notifications that were closed to keep the
+   * source within its limit.
+   */
+  props[PROP_N_COLLAPSED] =
+    g_param_spec_uint ("n-collapsed", "", "",
+                       0, G_MAXUINT, 0,
+                       G_PARAM_READABLE | G_PARAM_STATIC_STRINGS | G_PARAM_EXPLICIT_NOTIFY);
 
   g_object_class_install_properties (object_class, LAST_PROP, props);
 
@@ -263,3 +278,51 @@ phosh_notification_source_get_name (PhoshNotificationSource *self)
 
   return self->name;
 }
+
+
+guint
+phosh_notification_source_get_n_collapsed (PhoshNotificationSource *self)
+{
+  g_return_val_if_fail (PHOSH_IS_NOTIFICATION_SOURCE (self), 0);
+
+  return self->n_collapsed;
+}
+
+/**
+ * phosh_notification_source_collapse:
+ * @self: The notification source
+ * @max: The maximum number of notifications to keep
+ *
+ * Close the oldest notifications so that at most @max remain.
+ * Critical notifications are kept. The closed notifications are
+ * accounted in [property@NotificationSource:n-collapsed].
+ *
+ * Returns: The number of closed notifications
+ */
+guint
+phosh_notification_source_collapse (PhoshNotificationSource *self, guint max)
+{
+  guint n_items, collapsed = 0;
+
+  g_return_val_if_fail (PHOSH_IS_NOTIFICATION_SOURCE (self), 0);
+
+  n_items = g_list_model_get_n_items (G_LIST_MODEL (self->list));
+  /* Newest notifications are at the start, always keep the newest one */
+  for (guint i = n_items; i > 1 && n_items - collapsed > max; i--) {
+    g_autoptr (PhoshNotification) notification = NULL;
+
+    notification = g_list_model_get_item (G_LIST_MODEL (self->list), i - 1);
+    if (phosh_notification_get_urgency (notification) == PHOSH_NOTIFICATION_URGENCY_CRITICAL)
+      continue;
+
+    phosh_notification_close (notification, PHOSH_NOTIFICATION_REASON_UNDEFINED);
+    collapsed++;
+  }
+
+  if (collapsed) {
+    self->n_collapsed += collapsed;
+    g_object_notify_by_pspec (G_OBJECT (self), props[PROP_N_COLLAPSED]);
+  }
+
+  return collapsed;
+}
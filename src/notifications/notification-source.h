@@ -25,5 +25,8 @@ PhoshNotificationSource *phosh_notification_source_new      (const char
 void                     phosh_notification_source_add      (PhoshNotificationSource *self,
                                                              PhoshNotification       *notification);
 const char              *phosh_notification_source_get_name (PhoshNotificationSource *self);
+guint                    phosh_notification_source_get_n_collapsed (PhoshNotificationSource *self);
+guint                    phosh_notification_source_collapse (PhoshNotificationSource *self,
+                                                             guint                    max);
 
 G_END_DECLS
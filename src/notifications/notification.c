@@ -12,6 +12,7 @@
 #include "notification.h"
 #include "phosh-enums.h"
 #include "app-grid-button.h"
+#include "watchdog.h"
 
 #include <glib/gi18n-lib.h>
 
@@ -1095,8 +1096,8 @@ phosh_notification_expires (PhoshNotification *self,
   priv = phosh_notification_get_instance_private (self);
 
   g_clear_handle_id (&priv->timeout, g_source_remove);
-  priv->timeout = g_timeout_add (timeout, expired, self);
-  g_source_set_name_by_id (priv->timeout, "[phosh] notification_expires_id");
+  priv->timeout = phosh_watchdog_timeout_add (timeout, expired, self,
+                                              "[phosh] notification_expires_id");
 }
 
 /**
@@ -23,6 +23,8 @@
 
 #include <gmobile.h>
 
+#include <math.h>
+
 #define NOTIFICATIONS_KEY_APP_CHILDREN "application-children"
 
 #define NOTIFICATIONS_APP_SCHEMA_ID PHOSH_NOTIFICATIONS_SCHEMA_ID ".application"
@@ -33,6 +35,14 @@
 
 #define NOTIFICATIONS_SPEC_VERSION "1.2"
 
+#define PHOSH_NOTIFICATIONS_SCHEMA "sm.puri.phosh.notifications"
+#define PHOSH_NOTIFICATIONS_KEY_MAX_PER_SOURCE "max-per-source"
+#define PHOSH_NOTIFICATIONS_KEY_BANNERS_PER_MINUTE "banners-per-minute"
+#define BANNER_RATE_WINDOW (60 * G_USEC_PER_SEC)
+
+/* Images are shown at 32px, allow for scale 4 */
+#define NOTIFICATIONS_MAX_IMAGE_SIZE 128
+
 /**
  * PhoshNotifyManager:
  *
@@ -65,6 +75,15 @@ typedef struct _PhoshNotifyManager
   GStrv app_children;
 
   GSettings *settings;
+  GSettings *phosh_settings;
+
+  /* Storm control */
+  guint       max_per_source;
+  guint       banners_per_minute;
+  /* Banner rate by source */
+  GHashTable *banner_rates;
+  guint       n_collapsed;
+  guint       n_throttled_banners;
 
   /* Notification to be handled on unlock */
   struct {
@@ -74,8 +93,30 @@ typedef struct _PhoshNotifyManager
 
   PhoshNotificationList *list;
   PhoshNotifyFeedback *feedback;
+
+  /* Images from image-data hints by source and content */
+  GHashTable *image_cache;
+  /* Per app notification settings by app id */
+  GHashTable *app_policies;
 } PhoshNotifyManager;
 
+typedef struct {
+  GSettings *settings;
+  gboolean   enable;
+  gboolean   show_banners;
+} PhoshNotifyAppPolicy;
+
+typedef struct {
+  gint64 window_start;
+  guint  count;
+} PhoshNotifyBannerRate;
+
+typedef struct {
+  PhoshNotifyManager *manager;
+  char               *key;
+  GIcon              *icon;
+} PhoshImageCacheEntry;
+
 static void phosh_notify_manager_notify_iface_init (PhoshDBusNotificationsIface *iface);
 G_DEFINE_TYPE_WITH_CODE (PhoshNotifyManager,
                          phosh_notify_manager,
@@ -264,85 +305,188 @@ on_notification_closed (PhoshNotifyManager      *self,
 }
 
 
-static gboolean
-phosh_notify_manager_is_notification_enabled (PhoshNotification *notification)
+static void
+on_app_policy_changed (GSettings *settings, const char *key, PhoshNotifyAppPolicy *policy)
+{
+  policy->enable = g_settings_get_boolean (settings, NOTIFICATIONS_APP_KEY_ENABLE);
+  policy->show_banners = g_settings_get_boolean (settings, NOTIFICATIONS_APP_KEY_SHOW_BANNERS);
+}
+
+
+static void
+app_policy_free (PhoshNotifyAppPolicy *policy)
+{
+  g_signal_handlers_disconnect_by_data (policy->settings, policy);
+  g_object_unref (policy->settings);
+  g_free (policy);
+}
+
+/*
+ * Look up the app's notification settings. The settings object is
+ * kept so we're notified about changes and don't need to create a new
+ * one for each notification.
+ */
+static PhoshNotifyAppPolicy *
+get_app_policy (PhoshNotifyManager *self, GAppInfo *info)
 {
   g_autofree char *munged_id = NULL;
   g_autofree char *path = NULL;
-  g_autoptr (GSettings) settings = NULL;
-  GAppInfo *info;
+  PhoshNotifyAppPolicy *policy;
   const char *id;
 
-  info = phosh_notification_get_app_info (notification);
   if (!info)
-    return TRUE;
+    return NULL;
 
   id = g_app_info_get_id (info);
-  if (!info)
-    return TRUE;
-
   if (gm_str_is_null_or_empty (id))
-    return TRUE;
+    return NULL;
+
+  policy = g_hash_table_lookup (self->app_policies, id);
+  if (policy)
+    return policy;
 
   munged_id = phosh_munge_app_id (id);
   path = g_strconcat (NOTIFICATIONS_APP_PREFIX, "/", munged_id, "/", NULL);
-  settings = g_settings_new_with_path (NOTIFICATIONS_APP_SCHEMA_ID, path);
 
-  return g_settings_get_boolean (settings, NOTIFICATIONS_APP_KEY_ENABLE);
+  policy = g_new0 (PhoshNotifyAppPolicy, 1);
+  policy->settings = g_settings_new_with_path (NOTIFICATIONS_APP_SCHEMA_ID, path);
+  g_signal_connect (policy->settings, "changed", G_CALLBACK (on_app_policy_changed), policy);
+  on_app_policy_changed (policy->settings, NULL, policy);
+
+  g_hash_table_insert (self->app_policies, g_strdup (id), policy);
+
+  return policy;
+}
+
+
+static gboolean
+phosh_notify_manager_is_notification_enabled (PhoshNotifyManager *self,
+                                              PhoshNotification  *notification)
+{
+  PhoshNotifyAppPolicy *policy;
+
+  policy = get_app_policy (self, phosh_notification_get_app_info (notification));
+  if (!policy)
+    return TRUE;
+
+  return policy->enable;
+}
+
+
+static void
+on_cached_image_finalized (gpointer data, GObject *where_the_object_was)
+{
+  PhoshImageCacheEntry *entry = data;
+
+  entry->icon = NULL;
+  g_hash_table_remove (entry->manager->image_cache, entry->key);
+}
+
+
+static void
+image_cache_entry_free (PhoshImageCacheEntry *entry)
+{
+  if (entry->icon)
+    g_object_weak_unref (G_OBJECT (entry->icon), on_cached_image_finalized, entry);
+
+  g_free (entry->key);
+  g_free (entry);
 }
 
 
 static GIcon *
-parse_icon_data (GVariant *variant)
+parse_icon_data (PhoshNotifyManager *self, const char *source_id, GVariant *variant)
 {
-  GVariant *wrapped_data = NULL;
-  guchar *data = NULL;
-  GIcon *icon = NULL;
+  g_autoptr (GVariant) wrapped_data = NULL;
+  g_autoptr (GBytes) bytes = NULL;
+  g_autoptr (GdkPixbuf) pixbuf = NULL;
+  g_autofree char *checksum = NULL;
+  g_autofree char *key = NULL;
+  PhoshImageCacheEntry *entry;
   int width = 0;
   int height = 0;
   int row_stride = 0;
   int has_alpha = 0;
   int sample_size = 0;
   int channels = 0;
+  gsize size_should_be;
 
-  if (g_variant_is_of_type (variant, G_VARIANT_TYPE ("(iiibiiay)"))) {
-    gsize size_should_be;
+  if (!g_variant_is_of_type (variant, G_VARIANT_TYPE ("(iiibiiay)")))
+    return NULL;
 
-    g_variant_get (variant,
-                   "(iiibii@ay)",
-                   &width,
-                   &height,
-                   &row_stride,
-                   &has_alpha,
-                   &sample_size,
-                   &channels,
-                   &wrapped_data);
+  g_variant_get (variant,
+                 "(iiibii@ay)",
+                 &width,
+                 &height,
+                 &row_stride,
+                 &has_alpha,
+                 &sample_size,
+                 &channels,
+                 &wrapped_data);
+
+  if (width <= 0 || height <= 0 || sample_size != 8 || channels != (has_alpha ? 4 : 3) ||
+      row_stride < width * channels) {
+    g_warning ("Rejecting image, invalid format %dx%d, stride %d, %d channels, %d bits",
+               width, height, row_stride, channels, sample_size);
+    return NULL;
+  }
 
-    size_should_be = (height - 1) * row_stride + width * ((channels * sample_size + 7) / 8);
+  size_should_be = (gsize)(height - 1) * row_stride + width * ((channels * sample_size + 7) / 8);
 
-    if (size_should_be != g_variant_get_size (wrapped_data)) {
-      g_warning ("Rejecting image, %" G_GSIZE_FORMAT
-                 " (expected) != %" G_GSIZE_FORMAT,
-                 size_should_be, g_variant_get_size (wrapped_data));
+  if (size_should_be != g_variant_get_size (wrapped_data)) {
+    g_warning ("Rejecting image, %" G_GSIZE_FORMAT
+               " (expected) != %" G_GSIZE_FORMAT,
+               size_should_be, g_variant_get_size (wrapped_data));
 
-      return NULL;
-    }
+    return NULL;
+  }
 
-    /* Extract a copy of the raw data */
-    data = (guchar *) g_memdup2 (g_variant_get_data (wrapped_data), size_should_be);
-
-    icon = G_ICON (gdk_pixbuf_new_from_data (data,
-                                             GDK_COLORSPACE_RGB,
-                                             has_alpha,
-                                             sample_size,
-                                             width,
-                                             height,
-                                             row_stride,
-                                             (GdkPixbufDestroyNotify) g_free,
-                                             NULL));
+  /* Chat apps tend to send the same avatar over and over again */
+  checksum = g_compute_checksum_for_data (G_CHECKSUM_SHA1,
+                                          g_variant_get_data (wrapped_data),
+                                          size_should_be);
+  key = g_strdup_printf ("%s/%dx%d/%d/%d/%s", source_id, width, height, row_stride,
+                         has_alpha, checksum);
+  entry = g_hash_table_lookup (self->image_cache, key);
+  if (entry) {
+    g_debug ("Reusing image for %s", source_id);
+    return g_object_ref (entry->icon);
   }
 
-  return icon;
+  /* References the message's data, no copy */
+  bytes = g_variant_get_data_as_bytes (wrapped_data);
+  pixbuf = gdk_pixbuf_new_from_bytes (bytes,
+                                      GDK_COLORSPACE_RGB,
+                                      has_alpha,
+                                      sample_size,
+                                      width,
+                                      height,
+                                      row_stride);
+
+  /* Scale down once so we neither keep large images around nor scale on every draw */
+  if (width > NOTIFICATIONS_MAX_IMAGE_SIZE || height > NOTIFICATIONS_MAX_IMAGE_SIZE) {
+    GdkPixbuf *scaled;
+    double factor = (double)NOTIFICATIONS_MAX_IMAGE_SIZE / MAX (width, height);
+
+    scaled = gdk_pixbuf_scale_simple (pixbuf,
+                                      MAX (1, round (width * factor)),
+                                      MAX (1, round (height * factor)),
+                                      GDK_INTERP_BILINEAR);
+    if (scaled) {
+      g_object_unref (pixbuf);
+      pixbuf = scaled;
+    }
+  }
+
+  entry = g_new0 (PhoshImageCacheEntry, 1);
+  entry->manager = self;
+  entry->key = g_steal_pointer (&key);
+  entry->icon = G_ICON (pixbuf);
+  /* Entries only live as long as a notification uses the image */
+  g_object_weak_ref (G_OBJECT (entry->icon), on_cached_image_finalized, entry);
+  g_hash_table_insert (self->image_cache, entry->key, entry);
+
+  return G_ICON (g_steal_pointer (&pixbuf));
 }
 
 
@@ -374,9 +518,8 @@ static void
 phosh_notify_manager_add_application (PhoshNotifyManager *self, GAppInfo *info)
 {
   g_autofree char *munged_id = NULL;
-  g_autofree char *path = NULL;
-  g_autoptr (GSettings) settings = NULL;
   g_autoptr(GPtrArray) new_apps = NULL;
+  PhoshNotifyAppPolicy *policy;
   const char *id;
 
   id = g_app_info_get_id(info);
@@ -392,9 +535,9 @@ phosh_notify_manager_add_application (PhoshNotifyManager *self, GAppInfo *info)
   g_ptr_array_add (new_apps, munged_id);
   g_ptr_array_add (new_apps, NULL);
 
-  path = g_strconcat (NOTIFICATIONS_APP_PREFIX, "/", munged_id, "/", NULL);
-  settings = g_settings_new_with_path (NOTIFICATIONS_APP_SCHEMA_ID, path);
-  g_settings_set_string (settings, NOTIFICATIONS_APP_KEY_APP_ID, id);
+  policy = get_app_policy (self, info);
+  if (policy)
+    g_settings_set_string (policy->settings, NOTIFICATIONS_APP_KEY_APP_ID, id);
   g_settings_set_strv (self->settings, NOTIFICATIONS_KEY_APP_CHILDREN,
                        (const char * const *)new_apps->pdata);
 }
@@ -426,6 +569,8 @@ handle_notify (PhoshDBusNotifications *skeleton,
   g_autoptr (GIcon) path_gicon = NULL;
   g_autoptr (GIcon) app_gicon = NULL;
   g_autoptr (GIcon) old_data_gicon = NULL;
+  g_autoptr (GVariant) image_data = NULL;
+  g_autoptr (GVariant) old_image_data = NULL;
   gboolean transient = FALSE;
   gboolean resident = FALSE;
   g_autofree char *category = NULL;
@@ -455,14 +600,16 @@ handle_notify (PhoshDBusNotifications *skeleton,
       }
     } else if ((g_strcmp0 (key, "image-data") == 0) ||
                (g_strcmp0 (key, "image_data") == 0)) {
-      data_gicon = parse_icon_data (value);
+      g_clear_pointer (&image_data, g_variant_unref);
+      image_data = g_variant_ref (value);
     } else if ((g_strcmp0 (key, "image-path") == 0) ||
                (g_strcmp0 (key, "image_path") == 0)) {
       if (g_variant_is_of_type (value, G_VARIANT_TYPE_STRING)) {
         path_gicon = parse_icon_string (g_variant_get_string (value, NULL));
       }
     } else if (g_strcmp0 (key, "icon_data") == 0) {
-      old_data_gicon = parse_icon_data (value);
+      g_clear_pointer (&old_image_data, g_variant_unref);
+      old_image_data = g_variant_ref (value);
     } else if ((g_strcmp0 (key, "desktop_entry") == 0) ||
                (g_strcmp0 (key, "desktop-entry") == 0)) {
       if (g_variant_is_of_type (value, G_VARIANT_TYPE_STRING))
@@ -492,16 +639,6 @@ handle_notify (PhoshDBusNotifications *skeleton,
     g_variant_unref (item);
   }
 
-  if (data_gicon) {
-    image = data_gicon;
-  } else if (path_gicon) {
-    image = path_gicon;
-  } else if (old_data_gicon) {
-    image = old_data_gicon;
-  } else {
-    image = NULL;
-  }
-
   icon = app_gicon;
 
   if (desktop_id) {
@@ -521,6 +658,21 @@ handle_notify (PhoshDBusNotifications *skeleton,
     source_id = g_strdup_printf ("unknown-app-%i", self->unknown_source++);
   }
 
+  if (image_data)
+    data_gicon = parse_icon_data (self, source_id, image_data);
+  else if (old_image_data && !path_gicon)
+    old_data_gicon = parse_icon_data (self, source_id, old_image_data);
+
+  if (data_gicon) {
+    image = data_gicon;
+  } else if (path_gicon) {
+    image = path_gicon;
+  } else if (old_data_gicon) {
+    image = old_data_gicon;
+  } else {
+    image = NULL;
+  }
+
   if (replaces_id)
     notification = phosh_notification_list_get_by_id (self->list, replaces_id);
 
@@ -598,6 +750,17 @@ on_notifications_setting_changed (PhoshNotifyManager *self,
 }
 
 
+static void
+on_phosh_notifications_setting_changed (PhoshNotifyManager *self,
+                                        const char         *key,
+                                        GSettings          *settings)
+{
+  self->max_per_source = g_settings_get_uint (settings, PHOSH_NOTIFICATIONS_KEY_MAX_PER_SOURCE);
+  self->banners_per_minute = g_settings_get_uint (settings,
+                                                  PHOSH_NOTIFICATIONS_KEY_BANNERS_PER_MINUTE);
+}
+
+
 static void
 on_notification_apps_setting_changed (PhoshNotifyManager *self,
                                       const char         *key,
@@ -656,6 +819,11 @@ phosh_notify_manager_dispose (GObject *object)
   if (g_dbus_interface_skeleton_get_object_path (G_DBUS_INTERFACE_SKELETON (self)))
     g_dbus_interface_skeleton_unexport (G_DBUS_INTERFACE_SKELETON (self));
 
+  /* Before dropping the notifications so we don't get notified about their images */
+  g_clear_pointer (&self->image_cache, g_hash_table_destroy);
+  g_clear_pointer (&self->app_policies, g_hash_table_destroy);
+  g_clear_pointer (&self->banner_rates, g_hash_table_destroy);
+  g_clear_object (&self->phosh_settings);
   g_clear_object (&self->settings);
   g_clear_object (&self->feedback);
   g_clear_object (&self->list);
@@ -702,6 +870,11 @@ phosh_notify_manager_constructed (GObject *object)
                             G_CALLBACK (on_notification_apps_setting_changed), self);
   on_notification_apps_setting_changed (self, NULL, self->settings);
 
+  self->phosh_settings = g_settings_new (PHOSH_NOTIFICATIONS_SCHEMA);
+  g_signal_connect_swapped (self->phosh_settings, "changed",
+                            G_CALLBACK (on_phosh_notifications_setting_changed), self);
+  on_phosh_notifications_setting_changed (self, NULL, self->phosh_settings);
+
   g_signal_connect_swapped (shell, "notify::locked", G_CALLBACK (on_shell_lock_changed), self);
 
   self->feedback = phosh_notify_feedback_new (self->list);
@@ -762,6 +935,16 @@ phosh_notify_manager_init (PhoshNotifyManager *self)
   self->next_id = 1;
 
   self->list = phosh_notification_list_new ();
+  phosh_notification_list_set_batch_updates (self->list, TRUE);
+  self->image_cache = g_hash_table_new_full (g_str_hash,
+                                             g_str_equal,
+                                             NULL,
+                                             (GDestroyNotify) image_cache_entry_free);
+  self->app_policies = g_hash_table_new_full (g_str_hash,
+                                              g_str_equal,
+                                              g_free,
+                                              (GDestroyNotify) app_policy_free);
+  self->banner_rates = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
 }
 
 /**
@@ -853,7 +1036,7 @@ phosh_notify_manager_add_notification (PhoshNotifyManager *self,
   g_return_if_fail (PHOSH_IS_NOTIFICATION (notification));
   g_return_if_fail (source_id);
 
-  if (!phosh_notify_manager_is_notification_enabled (notification))
+  if (!phosh_notify_manager_is_notification_enabled (self, notification))
     return;
 
   if (expire_timeout == -1)
@@ -877,6 +1060,13 @@ phosh_notify_manager_add_notification (PhoshNotifyManager *self,
                            self,
                            G_CONNECT_SWAPPED);
 
+  if (self->max_per_source) {
+    PhoshNotificationSource *source = phosh_notification_list_get_source (self->list, source_id);
+
+    if (source)
+      self->n_collapsed += phosh_notification_source_collapse (source, self->max_per_source);
+  }
+
   if (expire_timeout)
     phosh_notification_expires (notification, expire_timeout);
 
@@ -901,6 +1091,47 @@ phosh_notify_manager_close_notification_by_id (PhoshNotifyManager *self,
   return TRUE;
 }
 
+static const char *
+get_banner_rate_key (PhoshNotification *notification)
+{
+  GAppInfo *info;
+  const char *key = NULL;
+
+  info = phosh_notification_get_app_info (notification);
+  if (info)
+    key = g_app_info_get_id (info);
+  if (gm_str_is_null_or_empty (key))
+    key = phosh_notification_get_app_name (notification);
+  if (gm_str_is_null_or_empty (key))
+    return NULL;
+
+  return key;
+}
+
+/* Limit the number of banners a single app can show per minute */
+static gboolean
+is_banner_throttled (PhoshNotifyManager *self, PhoshNotification *notification)
+{
+  PhoshNotifyBannerRate *rate;
+  const char *key;
+
+  if (self->banners_per_minute == 0)
+    return FALSE;
+
+  key = get_banner_rate_key (notification);
+  if (!key)
+    return FALSE;
+
+  rate = g_hash_table_lookup (self->banner_rates, key);
+  if (rate == NULL)
+    return FALSE;
+
+  if (g_get_monotonic_time () - rate->window_start > BANNER_RATE_WINDOW)
+    return FALSE;
+
+  return rate->count >= self->banners_per_minute;
+}
+
 /**
  * phosh_notify_manager_get_show_notfication_banner:
  * @self: the #PhoshNotifyManager
@@ -908,6 +1139,9 @@ phosh_notify_manager_close_notification_by_id (PhoshNotifyManager *self,
  *
  * Checks whether a #PhoshNotificationBanner should be displayed
  * for the given #PhoshNotification according to current policy.
+ * This doesn't account the banner against the app's banner quota, use
+ * `phosh_notify_manager_record_notification_banner()` once the banner
+ * is actually shown.
  *
  * Returns: %TRUE if the banner should be shown, otherwise %FALSE
  */
@@ -915,11 +1149,7 @@ gboolean
 phosh_notify_manager_get_show_notification_banner (PhoshNotifyManager *self,
                                                    PhoshNotification  *notification)
 {
-  g_autoptr (GSettings) settings = NULL;
-  g_autofree char *path = NULL;
-  g_autofree char *munged_id = NULL;
-  GAppInfo *app_info;
-  gboolean show;
+  PhoshNotifyAppPolicy *policy;
 
   g_return_val_if_fail (PHOSH_IS_NOTIFY_MANAGER (self), FALSE);
 
@@ -929,17 +1159,57 @@ phosh_notify_manager_get_show_notification_banner (PhoshNotifyManager *self,
   if (phosh_notification_get_urgency (notification) == PHOSH_NOTIFICATION_URGENCY_CRITICAL)
     return TRUE;
 
-  app_info = phosh_notification_get_app_info (notification);
-  if (!app_info)
-    return TRUE;
+  policy = get_app_policy (self, phosh_notification_get_app_info (notification));
+  if (policy && !policy->show_banners)
+    return FALSE;
 
-  munged_id = phosh_munge_app_id (g_app_info_get_id(app_info));
-  path = g_strconcat (NOTIFICATIONS_APP_PREFIX, "/", munged_id, "/", NULL);
-  settings = g_settings_new_with_path (NOTIFICATIONS_APP_SCHEMA_ID, path);
-  show = g_settings_get_boolean (settings, NOTIFICATIONS_APP_KEY_SHOW_BANNERS);
+  if (is_banner_throttled (self, notification)) {
+    g_debug ("Throttling banner for %s", get_banner_rate_key (notification));
+    self->n_throttled_banners++;
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+ * phosh_notify_manager_record_notification_banner:
+ * @self: the #PhoshNotifyManager
+ * @notification: the #PhoshNotification whose banner got shown
+ *
+ * Account a shown banner against the app's banner quota.
+ */
+void
+phosh_notify_manager_record_notification_banner (PhoshNotifyManager *self,
+                                                 PhoshNotification  *notification)
+{
+  PhoshNotifyBannerRate *rate;
+  const char *key;
+  gint64 now;
+
+  g_return_if_fail (PHOSH_IS_NOTIFY_MANAGER (self));
+  g_return_if_fail (PHOSH_IS_NOTIFICATION (notification));
+
+  if (phosh_notification_get_urgency (notification) == PHOSH_NOTIFICATION_URGENCY_CRITICAL)
+    return;
+
+  key = get_banner_rate_key (notification);
+  if (!key)
+    return;
+
+  now = g_get_monotonic_time ();
+  rate = g_hash_table_lookup (self->banner_rates, key);
+  if (rate == NULL) {
+    rate = g_new0 (PhoshNotifyBannerRate, 1);
+    g_hash_table_insert (self->banner_rates, g_strdup (key), rate);
+  }
 
-  g_debug ("Show banners for %s: %d", munged_id, show);
-  return show;
+  if (now - rate->window_start > BANNER_RATE_WINDOW) {
+    rate->window_start = now;
+    rate->count = 0;
+  }
+
+  rate->count++;
 }
 
 /**
@@ -1025,3 +1295,31 @@ phosh_notify_manager_add_shell_notification (PhoshNotifyManager *self,
                                          PHOSH_NOTIFICATION (notification));
   return id;
 }
+
+
+/**
+ * phosh_notify_manager_get_stats:
+ * @self: the #PhoshNotifyManager
+ *
+ * Get statistics about notification storm control: The number of
+ * notifications collapsed due to the per source limit, the number of
+ * throttled banners and the number of coalesced list updates.
+ *
+ * Returns: (transfer floating): The statistics as `a{sv}`
+ */
+GVariant *
+phosh_notify_manager_get_stats (PhoshNotifyManager *self)
+{
+  GVariantBuilder builder;
+
+  g_return_val_if_fail (PHOSH_IS_NOTIFY_MANAGER (self), NULL);
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+  g_variant_builder_add (&builder, "{sv}", "collapsed", g_variant_new_uint32 (self->n_collapsed));
+  g_variant_builder_add (&builder, "{sv}", "throttled-banners",
+                         g_variant_new_uint32 (self->n_throttled_banners));
+  g_variant_builder_add (&builder, "{sv}", "coalesced-updates",
+                         g_variant_new_uint32 (phosh_notification_list_get_n_coalesced (self->list)));
+
+  return g_variant_builder_end (&builder);
+}
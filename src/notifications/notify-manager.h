@@ -36,9 +36,12 @@ void                   phosh_notify_manager_close_all_notifications  (PhoshNotif
                                                                       PhoshNotificationReason  reaseon);
 gboolean               phosh_notify_manager_get_show_notification_banner (PhoshNotifyManager *self,
                          PhoshNotification  *notification);
+void                   phosh_notify_manager_record_notification_banner (PhoshNotifyManager *self,
+                                                                        PhoshNotification  *notification);
 
 guint                  phosh_notify_manager_add_shell_notification (PhoshNotifyManager *self,
                                                                     PhoshNotification  *notification,
                                                                     guint               id,
                                                                     int                 expire_timeout);
+GVariant              *phosh_notify_manager_get_stats (PhoshNotifyManager *self);
 G_END_DECLS
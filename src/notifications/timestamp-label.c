@@ -6,6 +6,7 @@
 
 #define G_LOG_DOMAIN "phosh-timestamp-label"
 
+#include "clock-ticker.h"
 #include "timestamp-label.h"
 #include "timestamp-label-priv.h"
 #include "phosh-config.h"
@@ -18,6 +19,10 @@
  *
  * The #PhoshTimestampLabel is used to display the time difference between
  * the timestamp stored in the #PhoshTimestampLabel and the current time.
+ *
+ * Updates are driven by the shared [class@ClockTicker] so many labels
+ * don't wake up the main loop at scattered offsets and labels that
+ * aren't visible don't update at all.
  */
 
 
@@ -26,7 +31,9 @@ struct _PhoshTimestampLabel {
 
   GtkLabel  *label;
   GDateTime *date;
-  guint      refresh_time;
+  gint64     next_update;
+  guint      tick_id;
+  PhoshClockTickerGranularity granularity;
 };
 
 
@@ -243,29 +250,56 @@ phosh_timestamp_label_calc_timeout (PhoshTimestampLabel *self)
 }
 
 
-static gboolean
+static void on_tick (gpointer user_data);
+
+static void
 phosh_timestamp_label_update (PhoshTimestampLabel *self)
 {
   g_autofree char *str = NULL;
+  PhoshClockTicker *ticker = phosh_clock_ticker_get_default ();
+  PhoshClockTickerGranularity granularity;
+  GTimeSpan age;
+
+  if (self->date == NULL) {
+    gtk_label_set_label (self->label, "");
+    if (self->tick_id)
+      phosh_clock_ticker_unsubscribe (ticker, self->tick_id);
+    self->tick_id = 0;
+    return;
+  }
 
-  if (self->date != NULL) {
-    GTimeSpan time;
+  str = phosh_time_ago_in_words (self->date);
+  gtk_label_set_label (self->label, str);
+  self->next_update = g_get_real_time () + phosh_timestamp_label_calc_timeout (self);
 
-    str = phosh_time_ago_in_words (self->date);
-    gtk_label_set_label (self->label, str);
+  /* Only the first two minutes need sub minute updates */
+  age = g_get_real_time () - g_date_time_to_unix (self->date) * G_USEC_PER_SEC;
+  if (age < 2 * G_TIME_SPAN_MINUTE)
+    granularity = PHOSH_CLOCK_TICKER_GRANULARITY_SECOND;
+  else
+    granularity = PHOSH_CLOCK_TICKER_GRANULARITY_MINUTE;
 
-    g_clear_handle_id (&(self->refresh_time), g_source_remove);
-    time = phosh_timestamp_label_calc_timeout (self);
-    self->refresh_time = g_timeout_add (time / G_TIME_SPAN_MILLISECOND,
-                                        (GSourceFunc) phosh_timestamp_label_update,
-                                        self);
-    g_source_set_name_by_id (self->refresh_time, "[PhoshTimestampLable] refresh");
-  } else {
-    gtk_label_set_label (self->label, "");
+  if (self->tick_id && self->granularity == granularity)
+    return;
 
-    g_clear_handle_id (&(self->refresh_time), g_source_remove);
-  }
-  return G_SOURCE_REMOVE;
+  if (self->tick_id)
+    phosh_clock_ticker_unsubscribe (ticker, self->tick_id);
+
+  self->granularity = granularity;
+  self->tick_id = phosh_clock_ticker_subscribe (ticker, granularity, GTK_WIDGET (self),
+                                                on_tick, self);
+}
+
+
+static void
+on_tick (gpointer user_data)
+{
+  PhoshTimestampLabel *self = PHOSH_TIMESTAMP_LABEL (user_data);
+
+  if (g_get_real_time () < self->next_update)
+    return;
+
+  phosh_timestamp_label_update (self);
 }
 
 
@@ -313,7 +347,9 @@ phosh_timestamp_label_dispose (GObject *object)
   PhoshTimestampLabel *self = PHOSH_TIMESTAMP_LABEL (object);
 
   g_clear_pointer (&self->date, g_date_time_unref);
-  g_clear_handle_id (&(self->refresh_time), g_source_remove);
+  if (self->tick_id)
+    phosh_clock_ticker_unsubscribe (phosh_clock_ticker_get_default (), self->tick_id);
+  self->tick_id = 0;
 
   G_OBJECT_CLASS (phosh_timestamp_label_parent_class)->dispose (object);
 }
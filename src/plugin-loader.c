@@ -11,6 +11,7 @@
 #include "phosh-config.h"
 
 #include "plugin-loader.h"
+#include "timeline.h"
 
 #include <gio/gio.h>
 #include <gtk/gtk.h>
@@ -105,7 +106,8 @@ phosh_plugin_loader_constructed (GObject *object)
 
   for (int i = 0; i < g_strv_length (self->plugin_dirs); i++) {
     g_debug ("Will load plugins from '%s' for '%s'", self->plugin_dirs[i], self->extension_point);
-    g_io_modules_scan_all_in_directory (self->plugin_dirs[i]);
+    PHOSH_TIMELINE_SPAN ("plugin-scan", self->extension_point,
+                         g_io_modules_scan_all_in_directory (self->plugin_dirs[i]));
   }
 }
 
@@ -185,6 +187,7 @@ phosh_plugin_loader_load_plugin (PhoshPluginLoader *self, const char *name)
 {
   GIOExtensionPoint *ep;
   GIOExtension *extension;
+  GtkWidget *widget;
   GType type;
 
   g_return_val_if_fail (PHOSH_IS_PLUGIN_LOADER (self), NULL);
@@ -198,7 +201,9 @@ phosh_plugin_loader_load_plugin (PhoshPluginLoader *self, const char *name)
 
   g_debug ("Loading plugin %s", name);
   type = g_io_extension_get_type (extension);
-  return g_object_new (type, NULL);
+  PHOSH_TIMELINE_SPAN ("plugin", name, widget = g_object_new (type, NULL));
+
+  return widget;
 }
 
 
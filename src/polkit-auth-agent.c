@@ -11,6 +11,7 @@
 #include "polkit-auth-agent.h"
 #include "polkit-auth-prompt.h"
 #include "shell-priv.h"
+#include "watchdog.h"
 
 #include <sys/types.h>
 #include <pwd.h>
@@ -312,8 +313,8 @@ on_request_cancelled (GCancellable *cancellable,
    * https://bugzilla.gnome.org/show_bug.cgi?id=642968
    * https://gitlab.gnome.org/GNOME/glib/issues/740
    */
-  id = g_idle_add (handle_cancelled_in_idle, request);
-  g_source_set_name_by_id (id, "[phosh] handle_cancelled_in_idle");
+  id = phosh_watchdog_idle_add (handle_cancelled_in_idle, request,
+                                "[phosh] handle_cancelled_in_idle");
 }
 
 
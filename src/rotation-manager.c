@@ -12,10 +12,14 @@
 #include "shell-priv.h"
 #include "sensor-proxy-manager.h"
 #include "util.h"
+#include "watchdog.h"
 
 #define ORIENTATION_LOCK_SCHEMA_ID "org.gnome.settings-daemon.peripherals.touchscreen"
 #define ORIENTATION_LOCK_KEY       "orientation-lock"
 
+/* How long the sensor's orientation needs to be stable before rotating */
+#define ORIENTATION_SETTLE_MS      300
+
 /**
  * PhoshRotationManager:
  *
@@ -27,6 +31,12 @@
  * by setting the #PhoshMonitorTransform explicitly.
  * It also takes the #PhoshLockscreenManager:locked status into account
  * to ensure the lockscreen is rotated accordingly on small phones.
+ *
+ * Sensor orientation changes are only acted upon once the orientation
+ * was stable for a short while. Only one output configuration is in
+ * flight at a time: transforms requested while the compositor is
+ * still applying a configuration are queued and superseded by newer
+ * requests so only the latest one gets applied.
  */
 
 enum {
@@ -53,6 +63,10 @@ typedef struct _PhoshRotationManager {
   PhoshMonitorTransform    prelock_transform;
   gboolean                 blanked;
 
+  guint                    settle_id;
+  PhoshMonitorTransform    queued_transform;
+  gulong                   config_pending_id;
+
   GSettings               *settings;
   gboolean                 orientation_locked;
 
@@ -62,6 +76,27 @@ typedef struct _PhoshRotationManager {
 G_DEFINE_TYPE (PhoshRotationManager, phosh_rotation_manager, G_TYPE_OBJECT);
 
 
+static void apply_transform (PhoshRotationManager *self, PhoshMonitorTransform transform);
+
+
+static void
+on_config_pending_changed (PhoshRotationManager *self,
+                           GParamSpec           *pspec,
+                           PhoshMonitorManager  *monitor_manager)
+{
+  PhoshMonitorTransform transform = self->queued_transform;
+
+  if (phosh_monitor_manager_get_config_pending (monitor_manager))
+    return;
+
+  if (transform == -1)
+    return;
+
+  g_debug ("Applying queued transform %d", transform);
+  apply_transform (self, transform);
+}
+
+
 static void
 apply_transform (PhoshRotationManager *self, PhoshMonitorTransform transform)
 {
@@ -73,6 +108,22 @@ apply_transform (PhoshRotationManager *self, PhoshMonitorTransform transform)
   if (!self->monitor)
     return;
 
+  /* Wait for the configuration in flight, newer requests supersede queued ones */
+  if (phosh_monitor_manager_get_config_pending (monitor_manager)) {
+    g_debug ("Output configuration pending, queueing transform %d", transform);
+    self->queued_transform = transform;
+
+    if (!self->config_pending_id) {
+      self->config_pending_id = g_signal_connect_object (monitor_manager,
+                                                         "notify::config-pending",
+                                                         G_CALLBACK (on_config_pending_changed),
+                                                         self,
+                                                         G_CONNECT_SWAPPED);
+    }
+    return;
+  }
+  self->queued_transform = -1;
+
   current = phosh_monitor_get_transform (self->monitor);
   if (current == transform)
     return;
@@ -362,6 +413,18 @@ on_lockscreen_manager_locked (PhoshRotationManager *self, GParamSpec *pspec,
 }
 
 
+static gboolean
+on_orientation_settled (gpointer data)
+{
+  PhoshRotationManager *self = PHOSH_ROTATION_MANAGER (data);
+
+  self->settle_id = 0;
+  match_orientation (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+
 static void
 on_accelerometer_orientation_changed (PhoshRotationManager    *self,
                                       GParamSpec              *pspec,
@@ -370,7 +433,10 @@ on_accelerometer_orientation_changed (PhoshRotationManager    *self,
   g_return_if_fail (PHOSH_IS_ROTATION_MANAGER (self));
   g_return_if_fail (self->sensor_proxy_manager == sensor);
 
-  match_orientation (self);
+  /* Only rotate once the orientation is stable, e.g. not while walking */
+  g_clear_handle_id (&self->settle_id, g_source_remove);
+  self->settle_id = phosh_watchdog_timeout_add (ORIENTATION_SETTLE_MS, on_orientation_settled, self,
+                                                "[phosh] rotation settle");
 }
 
 
@@ -511,6 +577,7 @@ phosh_rotation_manager_dispose (GObject *object)
   g_cancellable_cancel (self->cancel);
   g_clear_object (&self->cancel);
 
+  g_clear_handle_id (&self->settle_id, g_source_remove);
   g_clear_object (&self->settings);
 
   if (self->sensor_proxy_manager) {
@@ -604,6 +671,7 @@ static void
 phosh_rotation_manager_init (PhoshRotationManager *self)
 {
   self->cancel = g_cancellable_new ();
+  self->queued_transform = -1;
 }
 
 
@@ -17,6 +17,7 @@
 #include "lockscreen-manager.h"
 #include "session-presence.h"
 #include "util.h"
+#include "watchdog.h"
 
 #include <glib/gstdio.h>
 #include <gio/gunixfdlist.h>
@@ -148,10 +149,10 @@ arm_lock_delay_timer (PhoshScreenSaverManager *self, gboolean active, gboolean l
     return;
 
   g_debug ("Arming lock delay timer for %d seconds", self->lock_delay);
-  self->lock_delay_timer_id = g_timeout_add_seconds_once (self->lock_delay,
-                                                          on_lock_delay_timer_expired,
-                                                          self);
-  g_source_set_name_by_id (self->lock_delay_timer_id, "[phosh] lock_delay_timer");
+  self->lock_delay_timer_id = phosh_watchdog_timeout_add_seconds_once (self->lock_delay,
+                                                                       on_lock_delay_timer_expired,
+                                                                       self,
+                                                                       "[phosh] lock_delay_timer");
 }
 
 
@@ -203,10 +204,9 @@ on_power_button_pressed (GSimpleAction *action, GVariant *param, gpointer data)
       g_warning ("Long press timer already active");
       g_clear_handle_id (&self->long_press_id, g_source_remove);
     }
-    self->long_press_id = g_timeout_add_seconds (LONG_PRESS_TIMEOUT,
-                                                 on_long_press,
-                                                 self);
-    g_source_set_name_by_id (self->long_press_id, "[PhoshScreensaverManager] long press");
+    self->long_press_id = phosh_watchdog_timeout_add_seconds (LONG_PRESS_TIMEOUT, on_long_press,
+                                                              self,
+                                                              "[PhoshScreensaverManager] long press");
   }
 
   /* Press already unblanks since presence status changes due to key press so nothing to do here */
@@ -927,8 +927,8 @@ phosh_screen_saver_manager_constructed (GObject *object)
   }
 
   /* Perform login1 setup when idle */
-  self->idle_id = g_idle_add ((GSourceFunc)on_idle, self);
-  g_source_set_name_by_id (self->idle_id, "[PhoshScreenSaverManager] idle");
+  self->idle_id = phosh_watchdog_idle_add ((GSourceFunc)on_idle, self,
+                                           "[PhoshScreenSaverManager] idle");
 }
 
 
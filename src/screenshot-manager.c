@@ -16,6 +16,7 @@
 #include "screenshot-manager.h"
 #include "shell-priv.h"
 #include "util.h"
+#include "watchdog.h"
 #include "wl-buffer.h"
 
 #include "dbus/phosh-screenshot-dbus.h"
@@ -200,8 +201,8 @@ show_fader (PhoshScreenshotManager *self)
 {
   PhoshMonitor *monitor = phosh_shell_get_primary_monitor (phosh_shell_get_default ());
 
-  self->fader_id = g_timeout_add (FLASH_FADER_TIMEOUT, on_fader_timeout, self);
-  g_source_set_name_by_id (self->fader_id, "[phosh] screenshot fader");
+  self->fader_id = phosh_watchdog_timeout_add (FLASH_FADER_TIMEOUT, on_fader_timeout, self,
+                                               "[phosh] screenshot fader");
   self->fader = g_object_new (PHOSH_TYPE_FADER,
                               "monitor", monitor,
                               "style-class", "phosh-fader-flash-fade",
@@ -428,8 +429,8 @@ copy_to_clipboard (PhoshScreenshotManager *self, GdkPixbuf *pixbuf)
   self->for_clipboard = g_object_ref (pixbuf);
   /* FIXME: Would be better to trigger when the opaque window is up and got
      input focus but all such attempts failed */
-  self->opaque_id = g_timeout_add_seconds_once (1, on_opaque_timeout, self);
-  g_source_set_name_by_id (self->opaque_id, "[phosh] screenshot opaque");
+  self->opaque_id = phosh_watchdog_timeout_add_seconds_once (1, on_opaque_timeout, self,
+                                                             "[phosh] screenshot opaque");
 
   gtk_widget_set_visible (GTK_WIDGET (self->opaque), TRUE);
 }
@@ -36,6 +36,7 @@
 enum {
   PHOSH_SESSION_MANAGER_PROP_0,
   PHOSH_SESSION_MANAGER_PROP_ACTIVE,
+  PHOSH_SESSION_MANAGER_PROP_READY,
   PHOSH_SESSION_MANAGER_PROP_LAST_PROP,
 };
 static GParamSpec *props[PHOSH_SESSION_MANAGER_PROP_LAST_PROP];
@@ -46,8 +47,12 @@ static void phosh_session_manager_end_session_dialog_iface_init (
 typedef struct _PhoshSessionManager {
   PhoshDBusEndSessionDialogSkeleton     parent;
   gboolean                              active;
+  gboolean                              ready;
 
   PhoshDBusSessionManager              *proxy;
+  /* Registration requested before the proxy was ready */
+  char                                 *pending_app_id;
+  char                                 *pending_startup_id;
   GCancellable                         *cancel;
   PhoshDBusSessionManagerClientPrivate *priv_proxy;
 
@@ -161,6 +166,9 @@ phosh_session_manager_get_property (GObject    *object,
   case PHOSH_SESSION_MANAGER_PROP_ACTIVE:
     g_value_set_boolean (value, self->active);
     break;
+  case PHOSH_SESSION_MANAGER_PROP_READY:
+    g_value_set_boolean (value, self->ready);
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
     break;
@@ -342,20 +350,18 @@ on_reboot_finished (GObject *source_object, GAsyncResult *res, gpointer user_dat
 
 
 static void
-phosh_session_manager_constructed (GObject *object)
+on_proxy_new_for_bus_finish (GObject *source_object, GAsyncResult *res, gpointer user_data)
 {
-  PhoshSessionManager *self = PHOSH_SESSION_MANAGER (object);
-
+  PhoshSessionManager *self;
+  PhoshDBusSessionManager *proxy;
   g_autoptr (GError) err = NULL;
 
-  /* Sync call since this happens early in startup and we need it right away */
-  self->proxy = phosh_dbus_session_manager_proxy_new_for_bus_sync (
-    G_BUS_TYPE_SESSION,
-    G_DBUS_PROXY_FLAGS_DO_NOT_AUTO_START_AT_CONSTRUCTION,
-    BUS_NAME,
-    OBJECT_PATH,
-    NULL,
-    &err);
+  proxy = phosh_dbus_session_manager_proxy_new_for_bus_finish (res, &err);
+  if (!proxy && g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    return;
+
+  self = PHOSH_SESSION_MANAGER (user_data);
+  self->proxy = proxy;
 
   if (!self->proxy) {
     g_warning ("Failed to get session proxy %s", err->message);
@@ -368,6 +374,31 @@ phosh_session_manager_constructed (GObject *object)
     on_session_active_changed (self, NULL, self->proxy);
   }
 
+  self->ready = TRUE;
+  g_object_notify_by_pspec (G_OBJECT (self), props[PHOSH_SESSION_MANAGER_PROP_READY]);
+
+  if (self->pending_app_id && self->proxy)
+    phosh_session_manager_register (self, self->pending_app_id, self->pending_startup_id);
+  g_clear_pointer (&self->pending_app_id, g_free);
+  g_clear_pointer (&self->pending_startup_id, g_free);
+}
+
+
+static void
+phosh_session_manager_constructed (GObject *object)
+{
+  PhoshSessionManager *self = PHOSH_SESSION_MANAGER (object);
+
+  /* Don't block startup on the session manager, other startup work can
+   * proceed while we're waiting for the proxy */
+  phosh_dbus_session_manager_proxy_new_for_bus (G_BUS_TYPE_SESSION,
+                                                G_DBUS_PROXY_FLAGS_DO_NOT_AUTO_START_AT_CONSTRUCTION,
+                                                BUS_NAME,
+                                                OBJECT_PATH,
+                                                self->cancel,
+                                                on_proxy_new_for_bus_finish,
+                                                self);
+
   G_OBJECT_CLASS (phosh_session_manager_parent_class)->constructed (object);
 }
 
@@ -386,6 +417,8 @@ phosh_session_manager_dispose (GObject *object)
   g_clear_pointer (&self->dialog, phosh_cp_widget_destroy);
   g_clear_object (&self->priv_proxy);
   g_clear_object (&self->proxy);
+  g_clear_pointer (&self->pending_app_id, g_free);
+  g_clear_pointer (&self->pending_startup_id, g_free);
 
   G_OBJECT_CLASS (phosh_session_manager_parent_class)->dispose (object);
 }
@@ -411,6 +444,16 @@ phosh_session_manager_class_init (PhoshSessionManagerClass *klass)
                           "Active session",
                           FALSE,
                           G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+  /**
+   * PhoshSessionManager:ready:
+   *
+   * Whether the connection to the session manager was set up. This
+   * doesn't mean that it succeeded.
+   */
+  props[PHOSH_SESSION_MANAGER_PROP_READY] =
+    g_param_spec_boolean ("ready", "", "",
+                          FALSE,
+                          G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
 
   g_object_class_install_properties (object_class, PHOSH_SESSION_MANAGER_PROP_LAST_PROP, props);
 }
@@ -438,15 +481,42 @@ phosh_session_manager_is_active (PhoshSessionManager *self)
   return self->active;
 }
 
+
+gboolean
+phosh_session_manager_is_ready (PhoshSessionManager *self)
+{
+  g_return_val_if_fail (PHOSH_IS_SESSION_MANAGER (self), FALSE);
+
+  return self->ready;
+}
+
+/**
+ * phosh_session_manager_register:
+ * @self: The session manager
+ * @app_id: The app id to register
+ * @startup_id:(nullable): The startup id
+ *
+ * Register with the session manager. If the connection to the
+ * session manager isn't set up yet registration happens once it is.
+ */
 void
 phosh_session_manager_register (PhoshSessionManager *self,
                                 const char          *app_id,
                                 const char          *startup_id)
 {
   g_return_if_fail (PHOSH_IS_SESSION_MANAGER (self));
-  g_return_if_fail (PHOSH_DBUS_IS_SESSION_MANAGER_PROXY (self->proxy));
   g_return_if_fail (app_id != NULL);
 
+  if (!self->ready) {
+    g_free (self->pending_app_id);
+    self->pending_app_id = g_strdup (app_id);
+    g_free (self->pending_startup_id);
+    self->pending_startup_id = g_strdup (startup_id);
+    return;
+  }
+
+  g_return_if_fail (PHOSH_DBUS_IS_SESSION_MANAGER_PROXY (self->proxy));
+
   phosh_dbus_session_manager_call_register_client (self->proxy,
                                                    app_id,
                                                    startup_id ? startup_id : "",
@@ -515,6 +585,9 @@ phosh_session_manager_inhibit (PhoshSessionManager      *self,
   gboolean success;
   guint cookie;
 
+  g_return_val_if_fail (PHOSH_IS_SESSION_MANAGER (self), 0);
+  g_return_val_if_fail (PHOSH_DBUS_IS_SESSION_MANAGER_PROXY (self->proxy), 0);
+
   success = phosh_dbus_session_manager_call_inhibit_sync (self->proxy,
                                                           PHOSH_APP_ID,
                                                           0,
@@ -538,6 +611,9 @@ phosh_session_manager_uninhibit (PhoshSessionManager *self, guint cookie)
   g_autoptr (GError) err = NULL;
   gboolean success;
 
+  g_return_if_fail (PHOSH_IS_SESSION_MANAGER (self));
+  g_return_if_fail (PHOSH_DBUS_IS_SESSION_MANAGER_PROXY (self->proxy));
+
   success = phosh_dbus_session_manager_call_uninhibit_sync (self->proxy,
                                                             cookie,
                                                             self->cancel,
@@ -28,6 +28,7 @@ G_DECLARE_FINAL_TYPE (PhoshSessionManager, phosh_session_manager,
 
 PhoshSessionManager *phosh_session_manager_new (void);
 gboolean phosh_session_manager_is_active (PhoshSessionManager *self);
+gboolean phosh_session_manager_is_ready (PhoshSessionManager *self);
 void     phosh_session_manager_register (PhoshSessionManager *self, const char *app_id, const char *startup_id);
 void     phosh_session_manager_logout (PhoshSessionManager *self);
 void     phosh_session_manager_shutdown (PhoshSessionManager *self);
@@ -21,6 +21,7 @@
 #include "torch-manager.h"
 #include "notifications/notify-manager.h"
 #include "notifications/notification-frame.h"
+#include "watchdog.h"
 
 #include <gio/gdesktopappinfo.h>
 #include <xkbcommon/xkbcommon.h>
@@ -199,8 +200,9 @@ static void
 update_drag_handle_offset (PhoshSettings *self)
 {
   g_clear_handle_id (&self->debounce_handle, g_source_remove);
-  self->debounce_handle = g_timeout_add_once (200, delayed_update_drag_handle_offset, self);
-  g_source_set_name_by_id (self->debounce_handle, "[phosh] delayed_update_drag_handle_offset");
+  self->debounce_handle = phosh_watchdog_timeout_add_once (200, delayed_update_drag_handle_offset,
+                                                           self,
+                                                           "[phosh] delayed_update_drag_handle_offset");
 }
 
 
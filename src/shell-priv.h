@@ -27,6 +27,7 @@
 #include "rotation-manager.h"
 #include "screen-saver-manager.h"
 #include "splash-manager.h"
+#include "startup-scheduler.h"
 #include "style-manager.h"
 #include "toplevel-manager.h"
 #include "torch-manager.h"
@@ -65,6 +66,7 @@ typedef enum {
  * @PHOSH_SHELL_DEBUG_FLAG_FAKE_BUILTIN: When calculatiog layout treat the first
  *     virtual output like a built-in output.
  * @PHOSH_SHELL_DEBUG_BACKLIGHT_NON_LINEAR: Assume backlight uses non-linear scale
+ * @PHOSH_SHELL_DEBUG_FLAG_WATCHDOG: Log main loop stalls and record frame intervals
  *
  * These flags are to enable/disable debugging features.
  */
@@ -73,6 +75,7 @@ typedef enum {
   PHOSH_SHELL_DEBUG_FLAG_ALWAYS_SPLASH = 1 << 0,
   PHOSH_SHELL_DEBUG_FLAG_FAKE_BUILTIN  = 1 << 1,
   PHOSH_SHELL_DEBUG_BACKLIGHT_NON_LINEAR = 1 << 2,
+  PHOSH_SHELL_DEBUG_FLAG_WATCHDOG      = 1 << 3,
 } PhoshShellDebugFlags;
 
 
@@ -94,6 +97,7 @@ PhoshGtkMountManager   *phosh_shell_get_gtk_mount_manager  (PhoshShell *self);
 PhoshLayoutManager     *phosh_shell_get_layout_manager     (PhoshShell *self);
 PhoshModeManager       *phosh_shell_get_mode_manager       (PhoshShell *self);
 PhoshSplashManager *    phosh_shell_get_splash_manager     (PhoshShell *self);
+PhoshStartupScheduler  *phosh_shell_get_startup_scheduler  (PhoshShell *self);
 PhoshStyleManager      *phosh_shell_get_style_manager      (PhoshShell *self);
 PhoshToplevelManager   *phosh_shell_get_toplevel_manager   (PhoshShell *self);
 PhoshScreenSaverManager *phosh_shell_get_screen_saver_manager (PhoshShell *self);
@@ -40,6 +40,7 @@
 #include "connectivity-manager.h"
 #include "calls-manager.h"
 #include "cell-broadcast-manager.h"
+#include "clock-ticker.h"
 #include "docked-info.h"
 #include "docked-manager.h"
 #include "emergency-calls-manager.h"
@@ -89,9 +90,11 @@
 #include "screenshot-manager.h"
 #include "session-manager.h"
 #include "splash-manager.h"
+#include "startup-scheduler.h"
 #include "style-manager.h"
 #include "suspend-manager.h"
 #include "system-prompter.h"
+#include "timeline.h"
 #include "top-panel.h"
 #include "top-panel-bg.h"
 #include "torch-manager.h"
@@ -104,6 +107,7 @@
 #include "wwan/phosh-wwan-ofono.h"
 #include "wwan/phosh-wwan-mm.h"
 #include "wall-clock.h"
+#include "watchdog.h"
 
 #include "phosh-settings-enums.h"
 
@@ -130,6 +134,7 @@ enum {
   PROP_SHELL_STATE,
   PROP_OVERVIEW_VISIBLE,
   PROP_LOG_DOMAINS,
+  PROP_BLANKED,
   PROP_LAST_PROP
 };
 static GParamSpec *props[PROP_LAST_PROP];
@@ -210,6 +215,8 @@ typedef struct {
 
   gboolean                    startup_finished;
   guint startup_finished_id;
+  PhoshStartupScheduler      *startup_scheduler;
+  gint64                      setup_start;
 
   GSimpleActionGroup         *action_map;
 
@@ -360,6 +367,9 @@ on_primary_monitor_power_mode_changed (PhoshShell *self, GParamSpec *pspec, Phos
   g_object_get (monitor, "power-mode", &mode, NULL);
 
   phosh_shell_set_state (self, PHOSH_STATE_BLANKED, mode == PHOSH_MONITOR_POWER_SAVE_MODE_OFF);
+  /* Nobody sees clocks and countdowns while blanked */
+  phosh_clock_ticker_set_paused (phosh_clock_ticker_get_default (),
+                                 mode == PHOSH_MONITOR_POWER_SAVE_MODE_OFF);
 }
 
 
@@ -573,6 +583,9 @@ phosh_shell_get_property (GObject    *object,
   case PROP_LOG_DOMAINS:
     g_value_set_boxed (value, priv->log_domains);
     break;
+  case PROP_BLANKED:
+    g_value_set_boolean (value, phosh_shell_get_blanked (self));
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
     break;
@@ -587,6 +600,7 @@ phosh_shell_dispose (GObject *object)
   PhoshShellPrivate *priv = phosh_shell_get_instance_private (self);
 
   g_clear_handle_id (&priv->startup_finished_id, g_source_remove);
+  g_clear_object (&priv->startup_scheduler);
 
   panels_dispose (self);
   g_clear_pointer (&priv->faders, g_ptr_array_unref);
@@ -714,9 +728,11 @@ on_new_notification (PhoshShell         *self,
 
   /* Clear existing banner */
   g_clear_pointer (&priv->notification_banner, phosh_cp_widget_destroy);
-  if (phosh_notify_manager_get_show_notification_banner (manager, notification) &&
-      phosh_top_panel_get_state (PHOSH_TOP_PANEL (priv->top_panel)) == PHOSH_TOP_PANEL_STATE_FOLDED &&
-      !priv->locked) {
+  /* Only check the banner policy when the banner would be visible to not eat up the app's quota */
+  if (phosh_top_panel_get_state (PHOSH_TOP_PANEL (priv->top_panel)) == PHOSH_TOP_PANEL_STATE_FOLDED &&
+      !priv->locked &&
+      phosh_notify_manager_get_show_notification_banner (manager, notification)) {
+    phosh_notify_manager_record_notification_banner (manager, notification);
     priv->notification_banner = phosh_notification_banner_new (notification);
     g_signal_connect (priv->notification_banner,
                       "destroy",
@@ -821,35 +837,172 @@ on_startup_finished (gpointer data)
   priv = phosh_shell_get_instance_private (self);
 
   notify_compositor_up_state (self, PHOSH_PRIVATE_SHELL_STATE_UP);
+  /* In case the top panel didn't get drawn */
+  phosh_startup_scheduler_release_deferred (priv->startup_scheduler);
 
   priv->startup_finished_id = 0;
 }
 
 
+static void
+on_startup_scheduler_finished (PhoshShell *self)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (self);
+
+  /* Export the debug interface late so everything is up when the name appears */
+  phosh_debug_control_set_exported (priv->debug_control, TRUE);
+
+  /* Delay signaling to the compositor a bit so that idle handlers get a chance to run and
+     the user can unlock right away. Ideally we'd not need this */
+  priv->startup_finished_id = phosh_watchdog_timeout_add_seconds_once (1, on_startup_finished, self,
+                                                                       "[PhoshShell] startup finished");
+
+  priv->startup_finished = TRUE;
+  g_signal_emit (self, signals[READY], 0);
+
+  phosh_timeline_end (priv->setup_start, "shell", "setup");
+}
+
+
 static gboolean
-setup_idle_cb (PhoshShell *self)
+on_top_panel_first_tick (GtkWidget *widget, GdkFrameClock *frame_clock, gpointer user_data)
 {
-  g_autoptr (GError) err = NULL;
+  PhoshShell *self = PHOSH_SHELL (user_data);
   PhoshShellPrivate *priv = phosh_shell_get_instance_private (self);
 
+  /* Deferred tasks run at idle priority so they don't delay drawing this frame */
+  phosh_startup_scheduler_release_deferred (priv->startup_scheduler);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static void
+startup_debug_control (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (PHOSH_SHELL (user_data));
+
   priv->debug_control = phosh_debug_control_new ();
+}
+
+
+static void
+startup_app_tracker (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (PHOSH_SHELL (user_data));
+
   priv->app_tracker = phosh_app_tracker_new ();
   priv->splash_manager = phosh_splash_manager_new (priv->app_tracker);
+}
+
+
+static void
+startup_session_manager (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (PHOSH_SHELL (user_data));
+
   priv->session_manager = phosh_session_manager_new ();
+  /* Registration happens once the session manager is ready */
+  phosh_session_manager_register (priv->session_manager,
+                                  PHOSH_APP_ID,
+                                  g_getenv ("DESKTOP_AUTOSTART_ID"));
+  g_unsetenv ("DESKTOP_AUTOSTART_ID");
+}
+
+
+static void
+on_session_manager_ready (PhoshShell *self)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (self);
+
+  if (!phosh_session_manager_is_ready (priv->session_manager))
+    return;
+
+  g_signal_handlers_disconnect_by_func (priv->session_manager, on_session_manager_ready, self);
+  phosh_startup_scheduler_complete (priv->startup_scheduler, "session-ready");
+}
+
+
+static void
+startup_session_ready (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShell *self = PHOSH_SHELL (user_data);
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (self);
+
+  g_signal_connect_object (priv->session_manager,
+                           "notify::ready",
+                           G_CALLBACK (on_session_manager_ready),
+                           self,
+                           G_CONNECT_SWAPPED);
+  on_session_manager_ready (self);
+}
+
+
+static void
+startup_mode_manager (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (PHOSH_SHELL (user_data));
+
   priv->mode_manager = phosh_mode_manager_new ();
+}
+
+
+static void
+startup_wifi_manager (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (PHOSH_SHELL (user_data));
+
   priv->wifi_manager = phosh_wifi_manager_new ();
-  /* Connecivity manager needs Wi-Fi manager: */
+}
+
+
+static void
+startup_connectivity_manager (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (PHOSH_SHELL (user_data));
+
   priv->connectivity_manager = phosh_connectivity_manager_new ();
+}
+
+
+static void
+startup_sensors (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (PHOSH_SHELL (user_data));
+  g_autoptr (GError) err = NULL;
 
   priv->sensor_proxy_manager = phosh_sensor_proxy_manager_new (&err);
   if (priv->sensor_proxy_manager)
     priv->ambient = phosh_ambient_new (priv->sensor_proxy_manager);
   else
     g_message ("Failed to connect to sensor-proxy: %s", err->message);
+}
+
+
+static void
+startup_layout_manager (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (PHOSH_SHELL (user_data));
 
   priv->layout_manager = phosh_layout_manager_new ();
-  /* PhoshHome needs the background manager */
+}
+
+
+static void
+startup_background_manager (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (PHOSH_SHELL (user_data));
+
   priv->background_manager = phosh_background_manager_new ();
+}
+
+
+static void
+startup_panels (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShell *self = PHOSH_SHELL (user_data);
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (self);
+
   panels_create (self);
 
   g_signal_connect_object (priv->toplevel_manager,
@@ -865,12 +1018,34 @@ setup_idle_cb (PhoshShell *self)
                            self,
                            G_CONNECT_SWAPPED);
 
+  /* Run non-critical tasks once the top panel was drawn */
+  if (priv->top_panel)
+    gtk_widget_add_tick_callback (GTK_WIDGET (priv->top_panel), on_top_panel_first_tick, self, NULL);
+  else
+    phosh_startup_scheduler_release_deferred (priv->startup_scheduler);
+}
+
+
+static void
+startup_screen_saver_manager (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShell *self = PHOSH_SHELL (user_data);
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (self);
+
   /* Screen saver manager needs lock screen manager */
   priv->screen_saver_manager = phosh_screen_saver_manager_new (priv->lockscreen_manager);
   g_signal_connect_swapped (priv->screen_saver_manager,
                             "pb-long-press",
                             G_CALLBACK (on_pb_long_press),
                             self);
+}
+
+
+static void
+startup_notify_manager (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShell *self = PHOSH_SHELL (user_data);
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (self);
 
   priv->notify_manager = phosh_notify_manager_get_default ();
   g_signal_connect_object (priv->notify_manager,
@@ -883,49 +1058,203 @@ setup_idle_cb (PhoshShell *self)
                            G_CALLBACK (on_notification_activated),
                            self,
                            G_CONNECT_SWAPPED);
+}
 
-  phosh_shell_get_location_manager (self);
-  if (priv->sensor_proxy_manager) {
-    priv->proximity = phosh_proximity_new (priv->sensor_proxy_manager,
-                                           priv->calls_manager);
-    phosh_monitor_manager_set_sensor_proxy_manager (priv->monitor_manager,
-                                                    priv->sensor_proxy_manager);
-    g_signal_connect_swapped (priv->proximity, "notify::fader",
-                              G_CALLBACK (on_proximity_fader_changed), self);
-  }
+
+static void
+startup_location_manager (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  phosh_shell_get_location_manager (PHOSH_SHELL (user_data));
+}
+
+
+static void
+startup_proximity (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShell *self = PHOSH_SHELL (user_data);
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (self);
+
+  if (!priv->sensor_proxy_manager)
+    return;
+
+  priv->proximity = phosh_proximity_new (priv->sensor_proxy_manager, priv->calls_manager);
+  phosh_monitor_manager_set_sensor_proxy_manager (priv->monitor_manager,
+                                                  priv->sensor_proxy_manager);
+  g_signal_connect_swapped (priv->proximity, "notify::fader",
+                            G_CALLBACK (on_proximity_fader_changed), self);
+}
+
+
+static void
+startup_mount_manager (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (PHOSH_SHELL (user_data));
 
   priv->mount_manager = phosh_mount_manager_new ();
   priv->gtk_mount_manager = phosh_gtk_mount_manager_new ();
+}
 
-  phosh_session_manager_register (priv->session_manager,
-                                  PHOSH_APP_ID,
-                                  g_getenv ("DESKTOP_AUTOSTART_ID"));
-  g_unsetenv ("DESKTOP_AUTOSTART_ID");
+
+static void
+startup_gnome_shell_manager (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (PHOSH_SHELL (user_data));
 
   priv->gnome_shell_manager = phosh_gnome_shell_manager_get_default ();
+}
+
+
+static void
+startup_screenshot_manager (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (PHOSH_SHELL (user_data));
+
   priv->screenshot_manager = phosh_screenshot_manager_new ();
-  priv->run_command_manager = phosh_run_command_manager_new ();
+}
+
+
+static void
+startup_network_auth_manager (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (PHOSH_SHELL (user_data));
+
   priv->network_auth_manager = phosh_network_auth_manager_new ();
-  priv->portal_access_manager = phosh_portal_access_manager_new ();
+}
+
+
+static void
+startup_suspend_manager (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (PHOSH_SHELL (user_data));
+
   priv->suspend_manager = phosh_suspend_manager_new ();
+}
+
+
+static void
+startup_emergency_calls_manager (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (PHOSH_SHELL (user_data));
+
   priv->emergency_calls_manager = phosh_emergency_calls_manager_new ();
+}
+
+
+static void
+startup_power_menu_manager (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (PHOSH_SHELL (user_data));
+
   priv->power_menu_manager = phosh_power_menu_manager_new ();
-  priv->cell_broadcast_manager = phosh_cell_broadcast_manager_new ();
+}
+
+
+static void
+startup_event_hooks (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShell *self = PHOSH_SHELL (user_data);
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (self);
 
   setup_primary_monitor_signal_handlers (self);
   /* Setup event hooks late so state changes in UI files don't trigger feedback */
   phosh_feedback_manager_setup_event_hooks (priv->feedback_manager);
+}
 
-  /* Export the debug interface late so everything is up when the name appears */
-  phosh_debug_control_set_exported (priv->debug_control, TRUE);
 
-  /* Delay signaling to the compositor a bit so that idle handlers get a chance to run and
-     the user can unlock right away. Ideally we'd not need this */
-  priv->startup_finished_id = g_timeout_add_seconds_once (1, on_startup_finished, self);
-  g_source_set_name_by_id (priv->startup_finished_id, "[PhoshShell] startup finished");
+static void
+startup_run_command_manager (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (PHOSH_SHELL (user_data));
+
+  priv->run_command_manager = phosh_run_command_manager_new ();
+}
+
+
+static void
+startup_portal_access_manager (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (PHOSH_SHELL (user_data));
+
+  priv->portal_access_manager = phosh_portal_access_manager_new ();
+}
+
+
+static void
+startup_cell_broadcast_manager (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (PHOSH_SHELL (user_data));
+
+  priv->cell_broadcast_manager = phosh_cell_broadcast_manager_new ();
+}
+
+/*
+ * The tasks run on startup. Tasks are started in the order listed here
+ * once their dependencies are done.
+ */
+static const struct {
+  const char            *name;
+  PhoshStartupTaskFunc   func;
+  PhoshStartupTaskFlags  flags;
+  const char            *deps[10];
+} startup_tasks[] = {
+  { "debug-control", startup_debug_control },
+  { "app-tracker", startup_app_tracker },
+  { "session-manager", startup_session_manager },
+  { "session-ready", startup_session_ready, PHOSH_STARTUP_TASK_FLAG_ASYNC, { "session-manager" } },
+  { "mode-manager", startup_mode_manager },
+  { "wifi-manager", startup_wifi_manager },
+  /* Connecivity manager needs Wi-Fi manager: */
+  { "connectivity-manager", startup_connectivity_manager, 0, { "wifi-manager" } },
+  { "sensors", startup_sensors },
+  { "layout-manager", startup_layout_manager },
+  /* PhoshHome needs the background manager */
+  { "background-manager", startup_background_manager },
+  { "panels", startup_panels, 0,
+    { "app-tracker", "session-manager", "mode-manager", "wifi-manager", "connectivity-manager",
+      "sensors", "layout-manager", "background-manager" } },
+  { "screen-saver-manager", startup_screen_saver_manager, 0, { "panels" } },
+  { "notify-manager", startup_notify_manager, 0, { "panels" } },
+  { "location-manager", startup_location_manager },
+  { "proximity", startup_proximity, 0, { "sensors" } },
+  { "mount-manager", startup_mount_manager, 0, { "session-manager" } },
+  { "gnome-shell-manager", startup_gnome_shell_manager, 0, { "panels" } },
+  { "screenshot-manager", startup_screenshot_manager },
+  { "network-auth-manager", startup_network_auth_manager },
+  /* Inhibiting suspend needs the session manager */
+  { "suspend-manager", startup_suspend_manager, 0, { "session-ready" } },
+  { "emergency-calls-manager", startup_emergency_calls_manager },
+  { "power-menu-manager", startup_power_menu_manager, 0, { "session-manager" } },
+  { "event-hooks", startup_event_hooks, 0, { "panels", "notify-manager" } },
+  /* Not needed for an interactive shell, run after the top panel got drawn */
+  { "run-command-manager", startup_run_command_manager, PHOSH_STARTUP_TASK_FLAG_DEFERRED },
+  { "portal-access-manager", startup_portal_access_manager, PHOSH_STARTUP_TASK_FLAG_DEFERRED },
+  { "cell-broadcast-manager", startup_cell_broadcast_manager, PHOSH_STARTUP_TASK_FLAG_DEFERRED },
+};
 
-  priv->startup_finished = TRUE;
-  g_signal_emit (self, signals[READY], 0);
+
+static gboolean
+setup_idle_cb (PhoshShell *self)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (self);
+
+  priv->setup_start = phosh_timeline_begin ();
+
+  priv->startup_scheduler = phosh_startup_scheduler_new ();
+  g_signal_connect_object (priv->startup_scheduler,
+                           "finished",
+                           G_CALLBACK (on_startup_scheduler_finished),
+                           self,
+                           G_CONNECT_SWAPPED);
+
+  for (int i = 0; i < G_N_ELEMENTS (startup_tasks); i++) {
+    phosh_startup_scheduler_add_task (priv->startup_scheduler,
+                                      startup_tasks[i].name,
+                                      startup_tasks[i].deps,
+                                      startup_tasks[i].flags,
+                                      startup_tasks[i].func,
+                                      self);
+  }
+  phosh_startup_scheduler_run (priv->startup_scheduler);
 
   return FALSE;
 }
@@ -1112,7 +1441,8 @@ phosh_shell_constructed (GObject *object)
 
   G_OBJECT_CLASS (phosh_shell_parent_class)->constructed (object);
 
-  priv->monitor_manager = phosh_monitor_manager_new (NULL);
+  PHOSH_TIMELINE_SPAN ("manager", "monitor-manager",
+                       priv->monitor_manager = phosh_monitor_manager_new (NULL));
   g_signal_connect_swapped (priv->monitor_manager,
                             "monitor-added",
                             G_CALLBACK (on_monitor_added),
@@ -1147,23 +1477,30 @@ phosh_shell_constructed (GObject *object)
     g_error ("Need at least one monitor");
   }
 
-  priv->calls_manager = phosh_calls_manager_new ();
-  priv->launcher_entry_manager = phosh_launcher_entry_manager_new ();
+  PHOSH_TIMELINE_SPAN ("manager", "calls-manager",
+                       priv->calls_manager = phosh_calls_manager_new ());
+  PHOSH_TIMELINE_SPAN ("manager", "launcher-entry-manager",
+                       priv->launcher_entry_manager = phosh_launcher_entry_manager_new ());
 
-  priv->lockscreen_manager = phosh_lockscreen_manager_new (priv->calls_manager);
+  PHOSH_TIMELINE_SPAN ("manager", "lockscreen-manager",
+                       priv->lockscreen_manager = phosh_lockscreen_manager_new (priv->calls_manager));
   g_object_bind_property (priv->lockscreen_manager, "locked",
                           self, "locked",
                           G_BINDING_BIDIRECTIONAL | G_BINDING_SYNC_CREATE);
 
-  priv->idle_manager = phosh_idle_manager_get_default ();
+  PHOSH_TIMELINE_SPAN ("manager", "idle-manager",
+                       priv->idle_manager = phosh_idle_manager_get_default ());
 
   priv->faders = g_ptr_array_new_with_free_func ((GDestroyNotify) (gtk_widget_destroy));
 
   phosh_system_prompter_register ();
-  priv->polkit_auth_agent = phosh_polkit_auth_agent_new ();
+  PHOSH_TIMELINE_SPAN ("manager", "polkit-auth-agent",
+                       priv->polkit_auth_agent = phosh_polkit_auth_agent_new ());
 
-  priv->feedback_manager = phosh_feedback_manager_new ();
-  priv->keyboard_events = phosh_keyboard_events_new (&err);
+  PHOSH_TIMELINE_SPAN ("manager", "feedback-manager",
+                       priv->feedback_manager = phosh_feedback_manager_new ());
+  PHOSH_TIMELINE_SPAN ("manager", "keyboard-events",
+                       priv->keyboard_events = phosh_keyboard_events_new (&err));
   if (priv->keyboard_events) {
     g_signal_connect_swapped (priv->keyboard_events,
                               "pressed",
@@ -1173,8 +1510,7 @@ phosh_shell_constructed (GObject *object)
     g_warning ("Failed to initialize keyboard events: %s", err->message);
   }
 
-  id = g_idle_add ((GSourceFunc) setup_idle_cb, self);
-  g_source_set_name_by_id (id, "[PhoshShell] idle");
+  id = phosh_watchdog_idle_add ((GSourceFunc) setup_idle_cb, self, "[PhoshShell] idle");
 }
 
 /* {{{ Action Map/Group */
@@ -1402,7 +1738,18 @@ phosh_shell_class_init (PhoshShellClass *klass)
     g_param_spec_boxed ("log-domains", "", "",
                         G_TYPE_STRV,
                         G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
-
+  /**
+   * PhoshShell:blanked:
+   *
+   * Whether the primary display is currently blanked. Timers,
+   * animations and polling that only update what is shown on screen
+   * should be suspended while this is %TRUE and resynchronized once
+   * it becomes %FALSE again.
+   */
+  props[PROP_BLANKED] =
+    g_param_spec_boolean ("blanked", "", "",
+                          FALSE,
+                          G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
 
   g_object_class_install_properties (object_class, PROP_LAST_PROP, props);
 
@@ -1434,6 +1781,9 @@ static GDebugKey debug_keys[] =
  { .key = "backlight-non-linear",
    .value = PHOSH_SHELL_DEBUG_BACKLIGHT_NON_LINEAR,
  },
+ { .key = "watchdog",
+   .value = PHOSH_SHELL_DEBUG_FLAG_WATCHDOG,
+ },
 };
 
 
@@ -1458,16 +1808,21 @@ phosh_shell_init (PhoshShell *self)
   debug_flags = g_parse_debug_string (g_getenv ("PHOSH_DEBUG"),
                                       debug_keys,
                                       G_N_ELEMENTS (debug_keys));
+  if (debug_flags & PHOSH_SHELL_DEBUG_FLAG_WATCHDOG)
+    phosh_watchdog_start (PHOSH_WATCHDOG_DEFAULT_THRESHOLD);
 
-  priv->style_manager = phosh_style_manager_new ();
+  PHOSH_TIMELINE_SPAN ("manager", "style-manager",
+                       priv->style_manager = phosh_style_manager_new ());
   priv->shell_state = PHOSH_STATE_SETTINGS;
   priv->action_map = g_simple_action_group_new ();
   priv->settings = g_settings_new ("sm.puri.phosh");
 
   /* We bind this early since a wl_display_roundtrip () would make us miss
      existing toplevels */
-  priv->toplevel_manager = phosh_toplevel_manager_new ();
-  priv->udev_manager = phosh_udev_manager_get_default ();
+  PHOSH_TIMELINE_SPAN ("manager", "toplevel-manager",
+                       priv->toplevel_manager = phosh_toplevel_manager_new ());
+  PHOSH_TIMELINE_SPAN ("manager", "udev-manager",
+                       priv->udev_manager = phosh_udev_manager_get_default ());
 }
 
 /* }}} */
@@ -1547,8 +1902,8 @@ phosh_shell_set_primary_monitor (PhoshShell *self, PhoshMonitor *monitor)
     guint id;
     /* No monitor - we're not useful atm */
     notify_compositor_up_state (self, PHOSH_PRIVATE_SHELL_STATE_UNKNOWN);
-    id = g_idle_add (select_fallback_monitor, self);
-    g_source_set_name_by_id (id, "[PhoshShell] select fallback monitor");
+    id = phosh_watchdog_idle_add (select_fallback_monitor, self,
+                                  "[PhoshShell] select fallback monitor");
   } else {
     if (needs_notify)
       notify_compositor_up_state (self, PHOSH_PRIVATE_SHELL_STATE_UP);
@@ -1973,6 +2328,25 @@ phosh_shell_get_splash_manager (PhoshShell *self)
   return priv->splash_manager;
 }
 
+/**
+ * phosh_shell_get_startup_scheduler:
+ * @self: The shell singleton
+ *
+ * Get the scheduler that brings up the shell's managers
+ *
+ * Returns: (transfer none)(nullable): The startup scheduler
+ */
+PhoshStartupScheduler *
+phosh_shell_get_startup_scheduler (PhoshShell *self)
+{
+  PhoshShellPrivate *priv;
+
+  g_return_val_if_fail (PHOSH_IS_SHELL (self), NULL);
+  priv = phosh_shell_get_instance_private (self);
+
+  return priv->startup_scheduler;
+}
+
 /**
  * phosh_shell_get_wifi_manager:
  * @self: The shell singleton
@@ -2011,7 +2385,8 @@ phosh_shell_get_brightness_manager (PhoshShell *self)
   g_return_val_if_fail (PHOSH_IS_SHELL (self), NULL);
 
   if (!priv->brightness_manager)
-    priv->brightness_manager = phosh_brightness_manager_new ();
+    PHOSH_TIMELINE_SPAN ("manager", "brightness-manager",
+                         priv->brightness_manager = phosh_brightness_manager_new ());
 
   g_return_val_if_fail (PHOSH_IS_BRIGHTNESS_MANAGER (priv->brightness_manager), NULL);
 
@@ -2035,7 +2410,8 @@ phosh_shell_get_battery_manager (PhoshShell *self)
   priv = phosh_shell_get_instance_private (self);
 
   if (!priv->battery_manager)
-    priv->battery_manager = phosh_battery_manager_new ();
+    PHOSH_TIMELINE_SPAN ("manager", "battery-manager",
+                         priv->battery_manager = phosh_battery_manager_new ());
 
   g_return_val_if_fail (PHOSH_IS_BATTERY_MANAGER (priv->battery_manager), NULL);
   return priv->battery_manager;
@@ -2058,7 +2434,7 @@ phosh_shell_get_bt_manager (PhoshShell *self)
   priv = phosh_shell_get_instance_private (self);
 
   if (!priv->bt_manager)
-    priv->bt_manager = phosh_bt_manager_new ();
+    PHOSH_TIMELINE_SPAN ("manager", "bt-manager", priv->bt_manager = phosh_bt_manager_new ());
 
   g_return_val_if_fail (PHOSH_IS_BT_MANAGER (priv->bt_manager), NULL);
   return priv->bt_manager;
@@ -2081,7 +2457,8 @@ phosh_shell_get_docked_manager (PhoshShell *self)
   priv = phosh_shell_get_instance_private (self);
 
   if (!priv->docked_manager) {
-    priv->docked_manager = phosh_docked_manager_new (priv->mode_manager);
+    PHOSH_TIMELINE_SPAN ("manager", "docked-manager",
+                         priv->docked_manager = phosh_docked_manager_new (priv->mode_manager));
     g_object_bind_property (priv->docked_manager,
                             "enabled",
                             self,
@@ -2110,7 +2487,7 @@ phosh_shell_get_hks_manager (PhoshShell *self)
   priv = phosh_shell_get_instance_private (self);
 
   if (!priv->hks_manager)
-    priv->hks_manager = phosh_hks_manager_new ();
+    PHOSH_TIMELINE_SPAN ("manager", "hks-manager", priv->hks_manager = phosh_hks_manager_new ());
 
   g_return_val_if_fail (PHOSH_IS_HKS_MANAGER (priv->hks_manager), NULL);
   return priv->hks_manager;
@@ -2133,7 +2510,8 @@ phosh_shell_get_location_manager (PhoshShell *self)
   priv = phosh_shell_get_instance_private (self);
 
   if (!priv->location_manager)
-    priv->location_manager = phosh_location_manager_new ();
+    PHOSH_TIMELINE_SPAN ("manager", "location-manager",
+                         priv->location_manager = phosh_location_manager_new ());
 
   g_return_val_if_fail (PHOSH_IS_LOCATION_MANAGER (priv->location_manager), NULL);
   return priv->location_manager;
@@ -2156,7 +2534,8 @@ phosh_shell_get_mpris_manager (PhoshShell *self)
   priv = phosh_shell_get_instance_private (self);
 
   if (!priv->mpris_manager)
-    priv->mpris_manager = phosh_mpris_manager_new ();
+    PHOSH_TIMELINE_SPAN ("manager", "mpris-manager",
+                         priv->mpris_manager = phosh_mpris_manager_new ());
 
   g_return_val_if_fail (PHOSH_IS_MPRIS_MANAGER (priv->mpris_manager), NULL);
   return priv->mpris_manager;
@@ -2179,7 +2558,7 @@ phosh_shell_get_osk_manager (PhoshShell *self)
   priv = phosh_shell_get_instance_private (self);
 
   if (!priv->osk_manager)
-    priv->osk_manager = phosh_osk_manager_new ();
+    PHOSH_TIMELINE_SPAN ("manager", "osk-manager", priv->osk_manager = phosh_osk_manager_new ());
 
   g_return_val_if_fail (PHOSH_IS_OSK_MANAGER (priv->osk_manager), NULL);
   return priv->osk_manager;
@@ -2234,7 +2613,8 @@ phosh_shell_get_torch_manager (PhoshShell *self)
   priv = phosh_shell_get_instance_private (self);
 
   if (!priv->torch_manager)
-    priv->torch_manager = phosh_torch_manager_new ();
+    PHOSH_TIMELINE_SPAN ("manager", "torch-manager",
+                         priv->torch_manager = phosh_torch_manager_new ());
 
   g_return_val_if_fail (PHOSH_IS_TORCH_MANAGER (priv->torch_manager), NULL);
   return priv->torch_manager;
@@ -2257,7 +2637,7 @@ phosh_shell_get_vpn_manager (PhoshShell *self)
   priv = phosh_shell_get_instance_private (self);
 
   if (!priv->vpn_manager)
-    priv->vpn_manager = phosh_vpn_manager_new ();
+    PHOSH_TIMELINE_SPAN ("manager", "vpn-manager", priv->vpn_manager = phosh_vpn_manager_new ());
 
   g_return_val_if_fail (PHOSH_IS_VPN_MANAGER (priv->vpn_manager), NULL);
   return priv->vpn_manager;
@@ -2285,10 +2665,10 @@ phosh_shell_get_wwan (PhoshShell *self)
     switch (backend) {
       default:
       case PHOSH_WWAN_BACKEND_MM:
-        priv->wwan = PHOSH_WWAN (phosh_wwan_mm_new());
+        PHOSH_TIMELINE_SPAN ("manager", "wwan", priv->wwan = PHOSH_WWAN (phosh_wwan_mm_new()));
         break;
       case PHOSH_WWAN_BACKEND_OFONO:
-        priv->wwan = PHOSH_WWAN (phosh_wwan_ofono_new());
+        PHOSH_TIMELINE_SPAN ("manager", "wwan", priv->wwan = PHOSH_WWAN (phosh_wwan_ofono_new()));
         break;
     }
   }
@@ -2434,8 +2814,8 @@ phosh_shell_fade_out (PhoshShell *self, guint timeout)
     if (timeout > 0) {
       guint id;
 
-      id = g_timeout_add_seconds (timeout, (GSourceFunc) on_fade_out_timeout, self);
-      g_source_set_name_by_id (id, "[PhoshShell] fade out");
+      id = phosh_watchdog_timeout_add_seconds (timeout, (GSourceFunc) on_fade_out_timeout, self,
+                                               "[PhoshShell] fade out");
     }
   }
 }
@@ -2626,6 +3006,9 @@ phosh_shell_set_state (PhoshShell          *self,
 
   g_object_notify_by_pspec (G_OBJECT (self), props[PROP_SHELL_STATE]);
 
+  if ((old_state ^ priv->shell_state) & PHOSH_STATE_BLANKED)
+    g_object_notify_by_pspec (G_OBJECT (self), props[PROP_BLANKED]);
+
   if (state & PHOSH_STATE_MODAL_SYSTEM_PROMPT)
     update_top_level_layer (self);
 }
@@ -2822,10 +3205,9 @@ phosh_shell_show_osd (PhoshShell *self,
   }
 
   if (!priv->osd_timeoutid) {
-    priv->osd_timeoutid = g_timeout_add_seconds (OSD_HIDE_TIMEOUT,
-                                                 (GSourceFunc) on_osd_timeout,
-                                                 self);
-    g_source_set_name_by_id (priv->osd_timeoutid, "[phosh] osd-timeout");
+    priv->osd_timeoutid = phosh_watchdog_timeout_add_seconds (OSD_HIDE_TIMEOUT,
+                                                              (GSourceFunc) on_osd_timeout, self,
+                                                              "[phosh] osd-timeout");
   }
 }
 
@@ -0,0 +1,445 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#define G_LOG_DOMAIN "phosh-startup-scheduler"
+
+#include "phosh-config.h"
+
+#include "startup-scheduler.h"
+#include "timeline.h"
+#include "watchdog.h"
+
+/**
+ * PhoshStartupScheduler:
+ *
+ * Dependency ordered bring up of the shell's managers
+ *
+ * The scheduler runs named tasks once all the tasks they depend on are
+ * done. Tasks are run one per main loop iteration so frames can be drawn
+ * in between. Asynchronous tasks (e.g. ones that wait for a DBus proxy)
+ * only block the tasks that depend on them, allowing independent work to
+ * proceed concurrently. Deferred tasks are not critical for startup and
+ * only run once the shell released them (e.g. after the first frame of
+ * the top panel).
+ *
+ * Once all non-deferred tasks are done [signal@StartupScheduler::finished]
+ * is emitted and the critical path (the chain of tasks that determined
+ * the time until then) can be queried.
+ */
+
+enum {
+  FINISHED,
+  N_SIGNALS
+};
+static guint signals[N_SIGNALS];
+
+typedef enum {
+  TASK_STATE_PENDING,
+  TASK_STATE_RUNNING,
+  TASK_STATE_DONE,
+} TaskState;
+
+typedef struct {
+  char                 *name;
+  GStrv                 deps;
+  PhoshStartupTaskFlags flags;
+  PhoshStartupTaskFunc  func;
+  gpointer              user_data;
+
+  TaskState             state;
+  gint64                start;
+  gint64                end;
+  /* The dependency that finished last */
+  const char           *critical_dep;
+} PhoshStartupTask;
+
+
+struct _PhoshStartupScheduler {
+  GObject     parent;
+
+  GPtrArray  *tasks;
+  GHashTable *tasks_by_name;
+
+  gboolean    running;
+  gboolean    deferred_released;
+  gboolean    finished;
+  guint       idle_id;
+};
+G_DEFINE_TYPE (PhoshStartupScheduler, phosh_startup_scheduler, G_TYPE_OBJECT)
+
+
+static void
+phosh_startup_task_free (PhoshStartupTask *task)
+{
+  g_free (task->name);
+  g_strfreev (task->deps);
+  g_free (task);
+}
+
+
+static gboolean
+task_is_ready (PhoshStartupScheduler *self, PhoshStartupTask *task)
+{
+  if (task->state != TASK_STATE_PENDING)
+    return FALSE;
+
+  if ((task->flags & PHOSH_STARTUP_TASK_FLAG_DEFERRED) && !self->deferred_released)
+    return FALSE;
+
+  for (int i = 0; task->deps && task->deps[i]; i++) {
+    PhoshStartupTask *dep = g_hash_table_lookup (self->tasks_by_name, task->deps[i]);
+
+    /* Unknown dependencies are warned about in phosh_startup_scheduler_run () */
+    if (dep && dep->state != TASK_STATE_DONE)
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+
+static PhoshStartupTask *
+find_ready_task (PhoshStartupScheduler *self)
+{
+  for (guint i = 0; i < self->tasks->len; i++) {
+    PhoshStartupTask *task = g_ptr_array_index (self->tasks, i);
+
+    if (task_is_ready (self, task))
+      return task;
+  }
+
+  return NULL;
+}
+
+
+static void
+check_finished (PhoshStartupScheduler *self)
+{
+  if (self->finished)
+    return;
+
+  for (guint i = 0; i < self->tasks->len; i++) {
+    PhoshStartupTask *task = g_ptr_array_index (self->tasks, i);
+
+    if (task->flags & PHOSH_STARTUP_TASK_FLAG_DEFERRED)
+      continue;
+
+    if (task->state != TASK_STATE_DONE)
+      return;
+  }
+
+  self->finished = TRUE;
+
+  if (g_log_get_debug_enabled ()) {
+    g_autoptr (GVariant) path = g_variant_ref_sink (phosh_startup_scheduler_get_critical_path (self));
+    g_autofree char *str = g_variant_print (path, FALSE);
+
+    g_debug ("Startup finished, critical path: %s", str);
+  }
+
+  g_signal_emit (self, signals[FINISHED], 0);
+}
+
+
+static void
+task_done (PhoshStartupScheduler *self, PhoshStartupTask *task)
+{
+  task->state = TASK_STATE_DONE;
+  task->end = g_get_monotonic_time ();
+
+  phosh_timeline_add_span ("startup-task", task->name, task->start, task->end);
+  g_debug ("Task '%s' done after %" G_GINT64_FORMAT "µs", task->name, task->end - task->start);
+}
+
+
+static void
+run_task (PhoshStartupScheduler *self, PhoshStartupTask *task)
+{
+  gint64 latest = 0;
+
+  for (int i = 0; task->deps && task->deps[i]; i++) {
+    PhoshStartupTask *dep = g_hash_table_lookup (self->tasks_by_name, task->deps[i]);
+
+    if (dep && dep->end > latest) {
+      latest = dep->end;
+      task->critical_dep = dep->name;
+    }
+  }
+
+  g_debug ("Running task '%s'", task->name);
+  task->state = TASK_STATE_RUNNING;
+  task->start = g_get_monotonic_time ();
+
+  if (task->func)
+    task->func (self, task->user_data);
+
+  if (!(task->flags & PHOSH_STARTUP_TASK_FLAG_ASYNC))
+    task_done (self, task);
+}
+
+
+static gboolean
+on_idle (gpointer user_data)
+{
+  PhoshStartupScheduler *self = PHOSH_STARTUP_SCHEDULER (user_data);
+  PhoshStartupTask *task;
+
+  task = find_ready_task (self);
+  if (task == NULL) {
+    self->idle_id = 0;
+    return G_SOURCE_REMOVE;
+  }
+
+  g_object_ref (self);
+  run_task (self, task);
+  check_finished (self);
+  g_object_unref (self);
+
+  return G_SOURCE_CONTINUE;
+}
+
+
+static void
+schedule (PhoshStartupScheduler *self)
+{
+  if (!self->running || self->idle_id)
+    return;
+
+  /* Run at idle priority so redraws take precedence */
+  self->idle_id = phosh_watchdog_idle_add (on_idle, self, "[PhoshStartupScheduler] idle");
+}
+
+
+static void
+phosh_startup_scheduler_dispose (GObject *object)
+{
+  PhoshStartupScheduler *self = PHOSH_STARTUP_SCHEDULER (object);
+
+  g_clear_handle_id (&self->idle_id, g_source_remove);
+
+  G_OBJECT_CLASS (phosh_startup_scheduler_parent_class)->dispose (object);
+}
+
+
+static void
+phosh_startup_scheduler_finalize (GObject *object)
+{
+  PhoshStartupScheduler *self = PHOSH_STARTUP_SCHEDULER (object);
+
+  g_clear_pointer (&self->tasks_by_name, g_hash_table_destroy);
+  g_clear_pointer (&self->tasks, g_ptr_array_unref);
+
+  G_OBJECT_CLASS (phosh_startup_scheduler_parent_class)->finalize (object);
+}
+
+
+static void
+phosh_startup_scheduler_class_init (PhoshStartupSchedulerClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->dispose = phosh_startup_scheduler_dispose;
+  object_class->finalize = phosh_startup_scheduler_finalize;
+
+  /**
+   * PhoshStartupScheduler::finished:
+   *
+   * Emitted once all tasks that aren't deferred are done.
+   */
+  signals[FINISHED] = g_signal_new ("finished",
+                                    G_TYPE_FROM_CLASS (klass),
+                                    G_SIGNAL_RUN_LAST,
+                                    0, NULL, NULL, NULL,
+                                    G_TYPE_NONE,
+                                    0);
+}
+
+
+static void
+phosh_startup_scheduler_init (PhoshStartupScheduler *self)
+{
+  self->tasks = g_ptr_array_new_with_free_func ((GDestroyNotify) phosh_startup_task_free);
+  self->tasks_by_name = g_hash_table_new (g_str_hash, g_str_equal);
+}
+
+
+PhoshStartupScheduler *
+phosh_startup_scheduler_new (void)
+{
+  return g_object_new (PHOSH_TYPE_STARTUP_SCHEDULER, NULL);
+}
+
+/**
+ * phosh_startup_scheduler_add_task:
+ * @self: The startup scheduler
+ * @name: The task's unique name
+ * @deps:(nullable)(array zero-terminated=1): The names of the tasks this task depends on
+ * @flags: Flags for the task
+ * @func:(scope notified): The function to run
+ * @user_data: The user data passed to `func`
+ *
+ * Add a task to the scheduler. The task is run once all the tasks in
+ * @deps are done.
+ */
+void
+phosh_startup_scheduler_add_task (PhoshStartupScheduler *self,
+                                  const char            *name,
+                                  const char *const     *deps,
+                                  PhoshStartupTaskFlags  flags,
+                                  PhoshStartupTaskFunc   func,
+                                  gpointer               user_data)
+{
+  PhoshStartupTask *task;
+
+  g_return_if_fail (PHOSH_IS_STARTUP_SCHEDULER (self));
+  g_return_if_fail (name);
+  g_return_if_fail (!g_hash_table_contains (self->tasks_by_name, name));
+
+  task = g_new0 (PhoshStartupTask, 1);
+  task->name = g_strdup (name);
+  task->deps = g_strdupv ((GStrv)deps);
+  task->flags = flags;
+  task->func = func;
+  task->user_data = user_data;
+
+  g_ptr_array_add (self->tasks, task);
+  g_hash_table_insert (self->tasks_by_name, task->name, task);
+
+  /* Late additions need to invalidate a previous finish */
+  if (!(flags & PHOSH_STARTUP_TASK_FLAG_DEFERRED))
+    self->finished = FALSE;
+
+  schedule (self);
+}
+
+/**
+ * phosh_startup_scheduler_run:
+ * @self: The startup scheduler
+ *
+ * Start running tasks.
+ */
+void
+phosh_startup_scheduler_run (PhoshStartupScheduler *self)
+{
+  g_return_if_fail (PHOSH_IS_STARTUP_SCHEDULER (self));
+
+  for (guint i = 0; i < self->tasks->len; i++) {
+    PhoshStartupTask *task = g_ptr_array_index (self->tasks, i);
+
+    for (int j = 0; task->deps && task->deps[j]; j++) {
+      if (!g_hash_table_contains (self->tasks_by_name, task->deps[j]))
+        g_warning ("Task '%s' depends on unknown task '%s'", task->name, task->deps[j]);
+    }
+  }
+
+  self->running = TRUE;
+  schedule (self);
+}
+
+/**
+ * phosh_startup_scheduler_complete:
+ * @self: The startup scheduler
+ * @name: The name of the task
+ *
+ * Mark an asynchronous task as done. Tasks depending on it can then be
+ * run.
+ */
+void
+phosh_startup_scheduler_complete (PhoshStartupScheduler *self, const char *name)
+{
+  PhoshStartupTask *task;
+
+  g_return_if_fail (PHOSH_IS_STARTUP_SCHEDULER (self));
+
+  task = g_hash_table_lookup (self->tasks_by_name, name);
+  g_return_if_fail (task);
+  g_return_if_fail (task->flags & PHOSH_STARTUP_TASK_FLAG_ASYNC);
+  g_return_if_fail (task->state == TASK_STATE_RUNNING);
+
+  task_done (self, task);
+  check_finished (self);
+  schedule (self);
+}
+
+/**
+ * phosh_startup_scheduler_release_deferred:
+ * @self: The startup scheduler
+ *
+ * Allow deferred tasks to run. This can be invoked multiple times.
+ */
+void
+phosh_startup_scheduler_release_deferred (PhoshStartupScheduler *self)
+{
+  g_return_if_fail (PHOSH_IS_STARTUP_SCHEDULER (self));
+
+  if (self->deferred_released)
+    return;
+
+  g_debug ("Releasing deferred tasks");
+  self->deferred_released = TRUE;
+  schedule (self);
+}
+
+/**
+ * phosh_startup_scheduler_is_finished:
+ * @self: The startup scheduler
+ *
+ * Whether all non-deferred tasks are done.
+ *
+ * Returns: %TRUE if the scheduler finished
+ */
+gboolean
+phosh_startup_scheduler_is_finished (PhoshStartupScheduler *self)
+{
+  g_return_val_if_fail (PHOSH_IS_STARTUP_SCHEDULER (self), FALSE);
+
+  return self->finished;
+}
+
+/**
+ * phosh_startup_scheduler_get_critical_path:
+ * @self: The startup scheduler
+ *
+ * Get the critical path, that is the chain of dependencies that ends with the
+ * non-deferred task that finished last. For each task along that chain the dependency
+ * that finished last is picked. Each element holds the task's name
+ * and its start and end time in microseconds of the monotonic clock.
+ *
+ * Returns:(transfer floating): The critical path as `a(sxx)` variant
+ */
+GVariant *
+phosh_startup_scheduler_get_critical_path (PhoshStartupScheduler *self)
+{
+  g_autoptr (GPtrArray) path = g_ptr_array_new ();
+  PhoshStartupTask *last = NULL;
+  GVariantBuilder builder;
+
+  g_return_val_if_fail (PHOSH_IS_STARTUP_SCHEDULER (self), NULL);
+
+  for (guint i = 0; i < self->tasks->len; i++) {
+    PhoshStartupTask *task = g_ptr_array_index (self->tasks, i);
+
+    if (task->flags & PHOSH_STARTUP_TASK_FLAG_DEFERRED || task->state != TASK_STATE_DONE)
+      continue;
+
+    if (last == NULL || task->end > last->end)
+      last = task;
+  }
+
+  for (PhoshStartupTask *task = last; task; ) {
+    g_ptr_array_insert (path, 0, task);
+    task = task->critical_dep ? g_hash_table_lookup (self->tasks_by_name, task->critical_dep) : NULL;
+  }
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(sxx)"));
+  for (guint i = 0; i < path->len; i++) {
+    PhoshStartupTask *task = g_ptr_array_index (path, i);
+
+    g_variant_builder_add (&builder, "(sxx)", task->name, task->start, task->end);
+  }
+
+  return g_variant_builder_end (&builder);
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+/**
+ * PhoshStartupTaskFlags:
+ * @PHOSH_STARTUP_TASK_FLAG_NONE: No flags
+ * @PHOSH_STARTUP_TASK_FLAG_ASYNC: The task is only done once
+ *    `phosh_startup_scheduler_complete()` is invoked for it.
+ * @PHOSH_STARTUP_TASK_FLAG_DEFERRED: The task is not critical for startup and only
+ *    run once `phosh_startup_scheduler_release_deferred()` was invoked.
+ *
+ * Flags that modify how a startup task is run.
+ */
+typedef enum {
+  PHOSH_STARTUP_TASK_FLAG_NONE     = 0,
+  PHOSH_STARTUP_TASK_FLAG_ASYNC    = (1 << 0),
+  PHOSH_STARTUP_TASK_FLAG_DEFERRED = (1 << 1),
+} PhoshStartupTaskFlags;
+
+#define PHOSH_TYPE_STARTUP_SCHEDULER (phosh_startup_scheduler_get_type ())
+
+G_DECLARE_FINAL_TYPE (PhoshStartupScheduler, phosh_startup_scheduler,
+                      PHOSH, STARTUP_SCHEDULER, GObject)
+
+typedef void (*PhoshStartupTaskFunc) (PhoshStartupScheduler *scheduler, gpointer user_data);
+
+PhoshStartupScheduler *phosh_startup_scheduler_new (void);
+void                   phosh_startup_scheduler_add_task (PhoshStartupScheduler *self,
+                                                         const char            *name,
+                                                         const char *const     *deps,
+                                                         PhoshStartupTaskFlags  flags,
+                                                         PhoshStartupTaskFunc   func,
+                                                         gpointer               user_data);
+void                   phosh_startup_scheduler_run (PhoshStartupScheduler *self);
+void                   phosh_startup_scheduler_complete (PhoshStartupScheduler *self,
+                                                         const char            *name);
+void                   phosh_startup_scheduler_release_deferred (PhoshStartupScheduler *self);
+gboolean               phosh_startup_scheduler_is_finished (PhoshStartupScheduler *self);
+GVariant              *phosh_startup_scheduler_get_critical_path (PhoshStartupScheduler *self);
+
+G_END_DECLS
@@ -0,0 +1,15 @@
+/*
+ * Copyright (C) 2025 The Phosh Developers
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "status-icon.h"
+
+G_BEGIN_DECLS
+
+GVariant *phosh_status_icon_get_update_stats (void);
+
+G_END_DECLS
@@ -10,7 +10,8 @@
 
 #include "phosh-config.h"
 
-#include "status-icon.h"
+#include "status-icon-priv.h"
+#include "watchdog.h"
 
 /**
  * PhoshStatusIcon:
@@ -22,6 +23,11 @@
  * If the widget will be used in a [type@QuickSetting] it is
  * recommended (but not required) that derived classes implement a
  * `enabled` property.
+ *
+ * Derived classes that get frequent updates from their data source
+ * should implement the `update` virtual method and call
+ * [method@StatusIcon.queue_update] when their data changes. Updates
+ * are then coalesced to at most one per frame.
  */
 
 enum {
@@ -44,10 +50,20 @@ typedef struct {
   char        *info;
 
   guint       idle_id;
+  guint       update_id;
+  guint       tick_id;
 } PhoshStatusIconPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (PhoshStatusIcon, phosh_status_icon, GTK_TYPE_BIN);
 
+/* Shared across all status icons */
+static struct {
+  guint64 queued;
+  guint64 coalesced;
+  guint64 updates;
+  guint64 unchanged;
+} update_stats;
+
 
 static void
 phosh_status_icon_set_property (GObject      *object,
@@ -127,6 +143,50 @@ on_idle (PhoshStatusIcon *self)
 }
 
 
+static void
+run_update (PhoshStatusIcon *self)
+{
+  PhoshStatusIconClass *klass = PHOSH_STATUS_ICON_GET_CLASS (self);
+  PhoshStatusIconPrivate *priv = phosh_status_icon_get_instance_private (self);
+
+  g_clear_handle_id (&priv->update_id, g_source_remove);
+  if (priv->tick_id) {
+    gtk_widget_remove_tick_callback (GTK_WIDGET (self), priv->tick_id);
+    priv->tick_id = 0;
+  }
+
+  update_stats.updates++;
+  if (klass->update)
+    (*klass->update) (self);
+}
+
+
+static gboolean
+on_update_tick (GtkWidget *widget, GdkFrameClock *frame_clock, gpointer user_data)
+{
+  PhoshStatusIcon *self = PHOSH_STATUS_ICON (widget);
+  PhoshStatusIconPrivate *priv = phosh_status_icon_get_instance_private (self);
+
+  priv->tick_id = 0;
+  run_update (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static gboolean
+on_update_idle (gpointer data)
+{
+  PhoshStatusIcon *self = PHOSH_STATUS_ICON (data);
+  PhoshStatusIconPrivate *priv = phosh_status_icon_get_instance_private (self);
+
+  priv->update_id = 0;
+  run_update (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+
 static void
 phosh_status_icon_constructed (GObject *object)
 {
@@ -137,8 +197,7 @@ phosh_status_icon_constructed (GObject *object)
   G_OBJECT_CLASS (phosh_status_icon_parent_class)->constructed (object);
 
   if (klass->idle_init) {
-    priv->idle_id = g_idle_add ((GSourceFunc) on_idle, self);
-    g_source_set_name_by_id (priv->idle_id, "[PhoshStatusIcon] idle");
+    priv->idle_id = phosh_watchdog_idle_add ((GSourceFunc) on_idle, self, "[PhoshStatusIcon] idle");
   }
 }
 
@@ -150,6 +209,11 @@ phosh_status_icon_dispose (GObject *object)
   PhoshStatusIconPrivate *priv = phosh_status_icon_get_instance_private (self);
 
   g_clear_handle_id (&priv->idle_id, g_source_remove);
+  g_clear_handle_id (&priv->update_id, g_source_remove);
+  if (priv->tick_id) {
+    gtk_widget_remove_tick_callback (GTK_WIDGET (self), priv->tick_id);
+    priv->tick_id = 0;
+  }
 
   G_OBJECT_CLASS (phosh_status_icon_parent_class)->dispose (object);
 }
@@ -177,6 +241,23 @@ phosh_status_icon_destroy (GtkWidget *widget)
   GTK_WIDGET_CLASS (phosh_status_icon_parent_class)->destroy (widget);
 }
 
+static void
+phosh_status_icon_unmap (GtkWidget *widget)
+{
+  PhoshStatusIcon *self = PHOSH_STATUS_ICON (widget);
+  PhoshStatusIconPrivate *priv = phosh_status_icon_get_instance_private (self);
+
+  /* No more frames, make sure a pending update still happens */
+  if (priv->tick_id) {
+    gtk_widget_remove_tick_callback (widget, priv->tick_id);
+    priv->tick_id = 0;
+    priv->update_id = phosh_watchdog_idle_add (on_update_idle, self, "[PhoshStatusIcon] update");
+  }
+
+  GTK_WIDGET_CLASS (phosh_status_icon_parent_class)->unmap (widget);
+}
+
+
 static void
 phosh_status_icon_class_init (PhoshStatusIconClass *klass)
 {
@@ -190,6 +271,7 @@ phosh_status_icon_class_init (PhoshStatusIconClass *klass)
   object_class->finalize = phosh_status_icon_finalize;
 
   widget_class->destroy = phosh_status_icon_destroy;
+  widget_class->unmap = phosh_status_icon_unmap;
 
   gtk_widget_class_set_css_name (widget_class, "phosh-status-icon");
 
@@ -283,8 +365,10 @@ phosh_status_icon_set_icon_name (PhoshStatusIcon *self, const char *icon_name)
   priv = phosh_status_icon_get_instance_private (self);
 
   old_icon_name = phosh_status_icon_get_icon_name (self);
-  if (!g_strcmp0 (old_icon_name, icon_name))
+  if (!g_strcmp0 (old_icon_name, icon_name)) {
+    update_stats.unchanged++;
     return;
+  }
 
   gtk_image_set_from_icon_name (GTK_IMAGE (priv->image), icon_name, -1);
 
@@ -480,11 +564,70 @@ phosh_status_icon_set_info (PhoshStatusIcon *self, const char *info)
 
   priv = phosh_status_icon_get_instance_private (self);
 
-  if (g_strcmp0 (priv->info, info) == 0)
+  if (g_strcmp0 (priv->info, info) == 0) {
+    update_stats.unchanged++;
     return;
+  }
 
   g_clear_pointer (&priv->info, g_free);
   priv->info = g_strdup (info);
 
   g_object_notify_by_pspec (G_OBJECT (self), props[PHOSH_STATUS_ICON_PROP_INFO]);
 }
+
+
+/**
+ * phosh_status_icon_queue_update:
+ * @self: A status icon
+ *
+ * Schedule a call to the `update` virtual method. Multiple requests
+ * are coalesced so the update runs at most once per frame. If the
+ * icon isn't mapped the update runs on idle.
+ */
+void
+phosh_status_icon_queue_update (PhoshStatusIcon *self)
+{
+  PhoshStatusIconPrivate *priv;
+
+  g_return_if_fail (PHOSH_IS_STATUS_ICON (self));
+
+  priv = phosh_status_icon_get_instance_private (self);
+
+  update_stats.queued++;
+  if (priv->tick_id || priv->update_id) {
+    update_stats.coalesced++;
+    return;
+  }
+
+  if (gtk_widget_get_mapped (GTK_WIDGET (self))) {
+    priv->tick_id = gtk_widget_add_tick_callback (GTK_WIDGET (self), on_update_tick, NULL, NULL);
+  } else {
+    priv->update_id = phosh_watchdog_idle_add (on_update_idle, self, "[PhoshStatusIcon] update");
+  }
+}
+
+/**
+ * phosh_status_icon_get_update_stats:
+ *
+ * Get statistics about status icon updates of all icons: The number
+ * of queued updates, the number of queued updates that were merged
+ * into an already pending one, the number of updates run and the
+ * number of icon or info changes dropped as the value didn't change.
+ *
+ * Returns: (transfer floating): The statistics as `a{sv}`
+ */
+GVariant *
+phosh_status_icon_get_update_stats (void)
+{
+  GVariantBuilder builder;
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+  g_variant_builder_add (&builder, "{sv}", "queued", g_variant_new_uint64 (update_stats.queued));
+  g_variant_builder_add (&builder, "{sv}", "coalesced",
+                         g_variant_new_uint64 (update_stats.coalesced));
+  g_variant_builder_add (&builder, "{sv}", "updates", g_variant_new_uint64 (update_stats.updates));
+  g_variant_builder_add (&builder, "{sv}", "unchanged",
+                         g_variant_new_uint64 (update_stats.unchanged));
+
+  return g_variant_builder_end (&builder);
+}
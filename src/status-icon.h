@@ -18,14 +18,16 @@ G_DECLARE_DERIVABLE_TYPE (PhoshStatusIcon, phosh_status_icon, PHOSH, STATUS_ICON
  * PhoshStatusIconClass:
  * @parent_class: The parent class
  * @idle_init: a callback to be invoked once on idle
+ * @update: a callback to update icon and info, invoked at most once per
+ *   frame after [method@StatusIcon.queue_update]
  */
 struct _PhoshStatusIconClass {
   GtkBinClass parent_class;
 
   void        (*idle_init) (PhoshStatusIcon *self);
+  void        (*update)    (PhoshStatusIcon *self);
 
   /* Padding for future expansion */
-  void        (*_phosh_reserved1) (void);
   void        (*_phosh_reserved2) (void);
   void        (*_phosh_reserved3) (void);
   void        (*_phosh_reserved4) (void);
@@ -47,5 +49,6 @@ void phosh_status_icon_set_extra_widget (PhoshStatusIcon *self, GtkWidget *widge
 GtkWidget * phosh_status_icon_get_extra_widget (PhoshStatusIcon *self);
 void phosh_status_icon_set_info (PhoshStatusIcon *self, const char *info);
 char *phosh_status_icon_get_info (PhoshStatusIcon *self);
+void phosh_status_icon_queue_update (PhoshStatusIcon *self);
 
 G_END_DECLS
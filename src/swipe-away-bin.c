@@ -10,6 +10,7 @@
 
 #include "animation.h"
 #include "swipe-away-bin.h"
+#include "watchdog.h"
 #include <handy.h>
 
 enum {
@@ -91,8 +92,7 @@ animation_done_cb (PhoshSwipeAwayBin *self)
   if (ABS (self->progress) < 1)
     return;
 
-  id = g_idle_add ((GSourceFunc) animation_done_idle_cb, self);
-  g_source_set_name_by_id (id, "[SwipeAwayBin] idle");
+  id = phosh_watchdog_idle_add ((GSourceFunc) animation_done_idle_cb, self, "[SwipeAwayBin] idle");
 }
 
 
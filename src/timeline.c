@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#define G_LOG_DOMAIN "phosh-timeline"
+
+#include "phosh-config.h"
+
+#include "timeline.h"
+
+#include <unistd.h>
+
+/**
+ * PhoshTimeline:
+ *
+ * Low overhead recorder for startup spans
+ *
+ * The timeline records spans (a category, a name, a start and an end
+ * time) e.g. for manager construction, manager idle initialization,
+ * the first frame of layer surfaces and plugin loads. This allows to
+ * see what dominates the time to an interactive shell.
+ *
+ * The number of spans is bounded. Once the limit is reached further
+ * spans are dropped and only counted. All functions must be invoked
+ * from the main thread.
+ */
+
+#define PHOSH_TIMELINE_MAX_SPANS 1024
+
+typedef struct {
+  const char *category;
+  char       *name;
+  gint64      start;
+  gint64      end;
+} PhoshTimelineSpan;
+
+static GArray *spans;
+static guint n_dropped;
+
+
+static void
+clear_span (gpointer data)
+{
+  PhoshTimelineSpan *span = data;
+
+  g_free (span->name);
+}
+
+
+static void
+append_json_string (GString *str, const char *value)
+{
+  g_string_append_c (str, '"');
+  for (const char *p = value; *p; p++) {
+    switch (*p) {
+    case '"':
+      g_string_append (str, "\\\"");
+      break;
+    case '\\':
+      g_string_append (str, "\\\\");
+      break;
+    default:
+      if ((guchar)*p < 0x20)
+        g_string_append_printf (str, "\\u%04x", (guchar)*p);
+      else
+        g_string_append_c (str, *p);
+    }
+  }
+  g_string_append_c (str, '"');
+}
+
+/**
+ * phosh_timeline_begin:
+ *
+ * Get the start time of a span.
+ *
+ * Returns: The current monotonic time in microseconds
+ */
+gint64
+phosh_timeline_begin (void)
+{
+  return g_get_monotonic_time ();
+}
+
+/**
+ * phosh_timeline_end:
+ * @start: The start time as returned by `phosh_timeline_begin()`
+ * @category: The category of the span
+ * @name: The name of the span
+ *
+ * Record a span that started at @start and ends now.
+ */
+void
+phosh_timeline_end (gint64 start, const char *category, const char *name)
+{
+  phosh_timeline_add_span (category, name, start, g_get_monotonic_time ());
+}
+
+/**
+ * phosh_timeline_add_span:
+ * @category: (not nullable): The category of the span. Must be a static string.
+ * @name: (not nullable): The name of the span
+ * @start: The start time in microseconds
+ * @end: The end time in microseconds
+ *
+ * Record a span in the timeline.
+ */
+void
+phosh_timeline_add_span (const char *category, const char *name, gint64 start, gint64 end)
+{
+  PhoshTimelineSpan span;
+
+  g_return_if_fail (category);
+  g_return_if_fail (name);
+
+  if (G_UNLIKELY (spans == NULL)) {
+    spans = g_array_sized_new (FALSE, FALSE, sizeof (PhoshTimelineSpan), 64);
+    g_array_set_clear_func (spans, clear_span);
+  }
+
+  if (spans->len >= PHOSH_TIMELINE_MAX_SPANS) {
+    n_dropped++;
+    return;
+  }
+
+  span = (PhoshTimelineSpan) {
+    .category = category,
+    .name = g_strdup (name),
+    .start = start,
+    .end = MAX (start, end),
+  };
+  g_array_append_val (spans, span);
+
+  g_debug ("%s: %s took %" G_GINT64_FORMAT "µs", category, name, span.end - span.start);
+}
+
+/**
+ * phosh_timeline_is_recording:
+ *
+ * Whether further spans will be recorded.
+ *
+ * This can be used to avoid the overhead of measuring spans that
+ * would be dropped anyway.
+ *
+ * Returns: %TRUE if spans are recorded
+ */
+gboolean
+phosh_timeline_is_recording (void)
+{
+  return spans == NULL || spans->len < PHOSH_TIMELINE_MAX_SPANS;
+}
+
+/**
+ * phosh_timeline_get_n_dropped:
+ *
+ * Get the number of spans that were dropped since the timeline was full.
+ *
+ * Returns: The number of dropped spans
+ */
+guint
+phosh_timeline_get_n_dropped (void)
+{
+  return n_dropped;
+}
+
+/**
+ * phosh_timeline_get_spans:
+ *
+ * Get the recorded spans as array of category, name, start and end
+ * time (in microseconds of the monotonic clock).
+ *
+ * Returns:(transfer floating): The spans as `a(ssxx)` variant
+ */
+GVariant *
+phosh_timeline_get_spans (void)
+{
+  GVariantBuilder builder;
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(ssxx)"));
+  for (guint i = 0; spans && i < spans->len; i++) {
+    PhoshTimelineSpan *span = &g_array_index (spans, PhoshTimelineSpan, i);
+
+    g_variant_builder_add (&builder, "(ssxx)", span->category, span->name, span->start, span->end);
+  }
+
+  return g_variant_builder_end (&builder);
+}
+
+/**
+ * phosh_timeline_to_chrome_trace:
+ *
+ * Serialize the recorded spans in the Chrome trace event format so
+ * they can be inspected with e.g. `about:tracing` or Perfetto.
+ *
+ * Returns:(transfer full): The spans as JSON
+ */
+char *
+phosh_timeline_to_chrome_trace (void)
+{
+  GString *str = g_string_new ("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+  int pid = getpid ();
+
+  for (guint i = 0; spans && i < spans->len; i++) {
+    PhoshTimelineSpan *span = &g_array_index (spans, PhoshTimelineSpan, i);
+
+    if (i)
+      g_string_append_c (str, ',');
+
+    g_string_append (str, "{\"name\":");
+    append_json_string (str, span->name);
+    g_string_append (str, ",\"cat\":");
+    append_json_string (str, span->category);
+    g_string_append_printf (str,
+                            ",\"ph\":\"X\",\"ts\":%" G_GINT64_FORMAT
+                            ",\"dur\":%" G_GINT64_FORMAT ",\"pid\":%d,\"tid\":%d}",
+                            span->start,
+                            span->end - span->start,
+                            pid,
+                            pid);
+  }
+  g_string_append (str, "]}");
+
+  return g_string_free (str, FALSE);
+}
+
+/**
+ * phosh_timeline_reset:
+ *
+ * Drop all recorded spans.
+ */
+void
+phosh_timeline_reset (void)
+{
+  g_clear_pointer (&spans, g_array_unref);
+  n_dropped = 0;
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * PHOSH_TIMELINE_SPAN:
+ * @category: The span's category
+ * @name: The span's name
+ * @...: The statement to measure
+ *
+ * Record the time it takes to run the given statement as a span in the
+ * timeline.
+ */
+#define PHOSH_TIMELINE_SPAN(category, name, ...)                 \
+  G_STMT_START {                                                \
+    gint64 _phosh_timeline_start = phosh_timeline_begin ();     \
+    __VA_ARGS__;                                                \
+    phosh_timeline_end (_phosh_timeline_start, category, name); \
+  } G_STMT_END
+
+gint64           phosh_timeline_begin (void);
+void             phosh_timeline_end (gint64 start, const char *category, const char *name);
+void             phosh_timeline_add_span (const char *category,
+                                          const char *name,
+                                          gint64      start,
+                                          gint64      end);
+gboolean         phosh_timeline_is_recording (void);
+guint            phosh_timeline_get_n_dropped (void);
+GVariant        *phosh_timeline_get_spans (void);
+char            *phosh_timeline_to_chrome_trace (void);
+void             phosh_timeline_reset (void);
+
+G_END_DECLS
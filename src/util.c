@@ -38,6 +38,7 @@
 #include <fcntl.h>
 
 #include <math.h>
+#include <string.h>
 
 static gboolean have_gnome_software = -1;
 
@@ -64,56 +65,11 @@ phosh_cp_widget_destroy (void *widget)
 GDesktopAppInfo *
 phosh_get_desktop_app_info_for_app_id (const char *app_id)
 {
-  g_autofree char *desktop_id = NULL;
-  g_autofree char *lowercase = NULL;
-  GDesktopAppInfo *app_info = NULL;
-  char *last_component;
   PhoshAppListModel *model = phosh_app_list_model_get_default ();
 
   g_assert (app_id);
 
-  desktop_id = g_strdup_printf ("%s.desktop", app_id);
-  g_return_val_if_fail (desktop_id, NULL);
-  app_info = g_desktop_app_info_new (desktop_id);
-
-  if (app_info)
-    return app_info;
-
-  app_info = phosh_app_list_model_lookup_by_startup_wm_class (model, app_id);
-  if (app_info)
-    return g_object_ref (app_info);
-
-  app_info = phosh_app_list_model_lookup_by_exec (model, app_id);
-  if (app_info)
-    return g_object_ref (app_info);
-
-  /* try to handle the case where app-id is rev-DNS, but desktop file is not */
-  last_component = strrchr (app_id, '.');
-  if (last_component) {
-    /* Skip past '.' */
-    last_component++;
-    g_free (desktop_id);
-    desktop_id = g_strdup_printf ("%s.desktop", last_component);
-    g_return_val_if_fail (desktop_id, NULL);
-    app_info = g_desktop_app_info_new (desktop_id);
-    if (app_info)
-      return app_info;
-  }
-
-  /* X11 WM_CLASS is often capitalized, so try in lowercase as well */
-  lowercase = g_utf8_strdown (last_component ?: app_id, -1);
-  g_clear_pointer (&desktop_id, g_free);
-
-  app_info = phosh_app_list_model_lookup_by_startup_wm_class (model, lowercase);
-  if (app_info)
-    return g_object_ref (app_info);
-
-  app_info = phosh_app_list_model_lookup_by_exec (model, lowercase);
-  if (app_info)
-    return g_object_ref (app_info);
-
-  g_message ("Could not find application for app-id '%s'", app_id);
-  return NULL;
+  return phosh_app_list_model_lookup_by_app_id (model, app_id);
 }
 
 /**
@@ -379,63 +335,67 @@ phosh_create_shm_file (off_t size)
 char *
 phosh_util_escape_markup (const char *markup, gboolean allow_markup)
 {
-  if (allow_markup) {
-    g_autoptr (GError) err = NULL;
-    g_autoptr (GRegex) amp_re = NULL;
-    g_autoptr (GRegex) elem_re = NULL;
-    g_autofree char *amp_esc = NULL;
-    g_autofree char *escaped = NULL;
-
-    /* Escape &whatever; */
-    /* Support &amp;, &quot;, &apos;, &lt; and &gt;, escape all other occurrences of '&'. */
-    amp_re = g_regex_new ("&(?!amp;|quot;|apos;|lt;|gt;)",
-                          G_REGEX_DEFAULT,
-                          0,
-                          &err);
-    if (!amp_re) {
-      g_warning ("Failed to compile regex: %s", err->message);
-      goto out;
-    }
+  static const char * const entities[] = { "amp;", "quot;", "apos;", "lt;", "gt;" };
+  g_autoptr (GString) escaped = NULL;
+  g_autoptr (GString) open = NULL;
+  const char *p;
+
+  if (!allow_markup)
+    goto out;
+
+  if (!g_utf8_validate (markup, -1, NULL))
+    goto out;
+
+  /*
+   * Support &amp;, &quot;, &apos;, &lt; and &gt;, escape all other
+   * occurrences of '&'. Support <b>, <i>, and <u>, escape any other '<'
+   * so it displays as raw markup.
+   * https://specifications.freedesktop.org/notification-spec/latest/ar01s04.html
+   */
+  escaped = g_string_sized_new (strlen (markup) + 16);
+  /* Open <b>, <i> and <u> tags, innermost last */
+  open = g_string_new (NULL);
+  for (p = markup; *p; p++) {
+    if (*p == '&') {
+      gboolean known = FALSE;
+
+      for (int i = 0; i < G_N_ELEMENTS (entities); i++) {
+        if (strncmp (p + 1, entities[i], strlen (entities[i])) == 0) {
+          known = TRUE;
+          break;
+        }
+      }
+      g_string_append (escaped, known ? "&" : "&amp;");
+    } else if (*p == '<') {
+      gboolean closing = p[1] == '/';
+      const char *tag = closing ? p + 2 : p + 1;
 
-    amp_esc = g_regex_replace_literal (amp_re,
-                                       markup, -1, 0,
-                                       "&amp;",
-                                       0, /* flags */
-                                       &err);
-    if (err) {
-      g_warning ("Failed to escape string: %s", err->message);
-      goto out;
-    }
+      if ((tag[0] != 'b' && tag[0] != 'i' && tag[0] != 'u') || tag[1] != '>') {
+        g_string_append (escaped, "&lt;");
+        continue;
+      }
 
-    /*
-     * "HTML" element escape
-     * Support <b>, <i>, and <u>, escape anything else
-     * so it displays as raw markup.
-     * https://specifications.freedesktop.org/notification-spec/latest/ar01s04.html
-     */
-    elem_re = g_regex_new ("<(?!/?[biu]>)",
-                           G_REGEX_DEFAULT,
-                           0,
-                           &err);
-    if (!elem_re) {
-      g_warning ("Failed to compile regex: %s", err->message);
-      goto out;
-    }
+      /* Unbalanced markup, escape everything */
+      if (closing) {
+        if (open->len == 0 || open->str[open->len - 1] != tag[0])
+          goto out;
+        g_string_truncate (open, open->len - 1);
+      } else {
+        g_string_append_c (open, tag[0]);
+      }
+      g_string_append_len (escaped, p, tag + 2 - p);
+      p = tag + 1;
+    } else {
+      gsize len = strcspn (p, "&<");
 
-    escaped = g_regex_replace_literal (elem_re,
-                                       amp_esc, -1, 0,
-                                       "&lt;",
-                                       0, /* flags */
-                                       &err);
-    if (err) {
-      g_warning ("Failed to escape string: %s", err->message);
-      goto out;
+      g_string_append_len (escaped, p, len);
+      p += len - 1;
     }
-
-    if (pango_parse_markup(escaped, -1, 0, NULL, NULL, NULL, NULL))
-      return g_steal_pointer (&escaped);
   }
 
+  if (open->len == 0)
+    return g_string_free (g_steal_pointer (&escaped), FALSE);
+
  out:
   /*invalid markup or no markup allowed */
   return g_markup_escape_text (markup, -1);
@@ -0,0 +1,666 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#define G_LOG_DOMAIN "phosh-watchdog"
+
+#include "phosh-config.h"
+
+#include "watchdog.h"
+
+#include <string.h>
+
+/**
+ * PhoshWatchdog:
+ *
+ * Opt-in main loop stall detector
+ *
+ * The watchdog measures how long each iteration of the default main
+ * context spends outside of `poll()`, that is dispatching sources and
+ * running their callbacks. Iterations taking longer than the
+ * threshold are logged as stalls. Additionally the intervals between
+ * frames of tracked frame clocks (usually one per layer surface) are
+ * recorded so dropped frames can be attributed to a surface.
+ *
+ * GLib doesn't allow to time individual source dispatches of
+ * arbitrary sources. Sources added via [func@Phosh.watchdog_timeout_add],
+ * [func@Phosh.watchdog_idle_add] and friends are hence timed by
+ * wrapping their callback. Dispatch durations are recorded per source
+ * name and a stall is attributed to the slowest of these sources
+ * dispatched in that iteration.
+ *
+ * All functions must be invoked from the main thread.
+ */
+
+#define N_BUCKETS 12
+#define MAX_RECENT_STALLS 16
+/* Larger gaps mean the surface was idle rather than dropping frames */
+#define MAX_FRAME_INTERVAL (G_USEC_PER_SEC)
+
+static const gint64 bucket_limits[N_BUCKETS] = {
+  1000, 2000, 4000, 8000, 16000, 33000, 66000, 133000, 266000, 533000, 1066000, G_MAXINT64
+};
+
+typedef struct {
+  guint64 counts[N_BUCKETS];
+  guint64 n;
+  gint64  max;
+} PhoshWatchdogHistogram;
+
+typedef struct {
+  gint64      when;
+  gint64      duration;
+  const char *source; /* interned */
+} PhoshWatchdogStall;
+
+typedef struct {
+  GSourceFunc     func;
+  GSourceOnceFunc once_func;
+  gpointer        data;
+  GDestroyNotify  notify;
+  const char     *name; /* interned */
+} PhoshWatchdogTimedCallback;
+
+typedef struct {
+  GdkFrameClock *frame_clock;
+  char          *name;
+  gulong         after_paint_id;
+  gint64         last;
+} PhoshWatchdogFrameTracker;
+
+static gboolean running;
+static guint threshold;
+static GPollFunc orig_poll_func;
+static gint64 poll_exit;
+static guint64 n_stalls;
+static PhoshWatchdogHistogram dispatch_histogram;
+static PhoshWatchdogStall recent_stalls[MAX_RECENT_STALLS];
+static guint recent_stalls_pos;
+/* name → PhoshWatchdogHistogram */
+static GHashTable *frame_histograms;
+static GPtrArray *frame_trackers;
+/* source name → PhoshWatchdogHistogram */
+static GHashTable *source_histograms;
+/* The slowest timed source of the current iteration */
+static const char *slowest_source;
+static gint64 slowest_source_duration;
+
+
+static void
+histogram_add (PhoshWatchdogHistogram *histogram, gint64 value)
+{
+  for (int i = 0; i < N_BUCKETS; i++) {
+    if (value <= bucket_limits[i]) {
+      histogram->counts[i]++;
+      break;
+    }
+  }
+  histogram->n++;
+  histogram->max = MAX (histogram->max, value);
+}
+
+
+static GVariant *
+histogram_to_variant (PhoshWatchdogHistogram *histogram)
+{
+  GVariantBuilder builder;
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(xt)"));
+  for (int i = 0; i < N_BUCKETS; i++)
+    g_variant_builder_add (&builder, "(xt)", bucket_limits[i], histogram->counts[i]);
+
+  return g_variant_builder_end (&builder);
+}
+
+
+static void
+record_dispatch (gint64 duration)
+{
+  GSource *source;
+  PhoshWatchdogStall *stall;
+  const char *culprit = NULL;
+
+  histogram_add (&dispatch_histogram, duration);
+
+  if (threshold == 0 || duration < (gint64)threshold * 1000)
+    return;
+
+  /* Only blame a timed source if it accounts for most of the iteration */
+  if (slowest_source && slowest_source_duration * 2 >= duration)
+    culprit = slowest_source;
+
+  n_stalls++;
+  stall = &recent_stalls[recent_stalls_pos];
+  stall->when = poll_exit;
+  stall->duration = duration;
+  stall->source = culprit;
+  recent_stalls_pos = (recent_stalls_pos + 1) % MAX_RECENT_STALLS;
+
+  if (culprit) {
+    g_message ("Main loop stalled for %.1f ms ('%s' took %.1f ms)", duration / 1000.0,
+               culprit, slowest_source_duration / 1000.0);
+    return;
+  }
+
+  /* Only set when polling from a nested main loop */
+  source = g_main_current_source ();
+  if (source && g_source_get_name (source)) {
+    g_message ("Main loop stalled for %.1f ms (in '%s')", duration / 1000.0,
+               g_source_get_name (source));
+  } else {
+    g_message ("Main loop stalled for %.1f ms", duration / 1000.0);
+  }
+}
+
+
+static int
+watchdog_poll (GPollFD *ufds, guint nfds, int timeout)
+{
+  int ret;
+
+  if (poll_exit)
+    record_dispatch (g_get_monotonic_time () - poll_exit);
+  slowest_source = NULL;
+  slowest_source_duration = 0;
+
+  ret = orig_poll_func (ufds, nfds, timeout);
+  poll_exit = g_get_monotonic_time ();
+
+  return ret;
+}
+
+
+static void
+record_source_dispatch (const char *name, gint64 duration)
+{
+  PhoshWatchdogHistogram *histogram;
+
+  if (source_histograms == NULL)
+    source_histograms = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+  histogram = g_hash_table_lookup (source_histograms, name);
+  if (histogram == NULL) {
+    histogram = g_new0 (PhoshWatchdogHistogram, 1);
+    g_hash_table_insert (source_histograms, g_strdup (name), histogram);
+  }
+  histogram_add (histogram, duration);
+
+  if (duration > slowest_source_duration) {
+    slowest_source = name;
+    slowest_source_duration = duration;
+  }
+}
+
+
+static gboolean
+invoke_timed_callback (PhoshWatchdogTimedCallback *cb)
+{
+  if (cb->func)
+    return cb->func (cb->data);
+
+  cb->once_func (cb->data);
+  return G_SOURCE_REMOVE;
+}
+
+
+static gboolean
+on_timed_dispatch (gpointer user_data)
+{
+  PhoshWatchdogTimedCallback *cb = user_data;
+  gboolean ret;
+  gint64 start;
+
+  if (!running)
+    return invoke_timed_callback (cb);
+
+  start = g_get_monotonic_time ();
+  ret = invoke_timed_callback (cb);
+  /* The callback might have stopped the watchdog */
+  if (running)
+    record_source_dispatch (cb->name, g_get_monotonic_time () - start);
+
+  return ret;
+}
+
+
+static void
+timed_callback_free (PhoshWatchdogTimedCallback *cb)
+{
+  if (cb->notify)
+    cb->notify (cb->data);
+  g_free (cb);
+}
+
+
+static guint
+attach_timed_source (GSource         *source,
+                     int              priority,
+                     GSourceFunc      func,
+                     GSourceOnceFunc  once_func,
+                     gpointer         data,
+                     GDestroyNotify   notify,
+                     const char      *name)
+{
+  PhoshWatchdogTimedCallback *cb = g_new0 (PhoshWatchdogTimedCallback, 1);
+  guint id;
+
+  cb->func = func;
+  cb->once_func = once_func;
+  cb->data = data;
+  cb->notify = notify;
+  cb->name = g_intern_string (name);
+
+  g_source_set_priority (source, priority);
+  g_source_set_callback (source, on_timed_dispatch, cb, (GDestroyNotify)timed_callback_free);
+  g_source_set_static_name (source, cb->name);
+  id = g_source_attach (source, NULL);
+  g_source_unref (source);
+
+  return id;
+}
+
+
+static void
+frame_tracker_free (PhoshWatchdogFrameTracker *tracker)
+{
+  if (tracker->frame_clock) {
+    g_clear_signal_handler (&tracker->after_paint_id, tracker->frame_clock);
+    g_clear_weak_pointer (&tracker->frame_clock);
+  }
+  g_free (tracker->name);
+  g_free (tracker);
+}
+
+
+static void
+on_after_paint (GdkFrameClock *frame_clock, PhoshWatchdogFrameTracker *tracker)
+{
+  PhoshWatchdogHistogram *histogram;
+  gint64 now = gdk_frame_clock_get_frame_time (frame_clock);
+  gint64 interval = now - tracker->last;
+
+  if (tracker->last == 0 || interval > MAX_FRAME_INTERVAL) {
+    tracker->last = now;
+    return;
+  }
+  tracker->last = now;
+
+  histogram = g_hash_table_lookup (frame_histograms, tracker->name);
+  if (histogram == NULL) {
+    histogram = g_new0 (PhoshWatchdogHistogram, 1);
+    g_hash_table_insert (frame_histograms, g_strdup (tracker->name), histogram);
+  }
+  histogram_add (histogram, interval);
+}
+
+/**
+ * phosh_watchdog_start:
+ * @threshold_ms: Main loop iterations taking longer are logged. `0` disables logging.
+ *
+ * Start measuring main loop iterations. If the watchdog is already
+ * running only the threshold is updated.
+ */
+void
+phosh_watchdog_start (guint threshold_ms)
+{
+  GMainContext *context = g_main_context_default ();
+
+  threshold = threshold_ms;
+  if (running)
+    return;
+
+  if (frame_histograms == NULL)
+    frame_histograms = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+  if (frame_trackers == NULL)
+    frame_trackers = g_ptr_array_new_with_free_func ((GDestroyNotify)frame_tracker_free);
+
+  orig_poll_func = g_main_context_get_poll_func (context);
+  g_main_context_set_poll_func (context, watchdog_poll);
+  poll_exit = 0;
+  running = TRUE;
+
+  g_debug ("Watchdog started, threshold %u ms", threshold);
+}
+
+/**
+ * phosh_watchdog_stop:
+ *
+ * Stop measuring. Gathered statistics are kept until
+ * [func@Phosh.watchdog_reset] is invoked.
+ */
+void
+phosh_watchdog_stop (void)
+{
+  if (!running)
+    return;
+
+  g_main_context_set_poll_func (g_main_context_default (), orig_poll_func);
+  orig_poll_func = NULL;
+  g_clear_pointer (&frame_trackers, g_ptr_array_unref);
+  running = FALSE;
+
+  g_debug ("Watchdog stopped");
+}
+
+
+gboolean
+phosh_watchdog_is_running (void)
+{
+  return running;
+}
+
+
+guint
+phosh_watchdog_get_threshold (void)
+{
+  return running ? threshold : 0;
+}
+
+/**
+ * phosh_watchdog_track_frame_clock:
+ * @frame_clock: The frame clock to track
+ * @name: The name to account frame intervals to
+ *
+ * Record intervals between frames of the given frame clock. Does
+ * nothing if the watchdog isn't running. Tracking stops when the
+ * frame clock is finalized.
+ */
+void
+phosh_watchdog_track_frame_clock (GdkFrameClock *frame_clock, const char *name)
+{
+  PhoshWatchdogFrameTracker *tracker;
+
+  g_return_if_fail (GDK_IS_FRAME_CLOCK (frame_clock));
+  g_return_if_fail (name);
+
+  if (!running)
+    return;
+
+  /* Drop trackers of finalized clocks, skip already tracked ones */
+  for (int i = frame_trackers->len - 1; i >= 0; i--) {
+    tracker = g_ptr_array_index (frame_trackers, i);
+
+    if (tracker->frame_clock == NULL) {
+      g_ptr_array_remove_index_fast (frame_trackers, i);
+    } else if (tracker->frame_clock == frame_clock) {
+      g_free (tracker->name);
+      tracker->name = g_strdup (name);
+      return;
+    }
+  }
+
+  tracker = g_new0 (PhoshWatchdogFrameTracker, 1);
+  tracker->name = g_strdup (name);
+  g_set_weak_pointer (&tracker->frame_clock, frame_clock);
+  tracker->after_paint_id = g_signal_connect (frame_clock, "after-paint",
+                                              G_CALLBACK (on_after_paint), tracker);
+  g_ptr_array_add (frame_trackers, tracker);
+}
+
+/**
+ * phosh_watchdog_timeout_add_full:
+ * @priority: The priority of the source
+ * @interval: The timeout interval in milliseconds
+ * @func: The function to call
+ * @data: The data to pass to @func
+ * @notify: (nullable): Function to call when the source is removed
+ * @name: The source's name
+ *
+ * Like `g_timeout_add_full()` but additionally sets the source's name
+ * and records the duration of each dispatch while the watchdog is
+ * running.
+ *
+ * Returns: The ID of the source
+ */
+guint
+phosh_watchdog_timeout_add_full (int            priority,
+                                 guint          interval,
+                                 GSourceFunc    func,
+                                 gpointer       data,
+                                 GDestroyNotify notify,
+                                 const char    *name)
+{
+  g_return_val_if_fail (func, 0);
+  g_return_val_if_fail (name, 0);
+
+  return attach_timed_source (g_timeout_source_new (interval), priority, func, NULL, data, notify,
+                              name);
+}
+
+/**
+ * phosh_watchdog_timeout_add:
+ * @interval: The timeout interval in milliseconds
+ * @func: The function to call
+ * @data: The data to pass to @func
+ * @name: The source's name
+ *
+ * Like `g_timeout_add()` but the dispatch duration is recorded. See
+ * [func@Phosh.watchdog_timeout_add_full].
+ *
+ * Returns: The ID of the source
+ */
+guint
+phosh_watchdog_timeout_add (guint interval, GSourceFunc func, gpointer data, const char *name)
+{
+  return phosh_watchdog_timeout_add_full (G_PRIORITY_DEFAULT, interval, func, data, NULL, name);
+}
+
+/**
+ * phosh_watchdog_timeout_add_seconds:
+ * @interval: The timeout interval in seconds
+ * @func: The function to call
+ * @data: The data to pass to @func
+ * @name: The source's name
+ *
+ * Like `g_timeout_add_seconds()` but the dispatch duration is
+ * recorded. See [func@Phosh.watchdog_timeout_add_full].
+ *
+ * Returns: The ID of the source
+ */
+guint
+phosh_watchdog_timeout_add_seconds (guint interval, GSourceFunc func, gpointer data,
+                                    const char *name)
+{
+  g_return_val_if_fail (func, 0);
+  g_return_val_if_fail (name, 0);
+
+  return attach_timed_source (g_timeout_source_new_seconds (interval), G_PRIORITY_DEFAULT,
+                              func, NULL, data, NULL, name);
+}
+
+/**
+ * phosh_watchdog_timeout_add_once:
+ * @interval: The timeout interval in milliseconds
+ * @func: The function to call
+ * @data: The data to pass to @func
+ * @name: The source's name
+ *
+ * Like `g_timeout_add_once()` but the dispatch duration is recorded.
+ * See [func@Phosh.watchdog_timeout_add_full].
+ *
+ * Returns: The ID of the source
+ */
+guint
+phosh_watchdog_timeout_add_once (guint interval, GSourceOnceFunc func, gpointer data,
+                                 const char *name)
+{
+  g_return_val_if_fail (func, 0);
+  g_return_val_if_fail (name, 0);
+
+  return attach_timed_source (g_timeout_source_new (interval), G_PRIORITY_DEFAULT,
+                              NULL, func, data, NULL, name);
+}
+
+/**
+ * phosh_watchdog_timeout_add_seconds_once:
+ * @interval: The timeout interval in seconds
+ * @func: The function to call
+ * @data: The data to pass to @func
+ * @name: The source's name
+ *
+ * Like `g_timeout_add_seconds_once()` but the dispatch duration is
+ * recorded. See [func@Phosh.watchdog_timeout_add_full].
+ *
+ * Returns: The ID of the source
+ */
+guint
+phosh_watchdog_timeout_add_seconds_once (guint interval, GSourceOnceFunc func, gpointer data,
+                                         const char *name)
+{
+  g_return_val_if_fail (func, 0);
+  g_return_val_if_fail (name, 0);
+
+  return attach_timed_source (g_timeout_source_new_seconds (interval), G_PRIORITY_DEFAULT,
+                              NULL, func, data, NULL, name);
+}
+
+/**
+ * phosh_watchdog_idle_add_full:
+ * @priority: The priority of the source
+ * @func: The function to call
+ * @data: The data to pass to @func
+ * @notify: (nullable): Function to call when the source is removed
+ * @name: The source's name
+ *
+ * Like `g_idle_add_full()` but the dispatch duration is recorded. See
+ * [func@Phosh.watchdog_timeout_add_full].
+ *
+ * Returns: The ID of the source
+ */
+guint
+phosh_watchdog_idle_add_full (int            priority,
+                              GSourceFunc    func,
+                              gpointer       data,
+                              GDestroyNotify notify,
+                              const char    *name)
+{
+  g_return_val_if_fail (func, 0);
+  g_return_val_if_fail (name, 0);
+
+  return attach_timed_source (g_idle_source_new (), priority, func, NULL, data, notify, name);
+}
+
+/**
+ * phosh_watchdog_idle_add:
+ * @func: The function to call
+ * @data: The data to pass to @func
+ * @name: The source's name
+ *
+ * Like `g_idle_add()` but the dispatch duration is recorded. See
+ * [func@Phosh.watchdog_timeout_add_full].
+ *
+ * Returns: The ID of the source
+ */
+guint
+phosh_watchdog_idle_add (GSourceFunc func, gpointer data, const char *name)
+{
+  return phosh_watchdog_idle_add_full (G_PRIORITY_DEFAULT_IDLE, func, data, NULL, name);
+}
+
+/**
+ * phosh_watchdog_idle_add_once:
+ * @func: The function to call
+ * @data: The data to pass to @func
+ * @name: The source's name
+ *
+ * Like `g_idle_add_once()` but the dispatch duration is recorded. See
+ * [func@Phosh.watchdog_timeout_add_full].
+ *
+ * Returns: The ID of the source
+ */
+guint
+phosh_watchdog_idle_add_once (GSourceOnceFunc func, gpointer data, const char *name)
+{
+  g_return_val_if_fail (func, 0);
+  g_return_val_if_fail (name, 0);
+
+  return attach_timed_source (g_idle_source_new (), G_PRIORITY_DEFAULT_IDLE,
+                              NULL, func, data, NULL, name);
+}
+
+/**
+ * phosh_watchdog_get_stats:
+ *
+ * Get the gathered statistics. Durations are in microseconds,
+ * histograms are arrays of inclusive bucket upper bounds and counts.
+ * Recent stalls carry the name of the slowest timed source dispatched
+ * in that iteration (or an empty string if unknown).
+ *
+ * Returns: (transfer floating): The statistics as `a{sv}`
+ */
+GVariant *
+phosh_watchdog_get_stats (void)
+{
+  GVariantBuilder builder, stalls, frames, sources;
+  GHashTableIter iter;
+  gpointer key, value;
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+
+  g_variant_builder_add (&builder, "{sv}", "running", g_variant_new_boolean (running));
+  g_variant_builder_add (&builder, "{sv}", "threshold",
+                         g_variant_new_uint32 (phosh_watchdog_get_threshold ()));
+  g_variant_builder_add (&builder, "{sv}", "iterations",
+                         g_variant_new_uint64 (dispatch_histogram.n));
+  g_variant_builder_add (&builder, "{sv}", "stalls", g_variant_new_uint64 (n_stalls));
+  g_variant_builder_add (&builder, "{sv}", "max-dispatch",
+                         g_variant_new_int64 (dispatch_histogram.max));
+  g_variant_builder_add (&builder, "{sv}", "dispatch-histogram",
+                         histogram_to_variant (&dispatch_histogram));
+
+  g_variant_builder_init (&stalls, G_VARIANT_TYPE ("a(xxs)"));
+  for (int i = 0; i < MAX_RECENT_STALLS; i++) {
+    PhoshWatchdogStall *stall;
+
+    /* Oldest first */
+    stall = &recent_stalls[(recent_stalls_pos + i) % MAX_RECENT_STALLS];
+    if (stall->duration == 0)
+      continue;
+
+    g_variant_builder_add (&stalls, "(xxs)", stall->when, stall->duration,
+                           stall->source ?: "");
+  }
+  g_variant_builder_add (&builder, "{sv}", "recent-stalls", g_variant_builder_end (&stalls));
+
+  g_variant_builder_init (&frames, G_VARIANT_TYPE ("a{sa(xt)}"));
+  if (frame_histograms) {
+    g_hash_table_iter_init (&iter, frame_histograms);
+    while (g_hash_table_iter_next (&iter, &key, &value))
+      g_variant_builder_add (&frames, "{s@a(xt)}", key, histogram_to_variant (value));
+  }
+  g_variant_builder_add (&builder, "{sv}", "frame-intervals", g_variant_builder_end (&frames));
+
+  g_variant_builder_init (&sources, G_VARIANT_TYPE ("a{sa(xt)}"));
+  if (source_histograms) {
+    g_hash_table_iter_init (&iter, source_histograms);
+    while (g_hash_table_iter_next (&iter, &key, &value))
+      g_variant_builder_add (&sources, "{s@a(xt)}", key, histogram_to_variant (value));
+  }
+  g_variant_builder_add (&builder, "{sv}", "source-dispatch", g_variant_builder_end (&sources));
+
+  return g_variant_builder_end (&builder);
+}
+
+/**
+ * phosh_watchdog_reset:
+ *
+ * Clear the gathered statistics.
+ */
+void
+phosh_watchdog_reset (void)
+{
+  memset (&dispatch_histogram, 0, sizeof (dispatch_histogram));
+  memset (recent_stalls, 0, sizeof (recent_stalls));
+  recent_stalls_pos = 0;
+  n_stalls = 0;
+  poll_exit = 0;
+  slowest_source = NULL;
+  slowest_source_duration = 0;
+
+  if (frame_histograms)
+    g_hash_table_remove_all (frame_histograms);
+  if (source_histograms)
+    g_hash_table_remove_all (source_histograms);
+}
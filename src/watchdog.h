@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <gdk/gdk.h>
+
+G_BEGIN_DECLS
+
+#define PHOSH_WATCHDOG_DEFAULT_THRESHOLD 50
+
+void             phosh_watchdog_start (guint threshold_ms);
+void             phosh_watchdog_stop (void);
+gboolean         phosh_watchdog_is_running (void);
+guint            phosh_watchdog_get_threshold (void);
+guint            phosh_watchdog_timeout_add_full (int            priority,
+                                                  guint          interval,
+                                                  GSourceFunc    func,
+                                                  gpointer       data,
+                                                  GDestroyNotify notify,
+                                                  const char    *name);
+guint            phosh_watchdog_timeout_add (guint       interval,
+                                             GSourceFunc func,
+                                             gpointer    data,
+                                             const char *name);
+guint            phosh_watchdog_timeout_add_seconds (guint       interval,
+                                                     GSourceFunc func,
+                                                     gpointer    data,
+                                                     const char *name);
+guint            phosh_watchdog_timeout_add_once (guint           interval,
+                                                  GSourceOnceFunc func,
+                                                  gpointer        data,
+                                                  const char     *name);
+guint            phosh_watchdog_timeout_add_seconds_once (guint           interval,
+                                                          GSourceOnceFunc func,
+                                                          gpointer        data,
+                                                          const char     *name);
+guint            phosh_watchdog_idle_add_full (int            priority,
+                                               GSourceFunc    func,
+                                               gpointer       data,
+                                               GDestroyNotify notify,
+                                               const char    *name);
+guint            phosh_watchdog_idle_add (GSourceFunc func, gpointer data, const char *name);
+guint            phosh_watchdog_idle_add_once (GSourceOnceFunc func, gpointer data, const char *name);
+void             phosh_watchdog_track_frame_clock (GdkFrameClock *frame_clock, const char *name);
+GVariant        *phosh_watchdog_get_stats (void);
+void             phosh_watchdog_reset (void);
+
+G_END_DECLS
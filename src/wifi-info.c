@@ -64,15 +64,15 @@ phosh_wifi_info_get_property (GObject    *object,
 }
 
 static void
-update_icon (PhoshWifiInfo *self, GParamSpec *pspec, PhoshWifiManager *wifi)
+update_icon (PhoshWifiInfo *self)
 {
   const char *icon_name;
 
   g_debug ("Updating Wi-Fi icon");
   g_return_if_fail (PHOSH_IS_WIFI_INFO (self));
-  g_return_if_fail (PHOSH_IS_WIFI_MANAGER (wifi));
+  g_return_if_fail (PHOSH_IS_WIFI_MANAGER (self->wifi));
 
-  icon_name = phosh_wifi_manager_get_icon_name (wifi);
+  icon_name = phosh_wifi_manager_get_icon_name (self->wifi);
   if (icon_name)
     phosh_status_icon_set_icon_name (PHOSH_STATUS_ICON (self), icon_name);
 }
@@ -129,12 +129,19 @@ phosh_wifi_info_idle_init (PhoshStatusIcon *icon)
 {
   PhoshWifiInfo *self = PHOSH_WIFI_INFO (icon);
 
-  update_icon (self, NULL, self->wifi);
+  update_icon (self);
   update_info (self);
   on_wifi_enabled (self, NULL, self->wifi);
 }
 
 
+static void
+phosh_wifi_info_update (PhoshStatusIcon *icon)
+{
+  update_icon (PHOSH_WIFI_INFO (icon));
+}
+
+
 static void
 phosh_wifi_info_constructed (GObject *object)
 {
@@ -153,7 +160,7 @@ phosh_wifi_info_constructed (GObject *object)
 
   g_signal_connect_swapped (self->wifi,
                             "notify::icon-name",
-                            G_CALLBACK (update_icon),
+                            G_CALLBACK (phosh_status_icon_queue_update),
                             self);
 
   g_signal_connect_swapped (self->wifi,
@@ -202,6 +209,7 @@ phosh_wifi_info_class_init (PhoshWifiInfoClass *klass)
   object_class->get_property = phosh_wifi_info_get_property;
 
   status_icon_class->idle_init = phosh_wifi_info_idle_init;
+  status_icon_class->update = phosh_wifi_info_update;
 
   gtk_widget_class_set_css_name (widget_class, "phosh-wifi-info");
 
@@ -9,8 +9,10 @@
 
 #include "phosh-config.h"
 
+#include "shell-priv.h"
 #include "wifi-manager.h"
 #include "util.h"
+#include "watchdog.h"
 
 #include <NetworkManager.h>
 
@@ -569,8 +571,32 @@ on_request_scan (GObject *object, GAsyncResult *result, gpointer data)
   if (self->scanning_id)
     return;
 
-  self->scanning_id = g_timeout_add (2000, check_scanning, self);
   set_scanning (self, TRUE);
+  if (phosh_shell_get_blanked (phosh_shell_get_default ()))
+    return;
+
+  self->scanning_id = phosh_watchdog_timeout_add (2000, check_scanning, self,
+                                                  "[phosh] wifi check scanning");
+}
+
+
+static void
+on_shell_blanked_changed (PhoshWifiManager *self, GParamSpec *pspec, PhoshShell *shell)
+{
+  if (phosh_shell_get_blanked (shell)) {
+    /* Nobody sees the scan indicator, check once we're unblanked */
+    g_clear_handle_id (&self->scanning_id, g_source_remove);
+    return;
+  }
+
+  if (!self->scanning || self->scanning_id)
+    return;
+
+  if (check_scanning (self) == G_SOURCE_REMOVE)
+    return;
+
+  self->scanning_id = phosh_watchdog_timeout_add (2000, check_scanning, self,
+                                                  "[phosh] wifi check scanning");
 }
 
 
@@ -737,7 +763,8 @@ on_nm_access_point_strength_changed (PhoshWifiManager *self, GParamSpec *pspec,
   strength = phosh_wifi_manager_get_strength (self);
   g_debug ("Strength changed: %d", strength);
 
-  update_properties (self);
+  /* Only the icon depends on the strength */
+  update_icon_name (self);
 }
 
 
@@ -1066,6 +1093,12 @@ phosh_wifi_manager_constructed (GObject *object)
   self->cancel = g_cancellable_new ();
   nm_client_new_async (self->cancel, on_nm_client_ready, self);
 
+  g_signal_connect_object (phosh_shell_get_default (),
+                           "notify::blanked",
+                           G_CALLBACK (on_shell_blanked_changed),
+                           self,
+                           G_CONNECT_SWAPPED);
+
   G_OBJECT_CLASS (phosh_wifi_manager_parent_class)->constructed (object);
 }
 
@@ -136,40 +136,28 @@ signal_quality_icon_name (guint quality, gboolean data_enabled)
 
 
 static void
-update_icon_data(PhoshWWanInfo *self, GParamSpec *psepc, PhoshWWan *wwan)
+update_icon_data (PhoshWWanInfo *self)
 {
   GtkWidget *access_tec_widget;
   guint quality;
   const char *icon_name = NULL;
   const char *access_tec;
-  gboolean present, enabled, data_enabled;
+  gboolean data_enabled;
 
   g_return_if_fail (PHOSH_IS_WWAN_INFO (self));
-  present = phosh_wwan_is_present (self->wwan);
-  g_debug ("Updating wwan present: %d", present);
-  if (present != self->present) {
-    self->present = present;
-    g_object_notify_by_pspec (G_OBJECT (self), props[PROP_PRESENT]);
-  }
 
   access_tec_widget = phosh_status_icon_get_extra_widget (PHOSH_STATUS_ICON (self));
 
-  enabled = phosh_wwan_is_enabled (self->wwan);
-  if (!present) {
+  if (!self->present) {
     icon_name = "network-cellular-disabled-symbolic";
   } else if (!phosh_wwan_has_sim (self->wwan)) {
     icon_name = "auth-sim-missing-symbolic";
   } else if (!phosh_wwan_is_unlocked (self->wwan)) {
       icon_name = "auth-sim-locked-symbolic";
-  } else if (!enabled) {
+  } else if (!self->enabled) {
     icon_name = "network-cellular-disabled-symbolic";
   }
 
-  if (self->enabled != enabled) {
-    self->enabled = enabled;
-    g_object_notify_by_pspec (G_OBJECT (self), props[PROP_ENABLED]);
-  }
-
   if (icon_name) {
     phosh_status_icon_set_icon_name (PHOSH_STATUS_ICON (self), icon_name);
     gtk_widget_set_visible (access_tec_widget, FALSE);
@@ -198,6 +186,31 @@ update_icon_data(PhoshWWanInfo *self, GParamSpec *psepc, PhoshWWan *wwan)
   gtk_widget_set_visible (access_tec_widget, TRUE);
 }
 
+
+static void
+on_wwan_changed (PhoshWWanInfo *self, GParamSpec *pspec, PhoshWWan *wwan)
+{
+  gboolean present, enabled;
+
+  g_return_if_fail (PHOSH_IS_WWAN_INFO (self));
+
+  present = phosh_wwan_is_present (self->wwan);
+  if (present != self->present) {
+    g_debug ("Updating wwan present: %d", present);
+    self->present = present;
+    g_object_notify_by_pspec (G_OBJECT (self), props[PROP_PRESENT]);
+  }
+
+  enabled = phosh_wwan_is_enabled (self->wwan);
+  if (self->enabled != enabled) {
+    self->enabled = enabled;
+    g_object_notify_by_pspec (G_OBJECT (self), props[PROP_ENABLED]);
+  }
+
+  /* Icon and access technology follow on the next frame */
+  phosh_status_icon_queue_update (PHOSH_STATUS_ICON (self));
+}
+
 static void
 update_info (PhoshWWanInfo *self)
 {
@@ -219,11 +232,18 @@ phosh_wwan_info_idle_init (PhoshStatusIcon *icon)
 {
   PhoshWWanInfo *self = PHOSH_WWAN_INFO (icon);
 
-  update_icon_data (self, NULL, NULL);
+  on_wwan_changed (self, NULL, self->wwan);
   update_info (self);
 }
 
 
+static void
+phosh_wwan_info_update (PhoshStatusIcon *icon)
+{
+  update_icon_data (PHOSH_WWAN_INFO (icon));
+}
+
+
 static void
 phosh_wwan_info_constructed (GObject *object)
 {
@@ -244,7 +264,7 @@ phosh_wwan_info_constructed (GObject *object)
 
   for (int i = 0; i < g_strv_length(signals); i++) {
     g_signal_connect_swapped (self->wwan, signals[i],
-                              G_CALLBACK (update_icon_data),
+                              G_CALLBACK (on_wwan_changed),
                               self);
   }
 
@@ -285,6 +305,7 @@ phosh_wwan_info_class_init (PhoshWWanInfoClass *klass)
   gtk_widget_class_set_css_name (widget_class, "phosh-wwan-info");
 
   status_icon_class->idle_init = phosh_wwan_info_idle_init;
+  status_icon_class->update = phosh_wwan_info_update;
 
   /**
    * PhoshWWanInfo:show-details:
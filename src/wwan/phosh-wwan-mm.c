@@ -73,10 +73,16 @@ G_DEFINE_TYPE_WITH_CODE (PhoshWWanMM, phosh_wwan_mm, PHOSH_TYPE_WWAN_MANAGER,
 static void
 phosh_wwan_mm_update_signal_quality (PhoshWWanMM *self)
 {
+  guint signal_quality;
+
   g_return_if_fail (self);
   g_return_if_fail (self->modem);
 
-  self->signal_quality = mm_modem_get_signal_quality (self->modem, NULL);
+  signal_quality = mm_modem_get_signal_quality (self->modem, NULL);
+  if (self->signal_quality == signal_quality)
+    return;
+
+  self->signal_quality = signal_quality;
   g_object_notify_by_pspec (G_OBJECT (self), props[PROP_SIGNAL_QUALITY]);
 }
 
@@ -69,10 +69,16 @@ G_DEFINE_TYPE_WITH_CODE (PhoshWWanOfono, phosh_wwan_ofono, PHOSH_TYPE_WWAN_MANAG
 static void
 phosh_wwan_ofono_update_signal_quality (PhoshWWanOfono *self, GVariant *v)
 {
+  guint signal_quality;
+
   g_return_if_fail (self);
   g_return_if_fail (v);
 
-  self->signal_quality = g_variant_get_byte (v);
+  signal_quality = g_variant_get_byte (v);
+  if (self->signal_quality == signal_quality)
+    return;
+
+  self->signal_quality = signal_quality;
   g_object_notify (G_OBJECT (self), "signal-quality");
 }
 
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "testlib-bench.h"
+
+#include "app-list-model.c"
+#include "util.h"
+
+#define N_APPS 500
+
+static const char *searches[] = { "bench", "app 42", "synthetic", "does-not-match" };
+
+
+static PhoshAppListModel *
+get_model (void)
+{
+  PhoshAppListModel *model = phosh_app_list_model_get_default ();
+  PhoshAppListModelPrivate *priv = phosh_app_list_model_get_instance_private (model);
+
+  /* Don't let the initial debounce interfere */
+  g_clear_handle_id (&priv->debounce, g_source_remove);
+
+  return model;
+}
+
+
+static void
+bench_phosh_app_list_model_rebuild (void)
+{
+  g_autoptr (PhoshTestBench) bench = phosh_test_bench_new ("app-list-model-rebuild", N_APPS);
+  PhoshAppListModel *model = get_model ();
+
+  /* Warm up GIO's desktop file dir caches */
+  items_changed (model);
+  g_assert_cmpint (g_list_model_get_n_items (G_LIST_MODEL (model)), >=, N_APPS);
+
+  for (guint i = 0; i < phosh_test_bench_get_iterations (bench); i++) {
+    phosh_test_bench_begin (bench);
+    items_changed (model);
+    phosh_test_bench_end (bench);
+  }
+
+  phosh_test_bench_report (bench);
+  g_assert_finalize_object (model);
+}
+
+
+static void
+bench_phosh_app_grid_search (void)
+{
+  g_autoptr (PhoshTestBench) bench = phosh_test_bench_new ("app-grid-search", N_APPS);
+  PhoshAppListModel *model = get_model ();
+  g_autoptr (GPtrArray) apps = g_ptr_array_new_with_free_func (g_object_unref);
+  g_auto (GStrv) folded = g_new0 (char *, G_N_ELEMENTS (searches) + 1);
+  guint matches = 0;
+
+  items_changed (model);
+  for (guint i = 0; i < g_list_model_get_n_items (G_LIST_MODEL (model)); i++)
+    g_ptr_array_add (apps, g_list_model_get_item (G_LIST_MODEL (model), i));
+
+  /* Like the app grid we match against the casefolded search string */
+  for (guint i = 0; i < G_N_ELEMENTS (searches); i++)
+    folded[i] = g_utf8_casefold (searches[i], -1);
+
+  for (guint i = 0; i < phosh_test_bench_get_iterations (bench); i++) {
+    phosh_test_bench_begin (bench);
+    for (guint s = 0; folded[s]; s++) {
+      for (guint a = 0; a < apps->len; a++)
+        matches += phosh_util_matches_app_info (g_ptr_array_index (apps, a), folded[s]);
+    }
+    phosh_test_bench_end (bench);
+  }
+  g_assert_cmpint (matches, >, 0);
+
+  phosh_test_bench_report (bench);
+  g_clear_pointer (&apps, g_ptr_array_unref);
+  g_assert_finalize_object (model);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  g_autofree char *dir = phosh_test_bench_create_desktop_files (N_APPS);
+  int ret;
+
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/phosh/bench/app-list-model/rebuild", bench_phosh_app_list_model_rebuild);
+  g_test_add_func ("/phosh/bench/app-grid/search", bench_phosh_app_grid_search);
+
+  ret = g_test_run ();
+
+  phosh_test_bench_remove_desktop_files (dir, N_APPS);
+
+  return ret;
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "testlib-bench.h"
+
+#include "monitor/gamma-table.h"
+
+#define RAMP_SIZE 4096
+#define N_TEMPERATURES 64
+
+
+static void
+bench_phosh_gamma_table_fill (void)
+{
+  g_autoptr (PhoshTestBench) bench = phosh_test_bench_new ("gamma-table-fill", RAMP_SIZE);
+  g_autofree guint16 *table = g_new0 (guint16, RAMP_SIZE * 3);
+
+  for (guint i = 0; i < phosh_test_bench_get_iterations (bench); i++) {
+    phosh_test_bench_begin (bench);
+    /* Like a night light transition */
+    for (guint t = 0; t < N_TEMPERATURES; t++)
+      phosh_gamma_table_fill (table, RAMP_SIZE, 6500 - t * 50);
+    phosh_test_bench_end (bench);
+  }
+
+  phosh_test_bench_report (bench);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/phosh/bench/gamma-table/fill", bench_phosh_gamma_table_fill);
+
+  return g_test_run ();
+}
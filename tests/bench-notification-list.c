@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "testlib-bench.h"
+
+#include "notifications/notification-list.h"
+
+#define N_NOTIFICATIONS 1000
+#define N_SOURCES 25
+
+
+static void
+bench_phosh_notification_list_add (void)
+{
+  g_autoptr (PhoshTestBench) bench = phosh_test_bench_new ("notification-list-add",
+                                                           N_NOTIFICATIONS);
+  g_autoptr (GPtrArray) notifications = g_ptr_array_new_with_free_func (g_object_unref);
+  g_autoptr (GDateTime) now = g_date_time_new_now_local ();
+  g_auto (GStrv) source_ids = g_new0 (char *, N_SOURCES + 1);
+
+  for (guint i = 0; i < N_SOURCES; i++)
+    source_ids[i] = g_strdup_printf ("mobi.phosh.BenchApp%u", i);
+
+  for (guint i = 0; i < N_NOTIFICATIONS; i++) {
+    g_autofree char *summary = g_strdup_printf ("Notification %u", i);
+    PhoshNotification *noti;
+
+    noti = phosh_notification_new (i + 1,
+                                   NULL,
+                                   NULL,
+                                   summary,
+                                   "Benchmarking the notification list",
+                                   NULL,
+                                   NULL,
+                                   PHOSH_NOTIFICATION_URGENCY_NORMAL,
+                                   NULL,
+                                   FALSE,
+                                   FALSE,
+                                   NULL,
+                                   NULL,
+                                   now);
+    g_ptr_array_add (notifications, noti);
+  }
+
+  for (guint i = 0; i < phosh_test_bench_get_iterations (bench); i++) {
+    g_autoptr (PhoshNotificationList) list = phosh_notification_list_new ();
+
+    phosh_test_bench_begin (bench);
+    for (guint n = 0; n < notifications->len; n++) {
+      phosh_notification_list_add (list,
+                                   source_ids[n % N_SOURCES],
+                                   g_ptr_array_index (notifications, n));
+    }
+    phosh_test_bench_end (bench);
+
+    g_assert_cmpint (g_list_model_get_n_items (G_LIST_MODEL (list)), ==, N_SOURCES);
+  }
+
+  phosh_test_bench_report (bench);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/phosh/bench/notification-list/add", bench_phosh_notification_list_add);
+
+  return g_test_run ();
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "testlib-bench.h"
+
+#include "search/search-result-meta.h"
+
+#define N_RESULTS 200
+
+
+static void
+bench_phosh_search_result_meta_serialise (void)
+{
+  g_autoptr (PhoshTestBench) bench = phosh_test_bench_new ("search-result-meta-roundtrip",
+                                                           N_RESULTS);
+  g_autoptr (GPtrArray) metas = NULL;
+  g_autoptr (GIcon) icon = g_themed_icon_new ("start-here");
+
+  metas = g_ptr_array_new_with_free_func ((GDestroyNotify) phosh_search_result_meta_unref);
+  for (guint i = 0; i < N_RESULTS; i++) {
+    g_autofree char *id = g_strdup_printf ("result-%u", i);
+    g_autofree char *title = g_strdup_printf ("Result %u", i);
+
+    g_ptr_array_add (metas, phosh_search_result_meta_new (id,
+                                                          title,
+                                                          "A search result for benchmarking",
+                                                          icon,
+                                                          "copy-me"));
+  }
+
+  for (guint i = 0; i < phosh_test_bench_get_iterations (bench); i++) {
+    phosh_test_bench_begin (bench);
+    for (guint r = 0; r < metas->len; r++) {
+      g_autoptr (GVariant) variant = NULL;
+      g_autoptr (PhoshSearchResultMeta) meta = NULL;
+
+      variant = g_variant_ref_sink (phosh_search_result_meta_serialise (g_ptr_array_index (metas, r)));
+      meta = phosh_search_result_meta_deserialise (variant);
+      g_assert_nonnull (meta);
+    }
+    phosh_test_bench_end (bench);
+  }
+
+  phosh_test_bench_report (bench);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/phosh/bench/search-result-meta/serialise",
+                   bench_phosh_search_result_meta_serialise);
+
+  return g_test_run ();
+}
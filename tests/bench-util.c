@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "testlib-bench.h"
+
+#include "util.h"
+
+static const struct {
+  guint32 width;
+  guint32 height;
+} modes[] = {
+  { 720, 1440 },
+  { 1080, 2340 },
+  { 1440, 3120 },
+  { 1920, 1080 },
+  { 2560, 1440 },
+  { 3840, 2160 },
+};
+
+
+static void
+bench_phosh_util_calculate_supported_mode_scales (void)
+{
+  g_autoptr (PhoshTestBench) bench = phosh_test_bench_new ("calculate-supported-mode-scales",
+                                                           G_N_ELEMENTS (modes));
+
+  for (guint i = 0; i < phosh_test_bench_get_iterations (bench); i++) {
+    phosh_test_bench_begin (bench);
+    for (guint m = 0; m < G_N_ELEMENTS (modes); m++) {
+      g_autofree float *scales = NULL;
+      int n_scales;
+
+      scales = phosh_util_calculate_supported_mode_scales (modes[m].width,
+                                                           modes[m].height,
+                                                           &n_scales,
+                                                           TRUE);
+      g_assert_cmpint (n_scales, >, 0);
+    }
+    phosh_test_bench_end (bench);
+  }
+
+  phosh_test_bench_report (bench);
+}
+
+
+static void
+bench_phosh_util_escape_markup (void)
+{
+  g_autoptr (PhoshTestBench) bench = NULL;
+  g_autoptr (GString) body = g_string_new (NULL);
+
+  /* A long chat message with some markup, entities and stray characters */
+  for (int i = 0; i < 100; i++) {
+    g_string_append (body, "Hey <b>you</b>, did you see the <i>news</i>? Tom & Jerry "
+                     "&lt;3 each other &amp; <a href=\"https://example.com\">this</a> ");
+  }
+
+  bench = phosh_test_bench_new ("escape-markup", body->len);
+  for (guint i = 0; i < phosh_test_bench_get_iterations (bench); i++) {
+    phosh_test_bench_begin (bench);
+    for (int n = 0; n < 100; n++) {
+      g_autofree char *escaped = phosh_util_escape_markup (body->str, TRUE);
+    }
+    phosh_test_bench_end (bench);
+  }
+
+  phosh_test_bench_report (bench);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/phosh/bench/util/calculate-supported-mode-scales",
+                   bench_phosh_util_calculate_supported_mode_scales);
+  g_test_add_func ("/phosh/bench/util/escape-markup", bench_phosh_util_escape_markup);
+
+  return g_test_run ();
+}
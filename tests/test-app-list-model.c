@@ -88,6 +88,49 @@ test_phosh_app_list_model_api (void)
 }
 
 
+static void
+test_phosh_app_list_model_lookup_by_app_id (void)
+{
+  PhoshAppListModel *model = phosh_app_list_model_get_default ();
+  g_autoptr (GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+  g_autoptr (GDesktopAppInfo) info1 = NULL;
+  g_autoptr (GDesktopAppInfo) info2 = NULL;
+  g_autoptr (GAppInfo) item = NULL;
+  ItemsChangedContext context = {
+    .loop = loop,
+    .model = model,
+  };
+
+  g_signal_connect (model, "items-changed", G_CALLBACK (on_items_changed), &context);
+  g_main_loop_run (loop);
+  g_assert_true (context.changed);
+
+  /* Direct match, cached */
+  info1 = phosh_app_list_model_lookup_by_app_id (model, "demo.app.First");
+  g_assert_true (G_IS_DESKTOP_APP_INFO (info1));
+  info2 = phosh_app_list_model_lookup_by_app_id (model, "demo.app.First");
+  g_assert_true (info1 == info2);
+  g_clear_object (&info2);
+
+  /* Via StartupWMClass */
+  info2 = phosh_app_list_model_lookup_by_app_id (model, "first-app");
+  g_assert_cmpstr (g_app_info_get_id (G_APP_INFO (info1)), ==,
+                   g_app_info_get_id (G_APP_INFO (info2)));
+  g_clear_object (&info2);
+
+  /* Negative results are remembered until an exec gets added */
+  g_assert_null (phosh_app_list_model_lookup_by_app_id (model, "does-not-exist"));
+  g_assert_null (phosh_app_list_model_lookup_by_app_id (model, "does-not-exist"));
+
+  item = g_list_model_get_item (G_LIST_MODEL (model), 0);
+  phosh_app_list_model_add_exec (model, "/usr/bin/does-not-exist", item);
+  info2 = phosh_app_list_model_lookup_by_app_id (model, "does-not-exist");
+  g_assert_true (G_APP_INFO (info2) == item);
+
+  g_assert_finalize_object (model);
+}
+
+
 int
 main (int argc, char *argv[])
 {
@@ -95,6 +138,8 @@ main (int argc, char *argv[])
 
   g_test_add_func ("/phosh/app-list-model/new", test_phosh_app_list_model_get_default);
   g_test_add_func ("/phosh/app-list-model/api", test_phosh_app_list_model_api);
+  g_test_add_func ("/phosh/app-list-model/lookup-by-app-id",
+                   test_phosh_app_list_model_lookup_by_app_id);
 
   return g_test_run ();
 }
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "clock-ticker.h"
+
+
+static void
+on_tick_quit (gpointer user_data)
+{
+  g_main_loop_quit (user_data);
+}
+
+
+static void
+on_tick_count (gpointer user_data)
+{
+  guint *count = user_data;
+
+  (*count)++;
+}
+
+
+static gboolean
+on_timeout (gpointer user_data)
+{
+  g_main_loop_quit (user_data);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static void
+test_phosh_clock_ticker_tick (void)
+{
+  PhoshClockTicker *ticker = phosh_clock_ticker_get_default ();
+  g_autoptr (GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+  guint wakeups = phosh_clock_ticker_get_n_wakeups (ticker);
+  guint id;
+
+  id = phosh_clock_ticker_subscribe (ticker, PHOSH_CLOCK_TICKER_GRANULARITY_SECOND, NULL,
+                                     on_tick_quit, loop);
+  g_main_loop_run (loop);
+
+  /* Ticks happen right after full seconds */
+  g_assert_cmpint (g_get_real_time () % G_USEC_PER_SEC, <, G_USEC_PER_SEC / 2);
+  g_assert_cmpuint (phosh_clock_ticker_get_n_wakeups (ticker), ==, wakeups + 1);
+
+  phosh_clock_ticker_unsubscribe (ticker, id);
+}
+
+
+static void
+test_phosh_clock_ticker_paused (void)
+{
+  PhoshClockTicker *ticker = phosh_clock_ticker_get_default ();
+  guint count = 0;
+  guint id;
+
+  phosh_clock_ticker_set_paused (ticker, TRUE);
+  g_assert_true (phosh_clock_ticker_get_paused (ticker));
+
+  id = phosh_clock_ticker_subscribe (ticker, PHOSH_CLOCK_TICKER_GRANULARITY_MINUTE, NULL,
+                                     on_tick_count, &count);
+  g_assert_cmpuint (count, ==, 0);
+
+  /* Resuming catches up immediately */
+  phosh_clock_ticker_set_paused (ticker, FALSE);
+  g_assert_cmpuint (count, ==, 1);
+
+  phosh_clock_ticker_unsubscribe (ticker, id);
+  phosh_clock_ticker_set_paused (ticker, TRUE);
+  phosh_clock_ticker_set_paused (ticker, FALSE);
+  g_assert_cmpuint (count, ==, 1);
+}
+
+
+static void
+test_phosh_clock_ticker_widget (void)
+{
+  PhoshClockTicker *ticker = phosh_clock_ticker_get_default ();
+  g_autoptr (GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+  GtkWidget *label = gtk_label_new ("test");
+  guint count = 0;
+
+  g_object_ref_sink (label);
+
+  /* Unmapped widgets don't get ticks */
+  phosh_clock_ticker_subscribe (ticker, PHOSH_CLOCK_TICKER_GRANULARITY_SECOND, label,
+                                on_tick_count, &count);
+  g_timeout_add (1500, on_timeout, loop);
+  g_main_loop_run (loop);
+  g_assert_cmpuint (count, ==, 0);
+
+  /* Destroying the widget drops the subscription */
+  gtk_widget_destroy (label);
+  g_object_unref (label);
+  phosh_clock_ticker_set_paused (ticker, TRUE);
+  phosh_clock_ticker_set_paused (ticker, FALSE);
+  g_assert_cmpuint (count, ==, 0);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/phosh/clock-ticker/tick", test_phosh_clock_ticker_tick);
+  g_test_add_func ("/phosh/clock-ticker/paused", test_phosh_clock_ticker_paused);
+  g_test_add_func ("/phosh/clock-ticker/widget", test_phosh_clock_ticker_widget);
+
+  return g_test_run ();
+}
@@ -6,6 +6,7 @@
  * Author: Guido Günther <agx@sigxcpu.org>
  */
 
+#include "idle-manager-priv.h"
 #include "phosh-idle-dbus.h"
 #include "shell-priv.h"
 
@@ -16,6 +17,8 @@
 #define OBJECT_PATH "/org/gnome/Mutter/IdleMonitor/Core"
 
 #define POP_TIMEOUT 50000000
+/* An interval not used by anyone else so the timer is ours */
+#define SHARED_INTERVAL 1234
 
 static guint watch_id;
 static GMainLoop *loop;
@@ -138,6 +141,251 @@ test_phosh_idle_watch_unfired (PhoshTestFullShellFixture *fixture, gconstpointer
 }
 
 
+typedef struct {
+  GAsyncQueue *done;
+  guint        n_timers;
+  guint        n_clients;
+} CountData;
+
+
+static gboolean
+get_counts_cb (gpointer user_data)
+{
+  CountData *data = user_data;
+  PhoshIdleManager *manager = phosh_idle_manager_get_default ();
+
+  data->n_timers = phosh_idle_manager_get_n_timers (manager);
+  data->n_clients = phosh_idle_manager_get_n_clients (manager);
+  g_async_queue_push (data->done, data);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Fetch the idle manager's state from the shell's thread */
+static void
+get_counts (guint *n_timers, guint *n_clients)
+{
+  g_autoptr (GAsyncQueue) done = g_async_queue_new ();
+  CountData data = { .done = done };
+
+  gdk_threads_add_idle (get_counts_cb, &data);
+  g_assert_nonnull (g_async_queue_timeout_pop (done, POP_TIMEOUT));
+
+  if (n_timers)
+    *n_timers = data.n_timers;
+  if (n_clients)
+    *n_clients = data.n_clients;
+}
+
+
+static void
+on_watch_fired_push (PhoshIdleDBusIdleMonitor *proxy, guint id, GAsyncQueue *fired)
+{
+  g_async_queue_push (fired, GUINT_TO_POINTER (id));
+}
+
+
+static PhoshIdleDBusIdleMonitor *
+get_proxy (GDBusConnection *connection, GAsyncQueue *fired)
+{
+  g_autoptr (GError) err = NULL;
+  PhoshIdleDBusIdleMonitor *proxy;
+
+  proxy = phosh_idle_dbus_idle_monitor_proxy_new_sync (connection,
+                                                       G_DBUS_PROXY_FLAGS_NONE,
+                                                       BUS_NAME,
+                                                       OBJECT_PATH,
+                                                       NULL,
+                                                       &err);
+  g_assert_no_error (err);
+  g_assert_true (G_IS_DBUS_PROXY (proxy));
+
+  /* Emitted in the shell's thread as it runs the default main context */
+  if (fired)
+    g_signal_connect (proxy, "watch-fired", G_CALLBACK (on_watch_fired_push), fired);
+
+  return proxy;
+}
+
+
+static guint
+add_idle_watch (PhoshIdleDBusIdleMonitor *proxy, guint64 interval)
+{
+  g_autoptr (GError) err = NULL;
+  guint id = 0;
+
+  phosh_idle_dbus_idle_monitor_call_add_idle_watch_sync (proxy, interval, &id, NULL, &err);
+  g_assert_no_error (err);
+  g_assert_cmpuint (id, !=, 0);
+
+  return id;
+}
+
+
+static void
+remove_watch (PhoshIdleDBusIdleMonitor *proxy, guint id)
+{
+  g_autoptr (GError) err = NULL;
+
+  phosh_idle_dbus_idle_monitor_call_remove_watch_sync (proxy, id, NULL, &err);
+  g_assert_no_error (err);
+}
+
+
+static void
+test_phosh_idle_watch_shared (PhoshTestFullShellFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (GDBusConnection) connection = NULL;
+  g_autoptr (PhoshIdleDBusIdleMonitor) proxy = NULL;
+  g_autoptr (GAsyncQueue) fired = g_async_queue_new ();
+  g_autoptr (GError) err = NULL;
+  guint n_timers, base_timers, id1, id2, fired1, fired2;
+
+  /* Wait until comp/shell are up */
+  g_assert_nonnull (g_async_queue_timeout_pop (fixture->queue, POP_TIMEOUT));
+
+  connection = g_bus_get_sync (G_BUS_TYPE_SESSION, NULL, &err);
+  g_assert_no_error (err);
+  proxy = get_proxy (connection, fired);
+  get_counts (&base_timers, NULL);
+
+  /* Watches with the same interval share a timer */
+  id1 = add_idle_watch (proxy, SHARED_INTERVAL);
+  id2 = add_idle_watch (proxy, SHARED_INTERVAL);
+  g_assert_cmpuint (id1, !=, id2);
+  get_counts (&n_timers, NULL);
+  g_assert_cmpuint (n_timers, ==, base_timers + 1);
+
+  /* …and both fire */
+  fired1 = GPOINTER_TO_UINT (g_async_queue_timeout_pop (fired, POP_TIMEOUT));
+  fired2 = GPOINTER_TO_UINT (g_async_queue_timeout_pop (fired, POP_TIMEOUT));
+  g_assert_cmpuint (MIN (fired1, fired2), ==, MIN (id1, id2));
+  g_assert_cmpuint (MAX (fired1, fired2), ==, MAX (id1, id2));
+
+  remove_watch (proxy, id1);
+  remove_watch (proxy, id2);
+  get_counts (&n_timers, NULL);
+  g_assert_cmpuint (n_timers, ==, base_timers);
+}
+
+
+static void
+test_phosh_idle_watch_remove_one (PhoshTestFullShellFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (GDBusConnection) connection = NULL;
+  g_autoptr (PhoshIdleDBusIdleMonitor) proxy = NULL;
+  g_autoptr (GAsyncQueue) fired = g_async_queue_new ();
+  g_autoptr (GError) err = NULL;
+  guint n_timers, base_timers, id1, id2;
+
+  /* Wait until comp/shell are up */
+  g_assert_nonnull (g_async_queue_timeout_pop (fixture->queue, POP_TIMEOUT));
+
+  connection = g_bus_get_sync (G_BUS_TYPE_SESSION, NULL, &err);
+  g_assert_no_error (err);
+  proxy = get_proxy (connection, fired);
+  get_counts (&base_timers, NULL);
+
+  id1 = add_idle_watch (proxy, SHARED_INTERVAL);
+  id2 = add_idle_watch (proxy, SHARED_INTERVAL);
+
+  /* Removing one watch keeps the shared timer… */
+  remove_watch (proxy, id1);
+  get_counts (&n_timers, NULL);
+  g_assert_cmpuint (n_timers, ==, base_timers + 1);
+
+  /* …so the other one still fires */
+  g_assert_cmpuint (GPOINTER_TO_UINT (g_async_queue_timeout_pop (fired, POP_TIMEOUT)), ==, id2);
+  g_assert_null (g_async_queue_try_pop (fired));
+
+  remove_watch (proxy, id2);
+  get_counts (&n_timers, NULL);
+  g_assert_cmpuint (n_timers, ==, base_timers);
+}
+
+
+static void
+test_phosh_idle_watch_vanished (PhoshTestFullShellFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (GDBusConnection) connection = NULL;
+  g_autoptr (PhoshIdleDBusIdleMonitor) proxy = NULL;
+  g_autofree char *address = NULL;
+  g_autoptr (GError) err = NULL;
+  guint n_timers, n_clients, base_timers, base_clients;
+  gint64 deadline;
+
+  /* Wait until comp/shell are up */
+  g_assert_nonnull (g_async_queue_timeout_pop (fixture->queue, POP_TIMEOUT));
+
+  /* A private connection so we can make the client's name vanish */
+  address = g_dbus_address_get_for_bus_sync (G_BUS_TYPE_SESSION, NULL, &err);
+  g_assert_no_error (err);
+  connection = g_dbus_connection_new_for_address_sync (address,
+                                                       G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+                                                       G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION,
+                                                       NULL, NULL, &err);
+  g_assert_no_error (err);
+  proxy = get_proxy (connection, NULL);
+  get_counts (&base_timers, &base_clients);
+
+  /* Watches of one client share the name watcher */
+  add_idle_watch (proxy, SHARED_INTERVAL);
+  add_idle_watch (proxy, SHARED_INTERVAL + 1);
+  get_counts (&n_timers, &n_clients);
+  g_assert_cmpuint (n_timers, ==, base_timers + 2);
+  g_assert_cmpuint (n_clients, ==, base_clients + 1);
+
+  g_dbus_connection_close_sync (connection, NULL, &err);
+  g_assert_no_error (err);
+
+  /* The watches, their timers and the client go away with the bus name */
+  deadline = g_get_monotonic_time () + POP_TIMEOUT;
+  do {
+    g_usleep (10 * 1000);
+    get_counts (&n_timers, &n_clients);
+  } while ((n_timers != base_timers || n_clients != base_clients) &&
+           g_get_monotonic_time () < deadline);
+
+  g_assert_cmpuint (n_timers, ==, base_timers);
+  g_assert_cmpuint (n_clients, ==, base_clients);
+}
+
+
+static void
+test_phosh_idle_get_idletime (PhoshTestFullShellFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (GDBusConnection) connection = NULL;
+  g_autoptr (PhoshIdleDBusIdleMonitor) proxy = NULL;
+  g_autoptr (GAsyncQueue) fired = g_async_queue_new ();
+  g_autoptr (GError) err = NULL;
+  guint64 idletime = 0;
+  guint id;
+
+  /* Wait until comp/shell are up */
+  g_assert_nonnull (g_async_queue_timeout_pop (fixture->queue, POP_TIMEOUT));
+
+  connection = g_bus_get_sync (G_BUS_TYPE_SESSION, NULL, &err);
+  g_assert_no_error (err);
+  proxy = get_proxy (connection, fired);
+
+  /* Once a watch fired the user is idle for at least its interval */
+  id = add_idle_watch (proxy, SHARED_INTERVAL);
+  g_assert_cmpuint (GPOINTER_TO_UINT (g_async_queue_timeout_pop (fired, POP_TIMEOUT)), ==, id);
+
+  phosh_idle_dbus_idle_monitor_call_get_idletime_sync (proxy, &idletime, NULL, &err);
+  g_assert_no_error (err);
+  g_assert_cmpuint (idletime, >=, SHARED_INTERVAL);
+
+  /* Idle time keeps growing while idle */
+  g_usleep (200 * 1000);
+  phosh_idle_dbus_idle_monitor_call_get_idletime_sync (proxy, &idletime, NULL, &err);
+  g_assert_no_error (err);
+  g_assert_cmpuint (idletime, >=, SHARED_INTERVAL + 200);
+
+  remove_watch (proxy, id);
+}
+
+
 int
 main (int   argc, char *argv[])
 {
@@ -149,6 +397,13 @@ main (int   argc, char *argv[])
 
   PHOSH_FULL_SHELL_TEST_ADD ("/phosh/dbus/idle-manager/fired", cfg, test_phosh_idle_watch_fired);
   PHOSH_FULL_SHELL_TEST_ADD ("/phosh/dbus/idle-manager/unfired", cfg, test_phosh_idle_watch_unfired);
+  PHOSH_FULL_SHELL_TEST_ADD ("/phosh/dbus/idle-manager/shared", cfg, test_phosh_idle_watch_shared);
+  PHOSH_FULL_SHELL_TEST_ADD ("/phosh/dbus/idle-manager/remove-one", cfg,
+                             test_phosh_idle_watch_remove_one);
+  PHOSH_FULL_SHELL_TEST_ADD ("/phosh/dbus/idle-manager/vanished", cfg,
+                             test_phosh_idle_watch_vanished);
+  PHOSH_FULL_SHELL_TEST_ADD ("/phosh/dbus/idle-manager/idletime", cfg,
+                             test_phosh_idle_get_idletime);
 
   return g_test_run ();
 }
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "light-filter.h"
+
+#define WINDOW_MS 200
+
+
+static void
+on_high_contrast_changed (GMainLoop *loop)
+{
+  g_main_loop_quit (loop);
+}
+
+
+static gboolean
+on_timeout (gpointer user_data)
+{
+  g_main_loop_quit (user_data);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static void
+run_loop (GMainLoop *loop, guint timeout)
+{
+  guint id = g_timeout_add (timeout, on_timeout, loop);
+
+  g_main_loop_run (loop);
+  g_source_remove (id);
+}
+
+
+static void
+test_phosh_light_filter_switch (void)
+{
+  g_autoptr (PhoshLightFilter) filter = phosh_light_filter_new (WINDOW_MS);
+  g_autoptr (GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+  g_signal_connect_swapped (filter, "notify::high-contrast",
+                            G_CALLBACK (on_high_contrast_changed), loop);
+
+  phosh_light_filter_set_threshold (filter, 1000);
+  g_assert_cmpuint (phosh_light_filter_get_threshold (filter), ==, 1000);
+
+  /* A constant level beyond the threshold switches without further samples */
+  phosh_light_filter_add_sample (filter, 2000.0);
+  g_assert_false (phosh_light_filter_get_high_contrast (filter));
+  run_loop (loop, 10 * WINDOW_MS);
+  g_assert_true (phosh_light_filter_get_high_contrast (filter));
+
+  /* Within the hysteresis nothing changes */
+  phosh_light_filter_add_sample (filter, 950.0);
+  run_loop (loop, 2 * WINDOW_MS);
+  g_assert_true (phosh_light_filter_get_high_contrast (filter));
+
+  phosh_light_filter_add_sample (filter, 10.0);
+  run_loop (loop, 10 * WINDOW_MS);
+  g_assert_false (phosh_light_filter_get_high_contrast (filter));
+}
+
+
+static void
+test_phosh_light_filter_spike (void)
+{
+  g_autoptr (PhoshLightFilter) filter = phosh_light_filter_new (WINDOW_MS);
+  g_autoptr (GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+  phosh_light_filter_set_threshold (filter, 1000);
+
+  /* Short spikes don't switch */
+  phosh_light_filter_add_sample (filter, 100.0);
+  phosh_light_filter_add_sample (filter, 5000.0);
+  phosh_light_filter_add_sample (filter, 100.0);
+  run_loop (loop, 2 * WINDOW_MS);
+  g_assert_false (phosh_light_filter_get_high_contrast (filter));
+
+  /* Raising the threshold drops a pending switch */
+  phosh_light_filter_add_sample (filter, 5000.0);
+  phosh_light_filter_set_threshold (filter, 10000);
+  run_loop (loop, 2 * WINDOW_MS);
+  g_assert_false (phosh_light_filter_get_high_contrast (filter));
+
+  phosh_light_filter_reset (filter, TRUE);
+  g_assert_true (phosh_light_filter_get_high_contrast (filter));
+  run_loop (loop, 2 * WINDOW_MS);
+  g_assert_true (phosh_light_filter_get_high_contrast (filter));
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/phosh/light-filter/switch", test_phosh_light_filter_switch);
+  g_test_add_func ("/phosh/light-filter/spike", test_phosh_light_filter_spike);
+
+  return g_test_run ();
+}
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "testlib.h"
+
+#include "media-art-cache.h"
+
+/* Needs to match the cache's MAX_ENTRIES */
+#define MAX_ENTRIES 8
+
+typedef struct {
+  char *tmpdir;
+  char *square_url;
+  char *wide_url;
+} MediaArtFixture;
+
+
+static char *
+write_art (MediaArtFixture *fixture, const char *name, int width, int height)
+{
+  g_autoptr (GdkPixbuf) pixbuf = gdk_pixbuf_new (GDK_COLORSPACE_RGB, TRUE, 8, width, height);
+  g_autofree char *path = g_build_filename (fixture->tmpdir, name, NULL);
+  g_autoptr (GError) err = NULL;
+
+  /* Opaque red */
+  gdk_pixbuf_fill (pixbuf, 0xff0000ff);
+  gdk_pixbuf_save (pixbuf, path, "png", &err, NULL);
+  g_assert_no_error (err);
+
+  return g_filename_to_uri (path, NULL, NULL);
+}
+
+
+static void
+media_art_fixture_setup (MediaArtFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (GError) err = NULL;
+
+  fixture->tmpdir = g_dir_make_tmp ("phosh-test-media-art.XXXXXX", &err);
+  g_assert_no_error (err);
+
+  fixture->square_url = write_art (fixture, "square.png", 64, 64);
+  fixture->wide_url = write_art (fixture, "wide.png", 80, 40);
+}
+
+
+static void
+media_art_fixture_teardown (MediaArtFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (GFile) file = g_file_new_for_path (fixture->tmpdir);
+
+  phosh_test_remove_tree (file);
+  g_clear_pointer (&fixture->wide_url, g_free);
+  g_clear_pointer (&fixture->square_url, g_free);
+  g_clear_pointer (&fixture->tmpdir, g_free);
+}
+
+
+static void
+on_art_loaded (GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+  cairo_surface_t **surface = user_data;
+  g_autoptr (GError) err = NULL;
+
+  *surface = phosh_media_art_cache_load_finish (PHOSH_MEDIA_ART_CACHE (source_object), res, &err);
+  g_assert_no_error (err);
+  g_assert_nonnull (*surface);
+}
+
+
+static cairo_surface_t *
+load_art (PhoshMediaArtCache *cache, const char *url, int size, int scale)
+{
+  cairo_surface_t *surface = NULL;
+
+  phosh_media_art_cache_load_async (cache, url, size, scale, NULL, on_art_loaded, &surface);
+  while (surface == NULL)
+    g_main_context_iteration (NULL, TRUE);
+
+  return surface;
+}
+
+
+static void
+test_phosh_media_art_cache_shared (MediaArtFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (PhoshMediaArtCache) cache = g_object_new (PHOSH_TYPE_MEDIA_ART_CACHE, NULL);
+  cairo_surface_t *surface1 = NULL, *surface2 = NULL, *cached;
+
+  g_assert_null (phosh_media_art_cache_lookup (cache, fixture->square_url, 32, 1));
+
+  /* Concurrent loads of the same art share a single decode… */
+  phosh_media_art_cache_load_async (cache, fixture->square_url, 32, 1, NULL,
+                                    on_art_loaded, &surface1);
+  phosh_media_art_cache_load_async (cache, fixture->square_url, 32, 1, NULL,
+                                    on_art_loaded, &surface2);
+  while (surface1 == NULL || surface2 == NULL)
+    g_main_context_iteration (NULL, TRUE);
+  g_assert_true (surface1 == surface2);
+
+  /* …and the result is cached */
+  cached = phosh_media_art_cache_lookup (cache, fixture->square_url, 32, 1);
+  g_assert_true (cached == surface1);
+
+  /* Different scales are different entries */
+  g_assert_null (phosh_media_art_cache_lookup (cache, fixture->square_url, 32, 2));
+
+  cairo_surface_destroy (cached);
+  cairo_surface_destroy (surface2);
+  cairo_surface_destroy (surface1);
+}
+
+
+static void
+test_phosh_media_art_cache_evict (MediaArtFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (PhoshMediaArtCache) cache = g_object_new (PHOSH_TYPE_MEDIA_ART_CACHE, NULL);
+  cairo_surface_t *surface;
+
+  /* Each size is an entry of its own */
+  for (int size = 1; size <= MAX_ENTRIES; size++)
+    cairo_surface_destroy (load_art (cache, fixture->square_url, size, 1));
+
+  /* Mark the oldest entry as recently used */
+  surface = phosh_media_art_cache_lookup (cache, fixture->square_url, 1, 1);
+  g_assert_nonnull (surface);
+  cairo_surface_destroy (surface);
+
+  /* One more entry evicts the least recently used one */
+  cairo_surface_destroy (load_art (cache, fixture->square_url, MAX_ENTRIES + 1, 1));
+
+  g_assert_null (phosh_media_art_cache_lookup (cache, fixture->square_url, 2, 1));
+  for (int size = 1; size <= MAX_ENTRIES + 1; size++) {
+    if (size == 2)
+      continue;
+
+    surface = phosh_media_art_cache_lookup (cache, fixture->square_url, size, 1);
+    g_assert_nonnull (surface);
+    cairo_surface_destroy (surface);
+  }
+}
+
+
+static guint8
+get_alpha (cairo_surface_t *surface, int x, int y)
+{
+  guint8 *data = cairo_image_surface_get_data (surface);
+  int stride = cairo_image_surface_get_stride (surface);
+
+  /* ARGB32 in native endianness */
+  return *(guint32 *)(data + y * stride + x * 4) >> 24;
+}
+
+
+static void
+test_phosh_media_art_cache_non_square (MediaArtFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (PhoshMediaArtCache) cache = g_object_new (PHOSH_TYPE_MEDIA_ART_CACHE, NULL);
+  cairo_surface_t *surface;
+  double x_scale, y_scale;
+  int px = 16 * 2;
+
+  surface = load_art (cache, fixture->wide_url, 16, 2);
+
+  /* Square at the pixel size */
+  g_assert_cmpint (cairo_image_surface_get_width (surface), ==, px);
+  g_assert_cmpint (cairo_image_surface_get_height (surface), ==, px);
+  cairo_surface_get_device_scale (surface, &x_scale, &y_scale);
+  g_assert_cmpfloat (x_scale, ==, 2.0);
+  g_assert_cmpfloat (y_scale, ==, 2.0);
+
+  /* The art is centered vertically, the area above and below is transparent */
+  cairo_surface_flush (surface);
+  g_assert_cmpint (get_alpha (surface, px / 2, 2), ==, 0);
+  g_assert_cmpint (get_alpha (surface, px / 2, px / 2), ==, 0xff);
+  g_assert_cmpint (get_alpha (surface, px / 2, px - 3), ==, 0);
+
+  cairo_surface_destroy (surface);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  g_test_add ("/phosh/media-art-cache/shared", MediaArtFixture, NULL,
+              media_art_fixture_setup, test_phosh_media_art_cache_shared,
+              media_art_fixture_teardown);
+  g_test_add ("/phosh/media-art-cache/evict", MediaArtFixture, NULL,
+              media_art_fixture_setup, test_phosh_media_art_cache_evict,
+              media_art_fixture_teardown);
+  g_test_add ("/phosh/media-art-cache/non-square", MediaArtFixture, NULL,
+              media_art_fixture_setup, test_phosh_media_art_cache_non_square,
+              media_art_fixture_teardown);
+
+  return g_test_run ();
+}
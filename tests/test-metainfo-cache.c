@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2025 The Phosh Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "testlib.h"
+
+#include "metainfo-cache.h"
+
+#include <glib/gstdio.h>
+
+#include <utime.h>
+
+#define METAINFO_FMT                                                    \
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"                        \
+  "<component type=\"desktop-application\">\n"                          \
+  "  <id>%s</id>\n"                                                     \
+  "  <metadata_license>CC0-1.0</metadata_license>\n"                    \
+  "  <name>Example</name>\n"                                            \
+  "  <summary>An example app</summary>\n"                               \
+  "  <launchable type=\"desktop-id\">example.desktop</launchable>\n"    \
+  "</component>\n"
+
+typedef struct {
+  char *tmpdir;
+  char *index_path;
+  char *metainfo_dir;
+  char *metainfo_path;
+} MetainfoFixture;
+
+
+static void
+write_metainfo (MetainfoFixture *fixture, const char *cid, gint64 mtime)
+{
+  g_autofree char *content = g_strdup_printf (METAINFO_FMT, cid);
+  g_autoptr (GError) err = NULL;
+  struct utimbuf times = { .actime = mtime, .modtime = mtime };
+
+  g_file_set_contents (fixture->metainfo_path, content, -1, &err);
+  g_assert_no_error (err);
+  g_assert_cmpint (g_utime (fixture->metainfo_path, &times), ==, 0);
+}
+
+
+static void
+metainfo_fixture_setup (MetainfoFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (GError) err = NULL;
+
+  fixture->tmpdir = g_dir_make_tmp ("phosh-test-metainfo.XXXXXX", &err);
+  g_assert_no_error (err);
+
+  fixture->index_path = g_build_filename (fixture->tmpdir, "cache", "metainfo-index", NULL);
+  fixture->metainfo_dir = g_build_filename (fixture->tmpdir, "metainfo", NULL);
+  fixture->metainfo_path = g_build_filename (fixture->metainfo_dir, "org.example.Foo.metainfo.xml",
+                                             NULL);
+  g_assert_cmpint (g_mkdir_with_parents (fixture->metainfo_dir, 0755), ==, 0);
+
+  write_metainfo (fixture, "org.example.Foo", 1000000);
+}
+
+
+static void
+metainfo_fixture_teardown (MetainfoFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (GFile) file = g_file_new_for_path (fixture->tmpdir);
+
+  phosh_test_remove_tree (file);
+  g_clear_pointer (&fixture->metainfo_path, g_free);
+  g_clear_pointer (&fixture->metainfo_dir, g_free);
+  g_clear_pointer (&fixture->index_path, g_free);
+  g_clear_pointer (&fixture->tmpdir, g_free);
+}
+
+
+static void
+on_ready (GMainLoop *loop)
+{
+  g_main_loop_quit (loop);
+}
+
+
+static PhoshMetainfoCache *
+new_cache (MetainfoFixture *fixture)
+{
+  const char *dirs[] = { fixture->metainfo_dir, NULL };
+  g_autoptr (GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+  PhoshMetainfoCache *cache = phosh_metainfo_cache_new (fixture->index_path, dirs);
+  gboolean ready;
+
+  g_signal_connect_swapped (cache, "notify::ready", G_CALLBACK (on_ready), loop);
+  g_main_loop_run (loop);
+  g_signal_handlers_disconnect_by_data (cache, loop);
+
+  g_object_get (cache, "ready", &ready, NULL);
+  g_assert_true (ready);
+
+  return cache;
+}
+
+
+static char *
+get_cid (PhoshMetainfoCache *cache, const char *app_id)
+{
+  g_autofree char *data_id = phosh_metainfo_get_data_id (cache, app_id);
+  g_auto (GStrv) parts = NULL;
+
+  if (!data_id)
+    return NULL;
+
+  /* scope/bundle/origin/cid/branch */
+  parts = g_strsplit (data_id, "/", -1);
+  g_assert_cmpint (g_strv_length (parts), ==, 5);
+
+  return g_strdup (parts[3]);
+}
+
+
+static void
+test_phosh_metainfo_cache_data_id (MetainfoFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (PhoshMetainfoCache) cache = new_cache (fixture);
+  g_autofree char *cid = get_cid (cache, "example.desktop");
+
+  g_assert_cmpstr (cid, ==, "org.example.Foo");
+  g_assert_null (phosh_metainfo_get_data_id (cache, "doesnotexist.desktop"));
+
+  g_assert_true (g_file_test (fixture->index_path, G_FILE_TEST_EXISTS));
+}
+
+
+static void
+test_phosh_metainfo_cache_roundtrip (MetainfoFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (PhoshMetainfoCache) cache = NULL;
+  g_autoptr (GKeyFile) keyfile = g_key_file_new ();
+  g_autofree char *data_id = NULL;
+  g_autoptr (GError) err = NULL;
+
+  cache = new_cache (fixture);
+  g_clear_object (&cache);
+
+  /* Tamper with the persisted index, as the sources didn't change it must be used as is */
+  g_key_file_load_from_file (keyfile, fixture->index_path, G_KEY_FILE_NONE, &err);
+  g_assert_no_error (err);
+  g_key_file_set_string (keyfile, "launchables", "example.desktop", "from/the/index/cid/*");
+  g_key_file_save_to_file (keyfile, fixture->index_path, &err);
+  g_assert_no_error (err);
+
+  cache = new_cache (fixture);
+  data_id = phosh_metainfo_get_data_id (cache, "example.desktop");
+  g_assert_cmpstr (data_id, ==, "from/the/index/cid/*");
+}
+
+
+static void
+test_phosh_metainfo_cache_mtime (MetainfoFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (PhoshMetainfoCache) cache = NULL;
+  g_autofree char *cid = NULL;
+
+  cache = new_cache (fixture);
+  cid = get_cid (cache, "example.desktop");
+  g_assert_cmpstr (cid, ==, "org.example.Foo");
+  g_clear_object (&cache);
+  g_clear_pointer (&cid, g_free);
+
+  /* A modified source invalidates the index */
+  write_metainfo (fixture, "org.example.Bar", 2000000);
+
+  cache = new_cache (fixture);
+  cid = get_cid (cache, "example.desktop");
+  g_assert_cmpstr (cid, ==, "org.example.Bar");
+}
+
+
+static void
+test_phosh_metainfo_cache_incremental (MetainfoFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (PhoshMetainfoCache) cache = NULL;
+  g_autoptr (GKeyFile) keyfile = g_key_file_new ();
+  g_autofree char *other_path = NULL;
+  g_autofree char *other_group = NULL;
+  g_autofree char *other_content = NULL;
+  g_autofree char *data_id = NULL;
+  g_autofree char *cid = NULL;
+  g_autoptr (GError) err = NULL;
+  const char *tampered[] = { "from/the/index/cid/*", NULL };
+
+  other_path = g_build_filename (fixture->metainfo_dir, "org.example.Other.metainfo.xml", NULL);
+  other_content = g_strdup_printf (METAINFO_FMT, "org.example.Other");
+  g_file_set_contents (other_path, other_content, -1, &err);
+  g_assert_no_error (err);
+
+  cache = new_cache (fixture);
+  g_clear_object (&cache);
+
+  /* Tamper with what's recorded for the unchanged file */
+  g_key_file_load_from_file (keyfile, fixture->index_path, G_KEY_FILE_NONE, &err);
+  g_assert_no_error (err);
+  other_group = g_strconcat ("file:", other_path, NULL);
+  g_key_file_set_string_list (keyfile, other_group, "data-ids", tampered, 1);
+  g_key_file_save_to_file (keyfile, fixture->index_path, &err);
+  g_assert_no_error (err);
+
+  /* Only the modified file gets parsed again */
+  g_assert_cmpint (g_remove (fixture->metainfo_path), ==, 0);
+  cache = new_cache (fixture);
+  data_id = phosh_metainfo_get_data_id (cache, "example.desktop");
+  g_assert_cmpstr (data_id, ==, "from/the/index/cid/*");
+  g_clear_object (&cache);
+  g_clear_pointer (&data_id, g_free);
+
+  g_assert_cmpint (g_remove (other_path), ==, 0);
+  cache = new_cache (fixture);
+  cid = get_cid (cache, "example.desktop");
+  g_assert_null (cid);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add ("/phosh/metainfo-cache/data-id", MetainfoFixture, NULL,
+              metainfo_fixture_setup, test_phosh_metainfo_cache_data_id,
+              metainfo_fixture_teardown);
+  g_test_add ("/phosh/metainfo-cache/roundtrip", MetainfoFixture, NULL,
+              metainfo_fixture_setup, test_phosh_metainfo_cache_roundtrip,
+              metainfo_fixture_teardown);
+  g_test_add ("/phosh/metainfo-cache/mtime", MetainfoFixture, NULL,
+              metainfo_fixture_setup, test_phosh_metainfo_cache_mtime,
+              metainfo_fixture_teardown);
+  g_test_add ("/phosh/metainfo-cache/incremental", MetainfoFixture, NULL,
+              metainfo_fixture_setup, test_phosh_metainfo_cache_incremental,
+              metainfo_fixture_teardown);
+
+  return g_test_run ();
+}
@@ -229,6 +229,86 @@ test_phosh_notification_list_source_empty (void)
 }
 
 
+static void
+on_batch_items_changed (GListModel *list,
+                        guint       position,
+                        guint       removed,
+                        guint       added,
+                        gpointer    user_data)
+{
+  guint *n_emissions = user_data;
+
+  /* Sources are only ever moved to the top one at a time */
+  g_assert_cmpuint (removed, <=, 1);
+  g_assert_cmpuint (added, <=, 1);
+  if (added)
+    g_assert_cmpuint (position, ==, 0);
+
+  (*n_emissions)++;
+}
+
+
+static void
+test_phosh_notification_list_batch_updates (void)
+{
+  g_autoptr (PhoshNotificationList) list = NULL;
+  g_autoptr (GDateTime) now = g_date_time_new_now_local ();
+  g_autoptr (PhoshNotificationSource) source = NULL;
+  guint n_emissions = 0;
+  gboolean batch_updates;
+
+  list = phosh_notification_list_new ();
+  phosh_notification_list_set_batch_updates (list, TRUE);
+  g_object_get (list, "batch-updates", &batch_updates, NULL);
+  g_assert_true (batch_updates);
+
+  g_signal_connect (list, "items-changed", G_CALLBACK (on_batch_items_changed), &n_emissions);
+
+  for (guint i = 0; i < 10; i++) {
+    g_autoptr (PhoshNotification) noti = NULL;
+    g_autofree char *source_id = g_strdup_printf ("org.example.App%u", i % 3);
+
+    noti = phosh_notification_new (i, NULL, NULL, "Hey", "Testing", NULL, NULL,
+                                   PHOSH_NOTIFICATION_URGENCY_NORMAL, NULL,
+                                   FALSE, FALSE, NULL, NULL, now);
+    phosh_notification_list_add (list, source_id, noti);
+  }
+
+  /* Nothing emitted yet but sources are already known */
+  g_assert_cmpuint (n_emissions, ==, 0);
+  g_assert_nonnull (phosh_notification_list_get_source (list, "org.example.App1"));
+  g_assert_null (phosh_notification_list_get_source (list, "org.example.Unknown"));
+
+  while (g_main_context_iteration (NULL, FALSE));
+
+  /* One insertion per new source */
+  g_assert_cmpuint (n_emissions, ==, 3);
+  g_assert_cmpint (g_list_model_get_n_items (G_LIST_MODEL (list)), ==, 3);
+  g_assert_cmpuint (phosh_notification_list_get_n_coalesced (list), ==, 9);
+
+  /* Latest source on top */
+  source = g_list_model_get_item (G_LIST_MODEL (list), 0);
+  g_assert_cmpstr (phosh_notification_source_get_name (source), ==, "org.example.App0");
+  g_clear_object (&source);
+
+  /* Raising the bottom source only moves that one */
+  n_emissions = 0;
+  for (guint i = 10; i < 12; i++) {
+    g_autoptr (PhoshNotification) noti = NULL;
+
+    noti = phosh_notification_new (i, NULL, NULL, "Hey", "Testing", NULL, NULL,
+                                   PHOSH_NOTIFICATION_URGENCY_NORMAL, NULL,
+                                   FALSE, FALSE, NULL, NULL, now);
+    phosh_notification_list_add (list, "org.example.App1", noti);
+  }
+  while (g_main_context_iteration (NULL, FALSE));
+
+  g_assert_cmpuint (n_emissions, ==, 2);
+  source = g_list_model_get_item (G_LIST_MODEL (list), 0);
+  g_assert_cmpstr (phosh_notification_source_get_name (source), ==, "org.example.App1");
+}
+
+
 static void
 test_phosh_notification_list_seek (void)
 {
@@ -303,6 +383,7 @@ main (int argc, char **argv)
   g_test_add_func ("/phosh/notification-list/get-by", test_phosh_notification_list_get_by);
   g_test_add_func ("/phosh/notification-list/latest-on-top", test_phosh_notification_list_latest_on_top);
   g_test_add_func ("/phosh/notification-list/source-empty", test_phosh_notification_list_source_empty);
+  g_test_add_func ("/phosh/notification-list/batch-updates", test_phosh_notification_list_batch_updates);
   g_test_add_func ("/phosh/notification-list/seek", test_phosh_notification_list_seek);
 
   return g_test_run ();
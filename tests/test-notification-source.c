@@ -109,6 +109,48 @@ test_phosh_notification_source_close_invalid (void)
 }
 
 
+static void
+test_phosh_notification_source_collapse (void)
+{
+  g_autoptr (PhoshNotificationSource) source = NULL;
+  g_autoptr (GDateTime) now = g_date_time_new_now_local ();
+  g_autoptr (PhoshNotification) critical = NULL;
+  guint n_collapsed;
+
+  source = phosh_notification_source_new ("org.gnome.zbrown.KingsCross");
+
+  critical = phosh_notification_new (0, NULL, NULL, "Hey", "Critical", NULL, NULL,
+                                     PHOSH_NOTIFICATION_URGENCY_CRITICAL, NULL,
+                                     FALSE, FALSE, NULL, NULL, now);
+  phosh_notification_source_add (source, critical);
+
+  for (guint i = 1; i < 6; i++) {
+    g_autoptr (PhoshNotification) noti = NULL;
+
+    noti = phosh_notification_new (i, NULL, NULL, "Hey", "Testing", NULL, NULL,
+                                   PHOSH_NOTIFICATION_URGENCY_NORMAL, NULL,
+                                   FALSE, FALSE, NULL, NULL, now);
+    phosh_notification_source_add (source, noti);
+  }
+  g_assert_cmpint (g_list_model_get_n_items (G_LIST_MODEL (source)), ==, 6);
+
+  g_assert_cmpuint (phosh_notification_source_collapse (source, 10), ==, 0);
+  g_assert_cmpuint (phosh_notification_source_get_n_collapsed (source), ==, 0);
+
+  /* Critical notifications are kept */
+  g_assert_cmpuint (phosh_notification_source_collapse (source, 3), ==, 3);
+  g_assert_cmpint (g_list_model_get_n_items (G_LIST_MODEL (source)), ==, 3);
+  g_assert_cmpuint (phosh_notification_source_get_n_collapsed (source), ==, 3);
+  g_object_get (source, "n-collapsed", &n_collapsed, NULL);
+  g_assert_cmpuint (n_collapsed, ==, 3);
+
+  /* The newest notification is never collapsed */
+  g_assert_cmpuint (phosh_notification_source_collapse (source, 1), ==, 1);
+  g_assert_cmpint (g_list_model_get_n_items (G_LIST_MODEL (source)), ==, 2);
+  g_assert_cmpuint (phosh_notification_source_get_n_collapsed (source), ==, 4);
+}
+
+
 static void
 test_phosh_notification_source_set_prop_invalid (void)
 {
@@ -137,6 +179,7 @@ main (int argc, char **argv)
   g_test_add_func ("/phosh/notification-source/new", test_phosh_notification_source_new);
   g_test_add_func ("/phosh/notification-source/get", test_phosh_notification_source_get);
   g_test_add_func ("/phosh/notification-source/close-invalid", test_phosh_notification_source_close_invalid);
+  g_test_add_func ("/phosh/notification-source/collapse", test_phosh_notification_source_collapse);
   g_test_add_func ("/phosh/notification-source/set_prop_invalid", test_phosh_notification_source_set_prop_invalid);
   g_test_add_func ("/phosh/notification-source/get_prop_invalid", test_phosh_notification_source_get_prop_invalid);
 
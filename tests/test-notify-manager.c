@@ -14,6 +14,8 @@
 
 #include "testlib-full-shell.h"
 
+#include <string.h>
+
 #define BUS_NAME "org.freedesktop.Notifications"
 #define OBJECT_PATH "/org/freedesktop/Notifications"
 
@@ -149,6 +151,96 @@ test_phosh_notify_manager_server_notify (PhoshTestFullShellFixture *fixture, gco
 }
 
 
+static GVariant *
+new_image_data (int size, guchar value)
+{
+  g_autofree guchar *data = g_malloc (size * size * 4);
+
+  memset (data, value, size * size * 4);
+  return g_variant_new ("(iiibii@ay)", size, size, size * 4, TRUE, 8, 4,
+                        g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE, data, size * size * 4, 1));
+}
+
+
+static guint
+notify_with_image (PhoshDBusNotifications *proxy, GVariant *image_data)
+{
+  g_autoptr (GError) err = NULL;
+  const char *const * actions = (const char*[]){ NULL };
+  GVariantBuilder builder;
+  gboolean success;
+  guint id;
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+  g_variant_builder_add (&builder, "{sv}", "image-data", image_data);
+
+  success = phosh_dbus_notifications_call_notify_sync (proxy,
+                                                       "com.example.image",
+                                                       0,
+                                                       "",
+                                                       "Image",
+                                                       "",
+                                                       actions,
+                                                       g_variant_builder_end (&builder),
+                                                       -1,
+                                                       &id,
+                                                       NULL,
+                                                       &err);
+  g_assert_no_error (err);
+  g_assert_true (success);
+
+  return id;
+}
+
+
+static void
+test_phosh_notify_manager_server_image_data (PhoshTestFullShellFixture *fixture,
+                                             gconstpointer              unused)
+{
+  g_autoptr (GError) err = NULL;
+  g_autoptr (PhoshDBusNotifications) proxy = NULL;
+  PhoshNotificationList *list;
+  PhoshNotification *noti1, *noti2, *noti3;
+  GIcon *image1, *image2, *image3;
+  guint id1, id2, id3;
+
+  /* Wait until comp/shell are up */
+  g_assert_nonnull (g_async_queue_timeout_pop (fixture->queue, POP_TIMEOUT));
+
+  proxy = phosh_dbus_notifications_proxy_new_for_bus_sync (G_BUS_TYPE_SESSION,
+                                                           G_DBUS_PROXY_FLAGS_NONE,
+                                                           BUS_NAME,
+                                                           OBJECT_PATH,
+                                                           NULL,
+                                                           &err);
+  g_assert_no_error (err);
+
+  id1 = notify_with_image (proxy, new_image_data (512, 0x42));
+  id2 = notify_with_image (proxy, new_image_data (512, 0x42));
+  id3 = notify_with_image (proxy, new_image_data (512, 0x23));
+
+  /* phosh runs in another thread without locking, so careful */
+  list = phosh_notify_manager_get_list (phosh_notify_manager_get_default ());
+  noti1 = phosh_notification_list_get_by_id (list, id1);
+  noti2 = phosh_notification_list_get_by_id (list, id2);
+  noti3 = phosh_notification_list_get_by_id (list, id3);
+  g_assert_nonnull (noti1);
+  g_assert_nonnull (noti2);
+  g_assert_nonnull (noti3);
+
+  image1 = phosh_notification_get_image (noti1);
+  image2 = phosh_notification_get_image (noti2);
+  image3 = phosh_notification_get_image (noti3);
+  g_assert_true (GDK_IS_PIXBUF (image1));
+  /* Scaled down once */
+  g_assert_cmpint (gdk_pixbuf_get_width (GDK_PIXBUF (image1)), ==, 128);
+  g_assert_cmpint (gdk_pixbuf_get_height (GDK_PIXBUF (image1)), ==, 128);
+  /* Identical images are shared */
+  g_assert_true (image1 == image2);
+  g_assert_false (image1 == image3);
+}
+
+
 int
 main (int argc, char *argv[])
 {
@@ -167,6 +259,9 @@ main (int argc, char *argv[])
   PHOSH_FULL_SHELL_TEST_ADD ("/phosh/dbus/notify-manager/notify",
                              cfg,
                              test_phosh_notify_manager_server_notify);
+  PHOSH_FULL_SHELL_TEST_ADD ("/phosh/dbus/notify-manager/image-data",
+                             cfg,
+                             test_phosh_notify_manager_server_image_data);
 
   return g_test_run ();
 }
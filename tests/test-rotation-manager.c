@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "shell-priv.h"
+#include "monitor-manager.h"
+#include "rotation-manager.h"
+
+#include "testlib-full-shell.h"
+
+#define POP_TIMEOUT 50000000
+
+typedef struct {
+  GAsyncQueue          *results;
+  PhoshRotationManager *rotation_manager;
+  PhoshMonitor         *monitor;
+  guint                 n_configs;
+} RotationTestData;
+
+
+static void
+on_config_pending_changed (RotationTestData    *data,
+                           GParamSpec          *pspec,
+                           PhoshMonitorManager *monitor_manager)
+{
+  if (phosh_monitor_manager_get_config_pending (monitor_manager)) {
+    data->n_configs++;
+    return;
+  }
+
+  if (phosh_monitor_get_transform (data->monitor) != PHOSH_MONITOR_TRANSFORM_270)
+    return;
+
+  g_signal_handlers_disconnect_by_data (monitor_manager, data);
+  g_async_queue_push (data->results, GUINT_TO_POINTER (data->n_configs));
+}
+
+
+static gboolean
+rotate_queued (gpointer user_data)
+{
+  RotationTestData *data = user_data;
+  PhoshShell *shell = phosh_shell_get_default ();
+  PhoshMonitorManager *monitor_manager = phosh_shell_get_monitor_manager (shell);
+
+  data->rotation_manager = phosh_shell_get_rotation_manager (shell);
+  g_assert_true (PHOSH_IS_ROTATION_MANAGER (data->rotation_manager));
+  data->monitor = phosh_rotation_manager_get_monitor (data->rotation_manager);
+  g_assert_true (PHOSH_IS_MONITOR (data->monitor));
+  g_assert_false (phosh_monitor_manager_get_config_pending (monitor_manager));
+
+  phosh_rotation_manager_set_mode (data->rotation_manager, PHOSH_ROTATION_MANAGER_MODE_OFF);
+  g_signal_connect_swapped (monitor_manager, "notify::config-pending",
+                            G_CALLBACK (on_config_pending_changed), data);
+
+  phosh_rotation_manager_set_transform (data->rotation_manager, PHOSH_MONITOR_TRANSFORM_90);
+  g_assert_true (phosh_monitor_manager_get_config_pending (monitor_manager));
+
+  /* Queued while the first configuration is in flight, the last one wins */
+  phosh_rotation_manager_set_transform (data->rotation_manager, PHOSH_MONITOR_TRANSFORM_180);
+  phosh_rotation_manager_set_transform (data->rotation_manager, PHOSH_MONITOR_TRANSFORM_270);
+  g_assert_cmpint (phosh_monitor_get_transform (data->monitor), !=, PHOSH_MONITOR_TRANSFORM_270);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static void
+test_phosh_rotation_manager_queue (PhoshTestFullShellFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (GAsyncQueue) results = g_async_queue_new ();
+  RotationTestData data = { .results = results };
+  gpointer n_configs;
+
+  /* Wait until comp/shell are up */
+  g_assert_nonnull (g_async_queue_timeout_pop (fixture->queue, POP_TIMEOUT));
+
+  gdk_threads_add_idle (rotate_queued, &data);
+
+  /* The queued transform got flushed once the first configuration was done */
+  n_configs = g_async_queue_timeout_pop (results, POP_TIMEOUT);
+  g_assert_nonnull (n_configs);
+  /* The superseded transform was never applied */
+  g_assert_cmpuint (GPOINTER_TO_UINT (n_configs), ==, 2);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  g_autoptr (PhoshTestFullShellFixtureCfg) cfg = NULL;
+
+  g_test_init (&argc, &argv, NULL);
+
+  cfg = phosh_test_full_shell_fixture_cfg_new ("phosh-rotation-manager");
+
+  PHOSH_FULL_SHELL_TEST_ADD ("/phosh/rotation-manager/queue", cfg,
+                             test_phosh_rotation_manager_queue);
+
+  return g_test_run ();
+}
@@ -9,6 +9,8 @@
 #include "searchd/search-provider.c"
 #include <gio/gio.h>
 
+#include <string.h>
+
 #define DESKTOP_APP_ID "org.gnome.Phosh.desktop"
 #define BUS_NAME "org.gnome.Phosh.MockSearchProvider"
 #define BUS_PATH "/org/gnome/Phosh/MockSearchProvider"
@@ -35,6 +37,7 @@ fixture_setup (TestFixture *fixture, gconstpointer unused)
                                                  BUS_NAME,
                                                  TRUE,
                                                  FALSE);
+  phosh_search_provider_ensure_proxy (fixture->provider);
 
   g_assert_null (fixture->mainloop);
   fixture->mainloop = g_main_loop_new (NULL, FALSE);
@@ -111,6 +114,31 @@ test_phosh_search_provider_new (TestFixture *fixture, gconstpointer unused)
 }
 
 
+static void
+test_phosh_search_provider_lazy (TestFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (PhoshSearchProvider) provider = NULL;
+  PhoshSearchProviderPrivate *priv;
+
+  provider = phosh_search_provider_new (DESKTOP_APP_ID, NULL, BUS_PATH, BUS_NAME, TRUE, FALSE);
+  priv = phosh_search_provider_get_instance_private (provider);
+
+  /* No proxy until it's needed */
+  g_assert_false (phosh_search_provider_get_ready (provider));
+  g_assert_false (priv->proxy_pending);
+
+  g_signal_connect_swapped (provider, "ready", (GCallback)g_main_loop_quit, fixture->mainloop);
+  phosh_search_provider_ensure_proxy (provider);
+  g_assert_true (priv->proxy_pending);
+  /* Creating the proxy is only done once */
+  phosh_search_provider_ensure_proxy (provider);
+  g_main_loop_run (fixture->mainloop);
+
+  g_assert_true (phosh_search_provider_get_ready (provider));
+  g_assert_false (priv->proxy_pending);
+}
+
+
 static void
 test_phosh_search_provider_get_bus_path (TestFixture *fixture, gconstpointer unused)
 {
@@ -187,6 +215,188 @@ test_phosh_search_provider_get_result_meta_async (TestFixture *fixture, gconstpo
 }
 
 
+static void
+test_phosh_search_provider_get_result_meta_cached (TestFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (GPtrArray) first = NULL;
+  guint hits, misses;
+
+  g_clear_pointer (&result_metas, g_ptr_array_unref);
+
+  g_signal_connect_swapped (fixture->provider, "ready", (GCallback)g_main_loop_quit, fixture->mainloop);
+  g_main_loop_run (fixture->mainloop);
+
+  phosh_search_provider_get_result_meta (fixture->provider, final_results, got_result_metas, fixture);
+  g_main_loop_run (fixture->mainloop);
+  first = g_steal_pointer (&result_metas);
+  g_assert_cmpint (first->len, ==, 2);
+
+  phosh_search_provider_get_cache_stats (fixture->provider, &hits, &misses);
+  g_assert_cmpuint (hits, ==, 0);
+  g_assert_cmpuint (misses, ==, 2);
+
+  /* Second lookup is served from the cache */
+  fixture->got_metas_finished = FALSE;
+  phosh_search_provider_get_result_meta (fixture->provider, final_results, got_result_metas, fixture);
+  g_main_loop_run (fixture->mainloop);
+  g_assert_true (fixture->got_metas_finished);
+  g_assert_cmpint (result_metas->len, ==, 2);
+  for (guint i = 0; i < first->len; i++)
+    g_assert_true (g_ptr_array_index (first, i) == g_ptr_array_index (result_metas, i));
+
+  phosh_search_provider_get_cache_stats (fixture->provider, &hits, &misses);
+  g_assert_cmpuint (hits, ==, 2);
+  g_assert_cmpuint (misses, ==, 2);
+
+  phosh_search_provider_clear_cache (fixture->provider);
+  g_assert_null (meta_cache_lookup (fixture->provider,
+                                    phosh_search_result_meta_get_id (g_ptr_array_index (first, 0))));
+}
+
+
+static GIcon *
+intern_test_icon (PhoshSearchProvider *provider, guint8 value)
+{
+  guint8 pixels[2 * 2 * 3];
+  g_autoptr (GVariant) icon_data = NULL;
+
+  memset (pixels, value, sizeof (pixels));
+  icon_data = g_variant_ref_sink (g_variant_new ("(iiibii@ay)", 2, 2, 6, FALSE, 8, 3,
+                                                 g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE,
+                                                                            pixels,
+                                                                            sizeof (pixels),
+                                                                            1)));
+  return intern_icon_data (provider, icon_data);
+}
+
+
+static void
+insert_test_meta (PhoshSearchProvider *provider, const char *id, GIcon *icon)
+{
+  PhoshSearchResultMeta *meta = phosh_search_result_meta_new (id, id, NULL, icon, NULL);
+
+  meta_cache_insert (provider, meta);
+  phosh_search_result_meta_unref (meta);
+}
+
+
+static void
+test_phosh_search_provider_icon_store (TestFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (GIcon) icon_a = NULL;
+  g_autoptr (GIcon) icon_b = NULL;
+  g_autoptr (GIcon) icon_b2 = NULL;
+  g_autofree char *path_a = NULL;
+  g_autofree char *path_b = NULL;
+
+  icon_a = intern_test_icon (fixture->provider, 0x00);
+  icon_b = intern_test_icon (fixture->provider, 0xff);
+  /* Same content is interned once */
+  icon_b2 = intern_test_icon (fixture->provider, 0xff);
+  g_assert_true (icon_b == icon_b2);
+  g_assert_cmpuint (phosh_search_provider_get_n_interned_icons (), ==, 2);
+
+  g_assert_true (G_IS_FILE_ICON (icon_a));
+  path_a = g_file_get_path (g_file_icon_get_file (G_FILE_ICON (icon_a)));
+  path_b = g_file_get_path (g_file_icon_get_file (G_FILE_ICON (icon_b)));
+  g_assert_true (g_file_test (path_a, G_FILE_TEST_EXISTS));
+  g_assert_true (g_file_test (path_b, G_FILE_TEST_EXISTS));
+
+  insert_test_meta (fixture->provider, "a", icon_a);
+  insert_test_meta (fixture->provider, "b1", icon_b);
+  insert_test_meta (fixture->provider, "b2", icon_b);
+
+  /* Evicting the only result using an icon drops it and its file */
+  for (int i = 0; i < META_CACHE_SIZE - 2; i++) {
+    g_autofree char *id = g_strdup_printf ("filler-%d", i);
+
+    insert_test_meta (fixture->provider, id, NULL);
+  }
+  g_assert_cmpuint (phosh_search_provider_get_n_interned_icons (), ==, 1);
+  g_assert_false (g_file_test (path_a, G_FILE_TEST_EXISTS));
+  g_assert_true (g_file_test (path_b, G_FILE_TEST_EXISTS));
+
+  /* An icon is kept as long as any cached result uses it */
+  insert_test_meta (fixture->provider, "filler-b1", NULL);
+  g_assert_cmpuint (phosh_search_provider_get_n_interned_icons (), ==, 1);
+  g_assert_true (g_file_test (path_b, G_FILE_TEST_EXISTS));
+
+  phosh_search_provider_clear_cache (fixture->provider);
+  g_assert_cmpuint (phosh_search_provider_get_n_interned_icons (), ==, 0);
+  g_assert_false (g_file_test (path_b, G_FILE_TEST_EXISTS));
+
+  phosh_search_provider_clear_icon_store ();
+}
+
+
+static void
+test_phosh_search_provider_latency (TestFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (GVariant) stats = NULL;
+  guint p50, p95, samples, missed;
+  gboolean demoted;
+
+  for (int i = 1; i <= 10; i++)
+    record_latency (fixture->provider, i * 10 * 1000, FALSE);
+  g_assert_false (phosh_search_provider_get_demoted (fixture->provider));
+
+  stats = g_variant_ref_sink (phosh_search_provider_get_latency_stats (fixture->provider));
+  g_assert_true (g_variant_lookup (stats, "p50", "u", &p50));
+  g_assert_true (g_variant_lookup (stats, "p95", "u", &p95));
+  g_assert_true (g_variant_lookup (stats, "samples", "u", &samples));
+  g_assert_cmpuint (p50, ==, 50);
+  g_assert_cmpuint (p95, ==, 90);
+  g_assert_cmpuint (samples, ==, 10);
+
+  /* Repeatedly missing the deadline demotes the provider */
+  record_latency (fixture->provider, SEARCH_DEADLINE_MS * 1000, TRUE);
+  record_latency (fixture->provider, SEARCH_DEADLINE_MS * 1000, TRUE);
+  g_assert_false (phosh_search_provider_get_demoted (fixture->provider));
+  record_latency (fixture->provider, SEARCH_DEADLINE_MS * 1000, TRUE);
+  g_assert_true (phosh_search_provider_get_demoted (fixture->provider));
+
+  g_clear_pointer (&stats, g_variant_unref);
+  stats = g_variant_ref_sink (phosh_search_provider_get_latency_stats (fixture->provider));
+  g_assert_true (g_variant_lookup (stats, "missed", "u", &missed));
+  g_assert_true (g_variant_lookup (stats, "demoted", "b", &demoted));
+  g_assert_cmpuint (missed, ==, 3);
+  g_assert_true (demoted);
+
+  /* A timely answer lifts the demotion */
+  record_latency (fixture->provider, 10 * 1000, FALSE);
+  g_assert_false (phosh_search_provider_get_demoted (fixture->provider));
+}
+
+
+static void
+test_phosh_search_provider_deadline (TestFixture *fixture, gconstpointer unused)
+{
+  PhoshSearchProviderPrivate *priv = phosh_search_provider_get_instance_private (fixture->provider);
+  g_autoptr (GCancellable) pending = g_object_ref (priv->cancellable);
+  g_autoptr (GTask) slow = NULL;
+  g_autoptr (GTask) other = NULL;
+  guint deadline_id;
+
+  slow = search_task_new (fixture->provider, phosh_search_provider_get_initial, NULL, NULL);
+  other = search_task_new (fixture->provider, phosh_search_provider_get_initial, NULL, NULL);
+
+  /* A missed deadline only cancels that search */
+  deadline_id = ((SearchData *) g_task_get_task_data (slow))->deadline_id;
+  on_search_deadline (slow);
+  g_source_remove (deadline_id);
+  g_assert_true (g_cancellable_is_cancelled (g_task_get_cancellable (slow)));
+  g_assert_false (g_cancellable_is_cancelled (g_task_get_cancellable (other)));
+  g_assert_false (g_cancellable_is_cancelled (pending));
+
+  /* A new query still cancels all of them */
+  cancel_pending (fixture->provider);
+  g_assert_true (g_cancellable_is_cancelled (g_task_get_cancellable (other)));
+
+  g_assert_true (g_task_return_error_if_cancelled (slow));
+  g_assert_true (g_task_return_error_if_cancelled (other));
+}
+
+
 static void
 test_phosh_search_provider_limit_results (TestFixture *fixture, gconstpointer unused)
 {
@@ -231,6 +441,11 @@ main (gint argc, char *argv[])
               test_phosh_search_provider_new,
               fixture_teardown);
 
+  g_test_add ("/phosh/search-provider/lazy", TestFixture, NULL,
+              fixture_setup,
+              test_phosh_search_provider_lazy,
+              fixture_teardown);
+
   g_test_add ("/phosh/search-provider/get_bus_path", TestFixture, NULL,
               fixture_setup,
               test_phosh_search_provider_get_bus_path,
@@ -251,6 +466,26 @@ main (gint argc, char *argv[])
               test_phosh_search_provider_get_result_meta_async,
               fixture_teardown);
 
+  g_test_add ("/phosh/search-provider/get_result_meta_cached", TestFixture, NULL,
+              fixture_setup,
+              test_phosh_search_provider_get_result_meta_cached,
+              fixture_teardown);
+
+  g_test_add ("/phosh/search-provider/icon-store", TestFixture, NULL,
+              fixture_setup,
+              test_phosh_search_provider_icon_store,
+              fixture_teardown);
+
+  g_test_add ("/phosh/search-provider/latency", TestFixture, NULL,
+              fixture_setup,
+              test_phosh_search_provider_latency,
+              fixture_teardown);
+
+  g_test_add ("/phosh/search-provider/deadline", TestFixture, NULL,
+              fixture_setup,
+              test_phosh_search_provider_deadline,
+              fixture_teardown);
+
   g_test_add ("/phosh/search-provider/limit_results", TestFixture, NULL,
               fixture_setup,
               test_phosh_search_provider_limit_results,
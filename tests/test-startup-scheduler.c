@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "startup-scheduler.h"
+
+typedef struct {
+  GString  *order;
+  gboolean  finished;
+} Fixture;
+
+
+static void
+append_name (Fixture *fixture, const char *name)
+{
+  if (fixture->order->len)
+    g_string_append_c (fixture->order, ',');
+  g_string_append (fixture->order, name);
+}
+
+
+static void
+task_a (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  append_name (user_data, "a");
+}
+
+
+static void
+task_b (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  append_name (user_data, "b");
+}
+
+
+static void
+task_c (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  append_name (user_data, "c");
+}
+
+
+static void
+task_d (PhoshStartupScheduler *scheduler, gpointer user_data)
+{
+  append_name (user_data, "d");
+}
+
+
+static void
+on_finished (Fixture *fixture)
+{
+  fixture->finished = TRUE;
+}
+
+
+static void
+iterate (void)
+{
+  while (g_main_context_iteration (NULL, FALSE));
+}
+
+
+static void
+fixture_setup (Fixture *fixture, gconstpointer unused)
+{
+  fixture->order = g_string_new (NULL);
+  fixture->finished = FALSE;
+}
+
+
+static void
+fixture_teardown (Fixture *fixture, gconstpointer unused)
+{
+  g_string_free (fixture->order, TRUE);
+}
+
+
+static void
+test_phosh_startup_scheduler_order (Fixture *fixture, gconstpointer unused)
+{
+  g_autoptr (PhoshStartupScheduler) scheduler = phosh_startup_scheduler_new ();
+  const char *deps_c[] = { "b", NULL };
+
+  g_signal_connect_swapped (scheduler, "finished", G_CALLBACK (on_finished), fixture);
+
+  /* c depends on b which is added later */
+  phosh_startup_scheduler_add_task (scheduler, "c", deps_c, 0, task_c, fixture);
+  phosh_startup_scheduler_add_task (scheduler, "a", NULL, 0, task_a, fixture);
+  phosh_startup_scheduler_add_task (scheduler, "b", NULL, 0, task_b, fixture);
+
+  /* Nothing happens before run */
+  iterate ();
+  g_assert_cmpstr (fixture->order->str, ==, "");
+
+  phosh_startup_scheduler_run (scheduler);
+  iterate ();
+  g_assert_cmpstr (fixture->order->str, ==, "a,b,c");
+  g_assert_true (fixture->finished);
+  g_assert_true (phosh_startup_scheduler_is_finished (scheduler));
+}
+
+
+static void
+test_phosh_startup_scheduler_async (Fixture *fixture, gconstpointer unused)
+{
+  g_autoptr (PhoshStartupScheduler) scheduler = phosh_startup_scheduler_new ();
+  g_autoptr (GVariant) path = NULL;
+  const char *deps_b[] = { "a", NULL };
+  const char *name;
+  gint64 start, end;
+
+  g_signal_connect_swapped (scheduler, "finished", G_CALLBACK (on_finished), fixture);
+
+  phosh_startup_scheduler_add_task (scheduler, "a", NULL, PHOSH_STARTUP_TASK_FLAG_ASYNC,
+                                    task_a, fixture);
+  phosh_startup_scheduler_add_task (scheduler, "b", deps_b, 0, task_b, fixture);
+  phosh_startup_scheduler_add_task (scheduler, "c", NULL, 0, task_c, fixture);
+  phosh_startup_scheduler_run (scheduler);
+  iterate ();
+
+  /* Independent tasks proceed while a is pending */
+  g_assert_cmpstr (fixture->order->str, ==, "a,c");
+  g_assert_false (fixture->finished);
+
+  phosh_startup_scheduler_complete (scheduler, "a");
+  iterate ();
+  g_assert_cmpstr (fixture->order->str, ==, "a,c,b");
+  g_assert_true (fixture->finished);
+
+  path = g_variant_ref_sink (phosh_startup_scheduler_get_critical_path (scheduler));
+  g_assert_cmpint (g_variant_n_children (path), ==, 2);
+  g_variant_get_child (path, 0, "(&sxx)", &name, &start, &end);
+  g_assert_cmpstr (name, ==, "a");
+  g_assert_cmpint (end, >=, start);
+  g_variant_get_child (path, 1, "(&sxx)", &name, &start, &end);
+  g_assert_cmpstr (name, ==, "b");
+}
+
+
+static void
+test_phosh_startup_scheduler_deferred (Fixture *fixture, gconstpointer unused)
+{
+  g_autoptr (PhoshStartupScheduler) scheduler = phosh_startup_scheduler_new ();
+
+  g_signal_connect_swapped (scheduler, "finished", G_CALLBACK (on_finished), fixture);
+
+  phosh_startup_scheduler_add_task (scheduler, "d", NULL, PHOSH_STARTUP_TASK_FLAG_DEFERRED,
+                                    task_d, fixture);
+  phosh_startup_scheduler_add_task (scheduler, "a", NULL, 0, task_a, fixture);
+  phosh_startup_scheduler_run (scheduler);
+  iterate ();
+
+  /* Deferred tasks don't block finishing */
+  g_assert_cmpstr (fixture->order->str, ==, "a");
+  g_assert_true (fixture->finished);
+
+  phosh_startup_scheduler_release_deferred (scheduler);
+  iterate ();
+  g_assert_cmpstr (fixture->order->str, ==, "a,d");
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add ("/phosh/startup-scheduler/order", Fixture, NULL,
+              fixture_setup, test_phosh_startup_scheduler_order, fixture_teardown);
+  g_test_add ("/phosh/startup-scheduler/async", Fixture, NULL,
+              fixture_setup, test_phosh_startup_scheduler_async, fixture_teardown);
+  g_test_add ("/phosh/startup-scheduler/deferred", Fixture, NULL,
+              fixture_setup, test_phosh_startup_scheduler_deferred, fixture_teardown);
+
+  return g_test_run ();
+}
@@ -6,7 +6,44 @@
  * Author: Guido Günther <agx@sigxcpu.org>
  */
 
-#include "status-icon.h"
+#include "status-icon-priv.h"
+
+
+#define PHOSH_TYPE_TEST_STATUS_ICON (phosh_test_status_icon_get_type ())
+G_DECLARE_FINAL_TYPE (PhoshTestStatusIcon, phosh_test_status_icon, PHOSH, TEST_STATUS_ICON,
+                      PhoshStatusIcon)
+
+struct _PhoshTestStatusIcon {
+  PhoshStatusIcon parent;
+
+  guint           n_updates;
+};
+G_DEFINE_TYPE (PhoshTestStatusIcon, phosh_test_status_icon, PHOSH_TYPE_STATUS_ICON)
+
+
+static void
+phosh_test_status_icon_update (PhoshStatusIcon *icon)
+{
+  PhoshTestStatusIcon *self = PHOSH_TEST_STATUS_ICON (icon);
+
+  self->n_updates++;
+  phosh_status_icon_set_icon_name (icon, "test-symbolic");
+}
+
+
+static void
+phosh_test_status_icon_class_init (PhoshTestStatusIconClass *klass)
+{
+  PhoshStatusIconClass *status_icon_class = PHOSH_STATUS_ICON_CLASS (klass);
+
+  status_icon_class->update = phosh_test_status_icon_update;
+}
+
+
+static void
+phosh_test_status_icon_init (PhoshTestStatusIcon *self)
+{
+}
 
 static void
 test_phosh_status_icon_new (void)
@@ -128,6 +165,54 @@ test_phosh_status_icon_extra_widget (void)
 }
 
 
+static guint64
+lookup_stat (GVariant *stats, const char *key)
+{
+  guint64 value = 0;
+
+  g_assert_true (g_variant_lookup (stats, key, "t", &value));
+  return value;
+}
+
+
+static void
+test_phosh_status_icon_queue_update (void)
+{
+  PhoshTestStatusIcon *icon;
+  g_autoptr (GVariant) before = NULL;
+  g_autoptr (GVariant) after = NULL;
+  g_autofree char *icon_name = NULL;
+
+  icon = g_object_ref_sink (g_object_new (PHOSH_TYPE_TEST_STATUS_ICON, NULL));
+  before = g_variant_ref_sink (phosh_status_icon_get_update_stats ());
+
+  for (int i = 0; i < 5; i++)
+    phosh_status_icon_queue_update (PHOSH_STATUS_ICON (icon));
+  g_assert_cmpuint (icon->n_updates, ==, 0);
+
+  while (g_main_context_iteration (NULL, FALSE));
+  g_assert_cmpuint (icon->n_updates, ==, 1);
+  icon_name = phosh_status_icon_get_icon_name (PHOSH_STATUS_ICON (icon));
+  g_assert_cmpstr (icon_name, ==, "test-symbolic");
+
+  /* Same icon again, nothing to update */
+  phosh_status_icon_queue_update (PHOSH_STATUS_ICON (icon));
+  while (g_main_context_iteration (NULL, FALSE));
+  g_assert_cmpuint (icon->n_updates, ==, 2);
+
+  after = g_variant_ref_sink (phosh_status_icon_get_update_stats ());
+  g_assert_cmpuint (lookup_stat (after, "queued") - lookup_stat (before, "queued"), ==, 6);
+  g_assert_cmpuint (lookup_stat (after, "coalesced") - lookup_stat (before, "coalesced"), ==, 4);
+  g_assert_cmpuint (lookup_stat (after, "updates") - lookup_stat (before, "updates"), ==, 2);
+  g_assert_cmpuint (lookup_stat (after, "unchanged") - lookup_stat (before, "unchanged"), ==, 1);
+
+  /* Pending updates are dropped on destroy */
+  phosh_status_icon_queue_update (PHOSH_STATUS_ICON (icon));
+  gtk_widget_destroy (GTK_WIDGET (icon));
+  g_object_unref (icon);
+  while (g_main_context_iteration (NULL, FALSE));
+}
+
 
 int
 main (int   argc,
@@ -140,6 +225,7 @@ main (int   argc,
   g_test_add_func("/phosh/status-icon/pixel-size", test_phosh_status_icon_pixel_size);
   g_test_add_func("/phosh/status-icon/icon-name", test_phosh_status_icon_icon_name);
   g_test_add_func("/phosh/status-icon/extra-widget", test_phosh_status_icon_extra_widget);
+  g_test_add_func("/phosh/status-icon/queue-update", test_phosh_status_icon_queue_update);
 
   return g_test_run();
 }
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "timeline.h"
+
+#include <unistd.h>
+
+
+static void
+test_phosh_timeline_spans (void)
+{
+  g_autoptr (GVariant) spans = NULL;
+  const char *category, *name;
+  gint64 start, end;
+  gint64 ts;
+
+  phosh_timeline_reset ();
+
+  ts = phosh_timeline_begin ();
+  phosh_timeline_end (ts, "manager", "foo-manager");
+  phosh_timeline_add_span ("plugin", "bar", 10, 20);
+  /* End before start gets clamped */
+  phosh_timeline_add_span ("plugin", "baz", 20, 10);
+
+  spans = g_variant_ref_sink (phosh_timeline_get_spans ());
+  g_assert_cmpint (g_variant_n_children (spans), ==, 3);
+
+  g_variant_get_child (spans, 0, "(&s&sxx)", &category, &name, &start, &end);
+  g_assert_cmpstr (category, ==, "manager");
+  g_assert_cmpstr (name, ==, "foo-manager");
+  g_assert_cmpint (start, ==, ts);
+  g_assert_cmpint (end, >=, start);
+
+  g_variant_get_child (spans, 1, "(&s&sxx)", &category, &name, &start, &end);
+  g_assert_cmpstr (category, ==, "plugin");
+  g_assert_cmpstr (name, ==, "bar");
+  g_assert_cmpint (start, ==, 10);
+  g_assert_cmpint (end, ==, 20);
+
+  g_variant_get_child (spans, 2, "(&s&sxx)", &category, &name, &start, &end);
+  g_assert_cmpint (end, ==, start);
+
+  phosh_timeline_reset ();
+}
+
+
+static void
+test_phosh_timeline_limit (void)
+{
+  g_autoptr (GVariant) spans = NULL;
+  guint n;
+
+  phosh_timeline_reset ();
+
+  for (n = 0; phosh_timeline_is_recording (); n++)
+    phosh_timeline_add_span ("test", "span", n, n + 1);
+
+  g_assert_cmpint (phosh_timeline_get_n_dropped (), ==, 0);
+  phosh_timeline_add_span ("test", "dropped", 0, 1);
+  g_assert_cmpint (phosh_timeline_get_n_dropped (), ==, 1);
+
+  spans = g_variant_ref_sink (phosh_timeline_get_spans ());
+  g_assert_cmpint (g_variant_n_children (spans), ==, n);
+
+  phosh_timeline_reset ();
+  g_assert_true (phosh_timeline_is_recording ());
+  g_assert_cmpint (phosh_timeline_get_n_dropped (), ==, 0);
+}
+
+
+static void
+test_phosh_timeline_chrome_trace (void)
+{
+  g_autofree char *trace = NULL;
+  g_autofree char *expected = NULL;
+
+  phosh_timeline_reset ();
+
+  trace = phosh_timeline_to_chrome_trace ();
+  g_assert_cmpstr (trace, ==, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[]}");
+  g_clear_pointer (&trace, g_free);
+
+  phosh_timeline_add_span ("first-frame", "a \"quoted\"\\name", 100, 250);
+  trace = phosh_timeline_to_chrome_trace ();
+
+  expected = g_strdup_printf ("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["
+                              "{\"name\":\"a \\\"quoted\\\"\\\\name\",\"cat\":\"first-frame\","
+                              "\"ph\":\"X\",\"ts\":100,\"dur\":150,\"pid\":%d,\"tid\":%d}]}",
+                              getpid (), getpid ());
+  g_assert_cmpstr (trace, ==, expected);
+
+  phosh_timeline_reset ();
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/phosh/timeline/spans", test_phosh_timeline_spans);
+  g_test_add_func ("/phosh/timeline/limit", test_phosh_timeline_limit);
+  g_test_add_func ("/phosh/timeline/chrome-trace", test_phosh_timeline_chrome_trace);
+
+  return g_test_run ();
+}
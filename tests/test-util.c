@@ -43,6 +43,80 @@ test_phosh_util_escape_markup (void)
 }
 
 
+/* The former regex based implementation, used as reference */
+static char *
+escape_markup_regex (const char *markup)
+{
+  g_autoptr (GRegex) amp_re = NULL;
+  g_autoptr (GRegex) elem_re = NULL;
+  g_autofree char *amp_esc = NULL;
+  g_autofree char *escaped = NULL;
+
+  amp_re = g_regex_new ("&(?!amp;|quot;|apos;|lt;|gt;)", G_REGEX_DEFAULT, 0, NULL);
+  g_assert_nonnull (amp_re);
+  amp_esc = g_regex_replace_literal (amp_re, markup, -1, 0, "&amp;", 0, NULL);
+  g_assert_nonnull (amp_esc);
+
+  elem_re = g_regex_new ("<(?!/?[biu]>)", G_REGEX_DEFAULT, 0, NULL);
+  g_assert_nonnull (elem_re);
+  escaped = g_regex_replace_literal (elem_re, amp_esc, -1, 0, "&lt;", 0, NULL);
+  g_assert_nonnull (escaped);
+
+  if (pango_parse_markup (escaped, -1, 0, NULL, NULL, NULL, NULL))
+    return g_steal_pointer (&escaped);
+
+  return g_markup_escape_text (markup, -1);
+}
+
+
+static void
+test_phosh_util_escape_markup_differential (void)
+{
+  const char *pieces[] = {
+    "<", ">", "&", "/", ";", "b", "i", "u", "p", "<b>", "</b>", "<i>", "</i>", "<u>", "</u>",
+    "&amp;", "&lt;", "&gt;", "&quot;", "&apos;", "&foo;", "&#42;", "amp", "lt;", " ", "ä", "€",
+  };
+  const char *inputs[] = {
+    "",
+    "plain text",
+    "<b><i>nested</i></b>",
+    "<b><i>crossed</b></i>",
+    "<b>unclosed",
+    "closed</u>",
+    "<b/>",
+    "< b>",
+    "<B>upper</B>",
+    "&&&amp;&amp",
+    "trailing <",
+    "trailing </",
+    "trailing &",
+    "Tom & Jerry <3 <b>bold</b> & <a href=\"x\">link</a>",
+  };
+
+  for (int i = 0; i < G_N_ELEMENTS (inputs); i++) {
+    g_autofree char *expected = escape_markup_regex (inputs[i]);
+    g_autofree char *escaped = phosh_util_escape_markup (inputs[i], TRUE);
+
+    g_assert_cmpstr (escaped, ==, expected);
+  }
+
+  /* Random concatenations of the interesting bits */
+  for (int i = 0; i < 2000; i++) {
+    g_autoptr (GString) input = g_string_new (NULL);
+    g_autofree char *expected = NULL;
+    g_autofree char *escaped = NULL;
+    int len = g_test_rand_int_range (0, 24);
+
+    for (int j = 0; j < len; j++)
+      g_string_append (input, pieces[g_test_rand_int_range (0, G_N_ELEMENTS (pieces))]);
+
+    expected = escape_markup_regex (input->str);
+    escaped = phosh_util_escape_markup (input->str, TRUE);
+    g_assert_cmpstr (escaped, ==, expected);
+  }
+}
+
+
 static void
 test_phosh_util_data_uri_to_pixbuf (void)
 {
@@ -136,6 +210,8 @@ main (int argc, char *argv[])
   gtk_test_init (&argc, &argv, NULL);
 
   g_test_add_func ("/phosh/util/escacpe-markup", test_phosh_util_escape_markup);
+  g_test_add_func ("/phosh/util/escape-markup/differential",
+                   test_phosh_util_escape_markup_differential);
   g_test_add_func ("/phosh/util/data-uri-to-pixbuf", test_phosh_util_data_uri_to_pixbuf);
   g_test_add_func ("/phosh/util/scale/integer",
                    test_phosh_util_calculate_supported_mode_scales_integer);
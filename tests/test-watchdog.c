@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "watchdog.h"
+
+
+static gboolean
+on_idle_stall (gpointer data)
+{
+  gboolean *done = data;
+
+  g_usleep (20 * 1000);
+  *done = TRUE;
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static void
+test_phosh_watchdog_stall (void)
+{
+  g_autoptr (GVariant) stats = NULL;
+  g_autoptr (GVariant) recent = NULL;
+  g_autoptr (GVariant) histogram = NULL;
+  gboolean done = FALSE;
+  guint64 iterations, stalls;
+  gint64 max_dispatch;
+
+  phosh_watchdog_reset ();
+  phosh_watchdog_start (10);
+  g_assert_true (phosh_watchdog_is_running ());
+  g_assert_cmpint (phosh_watchdog_get_threshold (), ==, 10);
+
+  g_idle_add (on_idle_stall, &done);
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+  /* The stall is accounted on the next poll */
+  g_main_context_iteration (NULL, FALSE);
+
+  stats = g_variant_ref_sink (phosh_watchdog_get_stats ());
+  g_assert_true (g_variant_lookup (stats, "iterations", "t", &iterations));
+  g_assert_cmpint (iterations, >=, 1);
+  g_assert_true (g_variant_lookup (stats, "stalls", "t", &stalls));
+  g_assert_cmpint (stalls, ==, 1);
+  g_assert_true (g_variant_lookup (stats, "max-dispatch", "x", &max_dispatch));
+  g_assert_cmpint (max_dispatch, >=, 20 * 1000);
+
+  recent = g_variant_lookup_value (stats, "recent-stalls", G_VARIANT_TYPE ("a(xxs)"));
+  g_assert_nonnull (recent);
+  g_assert_cmpint (g_variant_n_children (recent), ==, 1);
+
+  histogram = g_variant_lookup_value (stats, "dispatch-histogram", G_VARIANT_TYPE ("a(xt)"));
+  g_assert_nonnull (histogram);
+  g_assert_cmpint (g_variant_n_children (histogram), >, 0);
+
+  phosh_watchdog_stop ();
+  g_assert_false (phosh_watchdog_is_running ());
+  g_assert_cmpint (phosh_watchdog_get_threshold (), ==, 0);
+}
+
+
+static void
+test_phosh_watchdog_source (void)
+{
+  g_autoptr (GVariant) stats = NULL;
+  g_autoptr (GVariant) recent = NULL;
+  g_autoptr (GVariant) sources = NULL;
+  g_autoptr (GVariant) histogram = NULL;
+  const char *name;
+  gboolean done = FALSE;
+  gint64 duration;
+  guint64 count = 0;
+
+  phosh_watchdog_reset ();
+  phosh_watchdog_start (10);
+
+  phosh_watchdog_idle_add (on_idle_stall, &done, "[phosh] test stall");
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+  g_main_context_iteration (NULL, FALSE);
+
+  stats = g_variant_ref_sink (phosh_watchdog_get_stats ());
+
+  /* The stall is attributed to the source */
+  recent = g_variant_lookup_value (stats, "recent-stalls", G_VARIANT_TYPE ("a(xxs)"));
+  g_assert_nonnull (recent);
+  g_assert_cmpint (g_variant_n_children (recent), ==, 1);
+  g_variant_get_child (recent, 0, "(xx&s)", NULL, &duration, &name);
+  g_assert_cmpint (duration, >=, 20 * 1000);
+  g_assert_cmpstr (name, ==, "[phosh] test stall");
+
+  /* The source's dispatch got recorded */
+  sources = g_variant_lookup_value (stats, "source-dispatch", G_VARIANT_TYPE ("a{sa(xt)}"));
+  g_assert_nonnull (sources);
+  histogram = g_variant_lookup_value (sources, "[phosh] test stall", G_VARIANT_TYPE ("a(xt)"));
+  g_assert_nonnull (histogram);
+  for (gsize i = 0; i < g_variant_n_children (histogram); i++) {
+    guint64 n;
+
+    g_variant_get_child (histogram, i, "(xt)", NULL, &n);
+    count += n;
+  }
+  g_assert_cmpint (count, ==, 1);
+
+  phosh_watchdog_stop ();
+}
+
+
+static void
+test_phosh_watchdog_reset (void)
+{
+  g_autoptr (GVariant) stats = NULL;
+  guint64 iterations, stalls;
+
+  phosh_watchdog_start (PHOSH_WATCHDOG_DEFAULT_THRESHOLD);
+  g_main_context_iteration (NULL, FALSE);
+  g_main_context_iteration (NULL, FALSE);
+  phosh_watchdog_stop ();
+
+  phosh_watchdog_reset ();
+  stats = g_variant_ref_sink (phosh_watchdog_get_stats ());
+  g_assert_true (g_variant_lookup (stats, "iterations", "t", &iterations));
+  g_assert_cmpint (iterations, ==, 0);
+  g_assert_true (g_variant_lookup (stats, "stalls", "t", &stalls));
+  g_assert_cmpint (stalls, ==, 0);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/phosh/watchdog/stall", test_phosh_watchdog_stall);
+  g_test_add_func ("/phosh/watchdog/source", test_phosh_watchdog_source);
+  g_test_add_func ("/phosh/watchdog/reset", test_phosh_watchdog_reset);
+
+  return g_test_run ();
+}
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/*
+ * Helpers for the benchmarks run via `meson test --benchmark`. Each
+ * benchmark times a number of iterations and reports them as a
+ * single line of JSON on stdout. If `PHOSH_BENCH_OUTPUT` is set the
+ * line is also appended to that file so results can be collected per
+ * commit. `PHOSH_BENCH_ITERATIONS` overrides the number of iterations.
+ */
+
+#include "testlib-bench.h"
+
+#include <gio/gio.h>
+#include <glib/gstdio.h>
+
+#include <string.h>
+
+#define DEFAULT_ITERATIONS 20
+
+struct _PhoshTestBench {
+  char   *name;
+  guint   n;
+  guint   iterations;
+  gint64  start;
+  GArray *samples;
+};
+
+
+PhoshTestBench *
+phosh_test_bench_new (const char *name, guint n)
+{
+  PhoshTestBench *self = g_new0 (PhoshTestBench, 1);
+  const char *iterations = g_getenv ("PHOSH_BENCH_ITERATIONS");
+
+  self->name = g_strdup (name);
+  self->n = n;
+  self->iterations = iterations ? g_ascii_strtoull (iterations, NULL, 10) : 0;
+  if (self->iterations == 0)
+    self->iterations = DEFAULT_ITERATIONS;
+  self->samples = g_array_new (FALSE, FALSE, sizeof (gint64));
+
+  return self;
+}
+
+
+void
+phosh_test_bench_free (PhoshTestBench *self)
+{
+  g_array_unref (self->samples);
+  g_free (self->name);
+  g_free (self);
+}
+
+
+guint
+phosh_test_bench_get_iterations (PhoshTestBench *self)
+{
+  return self->iterations;
+}
+
+
+void
+phosh_test_bench_begin (PhoshTestBench *self)
+{
+  self->start = g_get_monotonic_time ();
+}
+
+
+void
+phosh_test_bench_end (PhoshTestBench *self)
+{
+  gint64 sample = g_get_monotonic_time () - self->start;
+
+  g_array_append_val (self->samples, sample);
+}
+
+
+static int
+compare_samples (gconstpointer a, gconstpointer b)
+{
+  gint64 sa = *(const gint64 *)a;
+  gint64 sb = *(const gint64 *)b;
+
+  return (sa > sb) - (sa < sb);
+}
+
+/* Report min, median, mean and max in microseconds */
+void
+phosh_test_bench_report (PhoshTestBench *self)
+{
+  g_autofree char *line = NULL;
+  const char *output;
+  gint64 sum = 0;
+  guint len = self->samples->len;
+
+  g_assert_cmpint (len, >, 0);
+
+  g_array_sort (self->samples, compare_samples);
+  for (guint i = 0; i < len; i++)
+    sum += g_array_index (self->samples, gint64, i);
+
+  line = g_strdup_printf ("{\"benchmark\":\"%s\",\"n\":%u,\"iterations\":%u,"
+                          "\"min_us\":%" G_GINT64_FORMAT ",\"median_us\":%" G_GINT64_FORMAT ","
+                          "\"mean_us\":%" G_GINT64_FORMAT ",\"max_us\":%" G_GINT64_FORMAT "}\n",
+                          self->name,
+                          self->n,
+                          len,
+                          g_array_index (self->samples, gint64, 0),
+                          g_array_index (self->samples, gint64, len / 2),
+                          sum / len,
+                          g_array_index (self->samples, gint64, len - 1));
+  g_print ("%s", line);
+
+  output = g_getenv ("PHOSH_BENCH_OUTPUT");
+  if (output) {
+    g_autoptr (GFile) file = g_file_new_for_path (output);
+    g_autoptr (GFileOutputStream) stream = NULL;
+    g_autoptr (GError) err = NULL;
+
+    stream = g_file_append_to (file, G_FILE_CREATE_NONE, NULL, &err);
+    if (stream)
+      g_output_stream_write_all (G_OUTPUT_STREAM (stream), line, strlen (line), NULL, NULL, &err);
+    if (err)
+      g_warning ("Failed to write benchmark result to %s: %s", output, err->message);
+  }
+}
+
+/**
+ * phosh_test_bench_create_desktop_files:
+ * @n: The number of desktop files
+ *
+ * Creates a temporary data dir with `n` synthetic applications and
+ * prepends it to `XDG_DATA_DIRS`. Needs to be invoked before GIO
+ * looks up any applications.
+ *
+ * Returns: The data dir
+ */
+char *
+phosh_test_bench_create_desktop_files (guint n)
+{
+  g_autoptr (GError) err = NULL;
+  g_autofree char *apps_dir = NULL;
+  g_autofree char *data_dirs = NULL;
+  char *dir;
+
+  dir = g_dir_make_tmp ("phosh-bench-XXXXXX", &err);
+  g_assert_no_error (err);
+
+  apps_dir = g_build_filename (dir, "applications", NULL);
+  g_assert_cmpint (g_mkdir (apps_dir, 0755), ==, 0);
+
+  for (guint i = 0; i < n; i++) {
+    g_autofree char *basename = g_strdup_printf ("mobi.phosh.BenchApp%u.desktop", i);
+    g_autofree char *path = g_build_filename (apps_dir, basename, NULL);
+    g_autofree char *contents = NULL;
+
+    /* Exec needs to exist in PATH, otherwise GIO ignores the app */
+    contents = g_strdup_printf ("[Desktop Entry]\n"
+                                "Type=Application\n"
+                                "Name=Bench App %u\n"
+                                "GenericName=Synthetic Application\n"
+                                "Comment=Synthetic application %u for benchmarks\n"
+                                "Exec=true --bench-app-%u\n"
+                                "Icon=application-x-executable\n"
+                                "Keywords=bench;synthetic;app%u;\n"
+                                "Categories=Utility;\n"
+                                "StartupWMClass=bench-app-%u\n",
+                                i, i, i, i, i);
+    g_file_set_contents (path, contents, -1, &err);
+    g_assert_no_error (err);
+  }
+
+  data_dirs = g_strdup_printf ("%s:%s", dir, g_getenv ("XDG_DATA_DIRS") ?: "/usr/share");
+  g_setenv ("XDG_DATA_DIRS", data_dirs, TRUE);
+
+  return dir;
+}
+
+
+void
+phosh_test_bench_remove_desktop_files (const char *dir, guint n)
+{
+  g_autofree char *apps_dir = g_build_filename (dir, "applications", NULL);
+
+  for (guint i = 0; i < n; i++) {
+    g_autofree char *basename = g_strdup_printf ("mobi.phosh.BenchApp%u.desktop", i);
+    g_autofree char *path = g_build_filename (apps_dir, basename, NULL);
+
+    g_unlink (path);
+  }
+  g_rmdir (apps_dir);
+  g_rmdir (dir);
+}
@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) 2025 Phosh.mobi e.V.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _PhoshTestBench PhoshTestBench;
+
+PhoshTestBench *phosh_test_bench_new                  (const char     *name,
+                                                       guint           n);
+void            phosh_test_bench_free                 (PhoshTestBench *self);
+guint           phosh_test_bench_get_iterations       (PhoshTestBench *self);
+void            phosh_test_bench_begin                (PhoshTestBench *self);
+void            phosh_test_bench_end                  (PhoshTestBench *self);
+void            phosh_test_bench_report               (PhoshTestBench *self);
+
+char           *phosh_test_bench_create_desktop_files (guint           n);
+void            phosh_test_bench_remove_desktop_files (const char     *dir,
+                                                       guint           n);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (PhoshTestBench, phosh_test_bench_free)
+
+G_END_DECLS